@@ -8,6 +8,8 @@
 #include <rtems.h>
 #include <rtems/score/percpu.h>
 #include <rtems/score/threaddispatch.h>
+#include <rtems/score/timecounter.h>
+#include <rtems/score/watchdogimpl.h>
 
 #define CLOCK_VECTOR 0
 
@@ -27,6 +29,25 @@
 #define BSP_CLOCK_DRIVER_DELAY()
 #endif
 
+/*
+ *  In tickless idle mode, the simulated time advances in one step up to the
+ *  clock tick of the next watchdog expiration.  The skipped clock ticks are
+ *  accounted before the clock tick which processes the watchdogs.
+ */
+static void clock_driver_sim_idle_tickless( void )
+{
+  uint32_t         us_per_tick;
+  uint32_t         ticks;
+  ISR_lock_Context lock_context;
+
+  us_per_tick = rtems_configuration_get_microseconds_per_tick();
+  ticks = _Watchdog_Get_idle_ticks( UINT32_MAX / us_per_tick );
+  _Watchdog_Skip_ticks( ticks - 1 );
+
+  _Timecounter_Acquire( &lock_context );
+  _Timecounter_Tick_simple( ticks * us_per_tick, 0, &lock_context );
+}
+
 /*
  *  Since there is no interrupt on this simulator, let's just
  *  fake time passing.  This will not let preemption from an
@@ -39,7 +60,11 @@ void *clock_driver_sim_idle_body(
   for( ; ; ) {
     Per_CPU_Control *cpu = _Thread_Dispatch_disable();
     _ISR_Nest_level++;
-    rtems_clock_tick();
+    if ( _Watchdog_Tickless_idle ) {
+      clock_driver_sim_idle_tickless();
+    } else {
+      rtems_clock_tick();
+    }
     _ISR_Nest_level--;
     _Thread_Dispatch_enable( cpu );
     BSP_CLOCK_DRIVER_DELAY();
@@ -203,6 +203,53 @@ int mq_getattr(
   struct mq_attr *mqstat
 );
 
+/**
+ * @brief Send several messages to a message queue.
+ *
+ * Sends @a count messages of @a msg_len bytes each with the priority
+ * @a msg_prio.  The messages are stored consecutively at @a msg_ptr.  All
+ * messages are transferred under one acquisition of the message queue lock.
+ * If the message queue is full and O_NONBLOCK is not set, then the calling
+ * thread blocks until the first message is sent.
+ *
+ * This is an RTEMS extension.
+ *
+ * @return The count of messages sent.  Less than @a count messages are sent
+ * if the message queue is full.  In case of an error, -1 is returned and
+ * errno is set.
+ */
+ssize_t mq_send_many_np(
+  mqd_t         mqdes,
+  const char   *msg_ptr,
+  size_t        msg_len,
+  unsigned int  count,
+  unsigned int  msg_prio
+);
+
+/**
+ * @brief Receive several messages from a message queue.
+ *
+ * Receives up to @a count pending messages.  Message @a i is stored at
+ * @a msg_ptr + @a i * @a msg_len, its length in @a msg_lens[ @a i ] and its
+ * priority in @a msg_prios[ @a i ], if @a msg_prios is not NULL.  The
+ * @a msg_len must be at least the message size of the message queue.  If no
+ * message is pending and O_NONBLOCK is not set, then the calling thread
+ * blocks until it receives one message.
+ *
+ * This is an RTEMS extension.
+ *
+ * @return The count of messages received.  In case of an error, -1 is
+ * returned and errno is set.
+ */
+ssize_t mq_receive_many_np(
+  mqd_t         mqdes,
+  char         *msg_ptr,
+  size_t        msg_len,
+  size_t       *msg_lens,
+  unsigned int *msg_prios,
+  unsigned int  count
+);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -44,7 +44,7 @@ extern "C" {
  *
  * The Block Device Buffer Management implements a cache between the disk
  * devices and file systems.  The code provides read-ahead and write queuing to
- * the drivers and fast cache look-up using an AVL tree.
+ * the drivers and fast cache look-up using hash tables.
  *
  * The block size used by a file system can be set at runtime and must be a
  * multiple of the disk device block size.  The disk device's physical block
@@ -70,7 +70,16 @@ extern "C" {
  * cannot be realloced.  Groups with no buffers in use can be taken and
  * realloced to a new size.  This is how buffers of different sizes move around
  * the cache.
-
+ *
+ * The cache may be divided into independently locked partitions to reduce the
+ * lock contention on SMP configurations.  The groups are distributed over the
+ * partitions.  A block is assigned to a partition by a hash of its disk device
+ * and block extent, so consecutive blocks share a partition.  Each partition
+ * has its own hash index, lists and waiters.  A buffer stays in the partition
+ * of its group.  A partition without a buffer to recycle takes a group with no
+ * buffers in use from another partition.  If there is no such group, then the
+ * request waits until a buffer of any partition is released.
+ *
  * The buffers are held in various lists in the cache.  All buffers follow this
  * state machine:
  *
@@ -129,7 +138,8 @@ extern "C" {
  * Empty or cached buffers are added to the LRU list and removed from this
  * queue when a caller requests a buffer.  This is referred to as getting a
  * buffer in the code and the event get in the state diagram.  The buffer is
- * assigned to a block and inserted to the AVL based on the block/device key.
+ * assigned to a block and inserted to the hash index of its partition based on
+ * the block/device key.
  * If the block is to be read by the user and not in the cache it is transfered
  * from the disk into memory.  If no buffers are on the LRU list the modified
  * list is checked.  If buffers are on the modified the swap out task will be
@@ -178,11 +188,11 @@ extern "C" {
  * @brief State of a buffer of the cache.
  *
  * The state has several implications.  Depending on the state a buffer can be
- * in the AVL tree, in a list, in use by an entity and a group user or not.
+ * in the hash index, in a list, in use by an entity and a group user or not.
  *
  * <table>
  *   <tr>
- *     <th>State</th><th>Valid Data</th><th>AVL Tree</th>
+ *     <th>State</th><th>Valid Data</th><th>Hash Index</th>
  *     <th>LRU List</th><th>Modified List</th><th>Synchronization List</th>
  *     <th>Group User</th><th>External User</th>
  *   </tr>
@@ -299,20 +309,14 @@ typedef struct rtems_bdbuf_group rtems_bdbuf_group;
 /**
  * To manage buffers we using buffer descriptors (BD). A BD holds a buffer plus
  * a range of other information related to managing the buffer in the cache. To
- * speed-up buffer lookup descriptors are organized in AVL-Tree. The fields
+ * speed-up buffer lookup descriptors are organized in hash tables. The fields
  * 'dd' and 'block' are search keys.
  */
 typedef struct rtems_bdbuf_buffer
 {
   rtems_chain_node link;       /**< Link the BD onto a number of lists. */
 
-  struct rtems_bdbuf_avl_node
-  {
-    struct rtems_bdbuf_buffer* left;   /**< Left Child */
-    struct rtems_bdbuf_buffer* right;  /**< Right Child */
-    signed char                cache;  /**< Cache */
-    signed char                bal;    /**< The balance of the sub-tree */
-  } avl;
+  struct rtems_bdbuf_buffer* hash_next; /**< Next BD in the hash bucket. */
 
   rtems_disk_device *dd;        /**< disk device */
 
@@ -329,6 +333,12 @@ typedef struct rtems_bdbuf_buffer
   uint32_t hold_timer;           /**< Timer to indicate how long a buffer
                                   * has been held in the cache modified. */
 
+  bool hot;                      /**< The buffer is on the frequently used
+                                  * list of its partition. */
+  bool recent;                   /**< The buffer is on the recently used
+                                  * list of its partition.  It keeps its
+                                  * position there while it is accessed. */
+
   int   references;              /**< Allow reference counting by owner. */
   void* user;                    /**< User data. */
 } rtems_bdbuf_buffer;
@@ -349,8 +359,35 @@ struct rtems_bdbuf_group
                                       * 2. */
   uint32_t            users;         /**< How many users the block has. */
   rtems_bdbuf_buffer* bdbuf;         /**< First BD this block covers. */
+  uint32_t            partition;     /**< Index of the cache partition which
+                                      * owns the group. */
 };
 
+/**
+ * Replacement policies of the cache.  The policy selects the cached buffer
+ * which is recycled if a block is not in the cache and no free buffer is
+ * available.
+ */
+typedef enum {
+  /**
+   * @brief Recycle the least recently used buffer.
+   */
+  RTEMS_BDBUF_REPLACEMENT_LRU,
+
+  /**
+   * @brief Recycle buffers with the 2Q policy.
+   *
+   * A block read for the first time is placed on a recently used FIFO list
+   * limited to a quarter of the cache.  Only blocks read again shortly after
+   * they were recycled from this list are placed on the least recently used
+   * list.  The recycled blocks are remembered on a ghost list which contains
+   * no data.  A sequential scan of many blocks thus recycles only buffers of
+   * the recently used list and does not push out frequently used blocks, for
+   * example file system meta-data.
+   */
+  RTEMS_BDBUF_REPLACEMENT_2Q
+} rtems_bdbuf_replacement_policy;
+
 /**
  * Buffering configuration definition. See confdefs.h for support on using this
  * structure.
@@ -380,6 +417,19 @@ typedef struct rtems_bdbuf_config {
                                                 * allocation size. */
   rtems_task_priority read_ahead_priority;     /**< Priority of the read-ahead
                                                 * task. */
+  uint32_t            partitions;              /**< Number of independently
+                                                * locked cache partitions. */
+  rtems_bdbuf_replacement_policy replacement_policy; /**< Replacement policy
+                                                      * of the cache. */
+  uint32_t            swapout_queue_depth;     /**< Maximum number of write
+                                                * requests of a swap-out
+                                                * transfer submitted to a
+                                                * driver at a time. */
+  uint32_t            direct_transfer_min_blocks; /**< Minimum number of
+                                                   * blocks of a file system
+                                                   * transfer which bypasses
+                                                   * the cache.  Zero disables
+                                                   * direct transfers. */
 } rtems_bdbuf_config;
 
 /**
@@ -452,6 +502,29 @@ extern const rtems_bdbuf_config rtems_bdbuf_configuration;
  */
 #define RTEMS_BDBUF_BUFFER_MAX_SIZE_DEFAULT (4096)
 
+/**
+ * Default count of cache partitions.  A single partition uses one lock for the
+ * whole cache.
+ */
+#define RTEMS_BDBUF_PARTITIONS_DEFAULT (1)
+
+/**
+ * Default replacement policy.
+ */
+#define RTEMS_BDBUF_REPLACEMENT_POLICY_DEFAULT RTEMS_BDBUF_REPLACEMENT_LRU
+
+/**
+ * Default swap-out queue depth.  The swap-out waits for each write request
+ * before it submits the next one.
+ */
+#define RTEMS_BDBUF_SWAPOUT_QUEUE_DEPTH_DEFAULT (1)
+
+/**
+ * Default minimum number of blocks of a direct transfer.  The file systems use
+ * the cache for all transfers.
+ */
+#define RTEMS_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS_DEFAULT (0)
+
 /**
  * Prepare buffering layer to work - initialize buffer descritors and (if it is
  * neccessary) buffers. After initialization all blocks is placed into the
@@ -625,6 +698,122 @@ rtems_bdbuf_sync (rtems_bdbuf_buffer* bd);
 rtems_status_code
 rtems_bdbuf_syncdev (rtems_disk_device *dd);
 
+/**
+ * @brief Reads blocks of a disk device directly into a buffer of the caller.
+ *
+ * The blocks are read with multi-block transfer requests which bypass the
+ * cache, so the blocks do not displace other buffers.  Modified buffers of the
+ * blocks are written to the disk before the transfer.  Buffers of the blocks
+ * which are in use by another task delay the transfer until they are
+ * released, so the caller must not hold such a buffer itself.
+ *
+ * The cache is made coherent only once before the transfer.  The caller must
+ * keep other modifications of the blocks through the cache out for the whole
+ * call, e.g. with a lock of the file system or the file, otherwise the buffer
+ * may receive outdated content.
+ *
+ * Before you can use this function, the rtems_bdbuf_init() routine must be
+ * called at least once to initialize the cache, otherwise a fatal error will
+ * occur.
+ *
+ * @param dd [in] The disk device.
+ * @param block [in] Linear block number of the first block.
+ * @param block_count [in] Count of blocks to read.
+ * @param buffer [out] The buffer for @a block_count blocks.
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ID Invalid block range.
+ * @retval RTEMS_IO_ERROR IO error.
+ *
+ * @see rtems_bdbuf_can_transfer_direct().
+ */
+rtems_status_code
+rtems_bdbuf_read_direct (rtems_disk_device *dd,
+                         rtems_blkdev_bnum  block,
+                         uint32_t           block_count,
+                         void              *buffer);
+
+/**
+ * @brief Writes blocks of a disk device directly from a buffer of the caller.
+ *
+ * The blocks are written with multi-block transfer requests which bypass the
+ * cache.  Buffers of the blocks are discarded before the transfer since their
+ * content is outdated afterwards.  Buffers of the blocks which are in use by
+ * another task delay the transfer until they are released, so the caller must
+ * not hold such a buffer itself.  After a successful transfer the buffers of
+ * the blocks are discarded again, since a read through the cache during the
+ * transfer may have cached the previous content.
+ *
+ * The caller must keep other accesses of the blocks through the cache out for
+ * the whole call, e.g. with a lock of the file system or the file.  A
+ * modification through the cache during the transfer may be lost or may
+ * overwrite the written blocks later.
+ *
+ * Before you can use this function, the rtems_bdbuf_init() routine must be
+ * called at least once to initialize the cache, otherwise a fatal error will
+ * occur.
+ *
+ * @param dd [in] The disk device.
+ * @param block [in] Linear block number of the first block.
+ * @param block_count [in] Count of blocks to write.
+ * @param buffer [in] The buffer with @a block_count blocks.
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ID Invalid block range.
+ * @retval RTEMS_IO_ERROR IO error.
+ *
+ * @see rtems_bdbuf_can_transfer_direct().
+ */
+rtems_status_code
+rtems_bdbuf_write_direct (rtems_disk_device *dd,
+                          rtems_blkdev_bnum  block,
+                          uint32_t           block_count,
+                          const void        *buffer);
+
+/**
+ * @brief Indicates if a file system should transfer the blocks directly.
+ *
+ * This is the case if direct transfers are enabled by the configuration, the
+ * count of blocks reaches the configured minimum and the buffer is aligned to
+ * the data cache lines like the buffers of the cache.
+ *
+ * @param buffer [in] The buffer of the caller.
+ * @param block_count [in] Count of blocks to transfer.
+ *
+ * @retval true Use rtems_bdbuf_read_direct() or rtems_bdbuf_write_direct().
+ * @retval false Otherwise.
+ */
+bool
+rtems_bdbuf_can_transfer_direct (const void *buffer, uint32_t block_count);
+
+/**
+ * @brief Discards blocks of a disk device which are no longer in use.
+ *
+ * A file system uses this function for blocks it freed.  Buffers of the blocks
+ * are discarded, modified buffers without a write to the disk.  Buffers of the
+ * blocks which are in use by another task delay the discard until they are
+ * released, so the caller must not hold such a buffer itself.  In case the
+ * driver has the @ref RTEMS_BLKDEV_CAP_DISCARD capability, then a discard
+ * request for the blocks is issued to the driver.  Ranges of 4GiB and more are
+ * issued as several requests, since the request length is 32 bits wide.
+ *
+ * Before you can use this function, the rtems_bdbuf_init() routine must be
+ * called at least once to initialize the cache, otherwise a fatal error will
+ * occur.
+ *
+ * @param dd [in] The disk device.
+ * @param block [in] Linear block number of the first block.
+ * @param block_count [in] Count of blocks to discard.
+ *
+ * @retval RTEMS_SUCCESSFUL Successful operation.
+ * @retval RTEMS_INVALID_ID Invalid block range.
+ * @retval RTEMS_IO_ERROR The driver failed to discard the blocks.
+ */
+rtems_status_code
+rtems_bdbuf_discard (rtems_disk_device *dd,
+                     rtems_blkdev_bnum  block,
+                     uint32_t           block_count);
+
 /**
  * @brief Purges all buffers corresponding to the disk device @a dd.
  *
@@ -49,7 +49,9 @@ extern "C" {
 typedef enum rtems_blkdev_request_op {
   RTEMS_BLKDEV_REQ_READ,       /**< Read the requested blocks of data. */
   RTEMS_BLKDEV_REQ_WRITE,      /**< Write the requested blocks of data. */
-  RTEMS_BLKDEV_REQ_SYNC        /**< Sync any data with the media. */
+  RTEMS_BLKDEV_REQ_SYNC,       /**< Sync any data with the media. */
+  RTEMS_BLKDEV_REQ_DISCARD     /**< Discard the data of the requested
+                                    blocks. */
 } rtems_blkdev_request_op;
 
 struct rtems_blkdev_request;
@@ -97,6 +99,13 @@ typedef struct rtems_blkdev_sg_buffer {
  * called exactly once per request.  The return value of the IO control will be
  * ignored for transfer requests.
  *
+ * A discard request tells the driver that the file system no longer uses the
+ * data of the blocks.  Each scatter or gather buffer describes a range of
+ * blocks which starts at the block index and has the buffer length in bytes.
+ * The buffer pointer is @c NULL.  The content of a discarded block is
+ * undefined until it is written again.  Discard requests are only issued to
+ * drivers with the @ref RTEMS_BLKDEV_CAP_DISCARD capability.
+ *
  * @see rtems_blkdev_create().
  */
 typedef struct rtems_blkdev_request {
@@ -189,6 +198,7 @@ static inline void rtems_blkdev_request_done(
 #define RTEMS_BLKIO_PURGEDEV        _IO('B', 10)
 #define RTEMS_BLKIO_GETDEVSTATS     _IOR('B', 11, rtems_blkdev_stats *)
 #define RTEMS_BLKIO_RESETDEVSTATS   _IO('B', 12)
+#define RTEMS_BLKIO_GETQUEUEDEPTH   _IOR('B', 13, uint32_t)
 
 /** @} */
 
@@ -270,6 +280,26 @@ static inline int rtems_disk_fd_reset_device_stats(int fd)
  */
 #define RTEMS_BLKDEV_CAP_SYNC (1 << 1)
 
+/**
+ * @brief The driver accepts multiple requests at a time.
+ *
+ * The driver returns the maximum count of requests it accepts before the
+ * first of them is done via the @ref RTEMS_BLKIO_GETQUEUEDEPTH IO control.
+ * The swapout of the block device buffer cache submits up to this count of
+ * write requests limited by the configured swapout queue depth.
+ */
+#define RTEMS_BLKDEV_CAP_QUEUED_REQUESTS (1 << 2)
+
+/**
+ * @brief The driver accepts discard requests.
+ *
+ * Flash based devices may use the discarded blocks to reduce the copying of
+ * obsolete data during the garbage collection.
+ *
+ * @see rtems_bdbuf_discard().
+ */
+#define RTEMS_BLKDEV_CAP_DISCARD (1 << 3)
+
 /** @} */
 
 /**
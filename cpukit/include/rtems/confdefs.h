@@ -30,6 +30,8 @@
 #include <rtems/ioimpl.h>
 #include <rtems/sysinit.h>
 #include <rtems/score/apimutex.h>
+#include <rtems/score/heapimpl.h>
+#include <rtems/score/objectimpl.h>
 #include <rtems/score/percpu.h>
 #include <rtems/score/userextimpl.h>
 #include <rtems/score/wkspace.h>
@@ -150,6 +152,15 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
   #define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 3
 #endif
 
+/**
+ * This macro defines the number of entries of the global name cache used by
+ * the path evaluation of file systems which support it, e.g. the DOSFS and
+ * RFS.  The name cache is disabled by default.
+ */
+#ifndef CONFIGURE_FILESYSTEM_NAME_CACHE_ENTRIES
+  #define CONFIGURE_FILESYSTEM_NAME_CACHE_ENTRIES 0
+#endif
+
 /*
  * POSIX key count used by the IO library.
  */
@@ -163,6 +174,9 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
    * initialized to specify the maximum number of file descriptors.
    */
   const uint32_t rtems_libio_number_iops = RTEMS_ARRAY_SIZE(rtems_libio_iops);
+
+  const uint32_t rtems_filesystem_name_cache_entry_count =
+    CONFIGURE_FILESYSTEM_NAME_CACHE_ENTRIES;
 #endif
 
 #ifdef CONFIGURE_SMP_MAXIMUM_PROCESSORS
@@ -575,12 +589,16 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       static const IMFS_mknod_controls _Configure_IMFS_mknod_controls = {
         #ifdef CONFIGURE_IMFS_DISABLE_READDIR
           &IMFS_mknod_control_dir_minimal,
+        #elif defined(CONFIGURE_IMFS_ENABLE_HASHED_DIRECTORIES)
+          &IMFS_mknod_control_dir_hashed,
         #else
           &IMFS_mknod_control_dir_default,
         #endif
         &IMFS_mknod_control_device,
         #ifdef CONFIGURE_IMFS_DISABLE_MKNOD_FILE
           &IMFS_mknod_control_enosys,
+        #elif defined(CONFIGURE_IMFS_ENABLE_EXTENT_FILES)
+          &IMFS_mknod_control_extfile,
         #else
           &IMFS_mknod_control_memfile,
         #endif
@@ -1270,6 +1288,22 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
   #endif
 #endif
 
+#ifdef CONFIGURE_INIT
+  /**
+   * This configures the allocation method of the C Program Heap.  By
+   * default the first fit method is used.  The segregated fit method
+   * provides constant time allocations and deallocations at the cost of
+   * an index placed in the first heap area.
+   */
+  const Heap_Initialization_or_extend_handler
+    RTEMS_Malloc_Initialize_handler =
+    #ifdef CONFIGURE_MALLOC_SEGREGATED_FIT
+      _Heap_Initialize_segregated_fit;
+    #else
+      _Heap_Initialize;
+    #endif
+#endif
+
 #ifdef CONFIGURE_INIT
   /**
    * This configures the sbrk() support for the malloc family.
@@ -1285,6 +1319,19 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
     #endif
 #endif
 
+#ifdef CONFIGURE_INIT
+  /**
+   * This configures the per-processor cache for small objects in front of
+   * the C program heap.  It is disabled by default.
+   */
+  const rtems_malloc_cache_handlers *const rtems_malloc_cache =
+    #ifdef CONFIGURE_MALLOC_PER_CPU_CACHE
+      &rtems_malloc_per_cpu_cache;
+    #else
+      NULL;
+    #endif
+#endif
+
 #ifdef CONFIGURE_INIT
   /**
    * This configures the malloc family plugin which dirties memory
@@ -1355,6 +1402,32 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
 #define _Configure_Max_Objects(_max) \
   (_Configure_Zero_or_One(_max) * rtems_resource_maximum_per_allocation(_max))
 
+/**
+ * This macro accounts for the object name index of a set of configured
+ * objects.  The count of hash buckets is less than twice the maximum.
+ */
+#ifdef CONFIGURE_OBJECTS_NAME_INDEX
+  #define _CONFIGURE_OBJECTS_NAME_INDEX_RAM(_number) \
+    _Configure_Align_up( \
+      (3 * _Configure_Max_Objects(_number) + 2) * sizeof(Objects_Maximum), \
+      CPU_ALIGNMENT \
+    )
+#else
+  #define _CONFIGURE_OBJECTS_NAME_INDEX_RAM(_number) 0
+#endif
+
+/**
+ * This macro accounts for the per-processor caches of inactive objects of a
+ * set of configured objects.
+ */
+#if defined(CONFIGURE_OBJECTS_PER_CPU_CACHE) && \
+  _CONFIGURE_MAXIMUM_PROCESSORS > 1
+  #define _CONFIGURE_OBJECTS_INACTIVE_CACHE_RAM \
+    (_CONFIGURE_MAXIMUM_PROCESSORS * sizeof(Objects_Inactive_cache))
+#else
+  #define _CONFIGURE_OBJECTS_INACTIVE_CACHE_RAM 0
+#endif
+
 /**
  * This macro accounts for how memory for a set of configured objects is
  * allocated from the Executive Workspace.
@@ -1368,8 +1441,12 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       _Configure_Zero_or_One(_number) * ( \
         (_Configure_Max_Objects(_number) + 1) * sizeof(Objects_Control *) + \
         _Configure_Align_up(sizeof(void *), CPU_ALIGNMENT) + \
-        _Configure_Align_up(sizeof(uint32_t), CPU_ALIGNMENT) \
+        _Configure_Align_up(sizeof(uint32_t), CPU_ALIGNMENT) + \
+        _CONFIGURE_OBJECTS_NAME_INDEX_RAM(_number) \
       ) \
+    ) + \
+    _Configure_From_workspace( \
+      _Configure_Zero_or_One(_number) * _CONFIGURE_OBJECTS_INACTIVE_CACHE_RAM \
     ) \
   )
 /**@}*/
@@ -1758,6 +1835,22 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
     #define CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY \
                               RTEMS_BDBUF_READ_AHEAD_TASK_PRIORITY_DEFAULT
   #endif
+  #ifndef CONFIGURE_BDBUF_PARTITIONS
+    #define CONFIGURE_BDBUF_PARTITIONS \
+                              RTEMS_BDBUF_PARTITIONS_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_REPLACEMENT_POLICY
+    #define CONFIGURE_BDBUF_REPLACEMENT_POLICY \
+                              RTEMS_BDBUF_REPLACEMENT_POLICY_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_SWAPOUT_QUEUE_DEPTH
+    #define CONFIGURE_BDBUF_SWAPOUT_QUEUE_DEPTH \
+                              RTEMS_BDBUF_SWAPOUT_QUEUE_DEPTH_DEFAULT
+  #endif
+  #ifndef CONFIGURE_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS
+    #define CONFIGURE_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS \
+                              RTEMS_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS_DEFAULT
+  #endif
   #ifdef CONFIGURE_INIT
     const rtems_bdbuf_config rtems_bdbuf_configuration = {
       CONFIGURE_BDBUF_MAX_READ_AHEAD_BLOCKS,
@@ -1771,7 +1864,11 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
       CONFIGURE_BDBUF_CACHE_MEMORY_SIZE,
       CONFIGURE_BDBUF_BUFFER_MIN_SIZE,
       CONFIGURE_BDBUF_BUFFER_MAX_SIZE,
-      CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY
+      CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY,
+      CONFIGURE_BDBUF_PARTITIONS,
+      CONFIGURE_BDBUF_REPLACEMENT_POLICY,
+      CONFIGURE_BDBUF_SWAPOUT_QUEUE_DEPTH,
+      CONFIGURE_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS
     };
   #endif
 
@@ -2207,6 +2304,26 @@ extern rtems_initialization_tasks_table Initialization_tasks[];
   #define CONFIGURE_TICKS_PER_TIMESLICE        50
 #endif
 
+/**
+ * If CONFIGURE_WATCHDOG_TIMING_WHEEL is defined, then watchdogs with an
+ * expiration time in clock ticks are managed by a hierarchical timing wheel
+ * on each processor instead of a red-black tree.  This makes the insert and
+ * remove of these watchdogs constant-time operations at the cost of about
+ * 3KiB of memory per processor.  Watchdogs with an expiration time of the
+ * realtime or monotonic clock are not affected.
+ */
+#ifdef CONFIGURE_WATCHDOG_TIMING_WHEEL
+  #include <rtems/score/watchdogimpl.h>
+
+  #ifdef CONFIGURE_INIT
+    RTEMS_SYSINIT_ITEM(
+      _Watchdog_Wheel_initialize,
+      RTEMS_SYSINIT_DATA_STRUCTURES,
+      RTEMS_SYSINIT_ORDER_LAST
+    );
+  #endif
+#endif
+
 /**@}*/ /* end of General Configuration */
 
 /*
@@ -2951,6 +3068,18 @@ struct _reent *__getreent(void)
 
   const uint32_t _Watchdog_Ticks_per_second = _CONFIGURE_TICKS_PER_SECOND;
 
+  /**
+   * If CONFIGURE_TICKLESS_IDLE is defined, then a clock driver which supports
+   * it suspends the clock tick while all processors are idle until the next
+   * watchdog expires.  Clock drivers without support ignore this option.
+   */
+  const bool _Watchdog_Tickless_idle =
+    #ifdef CONFIGURE_TICKLESS_IDLE
+      true;
+    #else
+      false;
+    #endif
+
   /**
    * This is the Classic API Configuration Table.
    */
@@ -3014,6 +3143,18 @@ struct _reent *__getreent(void)
   uint32_t rtems_minimum_stack_size =
     CONFIGURE_MINIMUM_TASK_STACK_SIZE;
 
+  /**
+   * This configures the allocation method of the RTEMS Workspace.  By
+   * default the first fit method is used.
+   */
+  const Heap_Initialization_or_extend_handler
+    _Workspace_Initialize_handler =
+    #ifdef CONFIGURE_WORKSPACE_SEGREGATED_FIT
+      _Heap_Initialize_segregated_fit;
+    #else
+      _Heap_Initialize;
+    #endif
+
   /**
    * This is the primary Configuration Table for this application.
    */
@@ -3043,6 +3184,17 @@ struct _reent *__getreent(void)
     #else
       false,
     #endif
+    #ifdef CONFIGURE_OBJECTS_NAME_INDEX       /* true for object name index */
+      true,
+    #else
+      false,
+    #endif
+    #ifdef CONFIGURE_OBJECTS_PER_CPU_CACHE    /* true for per-processor caches
+                                                 of inactive objects */
+      true,
+    #else
+      false,
+    #endif
     #ifdef RTEMS_SMP
       #ifdef _CONFIGURE_SMP_APPLICATION
         true,
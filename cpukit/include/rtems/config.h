@@ -213,6 +213,25 @@ typedef struct {
    */
   bool                           stack_allocator_avoids_work_space;
 
+  /**
+   * @brief Specifies if the object name index is enabled or not.
+   *
+   * If this element is @a true, then each object information with local
+   * objects maintains a hash index of the object names, so that the object
+   * identification by name does not need a linear search.
+   */
+  bool                           objects_name_index;
+
+  /**
+   * @brief Specifies if the per-processor caches of inactive objects are
+   * enabled or not.
+   *
+   * If this element is @a true and more than one processor is configured,
+   * then each processor reuses the objects it deleted last before objects
+   * are taken from the inactive chain of the object information.
+   */
+  bool                           objects_inactive_cache;
+
   #ifdef RTEMS_SMP
     bool                         smp_enabled;
   #endif
@@ -268,6 +287,12 @@ extern const rtems_configuration_table Configuration;
 #define rtems_configuration_get_stack_allocator_avoids_work_space() \
         (Configuration.stack_allocator_avoids_work_space)
 
+#define rtems_configuration_get_objects_name_index() \
+        (Configuration.objects_name_index)
+
+#define rtems_configuration_get_objects_inactive_cache() \
+        (Configuration.objects_inactive_cache)
+
 #define rtems_configuration_get_stack_space_size() \
         (Configuration.stack_space_size)
 
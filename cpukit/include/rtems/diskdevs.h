@@ -59,19 +59,20 @@ typedef int (*rtems_block_device_ioctl)(
 #define RTEMS_DISK_READ_AHEAD_NO_TRIGGER ((rtems_blkdev_bnum) -1)
 
 /**
- * @brief Block device read-ahead control.
+ * @brief Count of sequential read streams tracked per disk device.
  */
-typedef struct {
-  /**
-   * @brief Chain node for the read-ahead request queue of the read-ahead task.
-   */
-  rtems_chain_node node;
+#define RTEMS_DISK_READ_AHEAD_STREAM_COUNT 4
 
+/**
+ * @brief Read-ahead state of a sequential read stream.
+ */
+typedef struct {
   /**
    * @brief Block value to trigger the read-ahead request.
    *
    * A value of @ref RTEMS_DISK_READ_AHEAD_NO_TRIGGER will disable further
-   * read-ahead requests since no valid block can have this value.
+   * read-ahead requests since no valid block can have this value.  Streams
+   * with this trigger value are unused.
    */
   rtems_blkdev_bnum trigger;
 
@@ -82,6 +83,50 @@ typedef struct {
    * be arbitrary.
    */
   rtems_blkdev_bnum next;
+
+  /**
+   * @brief Block count of the next read-ahead request.
+   *
+   * The window doubles each time the stream reaches its trigger up to the
+   * configured maximum read-ahead blocks.  It halves in case a block of the
+   * last read-ahead request was recycled before it was read.
+   */
+  uint32_t window;
+
+  /**
+   * @brief Value of the read-ahead use counter at the last use of this stream.
+   *
+   * A new stream replaces the least recently used stream.
+   */
+  uint32_t last_use;
+
+  /**
+   * @brief Indicates if the stream reached its trigger and waits for the
+   * read-ahead task.
+   */
+  bool pending;
+} rtems_blkdev_read_ahead_stream;
+
+/**
+ * @brief Block device read-ahead control.
+ */
+typedef struct {
+  /**
+   * @brief Chain node for the read-ahead request queue of the read-ahead task.
+   *
+   * The node is on the queue if at least one stream is pending.
+   */
+  rtems_chain_node node;
+
+  /**
+   * @brief Use counter to determine the least recently used stream.
+   */
+  uint32_t use_counter;
+
+  /**
+   * @brief The sequential read streams of this disk.
+   */
+  rtems_blkdev_read_ahead_stream streams[RTEMS_DISK_READ_AHEAD_STREAM_COUNT];
 } rtems_blkdev_read_ahead;
 
 /**
@@ -144,6 +189,28 @@ typedef struct {
    * Error count of transfers issued by write requests.
    */
   uint32_t write_errors;
+
+  /**
+   * @brief Read ghost hit count.
+   *
+   * A read ghost hit is a read miss of a block which was recycled from the
+   * recently used list of the 2Q replacement policy shortly before.  The block
+   * is placed on the frequently used list afterwards.  This count is zero for
+   * the LRU replacement policy.
+   */
+  uint32_t read_ghost_hits;
+
+  /**
+   * @brief Discard request count.
+   *
+   * Each discard request may discard multiple blocks.
+   */
+  uint32_t discard_requests;
+
+  /**
+   * @brief Count of blocks discarded by the device.
+   */
+  uint32_t discard_blocks;
 } rtems_blkdev_stats;
 
 /**
@@ -171,6 +238,14 @@ struct rtems_disk_device {
    */
   uint32_t capabilities;
 
+  /**
+   * @brief Maximum count of requests the driver accepts at a time.
+   *
+   * It is one unless the driver has the
+   * @ref RTEMS_BLKDEV_CAP_QUEUED_REQUESTS capability.
+   */
+  uint32_t queue_depth;
+
   /**
    * @brief Disk device name.
    */
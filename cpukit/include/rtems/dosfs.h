@@ -287,8 +287,31 @@ typedef struct {
    * rtems_dosfs_create_utf8_converter().
    */
   rtems_dosfs_convert_control *converter;
+
+  /**
+   * @brief Reservation size in bytes for growing files.
+   *
+   * In case this size is not zero, then a file which needs new clusters for
+   * a write gets at least this amount of space in addition from the volume.
+   * The additional clusters are reserved for the next writes to this file.
+   * This keeps files which are written in turn by small writes in long runs
+   * of consecutive clusters.  The reservation is kept in memory only, the
+   * clusters are allocated in the file allocation table when they are
+   * written.  Other files use the reserved clusters only if there are no
+   * other free clusters left.  The reservation of a file is returned to the
+   * free clusters by the last close() of the file.  The size is rounded up
+   * to the cluster size.  A size greater than
+   * RTEMS_DOSFS_RESERVATION_SIZE_MAX is rejected by mount() with EINVAL, so
+   * clear the mount options before use.
+   */
+  uint32_t reservation_size;
 } rtems_dosfs_mount_options;
 
+/**
+ * @brief Maximum reservation size of the FAT file system mount options.
+ */
+#define RTEMS_DOSFS_RESERVATION_SIZE_MAX (16U * 1024U * 1024U)
+
 /**
  * @brief Allocates and initializes a default converter.
  *
@@ -188,6 +188,28 @@ IMFS_jnode_t *IMFS_node_remove_default(
 
 IMFS_jnode_t *IMFS_node_remove_directory( IMFS_jnode_t *node );
 
+/**
+ * @brief Sets up a directory which maintains a hash index of its entries.
+ *
+ * @param[in] node The IMFS node.
+ * @param[in] arg Unused.
+ *
+ * @retval node Returns always the node passed as parameter.
+ *
+ * @see IMFS_mknod_control_dir_hashed.
+ */
+IMFS_jnode_t *IMFS_node_initialize_hashed_directory(
+  IMFS_jnode_t *node,
+  void *arg
+);
+
+/**
+ * @brief Frees the hash index of a hashed directory and the node.
+ *
+ * @param[in] node The IMFS node.
+ */
+void IMFS_node_destroy_hashed_directory( IMFS_jnode_t *node );
+
 /**
  * @brief Destroys an IMFS node.
  *
@@ -260,12 +282,60 @@ struct IMFS_jnode_tt {
 
 #define IMFS_NODE_FLAG_NAME_ALLOCATED 0x1
 
+#define IMFS_NODE_FLAG_HASHED_DIRECTORY 0x2
+
 typedef struct {
   IMFS_jnode_t                          Node;
   rtems_chain_control                   Entries;
   rtems_filesystem_mount_table_entry_t *mt_fs;
+
+  /*
+   *  Open addressing hash index of the entries.  It is only present in hashed
+   *  directories with enough entries, otherwise it is NULL.
+   */
+  IMFS_jnode_t                        **hash_table;
+  size_t                                hash_mask;    /* table size minus one */
+  size_t                                entry_count;  /* hashed directories */
 } IMFS_directory_t;
 
+/**
+ * @brief Adds an entry to the hash index of a hashed directory.
+ *
+ * The entry must be already on the entries chain.  The index is created once
+ * the directory has enough entries.  In case no memory is available the
+ * index is dropped and the lookups fall back to a linear search.
+ *
+ * @param[in] dir The hashed directory.
+ * @param[in] node The new entry.
+ */
+void IMFS_directory_hash_add( IMFS_directory_t *dir, IMFS_jnode_t *node );
+
+/**
+ * @brief Removes an entry from the hash index of a hashed directory.
+ *
+ * The entry must be already extracted from the entries chain.
+ *
+ * @param[in] dir The hashed directory.
+ * @param[in] node The removed entry.
+ */
+void IMFS_directory_hash_remove( IMFS_directory_t *dir, IMFS_jnode_t *node );
+
+/**
+ * @brief Looks up an entry in the hash index of a directory.
+ *
+ * @param[in] dir The directory.  It must have a hash index.
+ * @param[in] name The entry name.
+ * @param[in] namelen The entry name length.
+ *
+ * @retval NULL No such entry.
+ * @retval entry The entry with this name.
+ */
+IMFS_jnode_t *IMFS_directory_hash_search(
+  const IMFS_directory_t *dir,
+  const char *name,
+  size_t namelen
+);
+
 typedef struct {
   IMFS_jnode_t              Node;
   rtems_device_major_number major;
@@ -299,6 +369,29 @@ typedef struct {
   block_p         direct;           /* pointer to file image */
 } IMFS_linearfile_t;
 
+/**
+ * @brief A contiguous run of file data of an extent file.
+ *
+ * The extents of a file are ordered by offset and cover the file data without
+ * gaps starting at offset zero.
+ */
+typedef struct {
+  size_t   offset;                  /* file offset of the first byte */
+  size_t   size;                    /* bytes in this extent */
+  uint8_t *data;
+} IMFS_extent_t;
+
+/**
+ * @brief An in-memory file stored in extents which grow geometrically.
+ */
+typedef struct {
+  IMFS_filebase_t  File;
+  IMFS_extent_t   *extents;         /* array of extents ordered by offset */
+  size_t           extent_count;
+  size_t           extent_capacity; /* allocated elements of extents */
+  size_t           current;         /* index of the last accessed extent */
+} IMFS_extfile_t;
+
 /* Support copy on write for linear files */
 typedef union {
   IMFS_jnode_t      Node;
@@ -339,6 +432,11 @@ static inline IMFS_memfile_t *IMFS_iop_to_memfile( const rtems_libio_t *iop )
   return (IMFS_memfile_t *) iop->pathinfo.node_access;
 }
 
+static inline IMFS_extfile_t *IMFS_iop_to_extfile( const rtems_libio_t *iop )
+{
+  return (IMFS_extfile_t *) iop->pathinfo.node_access;
+}
+
 static inline time_t _IMFS_get_time( void )
 {
   struct bintime now;
@@ -398,8 +496,10 @@ typedef struct {
 
 extern const IMFS_mknod_control IMFS_mknod_control_dir_default;
 extern const IMFS_mknod_control IMFS_mknod_control_dir_minimal;
+extern const IMFS_mknod_control IMFS_mknod_control_dir_hashed;
 extern const IMFS_mknod_control IMFS_mknod_control_device;
 extern const IMFS_mknod_control IMFS_mknod_control_memfile;
+extern const IMFS_mknod_control IMFS_mknod_control_extfile;
 extern const IMFS_node_control IMFS_node_control_linfile;
 extern const IMFS_mknod_control IMFS_mknod_control_fifo;
 extern const IMFS_mknod_control IMFS_mknod_control_enosys;
@@ -410,6 +510,14 @@ extern const rtems_filesystem_limits_and_options_t  IMFS_LIMITS_AND_OPTIONS;
  *  Routines
  */
 
+/**
+ * @brief Initialize an IMFS mount.
+ *
+ * The mount data may be NULL or point to an IMFS_mknod_controls structure
+ * which selects the node types of the new instance, e.g.
+ * IMFS_mknod_control_extfile for files.  The structure must exist for the
+ * life time of the mount.
+ */
 extern int IMFS_initialize(
    rtems_filesystem_mount_table_entry_t *mt_entry,
    const void                           *data
@@ -875,13 +983,23 @@ static inline void IMFS_add_to_directory(
 
   entry_node->Parent = dir_node;
   rtems_chain_append_unprotected( &dir->Entries, &entry_node->Node );
+
+  if ( ( dir_node->flags & IMFS_NODE_FLAG_HASHED_DIRECTORY ) != 0 ) {
+    IMFS_directory_hash_add( dir, entry_node );
+  }
 }
 
 static inline void IMFS_remove_from_directory( IMFS_jnode_t *node )
 {
-  IMFS_assert( node->Parent != NULL );
+  IMFS_jnode_t *dir_node = node->Parent;
+
+  IMFS_assert( dir_node != NULL );
   node->Parent = NULL;
   rtems_chain_extract_unprotected( &node->Node );
+
+  if ( ( dir_node->flags & IMFS_NODE_FLAG_HASHED_DIRECTORY ) != 0 ) {
+    IMFS_directory_hash_remove( (IMFS_directory_t *) dir_node, node );
+  }
 }
 
 static inline bool IMFS_is_directory( const IMFS_jnode_t *node )
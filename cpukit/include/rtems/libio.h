@@ -999,6 +999,26 @@ typedef int (*rtems_filesystem_mmap_t)(
   off_t off
 );
 
+/**
+ * @brief Allocates the storage of a file region.
+ *
+ * The file size is increased to @a offset plus @a len if it is smaller.
+ *
+ * @param[in, out] iop The IO pointer.
+ * @param[in] offset The start of the region.
+ * @param[in] len The length of the region.
+ *
+ * @retval 0 Successful operation.
+ * @retval -1 An error occurred.  The errno is set to indicate the error.
+ *
+ * @see rtems_filesystem_default_fallocate().
+ */
+typedef int (*rtems_filesystem_fallocate_t)(
+  rtems_libio_t *iop,
+  off_t offset,
+  off_t len
+);
+
 /**
  * @brief File system node operations table.
  */
@@ -1019,6 +1039,7 @@ struct _rtems_filesystem_file_handlers_r {
   rtems_filesystem_readv_t readv_h;
   rtems_filesystem_writev_t writev_h;
   rtems_filesystem_mmap_t mmap_h;
+  rtems_filesystem_fallocate_t fallocate_h;
 };
 
 /**
@@ -1255,6 +1276,19 @@ int rtems_filesystem_default_mmap(
   off_t off
 );
 
+/**
+ * @brief Default fallocate handler.
+ *
+ * @retval -1 Always.  The errno is set to EINVAL.
+ *
+ * @see rtems_filesystem_fallocate_t.
+ */
+int rtems_filesystem_default_fallocate(
+  rtems_libio_t *iop,
+  off_t offset,
+  off_t len
+);
+
 /** @} */
 
 /**
@@ -529,6 +529,138 @@ void rtems_filesystem_eval_path_generic(
   const rtems_filesystem_eval_path_generic_config *config
 );
 
+/**
+ * @brief Maximum name length of a name cache entry.
+ *
+ * Longer names are not cached.
+ */
+#define RTEMS_FILESYSTEM_NAME_CACHE_NAME_MAX 32
+
+/**
+ * @brief File system specific value of a name cache entry.
+ *
+ * It contains the information necessary to locate the node of the name
+ * without a directory search, e.g. the inode number.
+ */
+typedef struct {
+  uint32_t data[ 4 ];
+} rtems_filesystem_name_cache_value;
+
+typedef enum {
+  RTEMS_FILESYSTEM_NAME_CACHE_MISS,
+  RTEMS_FILESYSTEM_NAME_CACHE_HIT,
+  RTEMS_FILESYSTEM_NAME_CACHE_NEGATIVE_HIT
+} rtems_filesystem_name_cache_status;
+
+typedef struct {
+  uint32_t hits;
+  uint32_t negative_hits;
+  uint32_t misses;
+} rtems_filesystem_name_cache_stats;
+
+/**
+ * @brief Number of name cache entries.
+ *
+ * Defined by the application configuration, see
+ * CONFIGURE_FILESYSTEM_NAME_CACHE_ENTRIES.  A value of zero disables the
+ * name cache.
+ */
+extern const uint32_t rtems_filesystem_name_cache_entry_count;
+
+/**
+ * @brief Looks up a name in the global name cache.
+ *
+ * The name cache maps the names of a directory to file system specific
+ * values.  It is shared by all file systems which opt in.  A file system
+ * opts in with calls to this function before it searches a directory and to
+ * rtems_filesystem_name_cache_enter() after the search.  It must invalidate
+ * the entries of a directory with rtems_filesystem_name_cache_remove() or
+ * rtems_filesystem_name_cache_purge_directory() before it changes the
+ * directory.  The caller must own the file system instance lock.  The entries
+ * of a file system instance are purged during unmount.  The "." and ".."
+ * names are never cached.
+ *
+ * @param[in] fs_info The file system instance.
+ * @param[in] dir The file system specific key of the directory.
+ * @param[in] name The name.
+ * @param[in] namelen The name length.
+ * @param[out] value The cached value in case of a hit.
+ *
+ * @retval RTEMS_FILESYSTEM_NAME_CACHE_HIT The name exists in the directory.
+ * @retval RTEMS_FILESYSTEM_NAME_CACHE_NEGATIVE_HIT The name does not exist in
+ *   the directory.
+ * @retval RTEMS_FILESYSTEM_NAME_CACHE_MISS The name is not cached.
+ */
+rtems_filesystem_name_cache_status rtems_filesystem_name_cache_lookup(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  rtems_filesystem_name_cache_value *value
+);
+
+/**
+ * @brief Enters the result of a directory search into the name cache.
+ *
+ * The least recently used entry is replaced if necessary.
+ *
+ * @param[in] fs_info The file system instance.
+ * @param[in] dir The file system specific key of the directory.
+ * @param[in] name The name.
+ * @param[in] namelen The name length.
+ * @param[in] value The value of an existing name, or NULL to enter a negative
+ *   entry for a name which does not exist.
+ */
+void rtems_filesystem_name_cache_enter(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  const rtems_filesystem_name_cache_value *value
+);
+
+/**
+ * @brief Removes a name from the name cache.
+ *
+ * @param[in] fs_info The file system instance.
+ * @param[in] dir The file system specific key of the directory.
+ * @param[in] name The name.
+ * @param[in] namelen The name length.
+ */
+void rtems_filesystem_name_cache_remove(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+);
+
+/**
+ * @brief Removes all names of a directory from the name cache.
+ *
+ * @param[in] fs_info The file system instance.
+ * @param[in] dir The file system specific key of the directory.
+ */
+void rtems_filesystem_name_cache_purge_directory(
+  const void *fs_info,
+  uintptr_t dir
+);
+
+/**
+ * @brief Removes all names of a file system instance from the name cache.
+ *
+ * @param[in] fs_info The file system instance.
+ */
+void rtems_filesystem_name_cache_purge( const void *fs_info );
+
+/**
+ * @brief Returns the name cache statistics and resets them.
+ *
+ * @param[out] stats The name cache statistics.
+ */
+void rtems_filesystem_name_cache_get_and_reset_stats(
+  rtems_filesystem_name_cache_stats *stats
+);
+
 void rtems_filesystem_initialize(void);
 
 /**
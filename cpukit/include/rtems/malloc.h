@@ -42,6 +42,16 @@ extern "C" {
  */
 extern Heap_Control *RTEMS_Malloc_Heap;
 
+/**
+ *  @brief C program heap initialization handler.
+ *
+ *  This is either _Heap_Initialize() or _Heap_Initialize_segregated_fit() and
+ *  is defined by the application configuration.  It is not used in case of
+ *  a unified work area.
+ */
+extern const Heap_Initialization_or_extend_handler
+  RTEMS_Malloc_Initialize_handler;
+
 void RTEMS_Malloc_Initialize(
   const Heap_Area *areas,
   size_t area_count,
@@ -93,6 +103,129 @@ void rtems_malloc_dirty_memory(
   size_t  size
 );
 
+/**
+ *  @brief Count of size classes of the per-processor malloc() cache.
+ *
+ *  The object size of class @a i is RTEMS_MALLOC_CACHE_MINIMUM_SIZE << @a i,
+ *  so the classes cover 16, 32, 64, 128, 256 and 512 bytes.
+ */
+#define RTEMS_MALLOC_CACHE_CLASS_COUNT 6
+
+/**
+ *  @brief Object size of the smallest size class of the per-processor
+ *  malloc() cache.
+ */
+#define RTEMS_MALLOC_CACHE_MINIMUM_SIZE 16
+
+/**
+ *  @brief Object size of the largest size class of the per-processor malloc()
+ *  cache.
+ */
+#define RTEMS_MALLOC_CACHE_MAXIMUM_SIZE \
+  ( RTEMS_MALLOC_CACHE_MINIMUM_SIZE << ( RTEMS_MALLOC_CACHE_CLASS_COUNT - 1 ) )
+
+/**
+ *  @brief Statistics of one size class of the per-processor malloc() cache
+ *  summed up over all processors.
+ */
+typedef struct {
+  /**
+   *  @brief Object size of this class in bytes.
+   */
+  size_t size;
+
+  /**
+   *  @brief Count of objects currently held by the caches.
+   */
+  uint32_t cached;
+
+  /**
+   *  @brief Count of allocations satisfied by a cache.
+   */
+  uint32_t hits;
+
+  /**
+   *  @brief Count of allocations which found an empty cache.
+   */
+  uint32_t misses;
+
+  /**
+   *  @brief Count of batch allocations from the heap to fill a cache.
+   */
+  uint32_t refills;
+
+  /**
+   *  @brief Count of batch frees to the heap to drain a full cache.
+   */
+  uint32_t drains;
+} rtems_malloc_cache_class_information;
+
+/**
+ *  @brief Statistics of the per-processor malloc() cache.
+ */
+typedef struct {
+  rtems_malloc_cache_class_information classes[
+    RTEMS_MALLOC_CACHE_CLASS_COUNT
+  ];
+} rtems_malloc_cache_information;
+
+/**
+ *  @brief Handlers of the per-processor malloc() cache.
+ */
+typedef struct {
+  /**
+   *  @brief Allocates an object of at least the specified size from the cache
+   *  of the current processor.
+   *
+   *  Returns NULL if the size is not cached, the system state does not permit
+   *  the use of the cache or the heap is exhausted.
+   */
+  void *( *allocate )( size_t size );
+
+  /**
+   *  @brief Returns the object to the cache of the current processor.
+   *
+   *  Returns false if the object is not cached.
+   */
+  bool ( *free )( void *ptr );
+
+  /**
+   *  @brief Gets the cache statistics.
+   */
+  void ( *get_information )( rtems_malloc_cache_information *info );
+} rtems_malloc_cache_handlers;
+
+/**
+ *  @brief Handlers of the per-processor malloc() cache.
+ *
+ *  This is either NULL or &rtems_malloc_per_cpu_cache and is defined by the
+ *  application configuration.
+ */
+extern const rtems_malloc_cache_handlers *const rtems_malloc_cache;
+
+/**
+ *  @brief Per-processor magazine cache for small objects.
+ *
+ *  Each processor has one magazine per size class.  The magazines are filled
+ *  from and drained to the C program heap in batches while the allocator
+ *  mutex is owned.  Allocations and frees which can be satisfied by the
+ *  magazine of the current processor need only to disable interrupts
+ *  locally.  Objects held by a magazine are used blocks from the heap point
+ *  of view.
+ */
+extern const rtems_malloc_cache_handlers rtems_malloc_per_cpu_cache;
+
+/**
+ *  @brief Gets the statistics of the per-processor malloc() cache.
+ *
+ *  @param[out] info The cache statistics.  All counters are zero if the
+ *  cache is not configured.
+ *
+ *  @retval 0 Successful operation.
+ *  @retval -1 The information pointer is NULL.
+ */
+int malloc_cache_info( rtems_malloc_cache_information *info );
+
 /**
  *  @brief RTEMS Variation on Aligned Memory Allocation
  *
@@ -45,6 +45,9 @@ typedef rtems_blkdev_bnum  rtems_rfs_buffer_block;
 typedef rtems_bdbuf_buffer rtems_rfs_buffer;
 #define rtems_rfs_buffer_io_request rtems_rfs_buffer_bdbuf_request
 #define rtems_rfs_buffer_io_release rtems_rfs_buffer_bdbuf_release
+#define rtems_rfs_buffer_io_direct rtems_rfs_buffer_bdbuf_direct
+#define rtems_rfs_buffer_io_can_direct rtems_bdbuf_can_transfer_direct
+#define rtems_rfs_buffer_io_discard rtems_rfs_buffer_bdbuf_discard
 
 /**
  * Request a buffer from the RTEMS libblock BD buffer cache.
@@ -58,6 +61,21 @@ int rtems_rfs_buffer_bdbuf_request (rtems_rfs_file_system* fs,
  */
 int rtems_rfs_buffer_bdbuf_release (rtems_rfs_buffer* handle,
                                     bool              modified);
+/**
+ * Transfer blocks between the media and a buffer bypassing the RTEMS libblock
+ * BD buffer cache.
+ */
+int rtems_rfs_buffer_bdbuf_direct (rtems_rfs_file_system* fs,
+                                   rtems_rfs_buffer_block block,
+                                   size_t                 count,
+                                   void*                  data,
+                                   bool                   read);
+/**
+ * Discard freed blocks in the RTEMS libblock BD buffer cache and the media.
+ */
+int rtems_rfs_buffer_bdbuf_discard (rtems_rfs_file_system* fs,
+                                    rtems_rfs_buffer_block block,
+                                    size_t                 count);
 #else /* Device I/O */
 typedef uint32_t rtems_rfs_buffer_block;
 typedef struct _rtems_rfs_buffer
@@ -70,6 +88,9 @@ typedef struct _rtems_rfs_buffer
 } rtems_rfs_buffer;
 #define rtems_rfs_buffer_io_request rtems_rfs_buffer_deviceio_request
 #define rtems_rfs_buffer_io_release rtems_rfs_buffer_deviceio_release
+#define rtems_rfs_buffer_io_direct(_fs, _b, _c, _d, _r) (ENOTSUP)
+#define rtems_rfs_buffer_io_can_direct(_d, _c) (false)
+#define rtems_rfs_buffer_io_discard(_fs, _b, _c) (0)
 
 /**
  * Request a buffer from the device I/O.
@@ -189,6 +210,48 @@ int rtems_rfs_buffer_handle_request (rtems_rfs_file_system*   fs,
 int rtems_rfs_buffer_handle_release (rtems_rfs_file_system*   fs,
                                      rtems_rfs_buffer_handle* handle);
 
+/**
+ * Transfer whole blocks between the media and the data of the caller bypassing
+ * the buffers. Buffers of the blocks held in the local cache of released
+ * buffers are released first. The transfer is not possible if a block is
+ * attached to a handle.
+ *
+ * @param[in] fs is the file system data.
+ * @param[in] block is the first block number.
+ * @param[in] count is the number of blocks.
+ * @param[in] data is the data of the caller.
+ * @param[in] read Read the data from the disk.
+ *
+ * @retval 0 Successful operation.
+ * @retval EBUSY A block is attached to a handle.
+ * @retval error_code An error occurred.
+ */
+int rtems_rfs_buffer_direct (rtems_rfs_file_system* fs,
+                             rtems_rfs_buffer_block block,
+                             size_t                 count,
+                             void*                  data,
+                             bool                   read);
+
+/**
+ * Add a freed block to the blocks waiting to be discarded. A block which
+ * extends the range of waiting blocks is only recorded, any other block
+ * discards the waiting blocks first.
+ *
+ * @param[in] fs is the file system data.
+ * @param[in] block is the freed block number.
+ */
+void rtems_rfs_buffer_discard (rtems_rfs_file_system* fs,
+                               rtems_rfs_buffer_block block);
+
+/**
+ * Discard the blocks waiting to be discarded. Buffers of the blocks held in
+ * the local cache of released buffers are released first. Blocks attached to
+ * a handle are skipped since a discard is only a hint to the media.
+ *
+ * @param[in] fs is the file system data.
+ */
+void rtems_rfs_buffer_discard_flush (rtems_rfs_file_system* fs);
+
 /**
  * Open a handle.
  *
@@ -28,6 +28,7 @@
  */
 #define RTEMS_RFS_SB_OFFSET_MAGIC           (0)
 #define RTEMS_RFS_SB_MAGIC                  (0x28092001)
+#define RTEMS_RFS_SB_MAGIC_FEATURES         (0x28092002)
 #define RTEMS_RFS_SB_OFFSET_VERSION         (RTEMS_RFS_SB_OFFSET_MAGIC           + 4)
 #define RTEMS_RFS_SB_OFFSET_BLOCK_SIZE      (RTEMS_RFS_SB_OFFSET_VERSION         + 4)
 #define RTEMS_RFS_SB_OFFSET_BLOCKS          (RTEMS_RFS_SB_OFFSET_BLOCK_SIZE      + 4)
@@ -45,9 +46,23 @@
 
 /**
  * RFS Version Number Mask. The mask determines which bits of the version
- * number indicate compatility issues.
+ * number indicate compatility issues. A file system with any of these bits set
+ * other than the feature bits known by this implementation is not mounted.
  */
-#define RTEMS_RFS_VERSION_MASK INT32_C(0x00000000)
+#define RTEMS_RFS_VERSION_MASK INT32_C(0xffffffff)
+
+/**
+ * RFS Version Number bit set if directories are created with a hash index.
+ * File systems without the index support would overwrite the index blocks, so
+ * the superblock of such a file system has the RTEMS_RFS_SB_MAGIC_FEATURES
+ * magic which they do not mount.
+ */
+#define RTEMS_RFS_VERSION_DIR_INDEX (0x00000001)
+
+/**
+ * RFS Version Number feature bits known by this implementation.
+ */
+#define RTEMS_RFS_VERSION_FEATURES (RTEMS_RFS_VERSION_DIR_INDEX)
 
 /**
  * The root inode number. Do not use 0 as this has special meaning in some
@@ -109,6 +124,9 @@ typedef int64_t rtems_rfs_pos_rel;
 #define RTEMS_RFS_FS_READ_ONLY         (1 << 3) /**< Make the mount
                                                  * read-only. Currently not
                                                  * supported. */
+#define RTEMS_RFS_FS_DIR_INDEX         (1 << 4) /**< Create directories with a
+                                                 * hash index. Set from the
+                                                 * superblock. */
 /**
  * RFS File System data.
  */
@@ -247,6 +265,34 @@ struct _rtems_rfs_file_system
    */
   uint32_t release_modified_count;
 
+  /**
+   * First block of the range of freed blocks waiting to be discarded.
+   */
+  rtems_rfs_buffer_block discard_block;
+
+  /**
+   * Number of freed blocks waiting to be discarded. Freed blocks are collected
+   * while they form a single range to discard them with one request.
+   */
+  size_t discard_count;
+
+  /**
+   * The lock of the buffer lists, the discard range and the requests of
+   * blocks in progress. It is not held while waiting for the I/O layer.
+   */
+  rtems_rfs_mutex buffer_lock;
+
+  /**
+   * List of blocks requested from the I/O layer and not yet returned. Another
+   * request of such a block waits for the first one to finish.
+   */
+  rtems_chain_control buffer_requests;
+
+  /**
+   * Signalled when a request of a block from the I/O layer finishes.
+   */
+  rtems_rfs_condition buffer_requests_done;
+
   /**
    * List of open shared file node data. The shared node data such as the inode
    * and block map allows a single file to be open more than once.
@@ -279,6 +325,13 @@ struct _rtems_rfs_file_system
  */
 #define rtems_rfs_fs_no_local_cache(_f) ((_f)->flags & RTEMS_RFS_FS_NO_LOCAL_CACHE)
 
+/**
+ * Are new directories created with a hash index ?
+ *
+ * @param[in] _fs is a pointer to the file system.
+ */
+#define rtems_rfs_fs_dir_index(_f) ((_f)->flags & RTEMS_RFS_FS_DIR_INDEX)
+
 /**
  * The disk device number.
  *
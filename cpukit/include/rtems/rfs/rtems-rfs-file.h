@@ -27,6 +27,7 @@
 #include <rtems/rfs/rtems-rfs-data.h>
 #include <rtems/rfs/rtems-rfs-file-system.h>
 #include <rtems/rfs/rtems-rfs-inode.h>
+#include <rtems/rfs/rtems-rfs-mutex.h>
 
 /**
  * File data that is shared by various file handles accessing the same file. We
@@ -84,8 +85,37 @@ typedef struct _rtems_rfs_file_shared
    */
   rtems_rfs_file_system* fs;
 
+  /**
+   * The lock of the file. It serialises the I/O of all handles of the file
+   * while the I/O of other files runs in parallel. The lock is obtained after
+   * the file system lock if both are needed.
+   */
+  rtems_rfs_mutex lock;
+
 } rtems_rfs_file_shared;
 
+/**
+ * Lock the shared file data.
+ *
+ * @param[in] shared is a pointer to the shared file data.
+ */
+static inline void
+rtems_rfs_file_shared_lock (rtems_rfs_file_shared* shared)
+{
+  rtems_rfs_mutex_lock (&shared->lock);
+}
+
+/**
+ * Unlock the shared file data.
+ *
+ * @param[in] shared is a pointer to the shared file data.
+ */
+static inline void
+rtems_rfs_file_shared_unlock (rtems_rfs_file_shared* shared)
+{
+  rtems_rfs_mutex_unlock (&shared->lock);
+}
+
 /**
  * Get the atime.
  *
@@ -360,6 +390,28 @@ int rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
                            size_t                 size,
                            bool                   read);
 
+/**
+ * Perform the I/O of whole blocks directly between the media and the data of
+ * the caller bypassing the buffers. This is only done at a block aligned file
+ * position if the libblock configuration enables direct transfers for the
+ * amount of data and the run of consecutive blocks on the media. A write grows
+ * the file as needed. A size of zero is returned if no direct I/O happened and
+ * the I/O has to use rtems_rfs_file_io_start and rtems_rfs_file_io_end. The
+ * file's position is updated by the size.
+ *
+ * @param[in] handle is the file handle.
+ * @param[in] data is the data of the caller.
+ * @param[in,out] size is the amount of data requested and transferred.
+ * @param[in] read is the I/O operation is a read.
+ *
+ * @retval 0 Successful operation.
+ * @retval error_code An error occurred.
+ */
+int rtems_rfs_file_io_direct (rtems_rfs_file_handle* handle,
+                              void*                  data,
+                              size_t*                size,
+                              bool                   read);
+
 /**
  * Release the I/O resources without any changes. If data has changed in the
  * buffer and the buffer was not already released as modified the data will be
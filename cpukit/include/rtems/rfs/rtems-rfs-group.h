@@ -32,6 +32,7 @@
 #include <rtems/rfs/rtems-rfs-trace.h>
 #include <rtems/rfs/rtems-rfs-bitmaps.h>
 #include <rtems/rfs/rtems-rfs-buffer.h>
+#include <rtems/rfs/rtems-rfs-mutex.h>
 
 /**
  * Block allocations for a group on disk.
@@ -80,6 +81,12 @@ typedef struct _rtems_rfs_group
    */
   rtems_rfs_buffer_handle inode_bitmap_buffer;
 
+  /**
+   * The lock of the bitmaps. Groups are locked one at a time so allocations
+   * and frees in different groups can run in parallel.
+   */
+  rtems_rfs_mutex lock;
+
 } rtems_rfs_group;
 
 /**
@@ -72,6 +72,12 @@
 #define RTEMS_RFS_S_SYMLINK \
   RTEMS_RFS_S_IFLNK | RTEMS_RFS_S_IRWXU | RTEMS_RFS_S_IRWXG | RTEMS_RFS_S_IRWXO
 
+/**
+ * Inode flags.
+ */
+#define RTEMS_RFS_INODE_FLAG_DIR_INDEX (1 << 0) /**< The directory has a hash
+                                                 * index. */
+
 /**
  * The inode number or ino.
  */
@@ -115,7 +121,7 @@ typedef struct _rtems_rfs_inode
   uint32_t owner;
 
   /**
-   * Reserved.
+   * The flags of the node. See RTEMS_RFS_INODE_FLAG_DIR_INDEX.
    */
   uint16_t flags;
 
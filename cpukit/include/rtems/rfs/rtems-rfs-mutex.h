@@ -41,6 +41,15 @@ typedef rtems_recursive_mutex rtems_rfs_mutex;
 typedef uint32_t rtems_rfs_mutex; /* place holder */
 #endif
 
+/**
+ * RFS Condition type. A condition is used together with a RFS mutex.
+ */
+#if __rtems__
+typedef rtems_condition_variable rtems_rfs_condition;
+#else
+typedef uint32_t rtems_rfs_condition; /* place holder */
+#endif
+
 /**
  * @brief Create the mutex.
  *
@@ -96,4 +105,63 @@ rtems_rfs_mutex_unlock (rtems_rfs_mutex* mutex)
   return 0;
 }
 
+/**
+ * @brief Create the condition.
+ *
+ * @param[in] condition is pointer to the condition to create.
+ *
+ * @retval 0 Successful operation.
+ * @retval EIO An error occurred.
+ */
+int rtems_rfs_condition_create (rtems_rfs_condition* condition);
+
+/**
+ * @brief Destroy the condition.
+ *
+ * @param[in] condition is a pointer to the condition to destroy.
+ *
+ * @retval 0 Successful operation.
+ * @retval EIO An error occurred.
+ */
+int rtems_rfs_condition_destroy (rtems_rfs_condition* condition);
+
+/**
+ * @brief Wait for the condition.
+ *
+ * The mutex is released while waiting even if it is held more than once and
+ * it is obtained again before the call returns.
+ *
+ * @param[in] condition is a pointer to the condition to wait for.
+ * @param[in] mutex is a pointer to the mutex held by the caller.
+ *
+ * @retval 0 Successful operation.
+ * @retval EIO An error occurred.
+ */
+static inline int
+rtems_rfs_condition_wait (rtems_rfs_condition* condition,
+                          rtems_rfs_mutex*     mutex)
+{
+#if __rtems__
+  _Condition_Wait_recursive(condition, mutex);
+#endif
+  return 0;
+}
+
+/**
+ * @brief Wake up all waiters of the condition.
+ *
+ * @param[in] condition is a pointer to the condition to signal.
+ *
+ * @retval 0 Successful operation.
+ * @retval EIO An error occurred.
+ */
+static inline int
+rtems_rfs_condition_broadcast (rtems_rfs_condition* condition)
+{
+#if __rtems__
+  rtems_condition_variable_broadcast(condition);
+#endif
+  return 0;
+}
+
 #endif
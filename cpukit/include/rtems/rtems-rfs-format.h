@@ -65,6 +65,12 @@ typedef struct _rtems_rfs_format_config
    */
   bool initialise_inodes;
 
+  /**
+   * Create directories with a hash index. Looking up names in large
+   * directories is faster.
+   */
+  bool dir_index;
+
   /**
    * Is the format verbose.
    */
@@ -167,6 +167,23 @@ typedef uint32_t   rtems_attribute;
  */
 #define RTEMS_BARRIER_MANUAL_RELEASE    0x00000000
 
+/******************** RTEMS Region Specific Attributes *********************/
+
+/**
+ *  This attribute constant indicates that the Classic API Region
+ *  instance created will use the first fit allocation method.
+ */
+#define RTEMS_FIRST_FIT                 0x00000000
+
+/**
+ *  This attribute constant indicates that the Classic API Region
+ *  instance created will use a segregated fit index for its free
+ *  blocks.  Allocations and deallocations of segments without an
+ *  alignment constraint have a constant execution time.  The index is
+ *  placed at the begin of the region memory area.
+ */
+#define RTEMS_SEGREGATED_FIT            0x00000200
+
 /**************** RTEMS Internal Task Specific Attributes ****************/
 
 /**
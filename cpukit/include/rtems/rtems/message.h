@@ -227,6 +227,154 @@ rtems_status_code rtems_message_queue_get_number_pending(
   uint32_t *count
 );
 
+/**
+ *  @brief Sends several messages to the message queue.
+ *
+ *  This directive sends COUNT messages of SIZE bytes each to the message
+ *  queue indicated by ID.  The messages are stored consecutively at BUFFER.
+ *  All messages are transferred under one acquisition of the message queue
+ *  lock.  Each task waiting for a message receives one message of the batch
+ *  in order and the rest is appended to the message queue.  The count of
+ *  messages sent is returned in SENT.
+ *
+ *  @retval RTEMS_SUCCESSFUL All messages were sent.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer or sent pointer is NULL.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_INVALID_SIZE The size is greater than the maximum message
+ *    size.
+ *  @retval RTEMS_TOO_MANY The message queue is full.  Only the messages
+ *    indicated by SENT were sent.
+ */
+rtems_status_code rtems_message_queue_send_many(
+  rtems_id    id,
+  const void *buffer,
+  size_t      size,
+  uint32_t    count,
+  uint32_t   *sent
+);
+
+/**
+ *  @brief Receives several messages from the message queue.
+ *
+ *  This directive receives up to COUNT pending messages from the message
+ *  queue indicated by ID under one acquisition of the message queue lock.
+ *  Message I is stored at BUFFER + I * SLOT_SIZE and its size in SIZES[I].
+ *  The count of messages received is returned in RECEIVED.  If no message
+ *  is pending, then the calling task waits for one message according to the
+ *  OPTION_SET and TIMEOUT like rtems_message_queue_receive().
+ *
+ *  @retval RTEMS_SUCCESSFUL Successful operation.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer, sizes or received pointer is
+ *    NULL.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_INVALID_SIZE The slot size is less than the maximum message
+ *    size.
+ *  @retval RTEMS_UNSATISFIED No message is pending and RTEMS_NO_WAIT is set.
+ *  @retval RTEMS_TIMEOUT Timed out waiting for a message.
+ *  @retval RTEMS_OBJECT_WAS_DELETED The message queue was deleted while
+ *    waiting.
+ */
+rtems_status_code rtems_message_queue_receive_many(
+  rtems_id        id,
+  void           *buffer,
+  size_t          slot_size,
+  size_t         *sizes,
+  uint32_t        count,
+  uint32_t       *received,
+  rtems_option    option_set,
+  rtems_interval  timeout
+);
+
+/**
+ *  @brief Loans a message buffer of the message queue.
+ *
+ *  This directive takes a message buffer from the pool of the message queue
+ *  indicated by ID and returns the begin of its content area in BUFFER.  The
+ *  caller may fill in the message in place and send it without a copy by
+ *  rtems_message_queue_submit().  A buffer which is not submitted must be
+ *  given back by rtems_message_queue_return().  The content area has the
+ *  maximum message size of the message queue and is aligned to the pointer
+ *  size.  Loaned buffers are not available for other messages.
+ *
+ *  @retval RTEMS_SUCCESSFUL Successful operation.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer pointer is NULL.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_TOO_MANY No message buffer is available.
+ */
+rtems_status_code rtems_message_queue_loan(
+  rtems_id   id,
+  void     **buffer
+);
+
+/**
+ *  @brief Sends a loaned message buffer to the message queue.
+ *
+ *  This directive appends the message of SIZE bytes contained in the loaned
+ *  BUFFER to the message queue indicated by ID without a copy of the
+ *  message.  If a task is waiting for a message, then the message is copied
+ *  to the task and the buffer goes back to the pool.  On success, the caller
+ *  must no longer use the buffer.
+ *
+ *  @retval RTEMS_SUCCESSFUL Successful operation.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer does not belong to the message
+ *    queue.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_INVALID_SIZE The size is greater than the maximum message
+ *    size.  The buffer remains loaned.
+ *  @retval RTEMS_INCORRECT_STATE The buffer is not loaned.
+ */
+rtems_status_code rtems_message_queue_submit(
+  rtems_id  id,
+  void     *buffer,
+  size_t    size
+);
+
+/**
+ *  @brief Receives a message from the message queue without a copy.
+ *
+ *  This directive works like rtems_message_queue_receive(), however, it
+ *  returns the message buffer itself in BUFFER instead of a copy of the
+ *  message.  The size of the message is returned in SIZE.  The caller must
+ *  give the buffer back by rtems_message_queue_return() or may send it
+ *  again by rtems_message_queue_submit().  A task which waits for a message
+ *  reserves a message buffer for the wait.
+ *
+ *  @retval RTEMS_SUCCESSFUL Successful operation.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer or size pointer is NULL.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_UNSATISFIED No message is pending and RTEMS_NO_WAIT is set.
+ *  @retval RTEMS_TIMEOUT Timed out waiting for a message.
+ *  @retval RTEMS_OBJECT_WAS_DELETED The message queue was deleted while
+ *    waiting.
+ *  @retval RTEMS_TOO_MANY No message is pending and no message buffer is
+ *    available to wait for a message.
+ */
+rtems_status_code rtems_message_queue_receive_loaned(
+  rtems_id         id,
+  void           **buffer,
+  size_t          *size,
+  rtems_option     option_set,
+  rtems_interval   timeout
+);
+
+/**
+ *  @brief Returns a loaned message buffer to the message queue.
+ *
+ *  This directive gives the BUFFER obtained by rtems_message_queue_loan()
+ *  or rtems_message_queue_receive_loaned() back to the message queue
+ *  indicated by ID.
+ *
+ *  @retval RTEMS_SUCCESSFUL Successful operation.
+ *  @retval RTEMS_INVALID_ADDRESS The buffer does not belong to the message
+ *    queue.
+ *  @retval RTEMS_INVALID_ID The message queue does not exist or is remote.
+ *  @retval RTEMS_INCORRECT_STATE The buffer is not loaned.
+ */
+rtems_status_code rtems_message_queue_return(
+  rtems_id  id,
+  void     *buffer
+);
+
 /**@}*/
 
 #ifdef __cplusplus
@@ -46,8 +46,10 @@ extern "C" {
  *  the region is of length bytes and starts at starting_address.
  *  The memory area will be divided into as many allocatable units of
  *  page_size bytes as possible.   The attribute_set determines which
- *  thread queue discipline is used by the region.  It returns the
- *  id of the created region in ID.
+ *  thread queue discipline is used by the region and whether the
+ *  region uses the first fit or the segregated fit allocation method
+ *  (RTEMS_SEGREGATED_FIT).  It returns the id of the created region
+ *  in ID.
  */
 rtems_status_code rtems_region_create(
   rtems_name          name,
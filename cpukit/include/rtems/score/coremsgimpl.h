@@ -65,6 +65,64 @@ extern "C" {
  */
 typedef int CORE_message_queue_Submit_types;
 
+/**
+ *  @brief Thread queue context for batched message transfers.
+ *
+ *  The thread queue flush filters of _CORE_message_queue_Submit_many() and
+ *  _CORE_message_queue_Seize_many() use this overlay structure to move
+ *  several messages under one acquisition of the message queue lock.
+ */
+typedef struct {
+  /**
+   *  @brief The thread queue context used for _CORE_message_queue_Acquire()
+   *  or _CORE_message_queue_Acquire_critical().
+   */
+  Thread_queue_Context Base;
+
+  /**
+   *  @brief The message queue of the batch.
+   */
+  CORE_message_queue_Control *the_message_queue;
+
+  /**
+   *  @brief The begin of the message contents of a submit batch.
+   */
+  const char *source;
+
+  /**
+   *  @brief The size of each message of a submit batch.
+   */
+  size_t size;
+
+  /**
+   *  @brief The count of messages of a submit batch.
+   */
+  uint32_t count;
+
+  /**
+   *  @brief The count of messages already transferred.
+   */
+  uint32_t done;
+
+  /**
+   *  @brief The submit type of all messages of a submit batch.
+   */
+  CORE_message_queue_Submit_types submit_type;
+} CORE_message_queue_Batch_context;
+
+/**
+ *  @brief Initializes a thread queue context for batched message transfers.
+ *
+ *  @param[out] context The batch context to initialize.
+ */
+RTEMS_INLINE_ROUTINE void _CORE_message_queue_Batch_context_initialize(
+  CORE_message_queue_Batch_context *context
+)
+{
+  _Thread_queue_Context_initialize( &context->Base );
+  context->done = 0;
+}
+
 /**
  *  @brief Initialize a message queue.
  *
@@ -249,6 +307,94 @@ Status_Control _CORE_message_queue_Seize(
   Thread_queue_Context       *queue_context
 );
 
+/**
+ *  @brief Send several messages to the message queue.
+ *
+ *  This routine sends @a count messages of @a size bytes each which are
+ *  stored consecutively at @a buffer.  All messages are transferred under
+ *  one acquisition of the message queue lock.  Threads waiting for a message
+ *  receive one message each in order and are unblocked together after the
+ *  lock release, so at most one thread dispatch is necessary for the batch.
+ *  The remaining messages are enqueued as long as message buffers are
+ *  available.
+ *
+ *  If no message could be sent because the message queue is full and the
+ *  calling thread is willing to wait, then the thread blocks until the first
+ *  message of the batch is sent.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] executing the executing thread
+ *  @param[in] buffer is the starting address of the message contents
+ *  @param[in] size is the size in bytes of each message
+ *  @param[in] count is the count of messages
+ *  @param[out] sent is the count of messages sent
+ *  @param[in] submit_type determines whether the messages are prepended,
+ *         appended, or enqueued in priority order.
+ *  @param[in] wait indicates whether the calling thread is willing to block
+ *         if the message queue is full.
+ *  @param[in] context The batch context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL All messages were sent.
+ *  @retval STATUS_MESSAGE_INVALID_SIZE The size is too large.
+ *  @retval STATUS_TOO_MANY Only the count of messages indicated by @a sent
+ *    was sent since the message queue is full.
+ */
+Status_Control _CORE_message_queue_Submit_many(
+  CORE_message_queue_Control       *the_message_queue,
+  Thread_Control                   *executing,
+  const void                       *buffer,
+  size_t                            size,
+  uint32_t                          count,
+  uint32_t                         *sent,
+  CORE_message_queue_Submit_types   submit_type,
+  bool                              wait,
+  CORE_message_queue_Batch_context *context
+);
+
+/**
+ *  @brief Receive several messages from the message queue.
+ *
+ *  This routine dequeues up to @a count pending messages under one
+ *  acquisition of the message queue lock.  Message @a i is copied to
+ *  @a buffer + @a i * @a slot_size.  Its size is stored in @a sizes[ @a i ]
+ *  and its priority in @a priorities[ @a i ], if @a priorities is not NULL.
+ *  Threads waiting to send a message fill the freed message buffers before
+ *  the lock release.
+ *
+ *  If no message is pending and the calling thread is willing to wait, then
+ *  the thread blocks until it receives one message.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] executing the executing thread
+ *  @param[in] buffer is the starting address of the receive slots
+ *  @param[in] slot_size is the size in bytes of each receive slot.  It must
+ *         be at least the maximum message size of the message queue.
+ *  @param[out] sizes is the array for the message sizes
+ *  @param[out] priorities is the array for the message priorities, may be
+ *         NULL
+ *  @param[in] count is the count of receive slots
+ *  @param[out] received is the count of messages received
+ *  @param[in] wait indicates whether the calling thread is willing to block
+ *         if the message queue is empty.
+ *  @param[in] context The batch context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval indication of the successful completion or reason for failure.
+ */
+Status_Control _CORE_message_queue_Seize_many(
+  CORE_message_queue_Control       *the_message_queue,
+  Thread_Control                   *executing,
+  void                             *buffer,
+  size_t                            slot_size,
+  size_t                           *sizes,
+  uint32_t                         *priorities,
+  uint32_t                          count,
+  uint32_t                         *received,
+  bool                              wait,
+  CORE_message_queue_Batch_context *context
+);
+
 /**
  *  @brief Insert a message into the message queue.
  *
@@ -270,6 +416,143 @@ void _CORE_message_queue_Insert_message(
   CORE_message_queue_Submit_types    submit_type
 );
 
+/**
+ *  @brief Enqueue a message into the message queue.
+ *
+ *  Inserts the message with its current content into the message queue
+ *  according to the submit type.  The message size must be already set.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the message to enqueue
+ *  @param[in] submit_type determines whether the message is prepended,
+ *         appended, or enqueued in priority order.
+ */
+void _CORE_message_queue_Enqueue_message(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  CORE_message_queue_Submit_types    submit_type
+);
+
+/**
+ *  @brief Loan a message buffer of the message queue.
+ *
+ *  Takes a buffer from the inactive message pool and hands it over to the
+ *  caller.  The caller may fill in the message content in place and submit
+ *  it with _CORE_message_queue_Submit_loaned() or give the buffer back with
+ *  _CORE_message_queue_Return().  Loaned buffers are not available for
+ *  other messages, so buffer loaning must not be used together with
+ *  blocking send operations.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[out] the_message is the loaned message buffer
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_TOO_MANY No inactive message buffer is available.
+ */
+Status_Control _CORE_message_queue_Loan(
+  CORE_message_queue_Control         *the_message_queue,
+  CORE_message_queue_Buffer_control **the_message,
+  Thread_queue_Context               *queue_context
+);
+
+/**
+ *  @brief Submit a loaned message buffer to the message queue.
+ *
+ *  The message is inserted into the message queue without a copy of its
+ *  content.  If a thread is waiting for a message, then the content is
+ *  copied to the receive buffer of the thread and the loaned buffer returns
+ *  to the inactive message pool.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the loaned message buffer
+ *  @param[in] size is the size of the message content
+ *  @param[in] submit_type determines whether the message is prepended,
+ *         appended, or enqueued in priority order.
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_MESSAGE_INVALID_SIZE The size is too large.  The buffer
+ *    remains loaned.
+ *  @retval STATUS_INCORRECT_STATE The buffer is not loaned.
+ */
+Status_Control _CORE_message_queue_Submit_loaned(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  size_t                             size,
+  CORE_message_queue_Submit_types    submit_type,
+  Thread_queue_Context              *queue_context
+);
+
+/**
+ *  @brief Seize a message buffer from the message queue.
+ *
+ *  Dequeues a message and hands over its buffer to the caller without a copy
+ *  of its content.  The caller must give the buffer back with
+ *  _CORE_message_queue_Return().
+ *
+ *  If no message is pending and the thread is willing to wait, then an
+ *  inactive message buffer is reserved to receive the message of the next
+ *  sender and the thread blocks.  In case the wait is not satisfied, the
+ *  reserved buffer is still handed over to the caller, except if the message
+ *  queue was deleted.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] executing is the executing thread
+ *  @param[out] the_message is the seized or reserved message buffer
+ *  @param[in] wait indicates whether the calling thread is willing to block
+ *         if the message queue is empty.
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_UNSATISFIED No message is pending and the thread is not
+ *    willing to wait.
+ *  @retval STATUS_TOO_MANY No message is pending and no inactive message
+ *    buffer is available to wait for a message.
+ */
+Status_Control _CORE_message_queue_Seize_loaned(
+  CORE_message_queue_Control         *the_message_queue,
+  Thread_Control                     *executing,
+  CORE_message_queue_Buffer_control **the_message,
+  bool                                wait,
+  Thread_queue_Context               *queue_context
+);
+
+/**
+ *  @brief Return a loaned message buffer to the message queue.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] the_message is the loaned message buffer
+ *  @param[in] queue_context The thread queue context used for
+ *    _CORE_message_queue_Acquire() or _CORE_message_queue_Acquire_critical().
+ *
+ *  @retval STATUS_SUCCESSFUL Successful operation.
+ *  @retval STATUS_INCORRECT_STATE The buffer is not loaned.
+ */
+Status_Control _CORE_message_queue_Return(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  Thread_queue_Context              *queue_context
+);
+
+/**
+ *  @brief Get the message buffer of a message content area.
+ *
+ *  @param[in] the_message_queue points to the message queue
+ *  @param[in] content is the begin of the message content area
+ *
+ *  @retval NULL The content area does not belong to a message buffer of the
+ *    message queue.
+ *  @retval buffer The message buffer of the content area.
+ */
+CORE_message_queue_Buffer_control *_CORE_message_queue_Buffer_of_content(
+  const CORE_message_queue_Control *the_message_queue,
+  const void                       *content
+);
+
 RTEMS_INLINE_ROUTINE Status_Control _CORE_message_queue_Send(
   CORE_message_queue_Control       *the_message_queue,
   const void                       *buffer,
@@ -332,6 +615,22 @@ RTEMS_INLINE_ROUTINE void _CORE_message_queue_Release(
   _Thread_queue_Release( &the_message_queue->Wait_queue, queue_context );
 }
 
+/**
+ * This function returns the size of a message buffer including the message
+ * buffer control.  The message buffers of a message queue are an array with
+ * elements of this size.
+ */
+RTEMS_INLINE_ROUTINE size_t _CORE_message_queue_Buffer_size(
+  const CORE_message_queue_Control *the_message_queue
+)
+{
+  size_t align_mask;
+
+  align_mask = sizeof( uintptr_t ) - 1;
+  return ( ( the_message_queue->maximum_message_size + align_mask )
+    & ~align_mask ) + sizeof( CORE_message_queue_Buffer_control );
+}
+
 /**
  * This routine copies the contents of the source message buffer
  * to the destination message buffer.
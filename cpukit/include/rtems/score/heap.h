@@ -126,6 +126,16 @@ extern "C" {
  * block indicates that the previous block is used, this ensures that the
  * last block appears as used for the _Heap_Is_used() and _Heap_Is_free()
  * functions.
+ *
+ * Optionally a heap may use a segregated fit index for its free blocks, see
+ * _Heap_Initialize_segregated_fit().  The free blocks are then kept in the
+ * same free list, however, the list is sorted by size classes.  The size
+ * classes use a two level scheme.  The first level is the most significant
+ * bit of the block size and the second level divides each power of two range
+ * into @ref HEAP_SEGREGATED_SL_COUNT linear sub-ranges.  The index contains
+ * the first free block of each non-empty size class and bitmaps of the
+ * non-empty size classes.  This allows to find a suitable free block and to
+ * insert or remove a free block in constant time.
  */
 /**@{**/
 
@@ -249,11 +259,63 @@ struct Heap_Block {
   Heap_Block *prev;
 };
 
+/**
+ * @brief Logarithm to base two of the count of second level size classes of
+ * the segregated fit index.
+ */
+#define HEAP_SEGREGATED_SL_COUNT_LOG2 3
+
+/**
+ * @brief Count of second level size classes per first level size class of the
+ * segregated fit index.
+ */
+#define HEAP_SEGREGATED_SL_COUNT (1U << HEAP_SEGREGATED_SL_COUNT_LOG2)
+
+/**
+ * @brief Count of first level size classes of the segregated fit index.
+ */
+#define HEAP_SEGREGATED_FL_COUNT (8U * sizeof( uintptr_t ))
+
+/**
+ * @brief Segregated fit index of the free blocks.
+ *
+ * @see _Heap_Initialize_segregated_fit().
+ */
+typedef struct {
+  /**
+   * @brief Bitmap of the first level size classes which contain at least one
+   * free block.
+   */
+  uintptr_t fl_bitmap;
+
+  /**
+   * @brief Bitmaps of the second level size classes which contain at least
+   * one free block for each first level size class.
+   */
+  uintptr_t sl_bitmap[ HEAP_SEGREGATED_FL_COUNT ];
+
+  /**
+   * @brief The first free block of each size class in the free list.
+   *
+   * The entry is NULL for empty size classes.
+   */
+  Heap_Block *first[ HEAP_SEGREGATED_FL_COUNT ][ HEAP_SEGREGATED_SL_COUNT ];
+} Heap_Segregated_index;
+
+/**
+ * @brief Worst case overhead of the segregated fit index in the heap area.
+ *
+ * @see _Heap_Initialize_segregated_fit().
+ */
+#define HEAP_SEGREGATED_INDEX_OVERHEAD \
+  ( sizeof( Heap_Segregated_index ) + CPU_ALIGNMENT - 1 )
+
 /**
  * @brief Control block used to manage a heap.
  */
 struct Heap_Control {
   Heap_Block free_list;
+  Heap_Segregated_index *segregated_index;
   uintptr_t page_size;
   uintptr_t min_block_size;
   uintptr_t area_begin;
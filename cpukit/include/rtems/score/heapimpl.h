@@ -91,6 +91,27 @@ uintptr_t _Heap_Initialize(
   uintptr_t page_size
 );
 
+/**
+ * @brief Initializes the heap control block @a heap to manage the area
+ * starting at @a area_begin of size @a area_size bytes with a segregated fit
+ * index of the free blocks.
+ *
+ * The segregated fit index is placed at the begin of the area.  The remaining
+ * area is initialized like in _Heap_Initialize().  Allocations without an
+ * alignment or boundary constraint and the release of memory areas have a
+ * constant execution time.  The heap may be extended with _Heap_Extend().
+ *
+ * Returns the maximum memory available, or zero in case of failure.
+ *
+ * @see Heap_Initialization_or_extend_handler.
+ */
+uintptr_t _Heap_Initialize_segregated_fit(
+  Heap_Control *heap,
+  void *area_begin,
+  uintptr_t area_size,
+  uintptr_t page_size
+);
+
 /**
  * @brief Allocates a memory area of size @a size bytes from the heap @a heap.
  *
@@ -527,6 +548,313 @@ RTEMS_INLINE_ROUTINE bool _Heap_Is_free(
   return !_Heap_Is_used( block );
 }
 
+RTEMS_INLINE_ROUTINE bool _Heap_Is_segregated_fit( const Heap_Control *heap )
+{
+  return heap->segregated_index != NULL;
+}
+
+/**
+ * @brief Returns the index of the most significant bit set in @a value.
+ *
+ * The @a value must not be zero.
+ */
+RTEMS_INLINE_ROUTINE unsigned int _Heap_Segregated_msb( uintptr_t value )
+{
+  return (unsigned int) ( 8 * sizeof( unsigned long ) - 1 )
+    - (unsigned int) __builtin_clzl( (unsigned long) value );
+}
+
+/**
+ * @brief Returns the index of the least significant bit set in @a value.
+ *
+ * The @a value must not be zero.
+ */
+RTEMS_INLINE_ROUTINE unsigned int _Heap_Segregated_lsb( uintptr_t value )
+{
+  return (unsigned int) __builtin_ctzl( (unsigned long) value );
+}
+
+/**
+ * @brief Maps the block size @a block_size to the first level size class
+ * @a fl and the second level size class @a sl.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Segregated_map(
+  uintptr_t     block_size,
+  unsigned int *fl,
+  unsigned int *sl
+)
+{
+  unsigned int msb = _Heap_Segregated_msb( block_size );
+  uintptr_t    shifted;
+
+  if ( msb >= HEAP_SEGREGATED_SL_COUNT_LOG2 ) {
+    shifted = block_size >> ( msb - HEAP_SEGREGATED_SL_COUNT_LOG2 );
+  } else {
+    shifted = block_size << ( HEAP_SEGREGATED_SL_COUNT_LOG2 - msb );
+  }
+
+  *fl = msb;
+  *sl = (unsigned int) ( shifted & ( HEAP_SEGREGATED_SL_COUNT - 1 ) );
+}
+
+/**
+ * @brief Returns the block size @a block_size rounded up to the begin of the
+ * next size class if it is not already at the begin of a size class.
+ *
+ * All free blocks of the size class of the returned value are at least
+ * @a block_size bytes large.  In case of an integer overflow, the
+ * @a block_size is returned unchanged.
+ */
+RTEMS_INLINE_ROUTINE uintptr_t _Heap_Segregated_round_up(
+  uintptr_t block_size
+)
+{
+  unsigned int msb = _Heap_Segregated_msb( block_size );
+  uintptr_t    rounded;
+
+  if ( msb < HEAP_SEGREGATED_SL_COUNT_LOG2 ) {
+    return block_size;
+  }
+
+  rounded = block_size
+    + ( ( (uintptr_t) 1 << ( msb - HEAP_SEGREGATED_SL_COUNT_LOG2 ) ) - 1 );
+
+  return rounded >= block_size ? rounded : block_size;
+}
+
+/**
+ * @brief Returns the first free block of the first non-empty size class
+ * greater than or equal to the size class @a fl and @a sl.
+ *
+ * The @a sl value may be equal to @ref HEAP_SEGREGATED_SL_COUNT to start the
+ * search at the next first level size class.
+ *
+ * Returns the free list tail, if no such size class exists.
+ */
+RTEMS_INLINE_ROUTINE Heap_Block *_Heap_Segregated_first_of(
+  Heap_Control *heap,
+  unsigned int  fl,
+  unsigned int  sl
+)
+{
+  const Heap_Segregated_index *index = heap->segregated_index;
+  uintptr_t                    map;
+
+  if ( sl < HEAP_SEGREGATED_SL_COUNT ) {
+    map = index->sl_bitmap[ fl ] & ( ~(uintptr_t) 0 << sl );
+  } else {
+    map = 0;
+  }
+
+  if ( map == 0 ) {
+    ++fl;
+
+    if ( fl >= HEAP_SEGREGATED_FL_COUNT ) {
+      return _Heap_Free_list_tail( heap );
+    }
+
+    map = index->fl_bitmap & ( ~(uintptr_t) 0 << fl );
+
+    if ( map == 0 ) {
+      return _Heap_Free_list_tail( heap );
+    }
+
+    fl = _Heap_Segregated_lsb( map );
+    map = index->sl_bitmap[ fl ];
+  }
+
+  sl = _Heap_Segregated_lsb( map );
+
+  return index->first[ fl ][ sl ];
+}
+
+/**
+ * @brief Returns the first free block in the free list which may be large
+ * enough for a block of size @a block_size.
+ *
+ * In case the heap uses no segregated fit index, then this is the first block
+ * of the free list.  Otherwise, this is the first free block of the first
+ * non-empty size class which contains only free blocks of at least
+ * @a block_size bytes.  If no such size class exists, then this is the first
+ * free block of the size class of @a block_size.  All free blocks after the
+ * returned block belong to larger size classes.
+ *
+ * Returns the free list tail, if no free block is large enough.
+ */
+RTEMS_INLINE_ROUTINE Heap_Block *_Heap_Free_list_first_fit(
+  Heap_Control *heap,
+  uintptr_t     block_size
+)
+{
+  Heap_Block   *block;
+  unsigned int  fl;
+  unsigned int  sl;
+
+  if ( !_Heap_Is_segregated_fit( heap ) ) {
+    return _Heap_Free_list_first( heap );
+  }
+
+  _Heap_Segregated_map( _Heap_Segregated_round_up( block_size ), &fl, &sl );
+  block = _Heap_Segregated_first_of( heap, fl, sl );
+
+  if ( block == _Heap_Free_list_tail( heap ) ) {
+    _Heap_Segregated_map( block_size, &fl, &sl );
+    block = _Heap_Segregated_first_of( heap, fl, sl );
+  }
+
+  return block;
+}
+
+/**
+ * @brief Inserts the free block @a block into the segregated fit index and
+ * the free list.
+ *
+ * The block size must be valid.  The block is inserted in front of the free
+ * blocks of its size class, so that the free list stays sorted by size
+ * classes.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Segregated_insert(
+  Heap_Control *heap,
+  Heap_Block   *block
+)
+{
+  Heap_Segregated_index *index = heap->segregated_index;
+  Heap_Block            *next;
+  unsigned int           fl;
+  unsigned int           sl;
+
+  _Heap_Segregated_map( _Heap_Block_size( block ), &fl, &sl );
+  next = index->first[ fl ][ sl ];
+
+  if ( next == NULL ) {
+    next = _Heap_Segregated_first_of( heap, fl, sl + 1 );
+    index->sl_bitmap[ fl ] |= (uintptr_t) 1 << sl;
+    index->fl_bitmap |= (uintptr_t) 1 << fl;
+  }
+
+  _Heap_Free_list_insert_before( next, block );
+  index->first[ fl ][ sl ] = block;
+}
+
+/**
+ * @brief Removes the free block @a block from the segregated fit index and
+ * the free list.
+ *
+ * The block size must be the one used to insert the block.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Segregated_remove(
+  Heap_Control *heap,
+  Heap_Block   *block
+)
+{
+  Heap_Segregated_index *index = heap->segregated_index;
+  unsigned int           fl;
+  unsigned int           sl;
+
+  _Heap_Segregated_map( _Heap_Block_size( block ), &fl, &sl );
+
+  if ( index->first[ fl ][ sl ] == block ) {
+    Heap_Block   *next = block->next;
+    unsigned int  next_fl;
+    unsigned int  next_sl;
+
+    if ( next != _Heap_Free_list_tail( heap ) ) {
+      _Heap_Segregated_map( _Heap_Block_size( next ), &next_fl, &next_sl );
+    } else {
+      next_fl = HEAP_SEGREGATED_FL_COUNT;
+      next_sl = 0;
+    }
+
+    if ( next_fl == fl && next_sl == sl ) {
+      index->first[ fl ][ sl ] = next;
+    } else {
+      index->first[ fl ][ sl ] = NULL;
+      index->sl_bitmap[ fl ] &= ~( (uintptr_t) 1 << sl );
+
+      if ( index->sl_bitmap[ fl ] == 0 ) {
+        index->fl_bitmap &= ~( (uintptr_t) 1 << fl );
+      }
+    }
+  }
+
+  _Heap_Free_list_remove( block );
+}
+
+/**
+ * @brief Inserts the free block @a block into the free list of the heap.
+ *
+ * Without a segregated fit index, the block is inserted after the
+ * @a free_list_anchor.  The block size must be valid.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Free_block_insert(
+  Heap_Control *heap,
+  Heap_Block   *free_list_anchor,
+  Heap_Block   *block
+)
+{
+  if ( _Heap_Is_segregated_fit( heap ) ) {
+    _Heap_Segregated_insert( heap, block );
+  } else {
+    _Heap_Free_list_insert_after( free_list_anchor, block );
+  }
+}
+
+/**
+ * @brief Removes the free block @a block from the free list of the heap.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Free_block_remove(
+  Heap_Control *heap,
+  Heap_Block   *block
+)
+{
+  if ( _Heap_Is_segregated_fit( heap ) ) {
+    _Heap_Segregated_remove( heap, block );
+  } else {
+    _Heap_Free_list_remove( block );
+  }
+}
+
+/**
+ * @brief Replaces the free block @a old_block by the free block @a new_block
+ * in the free list of the heap.
+ *
+ * The block sizes of both blocks must be valid.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Free_block_replace(
+  Heap_Control *heap,
+  Heap_Block   *old_block,
+  Heap_Block   *new_block
+)
+{
+  if ( _Heap_Is_segregated_fit( heap ) ) {
+    _Heap_Segregated_remove( heap, old_block );
+    _Heap_Segregated_insert( heap, new_block );
+  } else {
+    _Heap_Free_list_replace( old_block, new_block );
+  }
+}
+
+/**
+ * @brief Sets the size of the free block @a block which is in the free list
+ * of the heap to @a block_size.
+ *
+ * The previous block of a free block is always used.
+ */
+RTEMS_INLINE_ROUTINE void _Heap_Free_block_set_size(
+  Heap_Control *heap,
+  Heap_Block   *block,
+  uintptr_t     block_size
+)
+{
+  if ( _Heap_Is_segregated_fit( heap ) ) {
+    _Heap_Segregated_remove( heap, block );
+    block->size_and_flag = block_size | HEAP_PREV_BLOCK_USED;
+    _Heap_Segregated_insert( heap, block );
+  } else {
+    block->size_and_flag = block_size | HEAP_PREV_BLOCK_USED;
+  }
+}
+
 RTEMS_INLINE_ROUTINE bool _Heap_Is_block_in_heap(
   const Heap_Control *heap,
   const Heap_Block *block
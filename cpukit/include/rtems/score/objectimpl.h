@@ -115,6 +115,56 @@ typedef void ( *Objects_Thread_queue_Extract_callout )(
 );
 #endif
 
+/**
+ * @brief The count of inactive objects moved at once between a per-processor
+ * cache and the inactive chain of an object information.
+ *
+ * A cache holds at most twice this count of inactive objects.
+ */
+#define OBJECTS_INACTIVE_CACHE_BATCH 8
+
+/**
+ * @brief Per-processor cache of inactive objects.
+ *
+ * The cached objects are inactive objects from the object information point
+ * of view.  The caches are protected by the object allocator mutex.
+ */
+typedef struct {
+  /** @brief The chain of cached inactive objects, first freed object first. */
+  Chain_Control Inactive;
+
+  /** @brief The count of cached inactive objects. */
+  uint32_t      count;
+} Objects_Inactive_cache;
+
+/**
+ * @brief The name index of an object information.
+ *
+ * @see _Objects_Name_index_insert().
+ */
+typedef struct {
+  /**
+   * @brief The generation of the name index.
+   *
+   * It is odd while an insert or remove modifies the hash chains.  A lookup
+   * which found no object is repeated if the generation changed or was odd,
+   * since it may have followed a chain which was modified concurrently.
+   */
+  uint32_t        generation;
+
+  /** @brief The count of hash buckets minus one. */
+  Objects_Maximum bucket_mask;
+
+  /**
+   * @brief The hash buckets followed by the hash chain table indexed by object
+   * index.
+   *
+   * A hash bucket contains the index of the first object of its hash chain.
+   * Index zero terminates a hash chain.
+   */
+  Objects_Maximum entries[ RTEMS_ZERO_LENGTH_ARRAY ];
+} Objects_Name_index;
+
 /**
  *  The following defines the structure for the information used to
  *  manage each class of objects.
@@ -150,6 +200,22 @@ typedef struct {
   Objects_Maximum  *inactive_per_block;
   /** This is a table to the chain of inactive object memory blocks. */
   Objects_Control **object_blocks;
+  /**
+   * @brief The name index or NULL in case the name index is disabled.
+   *
+   * Everything is contained in one area, so that a lookup obtains a
+   * consistent view through a single pointer.
+   *
+   * @see _Objects_Name_index_insert().
+   */
+  Objects_Name_index *name_index;
+  /**
+   * @brief The per-processor caches of inactive objects indexed by processor
+   * index or NULL in case the caches are disabled.
+   *
+   * @see _Objects_Inactive_cache_get() and _Objects_Inactive_cache_put().
+   */
+  Objects_Inactive_cache *inactive_caches;
   #if defined(RTEMS_MULTIPROCESSING)
     /** This is this object class' method called when extracting a thread. */
     Objects_Thread_queue_Extract_callout extract;
@@ -205,6 +271,57 @@ void _Objects_Extend_information(
   Objects_Information *information
 );
 
+/**
+ * @brief Initializes the per-processor caches of inactive objects.
+ *
+ * The caches are only used if they are enabled by the application
+ * configuration and more than one processor is configured.
+ *
+ * @param[in] information The object information block.
+ */
+void _Objects_Initialize_inactive_caches(
+  Objects_Information *information
+);
+
+/**
+ * @brief Gets an inactive object via the cache of the current processor.
+ *
+ * An empty cache is refilled with a batch of objects from the inactive chain.
+ * In case the inactive chain is empty, an object cached by another processor
+ * is used.
+ *
+ * @param[in] information The object information block with enabled caches.
+ *
+ * @retval NULL No inactive object available.
+ * @retval object An inactive object.
+ */
+Objects_Control *_Objects_Inactive_cache_get(
+  Objects_Information *information
+);
+
+/**
+ * @brief Puts an inactive object into the cache of the current processor.
+ *
+ * The object is appended to the cache, so that objects are reused in first
+ * in, first out order.  A full cache returns a batch of the most recently
+ * freed objects to the inactive chain.
+ *
+ * @param[in] information The object information block with enabled caches.
+ * @param[in] the_object The object to put.
+ */
+void _Objects_Inactive_cache_put(
+  Objects_Information *information,
+  Objects_Control     *the_object
+);
+
+/**
+ * @brief Returns the objects of all per-processor caches to the inactive
+ * chain.
+ *
+ * @param[in] information The object information block.
+ */
+void _Objects_Flush_inactive_caches( Objects_Information *information );
+
 /**
  *  @brief Shrink an object class information record
  *
@@ -710,6 +827,105 @@ void _Objects_Namespace_remove_string(
   Objects_Control           *the_object
 );
 
+/**
+ * @brief Returns the size in bytes of the name index for the specified
+ * maximum object index.
+ *
+ * @param[in] maximum The maximum object index.
+ */
+size_t _Objects_Name_index_size( uint32_t maximum );
+
+/**
+ * @brief Builds the name index for the objects of a local table.
+ *
+ * This is used by _Objects_Extend_information() to set up the name index of
+ * the extended tables before they replace the current tables.
+ *
+ * @param[in] information The corresponding object information table.
+ * @param[in] local_table The local table.
+ * @param[in] maximum The maximum object index of the local table.
+ * @param[out] name_index The name index area of _Objects_Name_index_size()
+ *   bytes.
+ */
+void _Objects_Name_index_build(
+  const Objects_Information  *information,
+  Objects_Control           **local_table,
+  uint32_t                    maximum,
+  Objects_Name_index         *name_index
+);
+
+/**
+ * @brief Inserts the object into the name index.
+ *
+ * Objects without a name are not inserted.  The name index must be enabled
+ * and the caller must own the object allocator lock or the system must not
+ * be up.
+ *
+ * @param[in] information The corresponding object information table.
+ * @param[in] the_object The object.
+ */
+void _Objects_Name_index_insert(
+  const Objects_Information *information,
+  Objects_Control           *the_object
+);
+
+/**
+ * @brief Removes the object from the name index.
+ *
+ * Nothing happens in case the object is not in the name index.  The name of
+ * the object must be the one used to insert it.
+ *
+ * @param[in] information The corresponding object information table.
+ * @param[in] the_object The object.
+ */
+void _Objects_Name_index_remove(
+  const Objects_Information *information,
+  Objects_Control           *the_object
+);
+
+/**
+ * @brief Finds a local object with a 32-bit integer name via the name index.
+ *
+ * @param[in] information The corresponding object information table.
+ * @param[in] name The object name.
+ *
+ * @retval NULL No such object exists.
+ * @retval object An object with the specified name.
+ */
+Objects_Control *_Objects_Name_index_find_u32(
+  const Objects_Information *information,
+  uint32_t                   name
+);
+
+/**
+ * @brief Finds a local object with a string name via the name index.
+ *
+ * @param[in] information The corresponding object information table.
+ * @param[in] name The object name.
+ * @param[in] name_length The length of the name.
+ *
+ * @retval NULL No such object exists.
+ * @retval object An object with the specified name.
+ */
+Objects_Control *_Objects_Name_index_find_string(
+  const Objects_Information *information,
+  const char                *name,
+  size_t                     name_length
+);
+
+/**
+ * @brief Returns true if the name index of the object information is
+ * enabled, otherwise false.
+ *
+ * @param[in] information The corresponding object information table.
+ */
+RTEMS_INLINE_ROUTINE bool _Objects_Has_name_index(
+  const Objects_Information *information
+)
+{
+  return information->name_index != NULL;
+}
+
 /**
  *  @brief Close object.
  *
@@ -903,6 +1119,10 @@ RTEMS_INLINE_ROUTINE void _Objects_Open(
     _Objects_Get_index( the_object->id ),
     the_object
   );
+
+  if ( _Objects_Has_name_index( information ) ) {
+    _Objects_Name_index_insert( information, the_object );
+  }
 }
 
 /**
@@ -927,6 +1147,10 @@ RTEMS_INLINE_ROUTINE void _Objects_Open_u32(
     _Objects_Get_index( the_object->id ),
     the_object
   );
+
+  if ( _Objects_Has_name_index( information ) ) {
+    _Objects_Name_index_insert( information, the_object );
+  }
 }
 
 /**
@@ -951,6 +1175,10 @@ RTEMS_INLINE_ROUTINE void _Objects_Open_string(
     _Objects_Get_index( the_object->id ),
     the_object
   );
+
+  if ( _Objects_Has_name_index( information ) ) {
+    _Objects_Name_index_insert( information, the_object );
+  }
 }
 
 /**
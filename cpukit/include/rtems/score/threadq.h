@@ -149,12 +149,19 @@ typedef struct {
  * @brief A thread queue link from one thread to another specified by the
  * thread queue owner and thread wait queue relationships.
  */
-typedef struct {
+typedef struct Thread_queue_Link {
+  /**
+   * @brief Next link in the thread queue links registry bucket of the source
+   * thread queue.
+   */
+  struct Thread_queue_Link *Registry_next;
+
   /**
-   * @brief Node to register this link in the global thread queue links lookup
-   * tree.
+   * @brief Indicates if the deadlock detection for this link is in progress.
+   *
+   * Protected by the lock of the registry bucket.
    */
-  RBTree_Node Registry_node;
+  bool Registry_pending;
 
   /**
    * @brief The source thread queue determined by the thread queue owner.
@@ -62,6 +62,55 @@ typedef void Watchdog_Service_routine;
 typedef Watchdog_Service_routine
   ( *Watchdog_Service_routine_entry )( Watchdog_Control * );
 
+/**
+ * @brief Count of index bits of a timing wheel level.
+ */
+#define WATCHDOG_WHEEL_SLOT_BITS 6
+
+/**
+ * @brief Count of slots of a timing wheel level.
+ */
+#define WATCHDOG_WHEEL_SLOT_COUNT ( 1U << WATCHDOG_WHEEL_SLOT_BITS )
+
+/**
+ * @brief Count of timing wheel levels.
+ *
+ * Watchdogs which expire more than WATCHDOG_WHEEL_SLOT_COUNT to the power of
+ * WATCHDOG_WHEEL_LEVEL_COUNT ticks in the future are kept on an overflow
+ * chain.
+ */
+#define WATCHDOG_WHEEL_LEVEL_COUNT 4
+
+/**
+ * @brief Hierarchical timing wheel to manage scheduled watchdogs with an
+ * expiration time in clock ticks.
+ *
+ * The slot of level N covers WATCHDOG_WHEEL_SLOT_COUNT to the power of N
+ * ticks.  Watchdogs move to lower levels once their slot becomes current.
+ */
+typedef struct {
+  /**
+   * @brief The last clock tick processed by this timing wheel.
+   */
+  uint64_t ticks;
+
+  /**
+   * @brief Count of watchdogs scheduled on this timing wheel.
+   */
+  uint32_t count;
+
+  /**
+   * @brief Unordered chains of scheduled watchdogs for each slot.
+   */
+  Chain_Control
+    Slots[ WATCHDOG_WHEEL_LEVEL_COUNT ][ WATCHDOG_WHEEL_SLOT_COUNT ];
+
+  /**
+   * @brief Scheduled watchdogs beyond the range of the highest level.
+   */
+  Chain_Control Overflow;
+} Watchdog_Wheel;
+
 /**
  * @brief The watchdog header to manage scheduled watchdogs.
  */
@@ -76,6 +125,16 @@ typedef struct {
    * case no watchdog is scheduled.
    */
   RBTree_Node *first;
+
+  /**
+   * @brief The timing wheel used instead of the red-black tree or NULL.
+   *
+   * A timing wheel may only be used for expiration times in clock ticks.  In
+   * this case the red-black tree is unused.
+   *
+   * @see CONFIGURE_WATCHDOG_TIMING_WHEEL.
+   */
+  Watchdog_Wheel *wheel;
 } Watchdog_Header;
 
 /**
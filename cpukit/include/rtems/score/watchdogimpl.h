@@ -95,6 +95,7 @@ RTEMS_INLINE_ROUTINE void _Watchdog_Header_initialize(
 {
   _RBTree_Initialize_empty( &header->Watchdogs );
   header->first = NULL;
+  header->wheel = NULL;
 }
 
 RTEMS_INLINE_ROUTINE Watchdog_Control *_Watchdog_Header_first(
@@ -211,6 +212,108 @@ void _Watchdog_Do_tickle(
     _Watchdog_Do_tickle( header, first, now, lock_context )
 #endif
 
+/**
+ * @brief Initializes the timing wheels of the ticks based watchdog headers of
+ * all configured processors.
+ *
+ * This is a system initialization handler used by
+ * CONFIGURE_WATCHDOG_TIMING_WHEEL.
+ */
+void _Watchdog_Wheel_initialize( void );
+
+/**
+ * @brief Initializes a timing wheel and uses it for the watchdog header.
+ *
+ * The watchdog header must be initialized and empty.
+ *
+ * @param header The watchdog header.
+ * @param wheel The timing wheel to initialize.
+ * @param ticks The last clock tick processed by the timing wheel.
+ */
+void _Watchdog_Header_initialize_wheel(
+  Watchdog_Header *header,
+  Watchdog_Wheel  *wheel,
+  uint64_t         ticks
+);
+
+/**
+ * @brief Inserts a watchdog into a timing wheel.
+ *
+ * The watchdog must be inactive.  A watchdog which expires at or before the
+ * last processed clock tick expires with the next clock tick.
+ */
+void _Watchdog_Wheel_insert(
+  Watchdog_Wheel   *wheel,
+  Watchdog_Control *the_watchdog,
+  uint64_t          expire
+);
+
+/**
+ * @brief Removes a scheduled watchdog from a timing wheel.
+ */
+void _Watchdog_Wheel_remove(
+  Watchdog_Wheel   *wheel,
+  Watchdog_Control *the_watchdog
+);
+
+void _Watchdog_Wheel_do_tickle(
+  Watchdog_Wheel   *wheel,
+  uint64_t          now,
+#if defined(RTEMS_SMP)
+  ISR_lock_Control *lock,
+#endif
+  ISR_lock_Context *lock_context
+);
+
+#if defined(RTEMS_SMP)
+  #define _Watchdog_Wheel_tickle( wheel, now, lock, lock_context ) \
+    _Watchdog_Wheel_do_tickle( wheel, now, lock, lock_context )
+#else
+  #define _Watchdog_Wheel_tickle( wheel, now, lock, lock_context ) \
+    _Watchdog_Wheel_do_tickle( wheel, now, lock_context )
+#endif
+
+/**
+ * @brief Returns a lower bound of the count of clock ticks until the next
+ * clock tick which has work to do on the timing wheel.
+ *
+ * @param wheel The timing wheel.
+ * @param maximum The maximum count of clock ticks to return.
+ */
+uint32_t _Watchdog_Wheel_idle_ticks(
+  const Watchdog_Wheel *wheel,
+  uint32_t              maximum
+);
+
+/**
+ * @brief Returns the count of clock ticks until the next clock tick which is
+ * necessary on an online processor.
+ *
+ * This function is intended for clock drivers of tickless idle systems, see
+ * _Watchdog_Tickless_idle.  The returned value is one, if a processor other
+ * than the executing processor executes a thread which is not an idle thread,
+ * otherwise it is a lower bound of the count of clock ticks until the next
+ * watchdog expires.  Thread dispatching must be disabled.
+ *
+ * @param maximum The maximum count of clock ticks to return.  It must be
+ *   positive.
+ *
+ * @return The count of clock ticks in the range from one to @a maximum.
+ */
+uint32_t _Watchdog_Get_idle_ticks( uint32_t maximum );
+
+/**
+ * @brief Advances the clock tick counters of all online processors without
+ * processing the watchdogs.
+ *
+ * After a tickless idle period of N clock ticks, the clock driver skips N - 1
+ * clock ticks and then performs a normal clock tick.  No watchdog may expire
+ * within the skipped clock ticks, see _Watchdog_Get_idle_ticks().
+ *
+ * @param ticks The count of clock ticks to skip.
+ */
+void _Watchdog_Skip_ticks( uint32_t ticks );
+
 /**
  * @brief Inserts a watchdog into the set of scheduled watchdogs according to
  * the specified expiration time.
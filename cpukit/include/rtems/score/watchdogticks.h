@@ -63,6 +63,17 @@ extern const uint32_t _Watchdog_Nanoseconds_per_tick;
  */
 extern const uint32_t _Watchdog_Ticks_per_second;
 
+/**
+ * @brief Indicates if the clock driver may suspend the clock tick while all
+ * processors are idle.
+ *
+ * This constant is defined by the application configuration via
+ * <rtems/confdefs.h>.
+ *
+ * @see _Watchdog_Get_idle_ticks() and _Watchdog_Skip_ticks().
+ */
+extern const bool _Watchdog_Tickless_idle;
+
 /** @} */
 
 #ifdef __cplusplus
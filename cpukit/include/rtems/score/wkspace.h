@@ -45,6 +45,15 @@ extern "C" {
  */
 extern Heap_Control _Workspace_Area;
 
+/**
+ * @brief The heap initialization handler of the RTEMS Executive Workspace.
+ *
+ * This is either _Heap_Initialize() or _Heap_Initialize_segregated_fit() and
+ * is defined by the application configuration.
+ */
+extern const Heap_Initialization_or_extend_handler
+  _Workspace_Initialize_handler;
+
 /**
  * @brief Initilize workspace handler.
  *
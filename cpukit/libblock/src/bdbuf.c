@@ -32,6 +32,7 @@
 #endif
 #include <limits.h>
 #include <errno.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -61,7 +62,9 @@ typedef struct rtems_bdbuf_swapout_transfer
   rtems_chain_control   bds;         /**< The transfer list of BDs. */
   rtems_disk_device    *dd;          /**< The device the transfer is for. */
   bool                  syncing;     /**< The data is a sync'ing. */
-  rtems_blkdev_request  write_req;   /**< The write request. */
+  rtems_blkdev_request  write_req;   /**< The first write request.  The
+                                      * other write requests of the queue
+                                      * follow it. */
 } rtems_bdbuf_swapout_transfer;
 
 /**
@@ -87,8 +90,71 @@ typedef struct rtems_bdbuf_waiters {
   rtems_condition_variable cond_var;
 } rtems_bdbuf_waiters;
 
+/**
+ * A block recycled from the recently used list of the 2Q replacement policy.
+ * The disk device is only a search key and may refer to a deleted device.
+ */
+typedef struct rtems_bdbuf_ghost
+{
+  struct rtems_bdbuf_ghost* hash_next;   /**< Next ghost in the hash
+                                          * bucket. */
+  const rtems_disk_device*  dd;          /**< The disk device or NULL if the
+                                          * entry is unused. */
+  rtems_blkdev_bnum         block;       /**< The media block number. */
+} rtems_bdbuf_ghost;
+
+/**
+ * A partition of the BD buffer cache.  The partition lock protects the
+ * partition data and the BDs of the groups assigned to the partition.
+ */
+typedef struct rtems_bdbuf_partition
+{
+  rtems_mutex          lock;             /**< The partition lock. */
+  rtems_bdbuf_buffer** hash;             /**< Buffer descriptor lookup hash
+                                          * table. */
+  size_t               hash_mask;        /**< The hash table size minus
+                                          * one. */
+  rtems_chain_control  lru;              /**< Least recently used list */
+  rtems_chain_control  recent;           /**< Recently used list of the 2Q
+                                          * policy */
+  rtems_chain_control  modified;         /**< Modified buffers list */
+  rtems_chain_control  sync;             /**< Buffers to sync list */
+
+  size_t               group_count;      /**< The number of groups owned by
+                                          * the partition. */
+  size_t               recent_size;      /**< Minimum size buffers on the
+                                          * recently used list. */
+  size_t               recent_max;       /**< The recently used list is
+                                          * recycled first if it exceeds this
+                                          * size. */
+  rtems_bdbuf_ghost*   ghosts;           /**< Ring of ghosts. */
+  rtems_bdbuf_ghost**  ghost_hash;       /**< Ghost lookup hash table with
+                                          * the size of the BD hash table. */
+  size_t               ghost_count;      /**< The ghost ring size. */
+  size_t               ghost_next;       /**< The next ghost to replace. */
+
+  uint32_t             read_hits;        /**< Read hits of the partition. */
+  uint32_t             read_misses;      /**< Read misses of the
+                                          * partition. */
+  uint32_t             read_ghost_hits;  /**< Read ghost hits of the
+                                          * partition. */
+
+  rtems_bdbuf_waiters access_waiters;    /**< Wait for a buffer in
+                                          * ACCESS_CACHED, ACCESS_MODIFIED or
+                                          * ACCESS_EMPTY
+                                          * state. */
+  rtems_bdbuf_waiters transfer_waiters;  /**< Wait for a buffer in TRANSFER
+                                          * state. */
+  rtems_bdbuf_waiters buffer_waiters;    /**< Wait for a buffer and no one is
+                                          * available. */
+} rtems_bdbuf_partition;
+
 /**
  * The BD buffer cache.
+ *
+ * The lock order is the sync lock, the partition locks in ascending index
+ * order and then the cache lock.  No thread blocks while it owns the cache
+ * lock, except for the wait for a buffer of any partition which releases it.
  */
 typedef struct rtems_bdbuf_cache
 {
@@ -108,8 +174,11 @@ typedef struct rtems_bdbuf_cache
                                           * buffer size that fit in a group. */
   uint32_t            flags;             /**< Configuration flags. */
 
-  rtems_mutex         lock;              /**< The cache lock. It locks all
-                                          * cache data, BD and lists. */
+  rtems_mutex         lock;              /**< The cache lock. It locks the
+                                          * sync state, the swapout workers,
+                                          * the read-ahead chain and the disk
+                                          * statistics and read-ahead
+                                          * state. */
   rtems_mutex         sync_lock;         /**< Sync calls block writes. */
   bool                sync_active;       /**< True if a sync is active. */
   rtems_id            sync_requester;    /**< The sync requester. */
@@ -117,20 +186,21 @@ typedef struct rtems_bdbuf_cache
                                           * BDBUF_INVALID_DEV not a device
                                           * sync. */
 
-  rtems_bdbuf_buffer* tree;              /**< Buffer descriptor lookup AVL tree
-                                          * root. There is only one. */
-  rtems_chain_control lru;               /**< Least recently used list */
-  rtems_chain_control modified;          /**< Modified buffers list */
-  rtems_chain_control sync;              /**< Buffers to sync list */
-
-  rtems_bdbuf_waiters access_waiters;    /**< Wait for a buffer in
-                                          * ACCESS_CACHED, ACCESS_MODIFIED or
-                                          * ACCESS_EMPTY
-                                          * state. */
-  rtems_bdbuf_waiters transfer_waiters;  /**< Wait for a buffer in TRANSFER
-                                          * state. */
-  rtems_bdbuf_waiters buffer_waiters;    /**< Wait for a buffer and no one is
-                                          * available. */
+  uint32_t               partition_count; /**< The number of partitions. */
+  rtems_bdbuf_partition* partitions;      /**< The partitions. */
+  rtems_bdbuf_buffer**   hash;            /**< The hash tables of all
+                                           * partitions. */
+  rtems_bdbuf_ghost*     ghosts;          /**< The ghosts of all
+                                           * partitions. */
+  rtems_bdbuf_ghost**    ghost_hash;      /**< The ghost hash tables of all
+                                           * partitions. */
+  rtems_bdbuf_waiters    starving_waiters; /**< Wait for a buffer of any
+                                            * partition.  Protected by the
+                                            * cache lock. */
+  uint32_t               starving_generation; /**< Incremented if a buffer is
+                                               * released while there are
+                                               * starving waiters.  Protected
+                                               * by the cache lock. */
 
   rtems_bdbuf_swapout_transfer *swapout_transfer;
   rtems_bdbuf_swapout_worker *swapout_workers;
@@ -164,6 +234,7 @@ typedef enum {
   RTEMS_BDBUF_FATAL_STATE_9,
   RTEMS_BDBUF_FATAL_STATE_10,
   RTEMS_BDBUF_FATAL_STATE_11,
+  RTEMS_BDBUF_FATAL_STATE_12,
   RTEMS_BDBUF_FATAL_SWAPOUT_RE,
   RTEMS_BDBUF_FATAL_TREE_RM,
   RTEMS_BDBUF_FATAL_WAIT_EVNT,
@@ -187,11 +258,6 @@ static rtems_task rtems_bdbuf_read_ahead_task(rtems_task_argument arg);
 static rtems_bdbuf_cache bdbuf_cache = {
   .lock = RTEMS_MUTEX_INITIALIZER(NULL),
   .sync_lock = RTEMS_MUTEX_INITIALIZER(NULL),
-  .access_waiters = { .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL) },
-  .transfer_waiters = {
-    .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL)
-  },
-  .buffer_waiters = { .cond_var = RTEMS_CONDITION_VARIABLE_INITIALIZER(NULL) },
   .once = PTHREAD_ONCE_INIT
 };
 
@@ -227,22 +293,47 @@ void
 rtems_bdbuf_show_usage (void)
 {
   uint32_t group;
+  uint32_t partition;
   uint32_t total = 0;
   uint32_t val;
 
   for (group = 0; group < bdbuf_cache.group_count; group++)
     total += bdbuf_cache.groups[group].users;
   printf ("bdbuf:group users=%lu", total);
-  val = rtems_bdbuf_list_count (&bdbuf_cache.lru);
-  printf (", lru=%lu", val);
-  total = val;
-  val = rtems_bdbuf_list_count (&bdbuf_cache.modified);
-  printf (", mod=%lu", val);
-  total += val;
-  val = rtems_bdbuf_list_count (&bdbuf_cache.sync);
-  printf (", sync=%lu", val);
-  total += val;
+  total = 0;
+  for (partition = 0; partition < bdbuf_cache.partition_count; partition++)
+  {
+    rtems_bdbuf_partition *p = &bdbuf_cache.partitions[partition];
+
+    val = rtems_bdbuf_list_count (&p->lru);
+    printf (", lru[%" PRIu32 "]=%" PRIu32, partition, val);
+    total += val;
+    val = rtems_bdbuf_list_count (&p->recent);
+    printf (", recent[%" PRIu32 "]=%" PRIu32, partition, val);
+    total += val;
+    val = rtems_bdbuf_list_count (&p->modified);
+    printf (", mod[%" PRIu32 "]=%" PRIu32, partition, val);
+    total += val;
+    val = rtems_bdbuf_list_count (&p->sync);
+    printf (", sync[%" PRIu32 "]=%" PRIu32, partition, val);
+    total += val;
+  }
   printf (", total=%lu\n", total);
+  printf ("bdbuf:policy=%s",
+          bdbuf_config.replacement_policy == RTEMS_BDBUF_REPLACEMENT_2Q ?
+            "2Q" : "LRU");
+  for (partition = 0; partition < bdbuf_cache.partition_count; partition++)
+  {
+    rtems_bdbuf_partition *p = &bdbuf_cache.partitions[partition];
+
+    printf (", hits[%" PRIu32 "]=%" PRIu32
+            ", misses[%" PRIu32 "]=%" PRIu32
+            ", ghost-hits[%" PRIu32 "]=%" PRIu32,
+            partition, p->read_hits,
+            partition, p->read_misses,
+            partition, p->read_ghost_hits);
+  }
+  printf ("\n");
 }
 
 /**
@@ -271,15 +362,6 @@ rtems_bdbuf_show_users (const char* where, rtems_bdbuf_buffer* bd)
 #define rtems_bdbuf_show_users(_w, _b) ((void) 0)
 #endif
 
-/**
- * The default maximum height of 32 allows for AVL trees having between
- * 5,704,880 and 4,294,967,295 nodes, depending on order of insertion.  You may
- * change this compile-time constant as you wish.
- */
-#ifndef RTEMS_BDBUF_AVL_MAX_HEIGHT
-#define RTEMS_BDBUF_AVL_MAX_HEIGHT (32)
-#endif
-
 static void
 rtems_bdbuf_fatal (rtems_fatal_code error)
 {
@@ -293,571 +375,357 @@ rtems_bdbuf_fatal_with_state (rtems_bdbuf_buf_state state,
   rtems_bdbuf_fatal ((((uint32_t) state) << 16) | error);
 }
 
+/**
+ * The blocks of an extent of 2**RTEMS_BDBUF_PARTITION_EXTENT_SHIFT media
+ * blocks belong to the same partition.  This keeps multiple block transfers
+ * within one partition.  With more than one partition the read-ahead transfers
+ * are limited to the extent.
+ */
+#define RTEMS_BDBUF_PARTITION_EXTENT_SHIFT 5
+
+/**
+ * Maximum count of blocks of a direct transfer request.  The request is
+ * allocated on the stack.
+ */
+#define RTEMS_BDBUF_DIRECT_TRANSFER_MAX_BLOCKS 64
+
+static uint32_t
+rtems_bdbuf_hash (const rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  uintptr_t dd_key = (uintptr_t) dd;
+  uint32_t  hash = (uint32_t) (dd_key ^ (dd_key >> 16)) + block;
+
+  hash *= 0x9e3779b1U;
+
+  return hash ^ (hash >> 16);
+}
+
+/**
+ * Returns the partition of the specified dd/block.
+ *
+ * @param dd disk device
+ * @param block media block number
+ * @return pointer to the partition responsible for the dd/block
+ */
+static rtems_bdbuf_partition *
+rtems_bdbuf_get_partition (const rtems_disk_device *dd,
+                           rtems_blkdev_bnum        block)
+{
+  uint32_t hash = rtems_bdbuf_hash (dd,
+                                    block >> RTEMS_BDBUF_PARTITION_EXTENT_SHIFT);
+
+  return &bdbuf_cache.partitions [hash % bdbuf_cache.partition_count];
+}
+
+/**
+ * Returns the partition of the BD.  A BD belongs to the partition of its
+ * group.  A group moves to another partition only if none of its buffers is in
+ * use, so the partition of a BD in use is stable.
+ *
+ * @param bd the buffer descriptor
+ * @return pointer to the partition owning the BD
+ */
+static rtems_bdbuf_partition *
+rtems_bdbuf_get_partition_of_bd (const rtems_bdbuf_buffer *bd)
+{
+  return &bdbuf_cache.partitions [bd->group->partition];
+}
+
+static rtems_bdbuf_buffer **
+rtems_bdbuf_hash_bucket (const rtems_bdbuf_partition *partition,
+                         const rtems_disk_device     *dd,
+                         rtems_blkdev_bnum            block)
+{
+  return &partition->hash [rtems_bdbuf_hash (dd, block) & partition->hash_mask];
+}
+
 /**
  * Searches for the node with specified dd/block.
  *
- * @param root pointer to the root node of the AVL-Tree
+ * @param partition the partition of the dd/block
  * @param dd disk device search key
  * @param block block search key
  * @retval NULL node with the specified dd/block is not found
  * @return pointer to the node with specified dd/block
  */
 static rtems_bdbuf_buffer *
-rtems_bdbuf_avl_search (rtems_bdbuf_buffer** root,
-                        const rtems_disk_device *dd,
-                        rtems_blkdev_bnum    block)
+rtems_bdbuf_hash_search (const rtems_bdbuf_partition *partition,
+                         const rtems_disk_device     *dd,
+                         rtems_blkdev_bnum            block)
 {
-  rtems_bdbuf_buffer* p = *root;
+  rtems_bdbuf_buffer* p = *rtems_bdbuf_hash_bucket (partition, dd, block);
 
   while ((p != NULL) && ((p->dd != dd) || (p->block != block)))
-  {
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p = p->avl.right;
-    }
-    else
-    {
-      p = p->avl.left;
-    }
-  }
+    p = p->hash_next;
 
   return p;
 }
 
 /**
- * Inserts the specified node to the AVl-Tree.
+ * Inserts the specified node to the hash table of the partition.
  *
- * @param root pointer to the root node of the AVL-Tree
- * @param node Pointer to the node to add.
+ * @param partition the partition of the node
+ * @param node Pointer to the node to add
  * @retval 0 The node added successfully
- * @retval -1 An error occured
+ * @retval -1 An error occurred
  */
 static int
-rtems_bdbuf_avl_insert(rtems_bdbuf_buffer** root,
-                       rtems_bdbuf_buffer*  node)
+rtems_bdbuf_hash_insert(rtems_bdbuf_partition* partition,
+                        rtems_bdbuf_buffer*    node)
 {
-  const rtems_disk_device *dd = node->dd;
-  rtems_blkdev_bnum block = node->block;
-
-  rtems_bdbuf_buffer*  p = *root;
-  rtems_bdbuf_buffer*  q;
-  rtems_bdbuf_buffer*  p1;
-  rtems_bdbuf_buffer*  p2;
-  rtems_bdbuf_buffer*  buf_stack[RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer** buf_prev = buf_stack;
-
-  bool modified = false;
-
-  if (p == NULL)
-  {
-    *root = node;
-    node->avl.left = NULL;
-    node->avl.right = NULL;
-    node->avl.bal = 0;
-    return 0;
-  }
+  rtems_bdbuf_buffer** bucket =
+    rtems_bdbuf_hash_bucket (partition, node->dd, node->block);
+  rtems_bdbuf_buffer*  p = *bucket;
 
   while (p != NULL)
   {
-    *buf_prev++ = p;
-
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p->avl.cache = 1;
-      q = p->avl.right;
-      if (q == NULL)
-      {
-        q = node;
-        p->avl.right = q = node;
-        break;
-      }
-    }
-    else if ((p->dd != dd) || (p->block != block))
-    {
-      p->avl.cache = -1;
-      q = p->avl.left;
-      if (q == NULL)
-      {
-        q = node;
-        p->avl.left = q;
-        break;
-      }
-    }
-    else
-    {
+    if ((p->dd == node->dd) && (p->block == node->block))
       return -1;
-    }
 
-    p = q;
+    p = p->hash_next;
   }
 
-  q->avl.left = q->avl.right = NULL;
-  q->avl.bal = 0;
-  modified = true;
-  buf_prev--;
-
-  while (modified)
-  {
-    if (p->avl.cache == -1)
-    {
-      switch (p->avl.bal)
-      {
-        case 1:
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        case 0:
-          p->avl.bal = -1;
-          break;
-
-        case -1:
-          p1 = p->avl.left;
-          if (p1->avl.bal == -1) /* simple LL-turn */
-          {
-            p->avl.left = p1->avl.right;
-            p1->avl.right = p;
-            p->avl.bal = 0;
-            p = p1;
-          }
-          else /* double LR-turn */
-          {
-            p2 = p1->avl.right;
-            p1->avl.right = p2->avl.left;
-            p2->avl.left = p1;
-            p->avl.left = p2->avl.right;
-            p2->avl.right = p;
-            if (p2->avl.bal == -1) p->avl.bal = +1; else p->avl.bal = 0;
-            if (p2->avl.bal == +1) p1->avl.bal = -1; else p1->avl.bal = 0;
-            p = p2;
-          }
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        default:
-          break;
-      }
-    }
-    else
-    {
-      switch (p->avl.bal)
-      {
-        case -1:
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        case 0:
-          p->avl.bal = 1;
-          break;
-
-        case 1:
-          p1 = p->avl.right;
-          if (p1->avl.bal == 1) /* simple RR-turn */
-          {
-            p->avl.right = p1->avl.left;
-            p1->avl.left = p;
-            p->avl.bal = 0;
-            p = p1;
-          }
-          else /* double RL-turn */
-          {
-            p2 = p1->avl.left;
-            p1->avl.left = p2->avl.right;
-            p2->avl.right = p1;
-            p->avl.right = p2->avl.left;
-            p2->avl.left = p;
-            if (p2->avl.bal == +1) p->avl.bal = -1; else p->avl.bal = 0;
-            if (p2->avl.bal == -1) p1->avl.bal = +1; else p1->avl.bal = 0;
-            p = p2;
-          }
-          p->avl.bal = 0;
-          modified = false;
-          break;
-
-        default:
-          break;
-      }
-    }
-    q = p;
-    if (buf_prev > buf_stack)
-    {
-      p = *--buf_prev;
-
-      if (p->avl.cache == -1)
-      {
-        p->avl.left = q;
-      }
-      else
-      {
-        p->avl.right = q;
-      }
-    }
-    else
-    {
-      *root = p;
-      break;
-    }
-  };
+  node->hash_next = *bucket;
+  *bucket = node;
 
   return 0;
 }
 
-
 /**
- * Removes the node from the tree.
+ * Removes the node from the hash table of the partition.
  *
- * @param root Pointer to pointer to the root node
+ * @param partition the partition of the node
  * @param node Pointer to the node to remove
  * @retval 0 Item removed
  * @retval -1 No such item found
  */
 static int
-rtems_bdbuf_avl_remove(rtems_bdbuf_buffer**      root,
-                       const rtems_bdbuf_buffer* node)
+rtems_bdbuf_hash_remove(rtems_bdbuf_partition*    partition,
+                        const rtems_bdbuf_buffer* node)
 {
-  const rtems_disk_device *dd = node->dd;
-  rtems_blkdev_bnum block = node->block;
-
-  rtems_bdbuf_buffer*  p = *root;
-  rtems_bdbuf_buffer*  q;
-  rtems_bdbuf_buffer*  r;
-  rtems_bdbuf_buffer*  s;
-  rtems_bdbuf_buffer*  p1;
-  rtems_bdbuf_buffer*  p2;
-  rtems_bdbuf_buffer*  buf_stack[RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer** buf_prev = buf_stack;
-
-  bool modified = false;
+  rtems_bdbuf_buffer** link =
+    rtems_bdbuf_hash_bucket (partition, node->dd, node->block);
 
-  memset (buf_stack, 0, sizeof(buf_stack));
-
-  while (p != NULL)
+  while (*link != NULL)
   {
-    *buf_prev++ = p;
-
-    if (((uintptr_t) p->dd < (uintptr_t) dd)
-        || ((p->dd == dd) && (p->block < block)))
-    {
-      p->avl.cache = 1;
-      p = p->avl.right;
-    }
-    else if ((p->dd != dd) || (p->block != block))
-    {
-      p->avl.cache = -1;
-      p = p->avl.left;
-    }
-    else
+    if (*link == node)
     {
-      /* node found */
-      break;
+      *link = node->hash_next;
+      return 0;
     }
-  }
 
-  if (p == NULL)
-  {
-    /* there is no such node */
-    return -1;
+    link = &(*link)->hash_next;
   }
 
-  q = p;
+  return -1;
+}
 
-  buf_prev--;
-  if (buf_prev > buf_stack)
-  {
-    p = *(buf_prev - 1);
-  }
-  else
-  {
-    p = NULL;
-  }
+static rtems_bdbuf_ghost **
+rtems_bdbuf_ghost_bucket (const rtems_bdbuf_partition *partition,
+                          const rtems_disk_device     *dd,
+                          rtems_blkdev_bnum            block)
+{
+  return &partition->ghost_hash [rtems_bdbuf_hash (dd, block)
+                                 & partition->hash_mask];
+}
 
-  /* at this moment q - is a node to delete, p is q's parent */
-  if (q->avl.right == NULL)
-  {
-    r = q->avl.left;
-    if (r != NULL)
-    {
-      r->avl.bal = 0;
-    }
-    q = r;
-  }
-  else
-  {
-    rtems_bdbuf_buffer **t;
+static void
+rtems_bdbuf_ghost_remove (rtems_bdbuf_partition *partition,
+                          rtems_bdbuf_ghost     *ghost)
+{
+  rtems_bdbuf_ghost **link =
+    rtems_bdbuf_ghost_bucket (partition, ghost->dd, ghost->block);
 
-    r = q->avl.right;
+  while (*link != ghost)
+    link = &(*link)->hash_next;
 
-    if (r->avl.left == NULL)
-    {
-      r->avl.left = q->avl.left;
-      r->avl.bal = q->avl.bal;
-      r->avl.cache = 1;
-      *buf_prev++ = q = r;
-    }
-    else
-    {
-      t = buf_prev++;
-      s = r;
+  *link = ghost->hash_next;
+  ghost->dd = NULL;
+}
 
-      while (s->avl.left != NULL)
-      {
-        *buf_prev++ = r = s;
-        s = r->avl.left;
-        r->avl.cache = -1;
-      }
+/**
+ * Remembers the block of a buffer recycled from the recently used list.  The
+ * oldest ghost is replaced if the ring is full.
+ *
+ * @param partition the partition of the buffer
+ * @param bd the recycled buffer
+ */
+static void
+rtems_bdbuf_ghost_add (rtems_bdbuf_partition    *partition,
+                       const rtems_bdbuf_buffer *bd)
+{
+  rtems_bdbuf_ghost  *ghost = &partition->ghosts [partition->ghost_next];
+  rtems_bdbuf_ghost **bucket;
 
-      s->avl.left = q->avl.left;
-      r->avl.left = s->avl.right;
-      s->avl.right = q->avl.right;
-      s->avl.bal = q->avl.bal;
-      s->avl.cache = 1;
+  if (ghost->dd != NULL)
+    rtems_bdbuf_ghost_remove (partition, ghost);
 
-      *t = q = s;
-    }
-  }
+  partition->ghost_next = (partition->ghost_next + 1) % partition->ghost_count;
 
-  if (p != NULL)
-  {
-    if (p->avl.cache == -1)
-    {
-      p->avl.left = q;
-    }
-    else
-    {
-      p->avl.right = q;
-    }
-  }
-  else
-  {
-    *root = q;
-  }
+  ghost->dd = bd->dd;
+  ghost->block = bd->block;
+
+  bucket = rtems_bdbuf_ghost_bucket (partition, bd->dd, bd->block);
+  ghost->hash_next = *bucket;
+  *bucket = ghost;
+}
 
-  modified = true;
+/**
+ * Checks if the dd/block was recycled from the recently used list shortly
+ * before.  A found ghost is removed.
+ *
+ * @param partition the partition of the dd/block
+ * @param dd disk device
+ * @param block media block number
+ * @retval true The dd/block has a ghost.
+ * @retval false Otherwise.
+ */
+static bool
+rtems_bdbuf_ghost_hit (rtems_bdbuf_partition   *partition,
+                       const rtems_disk_device *dd,
+                       rtems_blkdev_bnum        block)
+{
+  rtems_bdbuf_ghost *ghost = *rtems_bdbuf_ghost_bucket (partition, dd, block);
 
-  while (modified)
+  while (ghost != NULL)
   {
-    if (buf_prev > buf_stack)
-    {
-      p = *--buf_prev;
-    }
-    else
+    if ((ghost->dd == dd) && (ghost->block == block))
     {
-      break;
+      rtems_bdbuf_ghost_remove (partition, ghost);
+      return true;
     }
 
-    if (p->avl.cache == -1)
-    {
-      /* rebalance left branch */
-      switch (p->avl.bal)
-      {
-        case -1:
-          p->avl.bal = 0;
-          break;
-        case  0:
-          p->avl.bal = 1;
-          modified = false;
-          break;
+    ghost = ghost->hash_next;
+  }
 
-        case +1:
-          p1 = p->avl.right;
+  return false;
+}
 
-          if (p1->avl.bal >= 0) /* simple RR-turn */
-          {
-            p->avl.right = p1->avl.left;
-            p1->avl.left = p;
-
-            if (p1->avl.bal == 0)
-            {
-              p1->avl.bal = -1;
-              modified = false;
-            }
-            else
-            {
-              p->avl.bal = 0;
-              p1->avl.bal = 0;
-            }
-            p = p1;
-          }
-          else /* double RL-turn */
-          {
-            p2 = p1->avl.left;
+static void
+rtems_bdbuf_set_state (rtems_bdbuf_buffer *bd, rtems_bdbuf_buf_state state)
+{
+  bd->state = state;
+}
 
-            p1->avl.left = p2->avl.right;
-            p2->avl.right = p1;
-            p->avl.right = p2->avl.left;
-            p2->avl.left = p;
+static rtems_blkdev_bnum
+rtems_bdbuf_media_block (const rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  if (dd->block_to_media_block_shift >= 0)
+    return block << dd->block_to_media_block_shift;
+  else
+    /*
+     * Change the block number for the block size to the block number for the media
+     * block size. We have to use 64bit maths. There is no short cut here.
+     */
+    return (rtems_blkdev_bnum)
+      ((((uint64_t) block) * dd->block_size) / dd->media_block_size);
+}
 
-            if (p2->avl.bal == +1) p->avl.bal = -1; else p->avl.bal = 0;
-            if (p2->avl.bal == -1) p1->avl.bal = 1; else p1->avl.bal = 0;
+/**
+ * Lock the mutex. A single task can nest calls.
+ *
+ * @param lock The mutex to lock.
+ */
+static void
+rtems_bdbuf_lock (rtems_mutex *lock)
+{
+  rtems_mutex_lock (lock);
+}
 
-            p = p2;
-            p2->avl.bal = 0;
-          }
-          break;
-
-        default:
-          break;
-      }
-    }
-    else
-    {
-      /* rebalance right branch */
-      switch (p->avl.bal)
-      {
-        case +1:
-          p->avl.bal = 0;
-          break;
-
-        case  0:
-          p->avl.bal = -1;
-          modified = false;
-          break;
-
-        case -1:
-          p1 = p->avl.left;
-
-          if (p1->avl.bal <= 0) /* simple LL-turn */
-          {
-            p->avl.left = p1->avl.right;
-            p1->avl.right = p;
-            if (p1->avl.bal == 0)
-            {
-              p1->avl.bal = 1;
-              modified = false;
-            }
-            else
-            {
-              p->avl.bal = 0;
-              p1->avl.bal = 0;
-            }
-            p = p1;
-          }
-          else /* double LR-turn */
-          {
-            p2 = p1->avl.right;
-
-            p1->avl.right = p2->avl.left;
-            p2->avl.left = p1;
-            p->avl.left = p2->avl.right;
-            p2->avl.right = p;
-
-            if (p2->avl.bal == -1) p->avl.bal = 1; else p->avl.bal = 0;
-            if (p2->avl.bal == +1) p1->avl.bal = -1; else p1->avl.bal = 0;
-
-            p = p2;
-            p2->avl.bal = 0;
-          }
-          break;
-
-        default:
-          break;
-      }
-    }
-
-    if (buf_prev > buf_stack)
-    {
-      q = *(buf_prev - 1);
-
-      if (q->avl.cache == -1)
-      {
-        q->avl.left = p;
-      }
-      else
-      {
-        q->avl.right = p;
-      }
-    }
-    else
-    {
-      *root = p;
-      break;
-    }
-
-  }
-
-  return 0;
-}
+/**
+ * Unlock the mutex.
+ *
+ * @param lock The mutex to unlock.
+ */
+static void
+rtems_bdbuf_unlock (rtems_mutex *lock)
+{
+  rtems_mutex_unlock (lock);
+}
 
+/**
+ * Lock the cache. A single task can nest calls.
+ */
 static void
-rtems_bdbuf_set_state (rtems_bdbuf_buffer *bd, rtems_bdbuf_buf_state state)
+rtems_bdbuf_lock_cache (void)
 {
-  bd->state = state;
+  rtems_bdbuf_lock (&bdbuf_cache.lock);
 }
 
-static rtems_blkdev_bnum
-rtems_bdbuf_media_block (const rtems_disk_device *dd, rtems_blkdev_bnum block)
+/**
+ * Unlock the cache.
+ */
+static void
+rtems_bdbuf_unlock_cache (void)
 {
-  if (dd->block_to_media_block_shift >= 0)
-    return block << dd->block_to_media_block_shift;
-  else
-    /*
-     * Change the block number for the block size to the block number for the media
-     * block size. We have to use 64bit maths. There is no short cut here.
-     */
-    return (rtems_blkdev_bnum)
-      ((((uint64_t) block) * dd->block_size) / dd->media_block_size);
+  rtems_bdbuf_unlock (&bdbuf_cache.lock);
 }
 
 /**
- * Lock the mutex. A single task can nest calls.
- *
- * @param lock The mutex to lock.
+ * Lock the cache's sync. A single task can nest calls.
  */
 static void
-rtems_bdbuf_lock (rtems_mutex *lock)
+rtems_bdbuf_lock_sync (void)
 {
-  rtems_mutex_lock (lock);
+  rtems_bdbuf_lock (&bdbuf_cache.sync_lock);
 }
 
 /**
- * Unlock the mutex.
- *
- * @param lock The mutex to unlock.
+ * Unlock the cache's sync lock. Any blocked writers are woken.
  */
 static void
-rtems_bdbuf_unlock (rtems_mutex *lock)
+rtems_bdbuf_unlock_sync (void)
 {
-  rtems_mutex_unlock (lock);
+  rtems_bdbuf_unlock (&bdbuf_cache.sync_lock);
 }
 
 /**
- * Lock the cache. A single task can nest calls.
+ * Lock the partition.
+ *
+ * @param partition The partition to lock.
  */
 static void
-rtems_bdbuf_lock_cache (void)
+rtems_bdbuf_lock_partition (rtems_bdbuf_partition *partition)
 {
-  rtems_bdbuf_lock (&bdbuf_cache.lock);
+  rtems_bdbuf_lock (&partition->lock);
 }
 
 /**
- * Unlock the cache.
+ * Unlock the partition.
+ *
+ * @param partition The partition to unlock.
  */
 static void
-rtems_bdbuf_unlock_cache (void)
+rtems_bdbuf_unlock_partition (rtems_bdbuf_partition *partition)
 {
-  rtems_bdbuf_unlock (&bdbuf_cache.lock);
+  rtems_bdbuf_unlock (&partition->lock);
 }
 
 /**
- * Lock the cache's sync. A single task can nest calls.
+ * Lock all partitions in ascending index order.
  */
 static void
-rtems_bdbuf_lock_sync (void)
+rtems_bdbuf_lock_all_partitions (void)
 {
-  rtems_bdbuf_lock (&bdbuf_cache.sync_lock);
+  uint32_t p;
+
+  for (p = 0; p < bdbuf_cache.partition_count; ++p)
+    rtems_bdbuf_lock_partition (&bdbuf_cache.partitions [p]);
 }
 
 /**
- * Unlock the cache's sync lock. Any blocked writers are woken.
+ * Unlock all partitions.
  */
 static void
-rtems_bdbuf_unlock_sync (void)
+rtems_bdbuf_unlock_all_partitions (void)
 {
-  rtems_bdbuf_unlock (&bdbuf_cache.sync_lock);
+  uint32_t p = bdbuf_cache.partition_count;
+
+  while (p > 0)
+  {
+    --p;
+    rtems_bdbuf_unlock_partition (&bdbuf_cache.partitions [p]);
+  }
 }
 
 static void
@@ -878,34 +746,38 @@ rtems_bdbuf_group_release (rtems_bdbuf_buffer *bd)
  * be woken and this would require storage and we do not know the number of
  * tasks that could be waiting.
  *
- * While we have the cache locked we can try and claim the semaphore and
- * therefore know when we release the lock to the cache we will block until the
- * semaphore is released. This may even happen before we get to block.
+ * While we have the partition locked we can try and claim the semaphore and
+ * therefore know when we release the lock to the partition we will block
+ * until the semaphore is released. This may even happen before we get to
+ * block.
  *
  * A counter is used to save the release call when no one is waiting.
  *
- * The function assumes the cache is locked on entry and it will be locked on
- * exit.
+ * The function assumes the partition is locked on entry and it will be locked
+ * on exit.
  */
 static void
-rtems_bdbuf_anonymous_wait (rtems_bdbuf_waiters *waiters)
+rtems_bdbuf_anonymous_wait (rtems_bdbuf_partition *partition,
+                            rtems_bdbuf_waiters   *waiters)
 {
   /*
    * Indicate we are waiting.
    */
   ++waiters->count;
 
-  rtems_condition_variable_wait (&waiters->cond_var, &bdbuf_cache.lock);
+  rtems_condition_variable_wait (&waiters->cond_var, &partition->lock);
 
   --waiters->count;
 }
 
 static void
-rtems_bdbuf_wait (rtems_bdbuf_buffer *bd, rtems_bdbuf_waiters *waiters)
+rtems_bdbuf_wait (rtems_bdbuf_partition *partition,
+                  rtems_bdbuf_buffer    *bd,
+                  rtems_bdbuf_waiters   *waiters)
 {
   rtems_bdbuf_group_obtain (bd);
   ++bd->waiters;
-  rtems_bdbuf_anonymous_wait (waiters);
+  rtems_bdbuf_anonymous_wait (partition, waiters);
   --bd->waiters;
   rtems_bdbuf_group_release (bd);
 }
@@ -932,41 +804,108 @@ rtems_bdbuf_wake_swapper (void)
     rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_SO_WAKE_1);
 }
 
+/**
+ * Wakes the threads waiting for a buffer of the partition and the threads
+ * waiting for a buffer of any partition.  The partition must be locked.
+ *
+ * A starving waiter announces itself before it visits the other partitions.
+ * If it missed this buffer, then it visited this partition before the buffer
+ * was released and the partition lock orders the announcement before the read
+ * of the waiter count.
+ */
+static void
+rtems_bdbuf_wake_buffer_waiters (rtems_bdbuf_partition *partition)
+{
+  rtems_bdbuf_wake (&partition->buffer_waiters);
+
+  if (bdbuf_cache.starving_waiters.count > 0)
+  {
+    rtems_bdbuf_lock_cache ();
+    ++bdbuf_cache.starving_generation;
+    rtems_bdbuf_wake (&bdbuf_cache.starving_waiters);
+    rtems_bdbuf_unlock_cache ();
+  }
+}
+
 static bool
-rtems_bdbuf_has_buffer_waiters (void)
+rtems_bdbuf_has_buffer_waiters (const rtems_bdbuf_partition *partition)
 {
-  return bdbuf_cache.buffer_waiters.count;
+  return partition->buffer_waiters.count > 0
+    || bdbuf_cache.starving_waiters.count > 0;
 }
 
 static void
-rtems_bdbuf_remove_from_tree (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_remove_from_hash (rtems_bdbuf_partition *partition,
+                              rtems_bdbuf_buffer    *bd)
 {
-  if (rtems_bdbuf_avl_remove (&bdbuf_cache.tree, bd) != 0)
+  if (rtems_bdbuf_hash_remove (partition, bd) != 0)
     rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_TREE_RM);
 }
 
+/**
+ * Returns the count of minimum size buffers covered by the BD.
+ */
+static size_t
+rtems_bdbuf_buffer_size_in_min_buffers (const rtems_bdbuf_buffer *bd)
+{
+  return bdbuf_cache.max_bds_per_group / bd->group->bds_per_group;
+}
+
+/**
+ * Extracts the BD from the LRU list, the recently used list or any other list
+ * it is on.
+ */
+static void
+rtems_bdbuf_remove_from_lru_list (rtems_bdbuf_partition *partition,
+                                  rtems_bdbuf_buffer    *bd)
+{
+  if (bd->recent)
+  {
+    bd->recent = false;
+    partition->recent_size -= rtems_bdbuf_buffer_size_in_min_buffers (bd);
+  }
+
+  rtems_chain_extract_unprotected (&bd->link);
+}
+
+/**
+ * Extracts an accessed BD from the recently used list before it moves to
+ * another list or becomes free.
+ */
+static void
+rtems_bdbuf_remove_from_recent_list (rtems_bdbuf_partition *partition,
+                                     rtems_bdbuf_buffer    *bd)
+{
+  if (bd->recent)
+    rtems_bdbuf_remove_from_lru_list (partition, bd);
+}
+
 static void
-rtems_bdbuf_remove_from_tree_and_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_remove_from_hash_and_lru_list (rtems_bdbuf_partition *partition,
+                                           rtems_bdbuf_buffer    *bd)
 {
   switch (bd->state)
   {
     case RTEMS_BDBUF_STATE_FREE:
       break;
     case RTEMS_BDBUF_STATE_CACHED:
-      rtems_bdbuf_remove_from_tree (bd);
+      if (!bd->hot)
+        rtems_bdbuf_ghost_add (partition, bd);
+      rtems_bdbuf_remove_from_hash (partition, bd);
       break;
     default:
       rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_10);
   }
 
-  rtems_chain_extract_unprotected (&bd->link);
+  rtems_bdbuf_remove_from_lru_list (partition, bd);
 }
 
 static void
-rtems_bdbuf_make_free_and_add_to_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_make_free_and_add_to_lru_list (rtems_bdbuf_partition *partition,
+                                           rtems_bdbuf_buffer    *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_FREE);
-  rtems_chain_prepend_unprotected (&bdbuf_cache.lru, &bd->link);
+  rtems_chain_prepend_unprotected (&partition->lru, &bd->link);
 }
 
 static void
@@ -976,30 +915,46 @@ rtems_bdbuf_make_empty (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_make_cached_and_add_to_lru_list (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_make_cached_and_add_to_lru_list (rtems_bdbuf_partition *partition,
+                                             rtems_bdbuf_buffer    *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_CACHED);
-  rtems_chain_append_unprotected (&bdbuf_cache.lru, &bd->link);
+
+  /*
+   * A buffer accessed while it is on the recently used list keeps its
+   * position, so that the list stays in first insertion order.
+   */
+  if (bd->hot)
+    rtems_chain_append_unprotected (&partition->lru, &bd->link);
+  else if (!bd->recent)
+  {
+    bd->recent = true;
+    partition->recent_size += rtems_bdbuf_buffer_size_in_min_buffers (bd);
+    rtems_chain_append_unprotected (&partition->recent, &bd->link);
+  }
 }
 
 static void
-rtems_bdbuf_discard_buffer (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_discard_buffer (rtems_bdbuf_partition *partition,
+                            rtems_bdbuf_buffer    *bd)
 {
+  rtems_bdbuf_remove_from_recent_list (partition, bd);
   rtems_bdbuf_make_empty (bd);
 
   if (bd->waiters == 0)
   {
-    rtems_bdbuf_remove_from_tree (bd);
-    rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+    rtems_bdbuf_remove_from_hash (partition, bd);
+    rtems_bdbuf_make_free_and_add_to_lru_list (partition, bd);
   }
 }
 
 static void
-rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_partition *partition,
+                                               rtems_bdbuf_buffer    *bd)
 {
   if (bdbuf_cache.sync_active && bdbuf_cache.sync_device == bd->dd)
   {
-    rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_unlock_partition (partition);
 
     /*
      * Wait for the sync lock.
@@ -1007,7 +962,7 @@ rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
     rtems_bdbuf_lock_sync ();
 
     rtems_bdbuf_unlock_sync ();
-    rtems_bdbuf_lock_cache ();
+    rtems_bdbuf_lock_partition (partition);
   }
 
   /*
@@ -1025,25 +980,27 @@ rtems_bdbuf_add_to_modified_list_after_access (rtems_bdbuf_buffer *bd)
         || bd->state == RTEMS_BDBUF_STATE_ACCESS_EMPTY)
     bd->hold_timer = bdbuf_config.swap_block_hold;
 
+  rtems_bdbuf_remove_from_recent_list (partition, bd);
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_MODIFIED);
-  rtems_chain_append_unprotected (&bdbuf_cache.modified, &bd->link);
+  rtems_chain_append_unprotected (&partition->modified, &bd->link);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
-  else if (rtems_bdbuf_has_buffer_waiters ())
+    rtems_bdbuf_wake (&partition->access_waiters);
+  else if (rtems_bdbuf_has_buffer_waiters (partition))
     rtems_bdbuf_wake_swapper ();
 }
 
 static void
-rtems_bdbuf_add_to_lru_list_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_add_to_lru_list_after_access (rtems_bdbuf_partition *partition,
+                                          rtems_bdbuf_buffer    *bd)
 {
   rtems_bdbuf_group_release (bd);
-  rtems_bdbuf_make_cached_and_add_to_lru_list (bd);
+  rtems_bdbuf_make_cached_and_add_to_lru_list (partition, bd);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&partition->access_waiters);
   else
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake_buffer_waiters (partition);
 }
 
 /**
@@ -1071,28 +1028,32 @@ rtems_bdbuf_bds_per_group (size_t size)
 }
 
 static void
-rtems_bdbuf_discard_buffer_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_discard_buffer_after_access (rtems_bdbuf_partition *partition,
+                                         rtems_bdbuf_buffer    *bd)
 {
   rtems_bdbuf_group_release (bd);
-  rtems_bdbuf_discard_buffer (bd);
+  rtems_bdbuf_discard_buffer (partition, bd);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&partition->access_waiters);
   else
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake_buffer_waiters (partition);
 }
 
 /**
  * Reallocate a group. The BDs currently allocated in the group are removed
- * from the ALV tree and any lists then the new BD's are prepended to the ready
- * list of the cache.
+ * from the hash table and any lists then the new BD's are prepended to the
+ * ready list of the partition.
  *
+ * @param partition The partition of the group.
  * @param group The group to reallocate.
  * @param new_bds_per_group The new count of BDs per group.
  * @return A buffer of this group.
  */
 static rtems_bdbuf_buffer *
-rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
+rtems_bdbuf_group_realloc (rtems_bdbuf_partition *partition,
+                           rtems_bdbuf_group     *group,
+                           size_t                 new_bds_per_group)
 {
   rtems_bdbuf_buffer* bd;
   size_t              b;
@@ -1108,7 +1069,7 @@ rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
   for (b = 0, bd = group->bdbuf;
        b < group->bds_per_group;
        b++, bd += bufs_per_bd)
-    rtems_bdbuf_remove_from_tree_and_lru_list (bd);
+    rtems_bdbuf_remove_from_hash_and_lru_list (partition, bd);
 
   group->bds_per_group = new_bds_per_group;
   bufs_per_bd = bdbuf_cache.max_bds_per_group / new_bds_per_group;
@@ -1116,38 +1077,47 @@ rtems_bdbuf_group_realloc (rtems_bdbuf_group* group, size_t new_bds_per_group)
   for (b = 1, bd = group->bdbuf + bufs_per_bd;
        b < group->bds_per_group;
        b++, bd += bufs_per_bd)
-    rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+    rtems_bdbuf_make_free_and_add_to_lru_list (partition, bd);
 
   if (b > 1)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake_buffer_waiters (partition);
 
   return group->bdbuf;
 }
 
 static void
-rtems_bdbuf_setup_empty_buffer (rtems_bdbuf_buffer *bd,
-                                rtems_disk_device  *dd,
-                                rtems_blkdev_bnum   block)
+rtems_bdbuf_setup_empty_buffer (rtems_bdbuf_partition *partition,
+                                rtems_bdbuf_buffer    *bd,
+                                rtems_disk_device     *dd,
+                                rtems_blkdev_bnum      block)
 {
   bd->dd        = dd ;
   bd->block     = block;
-  bd->avl.left  = NULL;
-  bd->avl.right = NULL;
+  bd->hash_next = NULL;
   bd->waiters   = 0;
 
-  if (rtems_bdbuf_avl_insert (&bdbuf_cache.tree, bd) != 0)
+  /*
+   * With the LRU policy all buffers are hot.  With the 2Q policy only blocks
+   * recycled from the recently used list shortly before are hot.
+   */
+  bd->hot = bdbuf_config.replacement_policy != RTEMS_BDBUF_REPLACEMENT_2Q
+    || rtems_bdbuf_ghost_hit (partition, dd, block);
+
+  if (rtems_bdbuf_hash_insert (partition, bd) != 0)
     rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RECYCLE);
 
   rtems_bdbuf_make_empty (bd);
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_from_lru_list (rtems_disk_device *dd,
-                                      rtems_blkdev_bnum  block)
+rtems_bdbuf_get_buffer_from_list (rtems_bdbuf_partition *partition,
+                                  rtems_chain_control   *list,
+                                  rtems_disk_device     *dd,
+                                  rtems_blkdev_bnum      block)
 {
-  rtems_chain_node *node = rtems_chain_first (&bdbuf_cache.lru);
+  rtems_chain_node *node = rtems_chain_first (list);
 
-  while (!rtems_chain_is_tail (&bdbuf_cache.lru, node))
+  while (!rtems_chain_is_tail (list, node))
   {
     rtems_bdbuf_buffer *bd = (rtems_bdbuf_buffer *) node;
     rtems_bdbuf_buffer *empty_bd = NULL;
@@ -1159,23 +1129,26 @@ rtems_bdbuf_get_buffer_from_lru_list (rtems_disk_device *dd,
               bd->group->bds_per_group, dd->bds_per_group);
 
     /*
-     * If nobody waits for this BD, we may recycle it.
+     * If nobody waits for this BD, we may recycle it.  Accessed buffers stay
+     * on the recently used list.
      */
-    if (bd->waiters == 0)
+    if (bd->waiters == 0
+        && (!bd->recent || bd->state == RTEMS_BDBUF_STATE_CACHED))
     {
       if (bd->group->bds_per_group == dd->bds_per_group)
       {
-        rtems_bdbuf_remove_from_tree_and_lru_list (bd);
+        rtems_bdbuf_remove_from_hash_and_lru_list (partition, bd);
 
         empty_bd = bd;
       }
       else if (bd->group->users == 0)
-        empty_bd = rtems_bdbuf_group_realloc (bd->group, dd->bds_per_group);
+        empty_bd = rtems_bdbuf_group_realloc (partition, bd->group,
+                                              dd->bds_per_group);
     }
 
     if (empty_bd != NULL)
     {
-      rtems_bdbuf_setup_empty_buffer (empty_bd, dd, block);
+      rtems_bdbuf_setup_empty_buffer (partition, empty_bd, dd, block);
 
       return empty_bd;
     }
@@ -1186,6 +1159,200 @@ rtems_bdbuf_get_buffer_from_lru_list (rtems_disk_device *dd,
   return NULL;
 }
 
+static bool
+rtems_bdbuf_has_free_buffer (const rtems_bdbuf_partition *partition)
+{
+  const rtems_chain_control *lru = &partition->lru;
+
+  return !rtems_chain_is_empty (lru)
+    && ((const rtems_bdbuf_buffer *) rtems_chain_immutable_first (lru))->state
+      == RTEMS_BDBUF_STATE_FREE;
+}
+
+/**
+ * Recycles a buffer for the dd/block.  Free buffers are at the head of the LRU
+ * list.  The recently used list is recycled first if it exceeds its share of
+ * the partition, otherwise the LRU list.
+ */
+static rtems_bdbuf_buffer *
+rtems_bdbuf_get_buffer_from_lru_list (rtems_bdbuf_partition *partition,
+                                      rtems_disk_device     *dd,
+                                      rtems_blkdev_bnum      block)
+{
+  rtems_bdbuf_buffer *bd = NULL;
+
+  if (partition->recent_size > partition->recent_max
+      && !rtems_bdbuf_has_free_buffer (partition))
+    bd = rtems_bdbuf_get_buffer_from_list (partition, &partition->recent,
+                                           dd, block);
+
+  if (bd == NULL)
+    bd = rtems_bdbuf_get_buffer_from_list (partition, &partition->lru,
+                                           dd, block);
+
+  if (bd == NULL)
+    bd = rtems_bdbuf_get_buffer_from_list (partition, &partition->recent,
+                                           dd, block);
+
+  return bd;
+}
+
+/**
+ * Sets the count of groups owned by the partition.  The 2Q policy limits the
+ * recently used list to a quarter of the minimum size buffers of the
+ * partition.
+ */
+static void
+rtems_bdbuf_partition_set_group_count (rtems_bdbuf_partition *partition,
+                                       size_t                 group_count)
+{
+  partition->group_count = group_count;
+
+  if (bdbuf_config.replacement_policy == RTEMS_BDBUF_REPLACEMENT_2Q)
+    partition->recent_max =
+      (group_count * bdbuf_cache.max_bds_per_group) / 4;
+}
+
+/**
+ * Returns true if no buffer of the group is in use, on the modified list or
+ * in a transfer and nobody waits for one of its buffers.
+ */
+static bool
+rtems_bdbuf_group_is_idle (const rtems_bdbuf_group *group)
+{
+  const rtems_bdbuf_buffer* bd;
+  size_t                    b;
+  size_t                    bufs_per_bd;
+
+  if (group->users != 0)
+    return false;
+
+  bufs_per_bd = bdbuf_cache.max_bds_per_group / group->bds_per_group;
+
+  for (b = 0, bd = group->bdbuf;
+       b < group->bds_per_group;
+       b++, bd += bufs_per_bd)
+  {
+    if (bd->waiters != 0
+        || (bd->state != RTEMS_BDBUF_STATE_FREE
+          && bd->state != RTEMS_BDBUF_STATE_CACHED))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Moves an idle group of the victim partition to the partition.  The buffers
+ * of the group become free buffers of the partition.  The victim keeps at
+ * least one group.  Both partitions must be locked.
+ *
+ * @retval true A group was moved.
+ * @retval false The victim has no idle group to spare.
+ */
+static bool
+rtems_bdbuf_move_idle_group (rtems_bdbuf_partition *victim,
+                             rtems_bdbuf_partition *partition)
+{
+  rtems_chain_control* lists [2] = { &victim->lru, &victim->recent };
+  size_t               l;
+
+  if (victim->group_count <= 1)
+    return false;
+
+  for (l = 0; l < RTEMS_ARRAY_SIZE (lists); ++l)
+  {
+    rtems_chain_node* node = rtems_chain_first (lists [l]);
+
+    while (!rtems_chain_is_tail (lists [l], node))
+    {
+      rtems_bdbuf_group* group = ((rtems_bdbuf_buffer *) node)->group;
+
+      if (rtems_bdbuf_group_is_idle (group))
+      {
+        rtems_bdbuf_buffer* bd;
+        size_t              b;
+        size_t              bufs_per_bd;
+
+        if (rtems_bdbuf_tracer)
+          printf ("bdbuf:move-group: %tu: %tu -> %tu\n",
+                  group - bdbuf_cache.groups,
+                  victim - bdbuf_cache.partitions,
+                  partition - bdbuf_cache.partitions);
+
+        bufs_per_bd = bdbuf_cache.max_bds_per_group / group->bds_per_group;
+
+        for (b = 0, bd = group->bdbuf;
+             b < group->bds_per_group;
+             b++, bd += bufs_per_bd)
+        {
+          rtems_bdbuf_remove_from_hash_and_lru_list (victim, bd);
+          rtems_bdbuf_make_free_and_add_to_lru_list (partition, bd);
+        }
+
+        group->partition = (uint32_t) (partition - bdbuf_cache.partitions);
+        rtems_bdbuf_partition_set_group_count (victim,
+                                               victim->group_count - 1);
+        rtems_bdbuf_partition_set_group_count (partition,
+                                               partition->group_count + 1);
+
+        return true;
+      }
+
+      node = rtems_chain_next (node);
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Takes an idle group from another partition.  The partition lock is released
+ * and the partitions are locked in ascending index order, so the caller must
+ * search the partition again.  The partition is locked on exit.
+ *
+ * @retval true A group was moved to the partition.
+ * @retval false No other partition has an idle group to spare.
+ */
+static bool
+rtems_bdbuf_steal_group (rtems_bdbuf_partition *partition)
+{
+  uint32_t index = (uint32_t) (partition - bdbuf_cache.partitions);
+  uint32_t i;
+  bool     moved = false;
+
+  rtems_bdbuf_unlock_partition (partition);
+
+  for (i = 1; !moved && i < bdbuf_cache.partition_count; ++i)
+  {
+    rtems_bdbuf_partition *victim =
+      &bdbuf_cache.partitions [(index + i) % bdbuf_cache.partition_count];
+
+    if (victim < partition)
+    {
+      rtems_bdbuf_lock_partition (victim);
+      rtems_bdbuf_lock_partition (partition);
+    }
+    else
+    {
+      rtems_bdbuf_lock_partition (partition);
+      rtems_bdbuf_lock_partition (victim);
+    }
+
+    moved = rtems_bdbuf_move_idle_group (victim, partition);
+
+    rtems_bdbuf_unlock_partition (victim);
+
+    if (!moved)
+      rtems_bdbuf_unlock_partition (partition);
+  }
+
+  if (!moved)
+    rtems_bdbuf_lock_partition (partition);
+
+  return moved;
+}
+
 static rtems_status_code
 rtems_bdbuf_create_task(
   rtems_name name,
@@ -1210,6 +1377,33 @@ rtems_bdbuf_create_task(
   return sc;
 }
 
+static size_t
+rtems_bdbuf_swapout_request_size (void)
+{
+  return sizeof (rtems_blkdev_request)
+    + (bdbuf_config.max_write_blocks * sizeof (rtems_blkdev_sg_buffer));
+}
+
+static size_t
+rtems_bdbuf_swapout_transfer_size (void)
+{
+  return offsetof (rtems_bdbuf_swapout_transfer, write_req)
+    + (bdbuf_config.swapout_queue_depth * rtems_bdbuf_swapout_request_size ());
+}
+
+/**
+ * Returns the write request of the transfer queue with the specified index.
+ */
+static rtems_blkdev_request *
+rtems_bdbuf_swapout_request (rtems_bdbuf_swapout_transfer *transfer,
+                             uint32_t                      index)
+{
+  char *first = (char *) &transfer->write_req;
+
+  return (rtems_blkdev_request *)
+    (first + index * rtems_bdbuf_swapout_request_size ());
+}
+
 static rtems_bdbuf_swapout_transfer*
 rtems_bdbuf_swapout_transfer_alloc (void)
 {
@@ -1219,9 +1413,7 @@ rtems_bdbuf_swapout_transfer_alloc (void)
    * have been a rtems_chain_control. Simple, fast and less storage as the node
    * is already part of the buffer structure.
    */
-  size_t transfer_size = sizeof (rtems_bdbuf_swapout_transfer)
-    + (bdbuf_config.max_write_blocks * sizeof (rtems_blkdev_sg_buffer));
-  return calloc (1, transfer_size);
+  return calloc (1, rtems_bdbuf_swapout_transfer_size ());
 }
 
 static void
@@ -1231,19 +1423,28 @@ static void
 rtems_bdbuf_swapout_transfer_init (rtems_bdbuf_swapout_transfer* transfer,
                                    rtems_id id)
 {
+  uint32_t i;
+
   rtems_chain_initialize_empty (&transfer->bds);
   transfer->dd = BDBUF_INVALID_DEV;
   transfer->syncing = false;
-  transfer->write_req.req = RTEMS_BLKDEV_REQ_WRITE;
-  transfer->write_req.done = rtems_bdbuf_transfer_done;
-  transfer->write_req.io_task = id;
-}
 
-static size_t
+  for (i = 0; i < bdbuf_config.swapout_queue_depth; ++i)
+  {
+    rtems_blkdev_request *req = rtems_bdbuf_swapout_request (transfer, i);
+
+    req->req = RTEMS_BLKDEV_REQ_WRITE;
+    req->done = rtems_bdbuf_transfer_done;
+    req->io_task = id;
+    req->bufnum = 0;
+  }
+}
+
+static size_t
 rtems_bdbuf_swapout_worker_size (void)
 {
-  return sizeof (rtems_bdbuf_swapout_worker)
-    + (bdbuf_config.max_write_blocks * sizeof (rtems_blkdev_sg_buffer));
+  return offsetof (rtems_bdbuf_swapout_worker, transfer)
+    + rtems_bdbuf_swapout_transfer_size ();
 }
 
 static rtems_task
@@ -1289,6 +1490,26 @@ rtems_bdbuf_swapout_workers_create (void)
   return sc;
 }
 
+static void
+rtems_bdbuf_partition_init (rtems_bdbuf_partition *partition,
+                            rtems_bdbuf_buffer   **hash,
+                            size_t                 hash_size)
+{
+  rtems_mutex_init (&partition->lock, "bdbuf partition");
+  partition->hash = hash;
+  partition->hash_mask = hash_size - 1;
+  rtems_chain_initialize_empty (&partition->lru);
+  rtems_chain_initialize_empty (&partition->recent);
+  rtems_chain_initialize_empty (&partition->modified);
+  rtems_chain_initialize_empty (&partition->sync);
+  rtems_condition_variable_init (&partition->access_waiters.cond_var,
+                                 "bdbuf access");
+  rtems_condition_variable_init (&partition->transfer_waiters.cond_var,
+                                 "bdbuf transfer");
+  rtems_condition_variable_init (&partition->buffer_waiters.cond_var,
+                                 "bdbuf buffer");
+}
+
 static size_t
 rtems_bdbuf_read_request_size (uint32_t transfer_count)
 {
@@ -1303,6 +1524,11 @@ rtems_bdbuf_do_init (void)
   rtems_bdbuf_buffer* bd;
   uint8_t*            buffer;
   size_t              b;
+  size_t              hash_size;
+  size_t              groups_per_partition;
+  size_t              ghost_count = 0;
+  size_t              ghost_index = 0;
+  uint32_t            p;
   rtems_status_code   sc;
 
   if (rtems_bdbuf_tracer)
@@ -1322,22 +1548,18 @@ rtems_bdbuf_do_init (void)
       > RTEMS_MINIMUM_STACK_SIZE / 8U)
     return RTEMS_INVALID_NUMBER;
 
+  if (bdbuf_config.swapout_queue_depth == 0)
+    return RTEMS_INVALID_NUMBER;
+
   bdbuf_cache.sync_device = BDBUF_INVALID_DEV;
 
   rtems_chain_initialize_empty (&bdbuf_cache.swapout_free_workers);
-  rtems_chain_initialize_empty (&bdbuf_cache.lru);
-  rtems_chain_initialize_empty (&bdbuf_cache.modified);
-  rtems_chain_initialize_empty (&bdbuf_cache.sync);
   rtems_chain_initialize_empty (&bdbuf_cache.read_ahead_chain);
 
   rtems_mutex_set_name (&bdbuf_cache.lock, "bdbuf lock");
   rtems_mutex_set_name (&bdbuf_cache.sync_lock, "bdbuf sync lock");
-  rtems_condition_variable_set_name (&bdbuf_cache.access_waiters.cond_var,
-                                     "bdbuf access");
-  rtems_condition_variable_set_name (&bdbuf_cache.transfer_waiters.cond_var,
-                                     "bdbuf transfer");
-  rtems_condition_variable_set_name (&bdbuf_cache.buffer_waiters.cond_var,
-                                     "bdbuf buffer");
+  rtems_condition_variable_init (&bdbuf_cache.starving_waiters.cond_var,
+                                 "bdbuf starving");
 
   rtems_bdbuf_lock_cache ();
 
@@ -1351,6 +1573,86 @@ rtems_bdbuf_do_init (void)
   bdbuf_cache.group_count =
     bdbuf_cache.buffer_min_count / bdbuf_cache.max_bds_per_group;
 
+  /*
+   * Each partition needs at least one group.
+   */
+  bdbuf_cache.partition_count = bdbuf_config.partitions;
+  if (bdbuf_cache.partition_count > bdbuf_cache.group_count)
+    bdbuf_cache.partition_count = bdbuf_cache.group_count;
+  if (bdbuf_cache.partition_count == 0)
+    bdbuf_cache.partition_count = 1;
+
+  /*
+   * Use a hash table size of a power of two with at least one bucket per
+   * minimum size buffer of the partition.
+   */
+  for (hash_size = 1;
+       hash_size * bdbuf_cache.partition_count < bdbuf_cache.buffer_min_count;
+       hash_size <<= 1)
+    ;
+
+  /*
+   * Allocate the memory for the partitions and their hash tables.
+   */
+  bdbuf_cache.partitions = calloc (sizeof (rtems_bdbuf_partition),
+                                   bdbuf_cache.partition_count);
+  if (!bdbuf_cache.partitions)
+    goto error;
+
+  bdbuf_cache.hash = calloc (sizeof (rtems_bdbuf_buffer*),
+                             hash_size * bdbuf_cache.partition_count);
+  if (!bdbuf_cache.hash)
+    goto error;
+
+  /*
+   * Each partition owns a contiguous range of groups.  The last partition
+   * owns the groups which remain from the division.  The 2Q policy remembers
+   * half as many recycled blocks as minimum size buffers fit into the groups
+   * of a partition.
+   */
+  groups_per_partition = bdbuf_cache.group_count / bdbuf_cache.partition_count;
+
+  if (bdbuf_config.replacement_policy == RTEMS_BDBUF_REPLACEMENT_2Q)
+  {
+    ghost_count = (bdbuf_cache.group_count * bdbuf_cache.max_bds_per_group) / 2
+      + bdbuf_cache.partition_count;
+
+    bdbuf_cache.ghosts = calloc (sizeof (rtems_bdbuf_ghost), ghost_count);
+    if (!bdbuf_cache.ghosts)
+      goto error;
+
+    bdbuf_cache.ghost_hash = calloc (sizeof (rtems_bdbuf_ghost*),
+                                     hash_size * bdbuf_cache.partition_count);
+    if (!bdbuf_cache.ghost_hash)
+      goto error;
+  }
+
+  for (p = 0; p < bdbuf_cache.partition_count; p++)
+  {
+    rtems_bdbuf_partition *partition = &bdbuf_cache.partitions[p];
+    size_t                 group_count = groups_per_partition;
+
+    if (p == bdbuf_cache.partition_count - 1)
+      group_count = bdbuf_cache.group_count - p * groups_per_partition;
+
+    rtems_bdbuf_partition_init (partition,
+                                &bdbuf_cache.hash[p * hash_size],
+                                hash_size);
+    rtems_bdbuf_partition_set_group_count (partition, group_count);
+
+    if (ghost_count > 0)
+    {
+      partition->ghost_count =
+        (group_count * bdbuf_cache.max_bds_per_group) / 2;
+      if (partition->ghost_count == 0)
+        partition->ghost_count = 1;
+
+      partition->ghosts = &bdbuf_cache.ghosts[ghost_index];
+      partition->ghost_hash = &bdbuf_cache.ghost_hash[p * hash_size];
+      ghost_index += partition->ghost_count;
+    }
+  }
+
   /*
    * Allocate the memory for the buffer descriptors.
    */
@@ -1378,37 +1680,42 @@ rtems_bdbuf_do_init (void)
     goto error;
 
   /*
-   * The cache is empty after opening so we need to add all the buffers to it
-   * and initialise the groups.
+   * The cache is empty after opening so we need to initialise the groups and
+   * add all the buffers to it.
    */
+  for (b = 0,
+         group = bdbuf_cache.groups,
+         bd = bdbuf_cache.bds;
+       b < bdbuf_cache.group_count;
+       b++,
+         group++,
+         bd += bdbuf_cache.max_bds_per_group)
+  {
+    group->bds_per_group = bdbuf_cache.max_bds_per_group;
+    group->bdbuf = bd;
+    group->partition = (uint32_t) (b / groups_per_partition);
+
+    if (group->partition >= bdbuf_cache.partition_count)
+      group->partition = bdbuf_cache.partition_count - 1;
+  }
+
   for (b = 0, group = bdbuf_cache.groups,
          bd = bdbuf_cache.bds, buffer = bdbuf_cache.buffers;
-       b < bdbuf_cache.buffer_min_count;
+       b < bdbuf_cache.group_count * bdbuf_cache.max_bds_per_group;
        b++, bd++, buffer += bdbuf_config.buffer_min)
   {
     bd->dd    = BDBUF_INVALID_DEV;
     bd->group  = group;
     bd->buffer = buffer;
 
-    rtems_chain_append_unprotected (&bdbuf_cache.lru, &bd->link);
+    rtems_chain_append_unprotected (&rtems_bdbuf_get_partition_of_bd (bd)->lru,
+                                    &bd->link);
 
     if ((b % bdbuf_cache.max_bds_per_group) ==
         (bdbuf_cache.max_bds_per_group - 1))
       group++;
   }
 
-  for (b = 0,
-         group = bdbuf_cache.groups,
-         bd = bdbuf_cache.bds;
-       b < bdbuf_cache.group_count;
-       b++,
-         group++,
-         bd += bdbuf_cache.max_bds_per_group)
-  {
-    group->bds_per_group = bdbuf_cache.max_bds_per_group;
-    group->bdbuf = bd;
-  }
-
   /*
    * Create and start swapout task.
    */
@@ -1491,6 +1798,10 @@ error:
   free (bdbuf_cache.buffers);
   free (bdbuf_cache.groups);
   free (bdbuf_cache.bds);
+  free (bdbuf_cache.ghost_hash);
+  free (bdbuf_cache.ghosts);
+  free (bdbuf_cache.hash);
+  free (bdbuf_cache.partitions);
   free (bdbuf_cache.swapout_transfer);
   free (bdbuf_cache.swapout_workers);
 
@@ -1543,7 +1854,8 @@ rtems_bdbuf_wait_for_transient_event (void)
 }
 
 static void
-rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_access (rtems_bdbuf_partition *partition,
+                             rtems_bdbuf_buffer    *bd)
 {
   while (true)
   {
@@ -1553,7 +1865,8 @@ rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
         rtems_bdbuf_group_release (bd);
         /* Fall through */
       case RTEMS_BDBUF_STATE_CACHED:
-        rtems_chain_extract_unprotected (&bd->link);
+        if (!bd->recent)
+          rtems_bdbuf_remove_from_lru_list (partition, bd);
         /* Fall through */
       case RTEMS_BDBUF_STATE_EMPTY:
         return;
@@ -1561,12 +1874,12 @@ rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
       case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
       case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.access_waiters);
+        rtems_bdbuf_wait (partition, bd, &partition->access_waiters);
         break;
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (partition, bd, &partition->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_7);
@@ -1575,11 +1888,12 @@ rtems_bdbuf_wait_for_access (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_partition *partition,
+                                              rtems_bdbuf_buffer    *bd)
 {
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_SYNC);
   rtems_chain_extract_unprotected (&bd->link);
-  rtems_chain_append_unprotected (&bdbuf_cache.sync, &bd->link);
+  rtems_chain_append_unprotected (&partition->sync, &bd->link);
   rtems_bdbuf_wake_swapper ();
 }
 
@@ -1590,7 +1904,8 @@ rtems_bdbuf_request_sync_for_modified_buffer (rtems_bdbuf_buffer *bd)
  * @retval @c false Buffer is invalid and has to searched again.
  */
 static bool
-rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_recycle (rtems_bdbuf_partition *partition,
+                              rtems_bdbuf_buffer    *bd)
 {
   while (true)
   {
@@ -1599,7 +1914,7 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_FREE:
         return true;
       case RTEMS_BDBUF_STATE_MODIFIED:
-        rtems_bdbuf_request_sync_for_modified_buffer (bd);
+        rtems_bdbuf_request_sync_for_modified_buffer (partition, bd);
         break;
       case RTEMS_BDBUF_STATE_CACHED:
       case RTEMS_BDBUF_STATE_EMPTY:
@@ -1613,19 +1928,19 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
            * pong with another recycle waiter.  The state of the buffer is
            * arbitrary afterwards.
            */
-          rtems_bdbuf_anonymous_wait (&bdbuf_cache.buffer_waiters);
+          rtems_bdbuf_anonymous_wait (partition, &partition->buffer_waiters);
           return false;
         }
       case RTEMS_BDBUF_STATE_ACCESS_CACHED:
       case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
       case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
       case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.access_waiters);
+        rtems_bdbuf_wait (partition, bd, &partition->access_waiters);
         break;
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (partition, bd, &partition->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_8);
@@ -1634,7 +1949,8 @@ rtems_bdbuf_wait_for_recycle (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_partition *partition,
+                                rtems_bdbuf_buffer    *bd)
 {
   while (true)
   {
@@ -1651,7 +1967,7 @@ rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
       case RTEMS_BDBUF_STATE_SYNC:
       case RTEMS_BDBUF_STATE_TRANSFER:
       case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
-        rtems_bdbuf_wait (bd, &bdbuf_cache.transfer_waiters);
+        rtems_bdbuf_wait (partition, bd, &partition->transfer_waiters);
         break;
       default:
         rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_9);
@@ -1660,26 +1976,77 @@ rtems_bdbuf_wait_for_sync_done (rtems_bdbuf_buffer *bd)
 }
 
 static void
-rtems_bdbuf_wait_for_buffer (void)
+rtems_bdbuf_wait_for_buffer (rtems_bdbuf_partition *partition)
 {
-  if (!rtems_chain_is_empty (&bdbuf_cache.modified))
+  if (!rtems_chain_is_empty (&partition->modified))
     rtems_bdbuf_wake_swapper ();
 
-  rtems_bdbuf_anonymous_wait (&bdbuf_cache.buffer_waiters);
+  rtems_bdbuf_anonymous_wait (partition, &partition->buffer_waiters);
 }
 
+/**
+ * Waits for a buffer if there is more than one partition.  An idle group of
+ * another partition is taken if possible, otherwise the thread waits until a
+ * buffer of any partition is released.  The partition lock is released in
+ * between, so the caller must search the partition again.
+ */
 static void
-rtems_bdbuf_sync_after_access (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_wait_for_any_buffer (rtems_bdbuf_partition *partition)
 {
+  uint32_t generation;
+  bool     moved;
+
+  /*
+   * Announce the wait before the other partitions are visited, so that a
+   * buffer released after the visit of its partition changes the generation.
+   */
+  rtems_bdbuf_lock_cache ();
+  ++bdbuf_cache.starving_waiters.count;
+  generation = bdbuf_cache.starving_generation;
+  rtems_bdbuf_unlock_cache ();
+
+  moved = rtems_bdbuf_steal_group (partition);
+
+  if (!moved)
+  {
+    /*
+     * The modified buffers of all partitions are written immediately while
+     * there are starving waiters.
+     */
+    rtems_bdbuf_wake_swapper ();
+    rtems_bdbuf_unlock_partition (partition);
+  }
+
+  rtems_bdbuf_lock_cache ();
+
+  if (!moved)
+  {
+    while (generation == bdbuf_cache.starving_generation)
+      rtems_condition_variable_wait (&bdbuf_cache.starving_waiters.cond_var,
+                                     &bdbuf_cache.lock);
+  }
+
+  --bdbuf_cache.starving_waiters.count;
+  rtems_bdbuf_unlock_cache ();
+
+  if (!moved)
+    rtems_bdbuf_lock_partition (partition);
+}
+
+static void
+rtems_bdbuf_sync_after_access (rtems_bdbuf_partition *partition,
+                               rtems_bdbuf_buffer    *bd)
+{
+  rtems_bdbuf_remove_from_recent_list (partition, bd);
   rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_SYNC);
 
-  rtems_chain_append_unprotected (&bdbuf_cache.sync, &bd->link);
+  rtems_chain_append_unprotected (&partition->sync, &bd->link);
 
   if (bd->waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.access_waiters);
+    rtems_bdbuf_wake (&partition->access_waiters);
 
   rtems_bdbuf_wake_swapper ();
-  rtems_bdbuf_wait_for_sync_done (bd);
+  rtems_bdbuf_wait_for_sync_done (partition, bd);
 
   /*
    * We may have created a cached or empty buffer which may be recycled.
@@ -1690,24 +2057,25 @@ rtems_bdbuf_sync_after_access (rtems_bdbuf_buffer *bd)
   {
     if (bd->state == RTEMS_BDBUF_STATE_EMPTY)
     {
-      rtems_bdbuf_remove_from_tree (bd);
-      rtems_bdbuf_make_free_and_add_to_lru_list (bd);
+      rtems_bdbuf_remove_from_hash (partition, bd);
+      rtems_bdbuf_make_free_and_add_to_lru_list (partition, bd);
     }
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake_buffer_waiters (partition);
   }
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_for_read_ahead (rtems_disk_device *dd,
-                                       rtems_blkdev_bnum  block)
+rtems_bdbuf_get_buffer_for_read_ahead (rtems_bdbuf_partition *partition,
+                                       rtems_disk_device     *dd,
+                                       rtems_blkdev_bnum      block)
 {
   rtems_bdbuf_buffer *bd = NULL;
 
-  bd = rtems_bdbuf_avl_search (&bdbuf_cache.tree, dd, block);
+  bd = rtems_bdbuf_hash_search (partition, dd, block);
 
   if (bd == NULL)
   {
-    bd = rtems_bdbuf_get_buffer_from_lru_list (dd, block);
+    bd = rtems_bdbuf_get_buffer_from_lru_list (partition, dd, block);
 
     if (bd != NULL)
       rtems_bdbuf_group_obtain (bd);
@@ -1723,39 +2091,45 @@ rtems_bdbuf_get_buffer_for_read_ahead (rtems_disk_device *dd,
 }
 
 static rtems_bdbuf_buffer *
-rtems_bdbuf_get_buffer_for_access (rtems_disk_device *dd,
-                                   rtems_blkdev_bnum  block)
+rtems_bdbuf_get_buffer_for_access (rtems_bdbuf_partition *partition,
+                                   rtems_disk_device     *dd,
+                                   rtems_blkdev_bnum      block)
 {
   rtems_bdbuf_buffer *bd = NULL;
 
   do
   {
-    bd = rtems_bdbuf_avl_search (&bdbuf_cache.tree, dd, block);
+    bd = rtems_bdbuf_hash_search (partition, dd, block);
 
     if (bd != NULL)
     {
       if (bd->group->bds_per_group != dd->bds_per_group)
       {
-        if (rtems_bdbuf_wait_for_recycle (bd))
+        if (rtems_bdbuf_wait_for_recycle (partition, bd))
         {
-          rtems_bdbuf_remove_from_tree_and_lru_list (bd);
-          rtems_bdbuf_make_free_and_add_to_lru_list (bd);
-          rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+          rtems_bdbuf_remove_from_hash_and_lru_list (partition, bd);
+          rtems_bdbuf_make_free_and_add_to_lru_list (partition, bd);
+          rtems_bdbuf_wake_buffer_waiters (partition);
         }
         bd = NULL;
       }
     }
     else
     {
-      bd = rtems_bdbuf_get_buffer_from_lru_list (dd, block);
+      bd = rtems_bdbuf_get_buffer_from_lru_list (partition, dd, block);
 
       if (bd == NULL)
-        rtems_bdbuf_wait_for_buffer ();
+      {
+        if (bdbuf_cache.partition_count > 1)
+          rtems_bdbuf_wait_for_any_buffer (partition);
+        else
+          rtems_bdbuf_wait_for_buffer (partition);
+      }
     }
   }
   while (bd == NULL);
 
-  rtems_bdbuf_wait_for_access (bd);
+  rtems_bdbuf_wait_for_access (partition, bd);
   rtems_bdbuf_group_obtain (bd);
 
   return bd;
@@ -1794,11 +2168,14 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
   rtems_bdbuf_buffer *bd = NULL;
   rtems_blkdev_bnum   media_block;
 
-  rtems_bdbuf_lock_cache ();
-
   sc = rtems_bdbuf_get_media_block (dd, block, &media_block);
   if (sc == RTEMS_SUCCESSFUL)
   {
+    rtems_bdbuf_partition *partition =
+      rtems_bdbuf_get_partition (dd, media_block);
+
+    rtems_bdbuf_lock_partition (partition);
+
     /*
      * Print the block index relative to the physical disk.
      */
@@ -1806,7 +2183,7 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
       printf ("bdbuf:get: %" PRIu32 " (%" PRIu32 ") (dev = %08x)\n",
               media_block, block, (unsigned) dd->dev);
 
-    bd = rtems_bdbuf_get_buffer_for_access (dd, media_block);
+    bd = rtems_bdbuf_get_buffer_for_access (partition, dd, media_block);
 
     switch (bd->state)
     {
@@ -1836,9 +2213,9 @@ rtems_bdbuf_get (rtems_disk_device   *dd,
       rtems_bdbuf_show_users ("get", bd);
       rtems_bdbuf_show_usage ();
     }
-  }
 
-  rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_unlock_partition (partition);
+  }
 
   *bd_ptr = bd;
 
@@ -1862,72 +2239,80 @@ rtems_bdbuf_transfer_done (rtems_blkdev_request* req, rtems_status_code status)
   rtems_event_transient_send (req->io_task);
 }
 
+/**
+ * Finish a transfer request which is done by the driver.  The buffers of the
+ * request are cached or discarded depending on the transfer status.
+ *
+ * @param dd The disk device.
+ * @param req The done transfer request.
+ * @param locked_partition The partition of all buffers of the request which is
+ * locked by the caller and unlocked during the transfer.  It is locked again
+ * by this function.  If it is NULL, then the partition of each buffer is
+ * locked on demand.
+ */
 static rtems_status_code
-rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
-                                      rtems_blkdev_request *req,
-                                      bool                  cache_locked)
+rtems_bdbuf_finish_transfer_request (rtems_disk_device     *dd,
+                                     rtems_blkdev_request  *req,
+                                     rtems_bdbuf_partition *locked_partition)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_status_code sc = req->status;
   uint32_t transfer_index = 0;
-  bool wake_transfer_waiters = false;
-  bool wake_buffer_waiters = false;
-
-  if (cache_locked)
-    rtems_bdbuf_unlock_cache ();
-
-  /* The return value will be ignored for transfer requests */
-  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
-
-  /* Wait for transfer request completion */
-  rtems_bdbuf_wait_for_transient_event ();
-  sc = req->status;
-
-  rtems_bdbuf_lock_cache ();
 
   /* Statistics */
-  if (req->req == RTEMS_BLKDEV_REQ_READ)
-  {
-    dd->stats.read_blocks += req->bufnum;
-    if (sc != RTEMS_SUCCESSFUL)
-      ++dd->stats.read_errors;
-  }
-  else
+  rtems_bdbuf_lock_cache ();
+  switch (req->req)
   {
-    dd->stats.write_blocks += req->bufnum;
-    ++dd->stats.write_transfers;
-    if (sc != RTEMS_SUCCESSFUL)
-      ++dd->stats.write_errors;
+    case RTEMS_BLKDEV_REQ_READ:
+      dd->stats.read_blocks += req->bufnum;
+      if (sc != RTEMS_SUCCESSFUL)
+        ++dd->stats.read_errors;
+      break;
+    case RTEMS_BLKDEV_REQ_WRITE:
+      dd->stats.write_blocks += req->bufnum;
+      ++dd->stats.write_transfers;
+      if (sc != RTEMS_SUCCESSFUL)
+        ++dd->stats.write_errors;
+      break;
+    default:
+      ++dd->stats.discard_requests;
+      if (sc == RTEMS_SUCCESSFUL)
+        dd->stats.discard_blocks += req->bufs [0].length / dd->block_size;
+      break;
   }
+  rtems_bdbuf_unlock_cache ();
+
+  if (locked_partition != NULL)
+    rtems_bdbuf_lock_partition (locked_partition);
 
   for (transfer_index = 0; transfer_index < req->bufnum; ++transfer_index)
   {
-    rtems_bdbuf_buffer *bd = req->bufs [transfer_index].user;
-    bool waiters = bd->waiters;
+    rtems_bdbuf_buffer    *bd = req->bufs [transfer_index].user;
+    rtems_bdbuf_partition *partition = rtems_bdbuf_get_partition_of_bd (bd);
+    bool waiters;
 
-    if (waiters)
-      wake_transfer_waiters = true;
-    else
-      wake_buffer_waiters = true;
+    if (locked_partition == NULL)
+      rtems_bdbuf_lock_partition (partition);
+
+    waiters = bd->waiters;
 
     rtems_bdbuf_group_release (bd);
 
     if (sc == RTEMS_SUCCESSFUL && bd->state == RTEMS_BDBUF_STATE_TRANSFER)
-      rtems_bdbuf_make_cached_and_add_to_lru_list (bd);
+      rtems_bdbuf_make_cached_and_add_to_lru_list (partition, bd);
     else
-      rtems_bdbuf_discard_buffer (bd);
+      rtems_bdbuf_discard_buffer (partition, bd);
 
     if (rtems_bdbuf_tracer)
       rtems_bdbuf_show_users ("transfer", bd);
-  }
-
-  if (wake_transfer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.transfer_waiters);
 
-  if (wake_buffer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    if (waiters)
+      rtems_bdbuf_wake (&partition->transfer_waiters);
+    else
+      rtems_bdbuf_wake_buffer_waiters (partition);
 
-  if (!cache_locked)
-    rtems_bdbuf_unlock_cache ();
+    if (locked_partition == NULL)
+      rtems_bdbuf_unlock_partition (partition);
+  }
 
   if (sc == RTEMS_SUCCESSFUL || sc == RTEMS_UNSATISFIED)
     return sc;
@@ -1935,10 +2320,37 @@ rtems_bdbuf_execute_transfer_request (rtems_disk_device    *dd,
     return RTEMS_IO_ERROR;
 }
 
+/**
+ * Execute a transfer request.
+ *
+ * @param dd The disk device.
+ * @param req The transfer request.
+ * @param locked_partition The partition of all buffers of the request which is
+ * locked by the caller.  It is unlocked during the transfer.  If it is NULL,
+ * then the partition of each buffer is locked on demand after the transfer.
+ */
 static rtems_status_code
-rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
-                                  rtems_bdbuf_buffer *bd,
-                                  uint32_t            transfer_count)
+rtems_bdbuf_execute_transfer_request (rtems_disk_device     *dd,
+                                      rtems_blkdev_request  *req,
+                                      rtems_bdbuf_partition *locked_partition)
+{
+  if (locked_partition != NULL)
+    rtems_bdbuf_unlock_partition (locked_partition);
+
+  /* The return value will be ignored for transfer requests */
+  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+
+  /* Wait for transfer request completion */
+  rtems_bdbuf_wait_for_transient_event ();
+
+  return rtems_bdbuf_finish_transfer_request (dd, req, locked_partition);
+}
+
+static rtems_status_code
+rtems_bdbuf_execute_read_request (rtems_bdbuf_partition *partition,
+                                  rtems_disk_device     *dd,
+                                  rtems_bdbuf_buffer    *bd,
+                                  uint32_t               transfer_count)
 {
   rtems_blkdev_request *req = NULL;
   rtems_blkdev_bnum media_block = bd->block;
@@ -1972,7 +2384,13 @@ rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
   {
     media_block += media_blocks_per_block;
 
-    bd = rtems_bdbuf_get_buffer_for_read_ahead (dd, media_block);
+    /*
+     * Stop at the end of the partition extent.
+     */
+    if (rtems_bdbuf_get_partition (dd, media_block) != partition)
+      break;
+
+    bd = rtems_bdbuf_get_buffer_for_read_ahead (partition, dd, media_block);
 
     if (bd == NULL)
       break;
@@ -1992,7 +2410,7 @@ rtems_bdbuf_execute_read_request (rtems_disk_device  *dd,
 
   req->bufnum = transfer_index;
 
-  return rtems_bdbuf_execute_transfer_request (dd, req, true);
+  return rtems_bdbuf_execute_transfer_request (dd, req, partition);
 }
 
 static bool
@@ -2014,43 +2432,127 @@ rtems_bdbuf_read_ahead_cancel (rtems_disk_device *dd)
 static void
 rtems_bdbuf_read_ahead_reset (rtems_disk_device *dd)
 {
+  size_t i;
+
   rtems_bdbuf_read_ahead_cancel (dd);
-  dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+
+  for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i)
+  {
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [i];
+
+    stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+    stream->pending = false;
+  }
+}
+
+static void
+rtems_bdbuf_read_ahead_use_stream (rtems_disk_device              *dd,
+                                   rtems_blkdev_read_ahead_stream *stream)
+{
+  stream->last_use = ++dd->read_ahead.use_counter;
 }
 
 static void
 rtems_bdbuf_check_read_ahead_trigger (rtems_disk_device *dd,
                                       rtems_blkdev_bnum  block)
 {
-  if (bdbuf_cache.read_ahead_task != 0
-      && dd->read_ahead.trigger == block
-      && !rtems_bdbuf_is_read_ahead_active (dd))
+  size_t i;
+
+  if (bdbuf_cache.read_ahead_task == 0)
+    return;
+
+  for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i)
   {
-    rtems_status_code sc;
-    rtems_chain_control *chain = &bdbuf_cache.read_ahead_chain;
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [i];
 
-    if (rtems_chain_is_empty (chain))
+    if (stream->trigger == block && !stream->pending)
     {
-      sc = rtems_event_send (bdbuf_cache.read_ahead_task,
-                             RTEMS_BDBUF_READ_AHEAD_WAKE_UP);
-      if (sc != RTEMS_SUCCESSFUL)
-        rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RA_WAKE_UP);
-    }
+      uint32_t window = 2 * stream->window;
+
+      if (window > bdbuf_config.max_read_ahead_blocks)
+        window = bdbuf_config.max_read_ahead_blocks;
+
+      stream->window = window;
+      stream->pending = true;
+      rtems_bdbuf_read_ahead_use_stream (dd, stream);
+
+      if (!rtems_bdbuf_is_read_ahead_active (dd))
+      {
+        rtems_status_code sc;
+        rtems_chain_control *chain = &bdbuf_cache.read_ahead_chain;
 
-    rtems_chain_append_unprotected (chain, &dd->read_ahead.node);
+        if (rtems_chain_is_empty (chain))
+        {
+          sc = rtems_event_send (bdbuf_cache.read_ahead_task,
+                                 RTEMS_BDBUF_READ_AHEAD_WAKE_UP);
+          if (sc != RTEMS_SUCCESSFUL)
+            rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_RA_WAKE_UP);
+        }
+
+        rtems_chain_append_unprotected (chain, &dd->read_ahead.node);
+      }
+    }
   }
 }
 
+/**
+ * Updates the read-ahead streams in case of a read miss.  A miss at the
+ * trigger of a stream continues this stream.  A miss of a block read ahead by
+ * a stream shrinks the window of this stream since the block was recycled
+ * before it was read.  Any other miss starts a new stream which replaces an
+ * unused or the least recently used stream.
+ *
+ * @param dd The disk device.
+ * @param block The missed block.
+ */
 static void
 rtems_bdbuf_set_read_ahead_trigger (rtems_disk_device *dd,
                                     rtems_blkdev_bnum  block)
 {
-  if (dd->read_ahead.trigger != block)
+  rtems_blkdev_read_ahead_stream *victim = NULL;
+  size_t i;
+
+  for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i)
   {
-    rtems_bdbuf_read_ahead_cancel (dd);
-    dd->read_ahead.trigger = block + 1;
-    dd->read_ahead.next = block + 2;
+    rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [i];
+
+    if (stream->trigger == block)
+    {
+      rtems_bdbuf_read_ahead_use_stream (dd, stream);
+      return;
+    }
+
+    if (stream->trigger == RTEMS_DISK_READ_AHEAD_NO_TRIGGER)
+    {
+      if (victim == NULL
+          || victim->trigger != RTEMS_DISK_READ_AHEAD_NO_TRIGGER)
+        victim = stream;
+    }
+    else
+    {
+      if (block < stream->next && stream->next - block <= stream->window)
+      {
+        if (stream->window > 1)
+          stream->window /= 2;
+
+        victim = stream;
+        break;
+      }
+
+      if (victim == NULL
+          || (victim->trigger != RTEMS_DISK_READ_AHEAD_NO_TRIGGER
+            && (int32_t) (stream->last_use - victim->last_use) < 0))
+        victim = stream;
+    }
   }
+
+  if (i == RTEMS_DISK_READ_AHEAD_STREAM_COUNT)
+    victim->window = 1;
+
+  victim->trigger = block + 1;
+  victim->next = block + 2;
+  victim->pending = false;
+  rtems_bdbuf_read_ahead_use_stream (dd, victim);
 }
 
 rtems_status_code
@@ -2062,34 +2564,42 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
   rtems_bdbuf_buffer   *bd = NULL;
   rtems_blkdev_bnum     media_block;
 
-  rtems_bdbuf_lock_cache ();
-
   sc = rtems_bdbuf_get_media_block (dd, block, &media_block);
   if (sc == RTEMS_SUCCESSFUL)
   {
+    rtems_bdbuf_partition *partition =
+      rtems_bdbuf_get_partition (dd, media_block);
+    bool                   read_hit = false;
+    bool                   ghost_hit = false;
+
+    rtems_bdbuf_lock_partition (partition);
+
     if (rtems_bdbuf_tracer)
       printf ("bdbuf:read: %" PRIu32 " (%" PRIu32 ") (dev = %08x)\n",
               media_block, block, (unsigned) dd->dev);
 
-    bd = rtems_bdbuf_get_buffer_for_access (dd, media_block);
+    bd = rtems_bdbuf_get_buffer_for_access (partition, dd, media_block);
     switch (bd->state)
     {
       case RTEMS_BDBUF_STATE_CACHED:
-        ++dd->stats.read_hits;
+        read_hit = true;
         rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
         break;
       case RTEMS_BDBUF_STATE_MODIFIED:
-        ++dd->stats.read_hits;
+        read_hit = true;
         rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_MODIFIED);
         break;
       case RTEMS_BDBUF_STATE_EMPTY:
-        ++dd->stats.read_misses;
+        ghost_hit = bd->hot
+          && bdbuf_config.replacement_policy == RTEMS_BDBUF_REPLACEMENT_2Q;
+        rtems_bdbuf_lock_cache ();
         rtems_bdbuf_set_read_ahead_trigger (dd, block);
-        sc = rtems_bdbuf_execute_read_request (dd, bd, 1);
+        rtems_bdbuf_unlock_cache ();
+        sc = rtems_bdbuf_execute_read_request (partition, dd, bd, 1);
         if (sc == RTEMS_SUCCESSFUL)
         {
+          rtems_bdbuf_remove_from_lru_list (partition, bd);
           rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
-          rtems_chain_extract_unprotected (&bd->link);
           rtems_bdbuf_group_obtain (bd);
         }
         else
@@ -2102,161 +2612,653 @@ rtems_bdbuf_read (rtems_disk_device   *dd,
         break;
     }
 
+    if (read_hit)
+      ++partition->read_hits;
+    else
+      ++partition->read_misses;
+
+    if (ghost_hit)
+      ++partition->read_ghost_hits;
+
+    rtems_bdbuf_unlock_partition (partition);
+
+    rtems_bdbuf_lock_cache ();
+
+    if (read_hit)
+      ++dd->stats.read_hits;
+    else
+      ++dd->stats.read_misses;
+
+    if (ghost_hit)
+      ++dd->stats.read_ghost_hits;
+
     rtems_bdbuf_check_read_ahead_trigger (dd, block);
+
+    rtems_bdbuf_unlock_cache ();
+  }
+
+  *bd_ptr = bd;
+
+  return sc;
+}
+
+static rtems_status_code
+rtems_bdbuf_check_bd_and_lock_partition (rtems_bdbuf_buffer     *bd,
+                                         const char             *kind,
+                                         rtems_bdbuf_partition **partition)
+{
+  if (bd == NULL)
+    return RTEMS_INVALID_ADDRESS;
+  if (rtems_bdbuf_tracer)
+  {
+    printf ("bdbuf:%s: %" PRIu32 "\n", kind, bd->block);
+    rtems_bdbuf_show_users (kind, bd);
   }
+  *partition = rtems_bdbuf_get_partition_of_bd (bd);
+  rtems_bdbuf_lock_partition (*partition);
 
+  return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code
+rtems_bdbuf_release (rtems_bdbuf_buffer *bd)
+{
+  rtems_status_code      sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_partition *partition;
+
+  sc = rtems_bdbuf_check_bd_and_lock_partition (bd, "release", &partition);
+  if (sc != RTEMS_SUCCESSFUL)
+    return sc;
+
+  switch (bd->state)
+  {
+    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
+      rtems_bdbuf_add_to_lru_list_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
+    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
+      rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
+      rtems_bdbuf_add_to_modified_list_after_access (partition, bd);
+      break;
+    default:
+      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_0);
+      break;
+  }
+
+  if (rtems_bdbuf_tracer)
+    rtems_bdbuf_show_usage ();
+
+  rtems_bdbuf_unlock_partition (partition);
+
+  return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code
+rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
+{
+  rtems_status_code      sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_partition *partition;
+
+  sc = rtems_bdbuf_check_bd_and_lock_partition (bd, "release modified",
+                                                &partition);
+  if (sc != RTEMS_SUCCESSFUL)
+    return sc;
+
+  switch (bd->state)
+  {
+    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
+    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
+    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
+      rtems_bdbuf_add_to_modified_list_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
+      rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      break;
+    default:
+      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_6);
+      break;
+  }
+
+  if (rtems_bdbuf_tracer)
+    rtems_bdbuf_show_usage ();
+
+  rtems_bdbuf_unlock_partition (partition);
+
+  return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code
+rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
+{
+  rtems_status_code      sc = RTEMS_SUCCESSFUL;
+  rtems_bdbuf_partition *partition;
+
+  sc = rtems_bdbuf_check_bd_and_lock_partition (bd, "sync", &partition);
+  if (sc != RTEMS_SUCCESSFUL)
+    return sc;
+
+  switch (bd->state)
+  {
+    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
+    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
+    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
+      rtems_bdbuf_sync_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
+      rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      break;
+    default:
+      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_5);
+      break;
+  }
+
+  if (rtems_bdbuf_tracer)
+    rtems_bdbuf_show_usage ();
+
+  rtems_bdbuf_unlock_partition (partition);
+
+  return RTEMS_SUCCESSFUL;
+}
+
+rtems_status_code
+rtems_bdbuf_syncdev (rtems_disk_device *dd)
+{
+  if (rtems_bdbuf_tracer)
+    printf ("bdbuf:syncdev: %08x\n", (unsigned) dd->dev);
+
+  /*
+   * Take the sync lock before locking the cache. Once we have the sync lock we
+   * can lock the cache. If another thread has the sync lock it will cause this
+   * thread to block until it owns the sync lock then it can own the cache. The
+   * sync lock can only be obtained with the partitions unlocked.
+   */
+  rtems_bdbuf_lock_sync ();
+  rtems_bdbuf_lock_all_partitions ();
+  rtems_bdbuf_lock_cache ();
+
+  /*
+   * Set the cache to have a sync active for a specific device and let the swap
+   * out task know the id of the requester to wake when done.
+   *
+   * The swap out task will negate the sync active flag when no more buffers
+   * for the device are held on the "modified for sync" queues.
+   */
+  bdbuf_cache.sync_active    = true;
+  bdbuf_cache.sync_requester = rtems_task_self ();
+  bdbuf_cache.sync_device    = dd;
+
+  rtems_bdbuf_wake_swapper ();
+  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_all_partitions ();
+  rtems_bdbuf_wait_for_transient_event ();
+  rtems_bdbuf_unlock_sync ();
+
+  return RTEMS_SUCCESSFUL;
+}
+
+/**
+ * Makes a buffer coherent with a direct transfer of its block.  Before a direct
+ * read a modified buffer is written to the disk.  Before a direct write or a
+ * discard the buffer is discarded.  The partition lock may be released while
+ * the caller waits for access to the buffer.
+ *
+ * @param partition The partition of the buffer.  The caller owns its lock.
+ * @param bd The buffer.
+ * @param write Indicates a direct write.
+ */
+static void
+rtems_bdbuf_prepare_direct_buffer (rtems_bdbuf_partition *partition,
+                                   rtems_bdbuf_buffer    *bd,
+                                   bool                   write)
+{
+  rtems_bdbuf_wait_for_access (partition, bd);
+  rtems_bdbuf_group_obtain (bd);
+
+  switch (bd->state)
+  {
+    case RTEMS_BDBUF_STATE_CACHED:
+      rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_CACHED);
+      if (write)
+        rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      else
+        rtems_bdbuf_add_to_lru_list_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_EMPTY:
+      rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_EMPTY);
+      rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      break;
+    case RTEMS_BDBUF_STATE_MODIFIED:
+      rtems_bdbuf_set_state (bd, RTEMS_BDBUF_STATE_ACCESS_MODIFIED);
+      if (write)
+        rtems_bdbuf_discard_buffer_after_access (partition, bd);
+      else
+        rtems_bdbuf_sync_after_access (partition, bd);
+      break;
+    default:
+      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_12);
+      break;
+  }
+}
+
+/**
+ * Makes the cache coherent with a direct transfer of the block.
+ *
+ * @param dd The disk device.
+ * @param media_block The media block number of the block.
+ * @param write Indicates a direct write.
+ */
+static void
+rtems_bdbuf_prepare_direct_transfer (rtems_disk_device *dd,
+                                     rtems_blkdev_bnum  media_block,
+                                     bool               write)
+{
+  rtems_bdbuf_partition *partition =
+    rtems_bdbuf_get_partition (dd, media_block);
+  rtems_bdbuf_buffer    *bd;
+
+  rtems_bdbuf_lock_partition (partition);
+
+  bd = rtems_bdbuf_hash_search (partition, dd, media_block);
+
+  if (bd != NULL)
+    rtems_bdbuf_prepare_direct_buffer (partition, bd, write);
+
+  rtems_bdbuf_unlock_partition (partition);
+}
+
+/**
+ * Discards the buffers of a media block range with a scan of the hash tables.
+ * This is cheaper than a lookup of each block if the range is larger than the
+ * cache.
+ *
+ * Empty buffers are skipped.  They hold no data and stay in the hash table
+ * while there are waiters, so a rescan would find them again.
+ *
+ * @param dd The disk device.
+ * @param first The media block number of the first block.
+ * @param last The media block number of the last block.
+ */
+static void
+rtems_bdbuf_discard_direct_range_by_scan (rtems_disk_device *dd,
+                                          rtems_blkdev_bnum  first,
+                                          rtems_blkdev_bnum  last)
+{
+  uint32_t p;
+
+  for (p = 0; p < bdbuf_cache.partition_count; ++p)
+  {
+    rtems_bdbuf_partition *partition = &bdbuf_cache.partitions [p];
+    size_t                 i;
+
+    rtems_bdbuf_lock_partition (partition);
+
+    for (i = 0; i <= partition->hash_mask; ++i)
+    {
+      rtems_bdbuf_buffer *bd = partition->hash [i];
+
+      while (bd != NULL)
+      {
+        if (bd->dd == dd && bd->block >= first && bd->block <= last
+            && bd->state != RTEMS_BDBUF_STATE_EMPTY)
+        {
+          rtems_bdbuf_prepare_direct_buffer (partition, bd, true);
+
+          /*
+           * The wait for access may release the partition lock, so start
+           * again at the head of the bucket.
+           */
+          bd = partition->hash [i];
+        }
+        else
+          bd = bd->hash_next;
+      }
+    }
+
+    rtems_bdbuf_unlock_partition (partition);
+  }
+}
+
+/**
+ * Makes the cache coherent with a direct transfer of a block range.
+ *
+ * @param dd The disk device.
+ * @param block The linear block number of the first block.
+ * @param block_count The count of blocks.
+ * @param write Indicates a direct write.
+ */
+static void
+rtems_bdbuf_prepare_direct_range (rtems_disk_device *dd,
+                                  rtems_blkdev_bnum  block,
+                                  uint32_t           block_count,
+                                  bool               write)
+{
+  uint32_t i;
+
+  /*
+   * A cache lookup of each block of a large range, for example the discard of
+   * a whole partition, would cost far more than a scan of all buffers.
+   */
+  if (write && block_count > bdbuf_cache.buffer_min_count)
+  {
+    rtems_blkdev_bnum first;
+    rtems_blkdev_bnum last;
+
+    rtems_bdbuf_get_media_block (dd, block, &first);
+    rtems_bdbuf_get_media_block (dd, block + block_count - 1, &last);
+    rtems_bdbuf_discard_direct_range_by_scan (dd, first, last);
+    return;
+  }
+
+  for (i = 0; i < block_count; ++i)
+  {
+    rtems_blkdev_bnum media_block;
+
+    rtems_bdbuf_get_media_block (dd, block + i, &media_block);
+    rtems_bdbuf_prepare_direct_transfer (dd, media_block, write);
+  }
+}
+
+static rtems_status_code
+rtems_bdbuf_execute_direct_request (rtems_disk_device    *dd,
+                                    rtems_blkdev_request *req)
+{
+  rtems_status_code sc;
+
+  /* The return value will be ignored for transfer requests */
+  dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+
+  /* Wait for transfer request completion */
+  rtems_bdbuf_wait_for_transient_event ();
+
+  sc = req->status;
+
+  /* Statistics */
+  rtems_bdbuf_lock_cache ();
+  switch (req->req)
+  {
+    case RTEMS_BLKDEV_REQ_READ:
+      dd->stats.read_blocks += req->bufnum;
+      if (sc != RTEMS_SUCCESSFUL)
+        ++dd->stats.read_errors;
+      break;
+    case RTEMS_BLKDEV_REQ_WRITE:
+      dd->stats.write_blocks += req->bufnum;
+      ++dd->stats.write_transfers;
+      if (sc != RTEMS_SUCCESSFUL)
+        ++dd->stats.write_errors;
+      break;
+    default:
+      ++dd->stats.discard_requests;
+      if (sc == RTEMS_SUCCESSFUL)
+        dd->stats.discard_blocks += req->bufs [0].length / dd->block_size;
+      break;
+  }
   rtems_bdbuf_unlock_cache ();
 
-  *bd_ptr = bd;
+  if (sc == RTEMS_SUCCESSFUL)
+    return sc;
+  else
+    return RTEMS_IO_ERROR;
+}
+
+static rtems_status_code
+rtems_bdbuf_transfer_direct (rtems_disk_device       *dd,
+                             rtems_blkdev_request_op  op,
+                             rtems_blkdev_bnum        block,
+                             uint32_t                 block_count,
+                             uint8_t                 *buffer)
+{
+  rtems_status_code     sc = RTEMS_SUCCESSFUL;
+  rtems_blkdev_request *req;
+  rtems_blkdev_bnum     media_block;
+  rtems_blkdev_bnum     first_block;
+  uint32_t              total_count;
+  uint32_t              block_size = dd->block_size;
+  uint32_t              i;
+
+  if (block >= dd->block_count || block_count > dd->block_count - block)
+    return RTEMS_INVALID_ID;
+
+  if (rtems_bdbuf_tracer)
+    printf ("bdbuf:%s direct: %" PRIu32 " (%" PRIu32 " blocks) (dev = %08x)\n",
+            op == RTEMS_BLKDEV_REQ_READ ? "read" : "write",
+            block, block_count, (unsigned) dd->dev);
+
+  rtems_bdbuf_prepare_direct_range (dd, block, block_count,
+                                    op == RTEMS_BLKDEV_REQ_WRITE);
+
+  req = bdbuf_alloc (
+    rtems_bdbuf_read_request_size (RTEMS_BDBUF_DIRECT_TRANSFER_MAX_BLOCKS));
+
+  req->req = op;
+  req->done = rtems_bdbuf_transfer_done;
+  req->io_task = rtems_task_self ();
+
+  first_block = block;
+  total_count = block_count;
+
+  while (block_count > 0 && sc == RTEMS_SUCCESSFUL)
+  {
+    uint32_t transfer_count = block_count;
+
+    if (transfer_count > RTEMS_BDBUF_DIRECT_TRANSFER_MAX_BLOCKS)
+      transfer_count = RTEMS_BDBUF_DIRECT_TRANSFER_MAX_BLOCKS;
+
+    for (i = 0; i < transfer_count; ++i)
+    {
+      rtems_bdbuf_get_media_block (dd, block + i, &media_block);
+
+      req->bufs [i].user   = NULL;
+      req->bufs [i].block  = media_block;
+      req->bufs [i].length = block_size;
+      req->bufs [i].buffer = buffer + i * block_size;
+    }
+
+    req->bufnum = transfer_count;
+
+    sc = rtems_bdbuf_execute_direct_request (dd, req);
+
+    block += transfer_count;
+    block_count -= transfer_count;
+    buffer += transfer_count * block_size;
+  }
+
+  /*
+   * A read of a block through the cache during the write may have cached the
+   * previous content of the block.
+   */
+  if (op == RTEMS_BLKDEV_REQ_WRITE && sc == RTEMS_SUCCESSFUL)
+    rtems_bdbuf_prepare_direct_range (dd, first_block, total_count, true);
 
   return sc;
 }
 
-static rtems_status_code
-rtems_bdbuf_check_bd_and_lock_cache (rtems_bdbuf_buffer *bd, const char *kind)
+rtems_status_code
+rtems_bdbuf_read_direct (rtems_disk_device *dd,
+                         rtems_blkdev_bnum  block,
+                         uint32_t           block_count,
+                         void              *buffer)
 {
-  if (bd == NULL)
-    return RTEMS_INVALID_ADDRESS;
-  if (rtems_bdbuf_tracer)
-  {
-    printf ("bdbuf:%s: %" PRIu32 "\n", kind, bd->block);
-    rtems_bdbuf_show_users (kind, bd);
-  }
-  rtems_bdbuf_lock_cache();
+  return rtems_bdbuf_transfer_direct (dd, RTEMS_BLKDEV_REQ_READ, block,
+                                      block_count, buffer);
+}
 
-  return RTEMS_SUCCESSFUL;
+rtems_status_code
+rtems_bdbuf_write_direct (rtems_disk_device *dd,
+                          rtems_blkdev_bnum  block,
+                          uint32_t           block_count,
+                          const void        *buffer)
+{
+  /*
+   * The request has no const buffers, the driver only reads from them.
+   */
+  return rtems_bdbuf_transfer_direct (dd, RTEMS_BLKDEV_REQ_WRITE, block,
+                                      block_count, (uint8_t *) buffer);
 }
 
 rtems_status_code
-rtems_bdbuf_release (rtems_bdbuf_buffer *bd)
+rtems_bdbuf_discard (rtems_disk_device *dd,
+                     rtems_blkdev_bnum  block,
+                     uint32_t           block_count)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  rtems_blkdev_request *req;
+  rtems_blkdev_bnum     media_block;
+  uint32_t              max_chunk;
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "release");
-  if (sc != RTEMS_SUCCESSFUL)
-    return sc;
+  if (block >= dd->block_count || block_count > dd->block_count - block)
+    return RTEMS_INVALID_ID;
 
-  switch (bd->state)
-  {
-    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
-      rtems_bdbuf_add_to_lru_list_after_access (bd);
-      break;
-    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
-    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
-      break;
-    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_add_to_modified_list_after_access (bd);
-      break;
-    default:
-      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_0);
-      break;
-  }
+  if (block_count == 0)
+    return RTEMS_SUCCESSFUL;
 
   if (rtems_bdbuf_tracer)
-    rtems_bdbuf_show_usage ();
+    printf ("bdbuf:discard: %" PRIu32 " (%" PRIu32 " blocks) (dev = %08x)\n",
+            block, block_count, (unsigned) dd->dev);
 
-  rtems_bdbuf_unlock_cache ();
+  /*
+   * The data of the blocks is obsolete, so modified buffers are discarded
+   * without a write to the disk.
+   */
+  rtems_bdbuf_prepare_direct_range (dd, block, block_count, true);
 
-  return RTEMS_SUCCESSFUL;
-}
+  if ((dd->phys_dev->capabilities & RTEMS_BLKDEV_CAP_DISCARD) == 0)
+    return RTEMS_SUCCESSFUL;
 
-rtems_status_code
-rtems_bdbuf_release_modified (rtems_bdbuf_buffer *bd)
-{
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  req = bdbuf_alloc (rtems_bdbuf_read_request_size (1));
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "release modified");
-  if (sc != RTEMS_SUCCESSFUL)
-    return sc;
+  /*
+   * The request length is in bytes, so split ranges of 4GiB and more into
+   * requests with a length which fits into 32 bits.
+   */
+  max_chunk = UINT32_MAX / dd->block_size;
 
-  switch (bd->state)
+  while (block_count > 0)
   {
-    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
-    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
-    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_add_to_modified_list_after_access (bd);
-      break;
-    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
-      break;
-    default:
-      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_6);
-      break;
-  }
+    uint32_t          chunk = block_count;
+    rtems_status_code sc;
 
-  if (rtems_bdbuf_tracer)
-    rtems_bdbuf_show_usage ();
+    if (chunk > max_chunk)
+      chunk = max_chunk;
 
-  rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_get_media_block (dd, block, &media_block);
+
+    req->req = RTEMS_BLKDEV_REQ_DISCARD;
+    req->done = rtems_bdbuf_transfer_done;
+    req->io_task = rtems_task_self ();
+    req->bufnum = 1;
+    req->bufs [0].user   = NULL;
+    req->bufs [0].block  = media_block;
+    req->bufs [0].length = chunk * dd->block_size;
+    req->bufs [0].buffer = NULL;
+
+    sc = rtems_bdbuf_execute_direct_request (dd, req);
+    if (sc != RTEMS_SUCCESSFUL)
+      return sc;
+
+    block += chunk;
+    block_count -= chunk;
+  }
 
   return RTEMS_SUCCESSFUL;
 }
 
-rtems_status_code
-rtems_bdbuf_sync (rtems_bdbuf_buffer *bd)
+bool
+rtems_bdbuf_can_transfer_direct (const void *buffer, uint32_t block_count)
 {
-  rtems_status_code sc = RTEMS_SUCCESSFUL;
+  uint32_t min_blocks = bdbuf_config.direct_transfer_min_blocks;
+  size_t   line_size = rtems_cache_get_data_line_size ();
 
-  sc = rtems_bdbuf_check_bd_and_lock_cache (bd, "sync");
-  if (sc != RTEMS_SUCCESSFUL)
-    return sc;
+  return min_blocks > 0 && block_count >= min_blocks
+    && (line_size == 0 || ((uintptr_t) buffer % line_size) == 0);
+}
 
-  switch (bd->state)
+/**
+ * Finish the write requests of the transfer queue which are done by the
+ * driver.  Wait for the driver until at least one or all requests are done.
+ *
+ * @param transfer The transfer transaction.
+ * @param queue_depth The queue depth of the transfer.
+ * @param all If true, then wait until all requests are done.
+ */
+static void
+rtems_bdbuf_swapout_finish_requests (rtems_bdbuf_swapout_transfer* transfer,
+                                     uint32_t                      queue_depth,
+                                     bool                          all)
+{
+  while (true)
   {
-    case RTEMS_BDBUF_STATE_ACCESS_CACHED:
-    case RTEMS_BDBUF_STATE_ACCESS_EMPTY:
-    case RTEMS_BDBUF_STATE_ACCESS_MODIFIED:
-      rtems_bdbuf_sync_after_access (bd);
-      break;
-    case RTEMS_BDBUF_STATE_ACCESS_PURGED:
-      rtems_bdbuf_discard_buffer_after_access (bd);
-      break;
-    default:
-      rtems_bdbuf_fatal_with_state (bd->state, RTEMS_BDBUF_FATAL_STATE_5);
-      break;
-  }
+    uint32_t in_flight = 0;
+    bool     finished = false;
+    uint32_t i;
 
-  if (rtems_bdbuf_tracer)
-    rtems_bdbuf_show_usage ();
+    for (i = 0; i < queue_depth; ++i)
+    {
+      rtems_blkdev_request *req = rtems_bdbuf_swapout_request (transfer, i);
 
-  rtems_bdbuf_unlock_cache ();
+      if (req->bufnum > 0)
+      {
+        if (req->status != RTEMS_RESOURCE_IN_USE)
+        {
+          rtems_bdbuf_finish_transfer_request (transfer->dd, req, NULL);
+          req->bufnum = 0;
+          finished = true;
+        }
+        else
+          ++in_flight;
+      }
+    }
 
-  return RTEMS_SUCCESSFUL;
+    if (in_flight == 0)
+    {
+      /*
+       * All requests are done, so drop the event of a request which was done
+       * before we had to wait for it.
+       */
+      rtems_event_transient_clear ();
+      return;
+    }
+
+    if (finished && !all)
+      return;
+
+    /*
+     * Each done request sends the transient event, so a request done after
+     * the check above is not missed.
+     */
+    rtems_bdbuf_wait_for_transient_event ();
+  }
 }
 
-rtems_status_code
-rtems_bdbuf_syncdev (rtems_disk_device *dd)
+/**
+ * Get an unused write request of the transfer queue.  Wait for the driver if
+ * all requests are in flight.
+ *
+ * @param transfer The transfer transaction.
+ * @param queue_depth The queue depth of the transfer.
+ */
+static rtems_blkdev_request *
+rtems_bdbuf_swapout_get_request (rtems_bdbuf_swapout_transfer* transfer,
+                                 uint32_t                      queue_depth)
 {
-  if (rtems_bdbuf_tracer)
-    printf ("bdbuf:syncdev: %08x\n", (unsigned) dd->dev);
-
-  /*
-   * Take the sync lock before locking the cache. Once we have the sync lock we
-   * can lock the cache. If another thread has the sync lock it will cause this
-   * thread to block until it owns the sync lock then it can own the cache. The
-   * sync lock can only be obtained with the cache unlocked.
-   */
-  rtems_bdbuf_lock_sync ();
-  rtems_bdbuf_lock_cache ();
+  while (true)
+  {
+    uint32_t i;
 
-  /*
-   * Set the cache to have a sync active for a specific device and let the swap
-   * out task know the id of the requester to wake when done.
-   *
-   * The swap out task will negate the sync active flag when no more buffers
-   * for the device are held on the "modified for sync" queues.
-   */
-  bdbuf_cache.sync_active    = true;
-  bdbuf_cache.sync_requester = rtems_task_self ();
-  bdbuf_cache.sync_device    = dd;
+    for (i = 0; i < queue_depth; ++i)
+    {
+      rtems_blkdev_request *req = rtems_bdbuf_swapout_request (transfer, i);
 
-  rtems_bdbuf_wake_swapper ();
-  rtems_bdbuf_unlock_cache ();
-  rtems_bdbuf_wait_for_transient_event ();
-  rtems_bdbuf_unlock_sync ();
+      if (req->bufnum == 0)
+      {
+        req->status = RTEMS_RESOURCE_IN_USE;
+        return req;
+      }
+    }
 
-  return RTEMS_SUCCESSFUL;
+    rtems_bdbuf_swapout_finish_requests (transfer, queue_depth, false);
+  }
 }
 
 /**
@@ -2264,6 +3266,12 @@ rtems_bdbuf_syncdev (rtems_disk_device *dd)
  * of consecutive write requests is multiple consecutive buffers are required
  * by the driver. The cache is not locked.
  *
+ * The buffers are sorted in block order.  If the driver accepts more than one
+ * request at a time, then each request covers a range of adjacent blocks and
+ * up to the queue depth requests are submitted before the swapout waits for
+ * the first of them.  The buffers of a request are finished in the completion
+ * path of the swapout and not by the driver.
+ *
  * @param transfer The transfer transaction.
  */
 static void
@@ -2287,8 +3295,16 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
 
     rtems_disk_device *dd = transfer->dd;
     uint32_t media_blocks_per_block = dd->media_blocks_per_block;
-    bool need_continuous_blocks =
-      (dd->phys_dev->capabilities & RTEMS_BLKDEV_CAP_MULTISECTOR_CONT) != 0;
+    uint32_t queue_depth = dd->phys_dev->queue_depth;
+    bool need_continuous_blocks;
+    rtems_blkdev_request *req = NULL;
+
+    if (queue_depth > bdbuf_config.swapout_queue_depth)
+      queue_depth = bdbuf_config.swapout_queue_depth;
+
+    need_continuous_blocks =
+      (dd->phys_dev->capabilities & RTEMS_BLKDEV_CAP_MULTISECTOR_CONT) != 0
+        || queue_depth > 1;
 
     /*
      * Take as many buffers as configured and pass to the driver. Note, the
@@ -2299,14 +3315,14 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
      * removed. Merging members of a struct into the first member is
      * trouble waiting to happen.
      */
-    transfer->write_req.status = RTEMS_RESOURCE_IN_USE;
-    transfer->write_req.bufnum = 0;
-
     while ((node = rtems_chain_get_unprotected(&transfer->bds)) != NULL)
     {
       rtems_bdbuf_buffer* bd = (rtems_bdbuf_buffer*) node;
       bool                write = false;
 
+      if (req == NULL)
+        req = rtems_bdbuf_swapout_get_request (transfer, queue_depth);
+
       /*
        * If the device only accepts sequential buffers and this is not the
        * first buffer (the first is always sequential, and the buffer is not
@@ -2316,10 +3332,10 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
 
       if (rtems_bdbuf_tracer)
         printf ("bdbuf:swapout write: bd:%" PRIu32 ", bufnum:%" PRIu32 " mode:%s\n",
-                bd->block, transfer->write_req.bufnum,
+                bd->block, req->bufnum,
                 need_continuous_blocks ? "MULTI" : "SCAT");
 
-      if (need_continuous_blocks && transfer->write_req.bufnum &&
+      if (need_continuous_blocks && req->bufnum &&
           bd->block != last_block + media_blocks_per_block)
       {
         rtems_chain_prepend_unprotected (&transfer->bds, &bd->link);
@@ -2328,8 +3344,8 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
       else
       {
         rtems_blkdev_sg_buffer* buf;
-        buf = &transfer->write_req.bufs[transfer->write_req.bufnum];
-        transfer->write_req.bufnum++;
+        buf = &req->bufs[req->bufnum];
+        req->bufnum++;
         buf->user   = bd;
         buf->block  = bd->block;
         buf->length = dd->block_size;
@@ -2343,18 +3359,19 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
        */
 
       if (rtems_chain_is_empty (&transfer->bds) ||
-          (transfer->write_req.bufnum >= bdbuf_config.max_write_blocks))
+          (req->bufnum >= bdbuf_config.max_write_blocks))
         write = true;
 
       if (write)
       {
-        rtems_bdbuf_execute_transfer_request (dd, &transfer->write_req, false);
-
-        transfer->write_req.status = RTEMS_RESOURCE_IN_USE;
-        transfer->write_req.bufnum = 0;
+        /* The return value will be ignored for transfer requests */
+        dd->ioctl (dd->phys_dev, RTEMS_BLKIO_REQUEST, req);
+        req = NULL;
       }
     }
 
+    rtems_bdbuf_swapout_finish_requests (transfer, queue_depth, true);
+
     /*
      * If sync'ing and the deivce is capability of handling a sync IO control
      * call perform the call.
@@ -2372,6 +3389,7 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
  * Process the modified list of buffers. There is a sync or modified list that
  * needs to be handled so we have a common function to do the work.
  *
+ * @param partition The partition of the chain. It must be locked.
  * @param dd_ptr Pointer to the device to handle. If BDBUF_INVALID_DEV no
  * device is selected so select the device of the first buffer to be written to
  * disk.
@@ -2383,12 +3401,13 @@ rtems_bdbuf_swapout_write (rtems_bdbuf_swapout_transfer* transfer)
  *                    amount.
  */
 static void
-rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
-                                         rtems_chain_control* chain,
-                                         rtems_chain_control* transfer,
-                                         bool                 sync_active,
-                                         bool                 update_timers,
-                                         uint32_t             timer_delta)
+rtems_bdbuf_swapout_modified_processing (rtems_bdbuf_partition* partition,
+                                         rtems_disk_device    **dd_ptr,
+                                         rtems_chain_control*   chain,
+                                         rtems_chain_control*   transfer,
+                                         bool                   sync_active,
+                                         bool                   update_timers,
+                                         uint32_t               timer_delta)
 {
   if (!rtems_chain_is_empty (chain))
   {
@@ -2417,7 +3436,7 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
        *       on TOD to be accurate. Does it matter ?
        */
       if (sync_all || (sync_active && (*dd_ptr == bd->dd))
-          || rtems_bdbuf_has_buffer_waiters ())
+          || rtems_bdbuf_has_buffer_waiters (partition))
         bd->hold_timer = 0;
 
       if (bd->hold_timer)
@@ -2494,8 +3513,9 @@ rtems_bdbuf_swapout_modified_processing (rtems_disk_device  **dd_ptr,
  * modified list extracting the buffers suitable to be written to disk. We have
  * a device at a time. The task level loop will repeat this operation while
  * there are buffers to be written. If the transfer fails place the buffers
- * back on the modified list and try again later. The cache is unlocked while
- * the buffers are being written to disk.
+ * back on the modified list and try again later. The partitions are processed
+ * one after another and are unlocked while the buffers are being written to
+ * disk.
  *
  * @param timer_delta It update_timers is true update the timers by this
  *                    amount.
@@ -2513,11 +3533,13 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
   rtems_bdbuf_swapout_worker* worker;
   bool                        transfered_buffers = false;
   bool                        sync_active;
+  uint32_t                    p;
 
   rtems_bdbuf_lock_cache ();
 
   /*
-   * To set this to true you need the cache and the sync lock.
+   * To set this to true you need the sync lock, all partition locks and the
+   * cache lock.
    */
   sync_active = bdbuf_cache.sync_active;
 
@@ -2552,32 +3574,46 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
   if (sync_active)
     transfer->dd = bdbuf_cache.sync_device;
 
-  /*
-   * If we have any buffers in the sync queue move them to the modified
-   * list. The first sync buffer will select the device we use.
-   */
-  rtems_bdbuf_swapout_modified_processing (&transfer->dd,
-                                           &bdbuf_cache.sync,
-                                           &transfer->bds,
-                                           true, false,
-                                           timer_delta);
+  rtems_bdbuf_unlock_cache ();
 
   /*
-   * Process the cache's modified list.
+   * If we have any buffers in the sync queues move them to the modified
+   * list. The first sync buffer will select the device we use.
    */
-  rtems_bdbuf_swapout_modified_processing (&transfer->dd,
-                                           &bdbuf_cache.modified,
-                                           &transfer->bds,
-                                           sync_active,
-                                           update_timers,
-                                           timer_delta);
+  for (p = 0; p < bdbuf_cache.partition_count; ++p)
+  {
+    rtems_bdbuf_partition *partition = &bdbuf_cache.partitions [p];
+
+    rtems_bdbuf_lock_partition (partition);
+    rtems_bdbuf_swapout_modified_processing (partition,
+                                             &transfer->dd,
+                                             &partition->sync,
+                                             &transfer->bds,
+                                             true, false,
+                                             timer_delta);
+    rtems_bdbuf_unlock_partition (partition);
+  }
 
   /*
-   * We have all the buffers that have been modified for this device so the
-   * cache can be unlocked because the state of each buffer has been set to
+   * Process the modified lists of the partitions.  We have all the buffers
+   * that have been modified for this device of a partition so the partition
+   * can be unlocked because the state of each buffer has been set to
    * TRANSFER.
    */
-  rtems_bdbuf_unlock_cache ();
+  for (p = 0; p < bdbuf_cache.partition_count; ++p)
+  {
+    rtems_bdbuf_partition *partition = &bdbuf_cache.partitions [p];
+
+    rtems_bdbuf_lock_partition (partition);
+    rtems_bdbuf_swapout_modified_processing (partition,
+                                             &transfer->dd,
+                                             &partition->modified,
+                                             &transfer->bds,
+                                             sync_active,
+                                             update_timers,
+                                             timer_delta);
+    rtems_bdbuf_unlock_partition (partition);
+  }
 
   /*
    * If there are buffers to transfer to the media transfer them.
@@ -2602,11 +3638,13 @@ rtems_bdbuf_swapout_processing (unsigned long                 timer_delta,
   if (sync_active && !transfered_buffers)
   {
     rtems_id sync_requester;
+    rtems_bdbuf_lock_all_partitions ();
     rtems_bdbuf_lock_cache ();
     sync_requester = bdbuf_cache.sync_requester;
     bdbuf_cache.sync_active = false;
     bdbuf_cache.sync_requester = 0;
     rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_unlock_all_partitions ();
     if (sync_requester)
       rtems_event_transient_send (sync_requester);
   }
@@ -2750,7 +3788,8 @@ rtems_bdbuf_swapout_task (rtems_task_argument arg)
 }
 
 static void
-rtems_bdbuf_purge_list (rtems_chain_control *purge_list)
+rtems_bdbuf_purge_list (rtems_bdbuf_partition *partition,
+                        rtems_chain_control   *purge_list)
 {
   bool wake_buffer_waiters = false;
   rtems_chain_node *node = NULL;
@@ -2762,27 +3801,29 @@ rtems_bdbuf_purge_list (rtems_chain_control *purge_list)
     if (bd->waiters == 0)
       wake_buffer_waiters = true;
 
-    rtems_bdbuf_discard_buffer (bd);
+    rtems_bdbuf_discard_buffer (partition, bd);
   }
 
   if (wake_buffer_waiters)
-    rtems_bdbuf_wake (&bdbuf_cache.buffer_waiters);
+    rtems_bdbuf_wake_buffer_waiters (partition);
 }
 
 static void
-rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
+rtems_bdbuf_gather_for_purge (rtems_bdbuf_partition   *partition,
+                              rtems_chain_control     *purge_list,
                               const rtems_disk_device *dd)
 {
-  rtems_bdbuf_buffer *stack [RTEMS_BDBUF_AVL_MAX_HEIGHT];
-  rtems_bdbuf_buffer **prev = stack;
-  rtems_bdbuf_buffer *cur = bdbuf_cache.tree;
-
-  *prev = NULL;
+  size_t bucket;
 
-  while (cur != NULL)
+  for (bucket = 0; bucket <= partition->hash_mask; ++bucket)
   {
-    if (cur->dd == dd)
+    rtems_bdbuf_buffer *cur;
+
+    for (cur = partition->hash [bucket]; cur != NULL; cur = cur->hash_next)
     {
+      if (cur->dd != dd)
+        continue;
+
       switch (cur->state)
       {
         case RTEMS_BDBUF_STATE_FREE:
@@ -2791,13 +3832,13 @@ rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
         case RTEMS_BDBUF_STATE_TRANSFER_PURGED:
           break;
         case RTEMS_BDBUF_STATE_SYNC:
-          rtems_bdbuf_wake (&bdbuf_cache.transfer_waiters);
+          rtems_bdbuf_wake (&partition->transfer_waiters);
           /* Fall through */
         case RTEMS_BDBUF_STATE_MODIFIED:
           rtems_bdbuf_group_release (cur);
           /* Fall through */
         case RTEMS_BDBUF_STATE_CACHED:
-          rtems_chain_extract_unprotected (&cur->link);
+          rtems_bdbuf_remove_from_lru_list (partition, cur);
           rtems_chain_append_unprotected (purge_list, &cur->link);
           break;
         case RTEMS_BDBUF_STATE_TRANSFER:
@@ -2812,57 +3853,40 @@ rtems_bdbuf_gather_for_purge (rtems_chain_control *purge_list,
           rtems_bdbuf_fatal (RTEMS_BDBUF_FATAL_STATE_11);
       }
     }
-
-    if (cur->avl.left != NULL)
-    {
-      /* Left */
-      ++prev;
-      *prev = cur;
-      cur = cur->avl.left;
-    }
-    else if (cur->avl.right != NULL)
-    {
-      /* Right */
-      ++prev;
-      *prev = cur;
-      cur = cur->avl.right;
-    }
-    else
-    {
-      while (*prev != NULL
-             && (cur == (*prev)->avl.right || (*prev)->avl.right == NULL))
-      {
-        /* Up */
-        cur = *prev;
-        --prev;
-      }
-      if (*prev != NULL)
-        /* Right */
-        cur = (*prev)->avl.right;
-      else
-        /* Finished */
-        cur = NULL;
-    }
   }
 }
 
+/**
+ * Purge the buffers of the device.  All partitions must be locked.
+ *
+ * @param dd The disk device.
+ */
 static void
 rtems_bdbuf_do_purge_dev (rtems_disk_device *dd)
 {
-  rtems_chain_control purge_list;
+  uint32_t p;
 
-  rtems_chain_initialize_empty (&purge_list);
+  rtems_bdbuf_lock_cache ();
   rtems_bdbuf_read_ahead_reset (dd);
-  rtems_bdbuf_gather_for_purge (&purge_list, dd);
-  rtems_bdbuf_purge_list (&purge_list);
+  rtems_bdbuf_unlock_cache ();
+
+  for (p = 0; p < bdbuf_cache.partition_count; ++p)
+  {
+    rtems_bdbuf_partition *partition = &bdbuf_cache.partitions [p];
+    rtems_chain_control    purge_list;
+
+    rtems_chain_initialize_empty (&purge_list);
+    rtems_bdbuf_gather_for_purge (partition, &purge_list, dd);
+    rtems_bdbuf_purge_list (partition, &purge_list);
+  }
 }
 
 void
 rtems_bdbuf_purge_dev (rtems_disk_device *dd)
 {
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_all_partitions ();
   rtems_bdbuf_do_purge_dev (dd);
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_all_partitions ();
 }
 
 rtems_status_code
@@ -2879,7 +3903,7 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
   if (sync)
     rtems_bdbuf_syncdev (dd);
 
-  rtems_bdbuf_lock_cache ();
+  rtems_bdbuf_lock_all_partitions ();
 
   if (block_size > 0)
   {
@@ -2917,11 +3941,104 @@ rtems_bdbuf_set_block_size (rtems_disk_device *dd,
     sc = RTEMS_INVALID_NUMBER;
   }
 
-  rtems_bdbuf_unlock_cache ();
+  rtems_bdbuf_unlock_all_partitions ();
 
   return sc;
 }
 
+/**
+ * Returns the maximum count of blocks of a read-ahead transfer starting at the
+ * media block.  With more than one partition the transfer must not cross the
+ * extent of the partition.
+ *
+ * @param dd The disk device.
+ * @param media_block The first media block of the transfer.
+ */
+static uint32_t
+rtems_bdbuf_max_read_ahead_blocks (const rtems_disk_device *dd,
+                                   rtems_blkdev_bnum        media_block)
+{
+  uint32_t max_blocks = bdbuf_config.max_read_ahead_blocks;
+
+  if (bdbuf_cache.partition_count > 1)
+  {
+    uint32_t extent_size = 1U << RTEMS_BDBUF_PARTITION_EXTENT_SHIFT;
+    uint32_t media_blocks = extent_size - (media_block & (extent_size - 1));
+    uint32_t media_blocks_per_block = dd->media_blocks_per_block;
+    uint32_t extent_blocks = (media_blocks + media_blocks_per_block - 1)
+      / media_blocks_per_block;
+
+    if (max_blocks > extent_blocks)
+      max_blocks = extent_blocks;
+  }
+
+  return max_blocks;
+}
+
+/**
+ * Executes the read-ahead request of a stream.  The cache lock must be owned.
+ * It is released during the transfer.
+ *
+ * @param dd The disk device.
+ * @param stream The pending stream.
+ */
+static void
+rtems_bdbuf_read_ahead_stream (rtems_disk_device              *dd,
+                               rtems_blkdev_read_ahead_stream *stream)
+{
+  rtems_blkdev_bnum block = stream->next;
+  rtems_blkdev_bnum media_block = 0;
+  rtems_status_code sc =
+    rtems_bdbuf_get_media_block (dd, block, &media_block);
+
+  if (sc == RTEMS_SUCCESSFUL)
+  {
+    rtems_bdbuf_partition *partition =
+      rtems_bdbuf_get_partition (dd, media_block);
+    rtems_bdbuf_buffer *bd;
+
+    rtems_bdbuf_unlock_cache ();
+    rtems_bdbuf_lock_partition (partition);
+
+    bd = rtems_bdbuf_get_buffer_for_read_ahead (partition, dd, media_block);
+
+    if (bd != NULL)
+    {
+      uint32_t transfer_count = dd->block_count - block;
+      uint32_t max_transfer_count =
+        rtems_bdbuf_max_read_ahead_blocks (dd, media_block);
+
+      rtems_bdbuf_lock_cache ();
+
+      if (max_transfer_count > stream->window)
+        max_transfer_count = stream->window;
+
+      if (transfer_count >= max_transfer_count)
+      {
+        transfer_count = max_transfer_count;
+        stream->trigger = block + transfer_count / 2;
+        stream->next = block + transfer_count;
+      }
+      else
+      {
+        stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+      }
+
+      ++dd->stats.read_ahead_transfers;
+      rtems_bdbuf_unlock_cache ();
+
+      rtems_bdbuf_execute_read_request (partition, dd, bd, transfer_count);
+    }
+
+    rtems_bdbuf_unlock_partition (partition);
+    rtems_bdbuf_lock_cache ();
+  }
+  else
+  {
+    stream->trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  }
+}
+
 static rtems_task
 rtems_bdbuf_read_ahead_task (rtems_task_argument arg)
 {
@@ -2938,42 +4055,24 @@ rtems_bdbuf_read_ahead_task (rtems_task_argument arg)
     {
       rtems_disk_device *dd =
         RTEMS_CONTAINER_OF (node, rtems_disk_device, read_ahead.node);
-      rtems_blkdev_bnum block = dd->read_ahead.next;
-      rtems_blkdev_bnum media_block = 0;
-      rtems_status_code sc =
-        rtems_bdbuf_get_media_block (dd, block, &media_block);
+      size_t i;
 
       rtems_chain_set_off_chain (&dd->read_ahead.node);
 
-      if (sc == RTEMS_SUCCESSFUL)
+      /*
+       * The streams are processed in index order.  A stream which becomes
+       * pending while the cache lock is released enqueues the disk again.
+       */
+      for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i)
       {
-        rtems_bdbuf_buffer *bd =
-          rtems_bdbuf_get_buffer_for_read_ahead (dd, media_block);
+        rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [i];
 
-        if (bd != NULL)
+        if (stream->pending)
         {
-          uint32_t transfer_count = dd->block_count - block;
-          uint32_t max_transfer_count = bdbuf_config.max_read_ahead_blocks;
-
-          if (transfer_count >= max_transfer_count)
-          {
-            transfer_count = max_transfer_count;
-            dd->read_ahead.trigger = block + transfer_count / 2;
-            dd->read_ahead.next = block + transfer_count;
-          }
-          else
-          {
-            dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
-          }
-
-          ++dd->stats.read_ahead_transfers;
-          rtems_bdbuf_execute_read_request (dd, bd, transfer_count);
+          stream->pending = false;
+          rtems_bdbuf_read_ahead_stream (dd, stream);
         }
       }
-      else
-      {
-        dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
-      }
     }
 
     rtems_bdbuf_unlock_cache ();
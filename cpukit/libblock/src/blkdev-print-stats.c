@@ -24,6 +24,7 @@
 #endif
 
 #include <rtems/blkdev.h>
+#include <rtems/bdbuf.h>
 
 #include <inttypes.h>
 
@@ -35,6 +36,26 @@ void rtems_blkdev_print_stats(
   const rtems_printer* printer
 )
 {
+  uint32_t read_count = stats->read_hits + stats->read_misses;
+  uint32_t hit_ratio = 0;
+  const char *policy;
+
+  if (read_count > 0) {
+    hit_ratio = (uint32_t) (((uint64_t) stats->read_hits * 1000) / read_count);
+  }
+
+  switch (rtems_bdbuf_configuration.replacement_policy) {
+    case RTEMS_BDBUF_REPLACEMENT_LRU:
+      policy = "LRU";
+      break;
+    case RTEMS_BDBUF_REPLACEMENT_2Q:
+      policy = "2Q";
+      break;
+    default:
+      policy = "?";
+      break;
+  }
+
   rtems_printf(
      printer,
      "-------------------------------------------------------------------------------\n"
@@ -43,25 +64,36 @@ void rtems_blkdev_print_stats(
      " MEDIA BLOCK SIZE     | %" PRIu32 "\n"
      " MEDIA BLOCK COUNT    | %" PRIu32 "\n"
      " BLOCK SIZE           | %" PRIu32 "\n"
+     " REPLACEMENT POLICY   | %s\n"
      " READ HITS            | %" PRIu32 "\n"
      " READ MISSES          | %" PRIu32 "\n"
+     " READ HIT RATIO       | %" PRIu32 ".%" PRIu32 "%%\n"
+     " READ GHOST HITS      | %" PRIu32 "\n"
      " READ AHEAD TRANSFERS | %" PRIu32 "\n"
      " READ BLOCKS          | %" PRIu32 "\n"
      " READ ERRORS          | %" PRIu32 "\n"
      " WRITE TRANSFERS      | %" PRIu32 "\n"
      " WRITE BLOCKS         | %" PRIu32 "\n"
      " WRITE ERRORS         | %" PRIu32 "\n"
+     " DISCARD REQUESTS     | %" PRIu32 "\n"
+     " DISCARD BLOCKS       | %" PRIu32 "\n"
      "----------------------+--------------------------------------------------------\n",
      media_block_size,
      media_block_count,
      block_size,
+     policy,
      stats->read_hits,
      stats->read_misses,
+     hit_ratio / 10,
+     hit_ratio % 10,
+     stats->read_ghost_hits,
      stats->read_ahead_transfers,
      stats->read_blocks,
      stats->read_errors,
      stats->write_transfers,
      stats->write_blocks,
-     stats->write_errors
+     stats->write_errors,
+     stats->discard_requests,
+     stats->discard_blocks
   );
 }
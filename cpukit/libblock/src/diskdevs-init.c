@@ -28,6 +28,15 @@
 
 #include <string.h>
 
+static void rtems_disk_init_read_ahead(rtems_disk_device *dd)
+{
+  size_t i;
+
+  for (i = 0; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i) {
+    dd->read_ahead.streams[i].trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  }
+}
+
 rtems_status_code rtems_disk_init_phys(
   rtems_disk_device *dd,
   uint32_t block_size,
@@ -45,13 +54,22 @@ rtems_status_code rtems_disk_init_phys(
   dd->media_block_size = block_size;
   dd->ioctl = handler;
   dd->driver_data = driver_data;
-  dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  dd->queue_depth = 1;
+  rtems_disk_init_read_ahead(dd);
 
   if (block_count > 0) {
     if ((*handler)(dd, RTEMS_BLKIO_CAPABILITIES, &dd->capabilities) != 0) {
       dd->capabilities = 0;
     }
 
+    if (
+      (dd->capabilities & RTEMS_BLKDEV_CAP_QUEUED_REQUESTS) != 0
+        && ((*handler)(dd, RTEMS_BLKIO_GETQUEUEDEPTH, &dd->queue_depth) != 0
+          || dd->queue_depth == 0)
+    ) {
+      dd->queue_depth = 1;
+    }
+
     sc = rtems_bdbuf_set_block_size(dd, block_size, false);
   } else {
     sc = RTEMS_INVALID_NUMBER;
@@ -77,7 +95,8 @@ rtems_status_code rtems_disk_init_log(
   dd->media_block_size = phys_dd->media_block_size;
   dd->ioctl = phys_dd->ioctl;
   dd->driver_data = phys_dd->driver_data;
-  dd->read_ahead.trigger = RTEMS_DISK_READ_AHEAD_NO_TRIGGER;
+  dd->queue_depth = phys_dd->queue_depth;
+  rtems_disk_init_read_ahead(dd);
 
   if (phys_dd->phys_dev == phys_dd) {
     rtems_blkdev_bnum phys_block_count = phys_dd->size;
@@ -1818,6 +1818,54 @@ rtems_fdisk_read_block (rtems_flashdisk* fd,
   return EIO;
 }
 
+/**
+ * Release the page with the data of a block. The page is flagged as used so
+ * the compaction can reclaim it.
+ *
+ * @param fd The flashdisk control table.
+ * @param bc The block control of the block with the page.
+ */
+static void
+rtems_fdisk_release_page (rtems_flashdisk* fd, rtems_fdisk_block_ctl* bc)
+{
+  rtems_fdisk_segment_ctl* sc = bc->segment;
+  rtems_fdisk_page_desc*   pd = &sc->page_descriptors[bc->page];
+  int                      ret;
+
+  /*
+   * The page exists in flash so we need to set the used flag
+   * in the page descriptor. The descriptor is in memory with the
+   * segment control block. We can assume this memory copy
+   * matches the flash device.
+   */
+
+  rtems_fdisk_page_desc_set_flags (pd, RTEMS_FDISK_PAGE_USED);
+
+  ret = rtems_fdisk_seg_write_page_desc_flags (fd, sc, bc->page, pd);
+
+  if (ret)
+  {
+#if RTEMS_FDISK_TRACE
+    rtems_fdisk_info (fd, " release:%02d-%03d-%03d: "      \
+                      "write used page desc failed: %s (%d)",
+                      sc->device, sc->segment, bc->page,
+                      strerror (ret), ret);
+#endif
+  }
+  else
+  {
+    sc->pages_active--;
+    sc->pages_used++;
+  }
+
+  /*
+   * If possible reuse this segment. This will mean the segment
+   * needs to be removed from the available list and placed
+   * back if space is still available.
+   */
+  rtems_fdisk_queue_segment (fd, sc);
+}
+
 /**
  * Write a block. The block:
  *
@@ -1876,7 +1924,6 @@ rtems_fdisk_write_block (rtems_flashdisk* fd,
   if (bc->segment)
   {
     sc = bc->segment;
-    pd = &sc->page_descriptors[bc->page];
 
 #if RTEMS_FDISK_TRACE
     rtems_fdisk_info (fd, " write:%02d-%03d-%03d: flag used",
@@ -1896,38 +1943,7 @@ rtems_fdisk_write_block (rtems_flashdisk* fd,
       return 0;
     }
 
-    /*
-     * The page exists in flash so we need to set the used flag
-     * in the page descriptor. The descriptor is in memory with the
-     * segment control block. We can assume this memory copy
-     * matches the flash device.
-     */
-
-    rtems_fdisk_page_desc_set_flags (pd, RTEMS_FDISK_PAGE_USED);
-
-    ret = rtems_fdisk_seg_write_page_desc_flags (fd, sc, bc->page, pd);
-
-    if (ret)
-    {
-#if RTEMS_FDISK_TRACE
-      rtems_fdisk_info (fd, " write:%02d-%03d-%03d: "      \
-                        "write used page desc failed: %s (%d)",
-                        sc->device, sc->segment, bc->page,
-                        strerror (ret), ret);
-#endif
-    }
-    else
-    {
-      sc->pages_active--;
-      sc->pages_used++;
-    }
-
-    /*
-     * If possible reuse this segment. This will mean the segment
-     * needs to be removed from the available list and placed
-     * back if space is still available.
-     */
-    rtems_fdisk_queue_segment (fd, sc);
+    rtems_fdisk_release_page (fd, bc);
 
     /*
      * If no background compacting then compact in the forground.
@@ -2132,6 +2148,73 @@ rtems_fdisk_write (rtems_flashdisk* fd, rtems_blkdev_request* req)
   return 0;
 }
 
+/**
+ * Discard a block. The block no longer has a page in flash and reads as
+ * erased.
+ *
+ * @param fd The flashdisk control table.
+ * @param block The block number to discard.
+ */
+static int
+rtems_fdisk_discard_block (rtems_flashdisk* fd, uint32_t block)
+{
+  rtems_fdisk_block_ctl* bc;
+
+#if RTEMS_FDISK_TRACE
+  rtems_fdisk_info (fd, "discard-block:%d", block);
+#endif
+
+  if (block >= (fd->block_count - fd->unavail_blocks))
+  {
+    rtems_fdisk_error ("discard-block: block out of range: %d", block);
+    return EIO;
+  }
+
+  bc = &fd->blocks[block];
+
+  if (bc->segment)
+  {
+    rtems_fdisk_release_page (fd, bc);
+
+    bc->segment = NULL;
+    bc->page    = 0;
+  }
+
+  return 0;
+}
+
+/**
+ * Flash disk DISCARD request handler. The pages of the discarded blocks are
+ * released, so the compaction does not copy them.
+ *
+ * @param req Pointers to the DISCARD block device request info.
+ * @retval 0 Always.  The request done callback contains the status.
+ */
+static int
+rtems_fdisk_discard (rtems_flashdisk* fd, rtems_blkdev_request* req)
+{
+  rtems_blkdev_sg_buffer* sg = req->bufs;
+  uint32_t                buf;
+  int                     ret = 0;
+
+  for (buf = 0; (ret == 0) && (buf < req->bufnum); buf++, sg++)
+  {
+    uint32_t fb;
+    uint32_t b;
+    fb = sg->length / fd->block_size;
+    for (b = 0; b < fb; b++)
+    {
+      ret = rtems_fdisk_discard_block (fd, sg->block + b);
+      if (ret)
+        break;
+    }
+  }
+
+  rtems_blkdev_request_done (req, ret ? RTEMS_IO_ERROR : RTEMS_SUCCESSFUL);
+
+  return 0;
+}
+
 /**
  * Flash disk erase disk.
  *
@@ -2390,6 +2473,10 @@ rtems_fdisk_ioctl (rtems_disk_device *dd, uint32_t req, void* argp)
             errno = rtems_fdisk_write (fd, r);
             break;
 
+          case RTEMS_BLKDEV_REQ_DISCARD:
+            errno = rtems_fdisk_discard (fd, r);
+            break;
+
           default:
             errno = EINVAL;
             break;
@@ -2397,6 +2484,10 @@ rtems_fdisk_ioctl (rtems_disk_device *dd, uint32_t req, void* argp)
       }
       break;
 
+    case RTEMS_BLKIO_CAPABILITIES:
+      *(uint32_t*) argp = RTEMS_BLKDEV_CAP_DISCARD;
+      break;
+
     case RTEMS_FDISK_IOCTL_ERASE_DISK:
       errno = rtems_fdisk_erase_disk (fd);
       break;
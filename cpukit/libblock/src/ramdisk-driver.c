@@ -95,6 +95,33 @@ ramdisk_write(struct ramdisk *rd, rtems_blkdev_request *req)
     return 0;
 }
 
+static int
+ramdisk_discard(struct ramdisk *rd, rtems_blkdev_request *req)
+{
+    uint8_t *area = rd->area;
+    uint32_t   i;
+    rtems_blkdev_sg_buffer *sg;
+
+#if RTEMS_RAMDISK_TRACE
+    rtems_ramdisk_printf (rd, "ramdisk discard: start=%d, ranges=%d",
+                          req->bufs[0].block, req->bufnum);
+#endif
+    /*
+     * The memory area is contiguous, so the discarded blocks cannot be given
+     * back.  They read as zero like the blocks of a new RAM disk.
+     */
+    for (i = 0, sg = req->bufs; i < req->bufnum; i++, sg++)
+    {
+#if RTEMS_RAMDISK_TRACE
+        rtems_ramdisk_printf (rd, "ramdisk discard: range=%d block=%d length=%d",
+                              i, sg->block, sg->length);
+#endif
+        memset(area + (sg->block * rd->block_size), 0, sg->length);
+    }
+    rtems_blkdev_request_done (req, RTEMS_SUCCESSFUL);
+    return 0;
+}
+
 int
 ramdisk_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
 {
@@ -114,6 +141,9 @@ ramdisk_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
                 case RTEMS_BLKDEV_REQ_WRITE:
                     return ramdisk_write(rd, r);
 
+                case RTEMS_BLKDEV_REQ_DISCARD:
+                    return ramdisk_discard(rd, r);
+
                 default:
                     errno = EINVAL;
                     return -1;
@@ -121,6 +151,10 @@ ramdisk_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
             break;
         }
 
+        case RTEMS_BLKIO_CAPABILITIES:
+            *(uint32_t *) argp = RTEMS_BLKDEV_CAP_DISCARD;
+            return 0;
+
         case RTEMS_BLKIO_DELETED:
             if (rd->free_at_delete_request) {
               ramdisk_free(rd);
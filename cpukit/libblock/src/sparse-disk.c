@@ -266,6 +266,56 @@ static int sparse_disk_read_write(
   return 0;
 }
 
+/*
+ * Give the buffers of discarded blocks back to the unused part of the key table
+ */
+static int sparse_disk_discard(
+  rtems_sparse_disk    *sparse_disk,
+  rtems_blkdev_request *req )
+{
+  uint32_t                req_buffer;
+  rtems_blkdev_sg_buffer *scatter_gather;
+  rtems_blkdev_bnum       begin;
+  rtems_blkdev_bnum       end;
+  size_t                  i;
+  size_t                  used_count;
+
+  rtems_mutex_lock( &sparse_disk->mutex );
+
+  for ( req_buffer = 0; req_buffer < req->bufnum; ++req_buffer ) {
+    scatter_gather = &req->bufs[req_buffer];
+    begin          = scatter_gather->block;
+    end            = begin + scatter_gather->length
+                     / sparse_disk->media_block_size;
+    used_count     = 0;
+
+    /*
+     * Move the remaining keys in order to the front, so that they stay
+     * sorted.  The keys of the discarded blocks end up behind them.
+     */
+    for ( i = 0; i < sparse_disk->used_count; ++i ) {
+      rtems_sparse_disk_key key = sparse_disk->key_table[i];
+
+      if ( key.block >= begin && key.block < end ) {
+        memset( key.data, sparse_disk->fill_pattern,
+                sparse_disk->media_block_size );
+      } else {
+        sparse_disk->key_table[i] = sparse_disk->key_table[used_count];
+        sparse_disk->key_table[used_count] = key;
+        ++used_count;
+      }
+    }
+
+    sparse_disk->used_count = used_count;
+  }
+
+  rtems_mutex_unlock( &sparse_disk->mutex );
+
+  rtems_blkdev_request_done( req, RTEMS_SUCCESSFUL );
+
+  return 0;
+}
+
 /*
  * ioctl handler to be passed to the block device handler
  */
@@ -280,9 +330,15 @@ static int sparse_disk_ioctl( rtems_disk_device *dd, uint32_t req, void *argp )
       case RTEMS_BLKDEV_REQ_READ:
       case RTEMS_BLKDEV_REQ_WRITE:
         return sparse_disk_read_write( sd, r, r->req == RTEMS_BLKDEV_REQ_READ );
+      case RTEMS_BLKDEV_REQ_DISCARD:
+        return sparse_disk_discard( sd, r );
       default:
         break;
     }
+  } else if ( RTEMS_BLKIO_CAPABILITIES == req ) {
+    *(uint32_t *) argp = RTEMS_BLKDEV_CAP_DISCARD;
+
+    return 0;
   } else if ( RTEMS_BLKIO_DELETED == req ) {
     rtems_mutex_destroy( &sd->mutex );
 
@@ -52,7 +52,8 @@ static const rtems_filesystem_file_handlers_r _Console_simple_Handlers = {
   .fcntl_h = rtems_filesystem_default_fcntl,
   .readv_h = rtems_filesystem_default_readv,
   .writev_h = rtems_filesystem_default_writev,
-  .mmap_h = rtems_filesystem_default_mmap
+  .mmap_h = rtems_filesystem_default_mmap,
+  .fallocate_h = rtems_filesystem_default_fallocate
 };
 
 static const IMFS_node_control
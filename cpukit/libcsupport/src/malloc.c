@@ -36,7 +36,17 @@ void *malloc(
   if ( !size )
     return (void *) 0;
 
-  return_this = rtems_heap_allocate_aligned_with_boundary( size, 0, 0 );
+  /*
+   *  Try the per-processor cache first, it falls back to the heap only for
+   *  sizes it does not cache or if it cannot obtain objects from the heap.
+   */
+  return_this = NULL;
+  if ( rtems_malloc_cache != NULL )
+    return_this = (*rtems_malloc_cache->allocate)( size );
+
+  if ( !return_this )
+    return_this = rtems_heap_allocate_aligned_with_boundary( size, 0, 0 );
+
   if ( !return_this ) {
     errno = ENOMEM;
     return (void *) 0;
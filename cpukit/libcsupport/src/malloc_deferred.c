@@ -57,6 +57,14 @@ static void *_Malloc_Get_deferred_free( void )
   rtems_interrupt_lock_context lock_context;
   void *p;
 
+  /*
+   * This is called on each allocation, so avoid the lock in the common case.
+   * A free deferred concurrently is processed by a later call.
+   */
+  if ( rtems_chain_is_empty( &_Malloc_GC_list ) ) {
+    return NULL;
+  }
+
   rtems_interrupt_lock_acquire( &_Malloc_GC_lock, &lock_context );
   p = rtems_chain_get_unprotected( &_Malloc_GC_list );
   rtems_interrupt_lock_release( &_Malloc_GC_lock, &lock_context );
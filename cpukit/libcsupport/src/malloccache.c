@@ -0,0 +1,398 @@
+/**
+ *  @file
+ *
+ *  @brief Per-Processor Malloc Cache
+ *  @ingroup libcsupport
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef RTEMS_NEWLIB
+#include <string.h>
+
+#include "malloc_p.h"
+
+#include <rtems/score/heapimpl.h>
+#include <rtems/score/isrlevel.h>
+#include <rtems/score/percpudata.h>
+#include <rtems/score/smp.h>
+
+/*
+ * Capacity of a magazine in objects.  A refill or drain moves half of the
+ * capacity, so a processor which alternates between allocations and frees
+ * touches the heap at most once every MALLOC_CACHE_BATCH operations.
+ */
+#define MALLOC_CACHE_CAPACITY 32
+
+#define MALLOC_CACHE_BATCH ( MALLOC_CACHE_CAPACITY / 2 )
+
+/*
+ * Key of the mark placed at the end of the objects in a magazine.  It is used
+ * to detect a free() of an object which is already in a magazine.
+ */
+#define MALLOC_CACHE_KEY ( (uintptr_t) 0x6d63616cU )
+
+typedef struct {
+  uintptr_t key;
+  uintptr_t object;
+} Malloc_Cache_mark;
+
+typedef struct {
+  uint32_t count;
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t refills;
+  uint32_t drains;
+  void *objects[ MALLOC_CACHE_CAPACITY ];
+} Malloc_Cache_magazine;
+
+typedef struct {
+  Malloc_Cache_magazine magazines[ RTEMS_MALLOC_CACHE_CLASS_COUNT ];
+} Malloc_Cache_control;
+
+static PER_CPU_DATA_ITEM( Malloc_Cache_control, _Malloc_Cache );
+
+static Malloc_Cache_magazine *_Malloc_Cache_get_magazine(
+  const Per_CPU_Control *cpu,
+  size_t                 index
+)
+{
+  Malloc_Cache_control *cache;
+
+  cache = PER_CPU_DATA_GET( cpu, Malloc_Cache_control, _Malloc_Cache );
+  return &cache->magazines[ index ];
+}
+
+static size_t _Malloc_Cache_class_size( size_t index )
+{
+  return (size_t) RTEMS_MALLOC_CACHE_MINIMUM_SIZE << index;
+}
+
+/*
+ * The mark is at the end of the object, so that it does not overlap with the
+ * chain node of a deferred free on targets with 32-bit pointers.
+ */
+static Malloc_Cache_mark *_Malloc_Cache_mark_of_object(
+  void   *ptr,
+  size_t  index
+)
+{
+  return (Malloc_Cache_mark *) ( (char *) ptr
+    + _Malloc_Cache_class_size( index ) - sizeof( Malloc_Cache_mark ) );
+}
+
+static void _Malloc_Cache_set_mark( void *ptr, size_t index )
+{
+  Malloc_Cache_mark *mark;
+
+  mark = _Malloc_Cache_mark_of_object( ptr, index );
+  mark->key = MALLOC_CACHE_KEY;
+  mark->object = (uintptr_t) ptr;
+}
+
+static void _Malloc_Cache_clear_mark( void *ptr, size_t index )
+{
+  Malloc_Cache_mark *mark;
+
+  mark = _Malloc_Cache_mark_of_object( ptr, index );
+  mark->key = 0;
+  mark->object = 0;
+}
+
+static bool _Malloc_Cache_is_marked( void *ptr, size_t index )
+{
+  const Malloc_Cache_mark *mark;
+
+  mark = _Malloc_Cache_mark_of_object( ptr, index );
+  return mark->key == MALLOC_CACHE_KEY && mark->object == (uintptr_t) ptr;
+}
+
+static int _Malloc_Cache_msb( size_t value )
+{
+  return (int) ( 8 * sizeof( value ) ) - 1 - __builtin_clzl( value );
+}
+
+/*
+ * Returns the index of the smallest class with an object size greater than or
+ * equal to the requested size.  The size must be in the cached range.
+ */
+static size_t _Malloc_Cache_index_of_request( size_t size )
+{
+  if ( size <= RTEMS_MALLOC_CACHE_MINIMUM_SIZE ) {
+    return 0;
+  }
+
+  return (size_t) ( _Malloc_Cache_msb( size - 1 ) + 1
+    - _Malloc_Cache_msb( RTEMS_MALLOC_CACHE_MINIMUM_SIZE ) );
+}
+
+/*
+ * Returns true and the index of the largest class with an object size less
+ * than or equal to the usable size of the used heap block, if the usable size
+ * is less than the double of this object size.  This bounds the memory wasted
+ * by a cached object.  Blocks which are not used from the heap point of view
+ * are rejected, so that the heap reports the invalid free.  Only the header of
+ * the block and the previous block used flag of the next block are read, which
+ * are stable while the caller owns the block.
+ */
+static bool _Malloc_Cache_index_of_object(
+  const Heap_Control *heap,
+  void               *ptr,
+  size_t             *index
+)
+{
+  uintptr_t alloc_begin;
+  Heap_Block *block;
+  Heap_Block *next_block;
+  uintptr_t usable_size;
+
+  alloc_begin = (uintptr_t) ptr;
+  block = _Heap_Block_of_alloc_area( alloc_begin, heap->page_size );
+
+  if ( !_Heap_Is_block_in_heap( heap, block ) ) {
+    return false;
+  }
+
+  next_block = _Heap_Block_at( block, _Heap_Block_size( block ) );
+
+  if (
+    !_Heap_Is_block_in_heap( heap, next_block )
+      || !_Heap_Is_prev_used( next_block )
+  ) {
+    return false;
+  }
+
+  usable_size = (uintptr_t) block + _Heap_Block_size( block )
+    + HEAP_ALLOC_BONUS - alloc_begin;
+
+  if (
+    usable_size < RTEMS_MALLOC_CACHE_MINIMUM_SIZE
+      || usable_size >= 2 * RTEMS_MALLOC_CACHE_MAXIMUM_SIZE
+  ) {
+    return false;
+  }
+
+  *index = (size_t) ( _Malloc_Cache_msb( usable_size )
+    - _Malloc_Cache_msb( RTEMS_MALLOC_CACHE_MINIMUM_SIZE ) );
+  return true;
+}
+
+static void *_Malloc_Cache_refill( size_t index )
+{
+  Heap_Control *heap;
+  uintptr_t size;
+  void *batch[ MALLOC_CACHE_BATCH ];
+  size_t n;
+  size_t i;
+  ISR_Level level;
+  Malloc_Cache_magazine *magazine;
+
+  heap = RTEMS_Malloc_Heap;
+  size = _Malloc_Cache_class_size( index );
+
+  _RTEMS_Lock_allocator();
+
+  for ( n = 0; n < MALLOC_CACHE_BATCH; ++n ) {
+    batch[ n ] = _Heap_Allocate( heap, size );
+
+    if ( batch[ n ] == NULL ) {
+      break;
+    }
+  }
+
+  _RTEMS_Unlock_allocator();
+
+  if ( n == 0 ) {
+    return NULL;
+  }
+
+  /*
+   * The executing thread may have migrated to another processor in the
+   * meantime, so put the batch into the magazine of the current processor.
+   */
+  _ISR_Local_disable( level );
+  magazine = _Malloc_Cache_get_magazine( _Per_CPU_Get(), index );
+  ++magazine->refills;
+
+  for ( i = 1; i < n && magazine->count < MALLOC_CACHE_CAPACITY; ++i ) {
+    _Malloc_Cache_set_mark( batch[ i ], index );
+    magazine->objects[ magazine->count ] = batch[ i ];
+    ++magazine->count;
+  }
+
+  _ISR_Local_enable( level );
+
+  if ( i < n ) {
+    _RTEMS_Lock_allocator();
+
+    while ( i < n ) {
+      _Heap_Free( heap, batch[ i ] );
+      ++i;
+    }
+
+    _RTEMS_Unlock_allocator();
+  }
+
+  return batch[ 0 ];
+}
+
+static void *_Malloc_Cache_allocate( size_t size )
+{
+  size_t index;
+  ISR_Level level;
+  Malloc_Cache_magazine *magazine;
+  void *p;
+
+  if (
+    size > RTEMS_MALLOC_CACHE_MAXIMUM_SIZE
+      || _Malloc_System_state() != MALLOC_SYSTEM_STATE_NORMAL
+  ) {
+    return NULL;
+  }
+
+  /*
+   * The deferred frees may put objects into the magazines, so process them
+   * before a cache hit bypasses the heap allocation which does it otherwise.
+   */
+  _Malloc_Process_deferred_frees();
+
+  index = _Malloc_Cache_index_of_request( size );
+
+  _ISR_Local_disable( level );
+  magazine = _Malloc_Cache_get_magazine( _Per_CPU_Get(), index );
+
+  if ( RTEMS_PREDICT_TRUE( magazine->count > 0 ) ) {
+    --magazine->count;
+    p = magazine->objects[ magazine->count ];
+    ++magazine->hits;
+    _ISR_Local_enable( level );
+    _Malloc_Cache_clear_mark( p, index );
+  } else {
+    ++magazine->misses;
+    _ISR_Local_enable( level );
+    p = _Malloc_Cache_refill( index );
+  }
+
+  if ( p != NULL && rtems_malloc_dirty_helper != NULL ) {
+    (*rtems_malloc_dirty_helper)( p, size );
+  }
+
+  return p;
+}
+
+static bool _Malloc_Cache_free( void *ptr )
+{
+  Heap_Control *heap;
+  size_t index;
+  ISR_Level level;
+  Malloc_Cache_magazine *magazine;
+  void *batch[ MALLOC_CACHE_BATCH ];
+  size_t i;
+
+  heap = RTEMS_Malloc_Heap;
+
+  if ( !_Malloc_Cache_index_of_object( heap, ptr, &index ) ) {
+    return false;
+  }
+
+  /*
+   * An object in a magazine is a used block for the heap, so a second free()
+   * of it would be accepted by the heap and the object would be cached twice.
+   */
+  if ( _Malloc_Cache_is_marked( ptr, index ) ) {
+    rtems_fatal( RTEMS_FATAL_SOURCE_INVALID_HEAP_FREE, (rtems_fatal_code) ptr );
+  }
+
+  _Malloc_Cache_set_mark( ptr, index );
+
+  _ISR_Local_disable( level );
+  magazine = _Malloc_Cache_get_magazine( _Per_CPU_Get(), index );
+
+  if ( RTEMS_PREDICT_TRUE( magazine->count < MALLOC_CACHE_CAPACITY ) ) {
+    magazine->objects[ magazine->count ] = ptr;
+    ++magazine->count;
+    _ISR_Local_enable( level );
+    return true;
+  }
+
+  magazine->count -= MALLOC_CACHE_BATCH;
+  memcpy(
+    batch,
+    &magazine->objects[ magazine->count ],
+    sizeof( batch )
+  );
+  magazine->objects[ magazine->count ] = ptr;
+  ++magazine->count;
+  ++magazine->drains;
+  _ISR_Local_enable( level );
+
+  for ( i = 0; i < MALLOC_CACHE_BATCH; ++i ) {
+    _Malloc_Cache_clear_mark( batch[ i ], index );
+  }
+
+  _RTEMS_Lock_allocator();
+
+  for ( i = 0; i < MALLOC_CACHE_BATCH; ++i ) {
+    if ( !_Heap_Free( heap, batch[ i ] ) ) {
+      rtems_fatal(
+        RTEMS_FATAL_SOURCE_INVALID_HEAP_FREE,
+        (rtems_fatal_code) batch[ i ]
+      );
+    }
+  }
+
+  _RTEMS_Unlock_allocator();
+
+  return true;
+}
+
+static void _Malloc_Cache_get_information(
+  rtems_malloc_cache_information *info
+)
+{
+  uint32_t cpu_count;
+  uint32_t cpu_index;
+  size_t index;
+
+  cpu_count = _SMP_Get_processor_count();
+
+  for ( index = 0; index < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++index ) {
+    rtems_malloc_cache_class_information *class_info;
+
+    class_info = &info->classes[ index ];
+    class_info->size = _Malloc_Cache_class_size( index );
+
+    /*
+     * The counters of other processors are read without synchronization, so
+     * the sums are only a snapshot.
+     */
+    for ( cpu_index = 0; cpu_index < cpu_count; ++cpu_index ) {
+      const Malloc_Cache_magazine *magazine;
+
+      magazine = _Malloc_Cache_get_magazine(
+        _Per_CPU_Get_by_index( cpu_index ),
+        index
+      );
+      class_info->cached += magazine->count;
+      class_info->hits += magazine->hits;
+      class_info->misses += magazine->misses;
+      class_info->refills += magazine->refills;
+      class_info->drains += magazine->drains;
+    }
+  }
+}
+
+const rtems_malloc_cache_handlers rtems_malloc_per_cpu_cache = {
+  .allocate = _Malloc_Cache_allocate,
+  .free = _Malloc_Cache_free,
+  .get_information = _Malloc_Cache_get_information
+};
+#endif
@@ -21,6 +21,8 @@
 #include <rtems/malloc.h>
 #include <rtems/score/protectedheap.h>
 
+#include <string.h>
+
 int malloc_info(
   Heap_Information_block *the_info
 )
@@ -31,3 +33,18 @@ int malloc_info(
   _Protected_heap_Get_information( RTEMS_Malloc_Heap, the_info );
   return 0;
 }
+
+int malloc_cache_info(
+  rtems_malloc_cache_information *info
+)
+{
+  if ( !info )
+    return -1;
+
+  memset( info, 0, sizeof( *info ) );
+
+  if ( rtems_malloc_cache != NULL )
+    (*rtems_malloc_cache->get_information)( info );
+
+  return 0;
+}
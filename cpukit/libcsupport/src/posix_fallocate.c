@@ -0,0 +1,62 @@
+/**
+ * @file
+ *
+ * @brief Allocates the Storage of a File Region
+ *
+ * @ingroup libcsupport
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <fcntl.h>
+#include <stdint.h>
+
+#include <rtems/libio_.h>
+
+static int do_fallocate( int fd, off_t offset, off_t len )
+{
+  rtems_libio_t *iop;
+  int rv;
+
+  LIBIO_GET_IOP_WITH_ACCESS( fd, iop, LIBIO_FLAGS_WRITE, EBADF );
+
+  rv = (*iop->pathinfo.handlers->fallocate_h)( iop, offset, len );
+  rtems_libio_iop_drop( iop );
+
+  return rv;
+}
+
+int posix_fallocate( int fd, off_t offset, off_t len )
+{
+  int saved_errno;
+  int eno;
+
+  if ( offset < 0 || len <= 0 ) {
+    return EINVAL;
+  }
+
+  if ( offset > INT64_MAX - len ) {
+    return EFBIG;
+  }
+
+  /* This function reports the error by its return value and not by errno */
+  saved_errno = errno;
+
+  if ( do_fallocate( fd, offset, len ) == 0 ) {
+    eno = 0;
+  } else {
+    eno = errno;
+  }
+
+  errno = saved_errno;
+
+  return eno;
+}
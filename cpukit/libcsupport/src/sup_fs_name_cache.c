@@ -0,0 +1,379 @@
+/**
+ * @file
+ *
+ * @brief File System Name Cache
+ *
+ * @ingroup LibIOInternal
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/libio_.h>
+#include <rtems/thread.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct name_cache_entry name_cache_entry;
+
+struct name_cache_entry {
+  /*
+   * Node on the free chain or the LRU chain.  The first entry of the LRU chain
+   * is the least recently used one.
+   */
+  rtems_chain_node lru_node;
+  name_cache_entry *hash_next;
+  const void *fs_info;
+  uintptr_t dir;
+  rtems_filesystem_name_cache_value value;
+  bool negative;
+  uint8_t namelen;
+  char name[ RTEMS_FILESYSTEM_NAME_CACHE_NAME_MAX ];
+};
+
+typedef struct {
+  rtems_mutex mutex;
+  name_cache_entry *entries;
+  name_cache_entry **buckets;
+  uint32_t bucket_mask;
+  rtems_chain_control free_chain;
+  rtems_chain_control lru_chain;
+  rtems_filesystem_name_cache_stats stats;
+} name_cache_control;
+
+static name_cache_control name_cache = {
+  .mutex = RTEMS_MUTEX_INITIALIZER( "Name Cache" ),
+  .free_chain = RTEMS_CHAIN_INITIALIZER_EMPTY( name_cache.free_chain ),
+  .lru_chain = RTEMS_CHAIN_INITIALIZER_EMPTY( name_cache.lru_chain )
+};
+
+static bool name_cache_is_cacheable( const char *name, size_t namelen )
+{
+  return namelen <= RTEMS_FILESYSTEM_NAME_CACHE_NAME_MAX
+    && !rtems_filesystem_is_current_directory( name, namelen )
+    && !rtems_filesystem_is_parent_directory( name, namelen );
+}
+
+/*
+ * The entries are allocated on demand, so that an application which does not
+ * use a file system with name cache support pays nothing.
+ */
+static bool name_cache_initialize( name_cache_control *cache )
+{
+  uint32_t count = rtems_filesystem_name_cache_entry_count;
+  uint32_t bucket_count;
+  uint32_t i;
+
+  if ( cache->entries != NULL ) {
+    return true;
+  }
+
+  if ( count == 0 ) {
+    return false;
+  }
+
+  bucket_count = 1;
+  while ( bucket_count < count ) {
+    bucket_count *= 2;
+  }
+
+  cache->entries = calloc( count, sizeof( *cache->entries ) );
+  cache->buckets = calloc( bucket_count, sizeof( *cache->buckets ) );
+
+  if ( cache->entries == NULL || cache->buckets == NULL ) {
+    free( cache->entries );
+    free( cache->buckets );
+    cache->entries = NULL;
+    cache->buckets = NULL;
+    return false;
+  }
+
+  cache->bucket_mask = bucket_count - 1;
+
+  for ( i = 0; i < count; ++i ) {
+    rtems_chain_append_unprotected(
+      &cache->free_chain,
+      &cache->entries[ i ].lru_node
+    );
+  }
+
+  return true;
+}
+
+static name_cache_entry **name_cache_bucket(
+  const name_cache_control *cache,
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+)
+{
+  uint32_t hash = 2166136261U;
+  size_t i;
+
+  hash ^= (uint32_t) (uintptr_t) fs_info;
+  hash *= 16777619U;
+  hash ^= (uint32_t) dir;
+  hash *= 16777619U;
+
+  for ( i = 0; i < namelen; ++i ) {
+    hash ^= (uint8_t) name[ i ];
+    hash *= 16777619U;
+  }
+
+  return &cache->buckets[ hash & cache->bucket_mask ];
+}
+
+/*
+ * Returns the link pointing to the entry of the name or to the NULL at the
+ * end of the bucket.
+ */
+static name_cache_entry **name_cache_find(
+  const name_cache_control *cache,
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+)
+{
+  name_cache_entry **link;
+  name_cache_entry *entry;
+
+  link = name_cache_bucket( cache, fs_info, dir, name, namelen );
+
+  while ( ( entry = *link ) != NULL ) {
+    if (
+      entry->fs_info == fs_info
+        && entry->dir == dir
+        && entry->namelen == namelen
+        && memcmp( entry->name, name, namelen ) == 0
+    ) {
+      break;
+    }
+
+    link = &entry->hash_next;
+  }
+
+  return link;
+}
+
+static void name_cache_unhash(
+  name_cache_control *cache,
+  name_cache_entry *entry
+)
+{
+  name_cache_entry **link;
+
+  link = name_cache_bucket(
+    cache,
+    entry->fs_info,
+    entry->dir,
+    entry->name,
+    entry->namelen
+  );
+
+  while ( *link != entry ) {
+    link = &( *link )->hash_next;
+  }
+
+  *link = entry->hash_next;
+}
+
+static void name_cache_free(
+  name_cache_control *cache,
+  name_cache_entry *entry
+)
+{
+  name_cache_unhash( cache, entry );
+  entry->fs_info = NULL;
+  rtems_chain_extract_unprotected( &entry->lru_node );
+  rtems_chain_prepend_unprotected( &cache->free_chain, &entry->lru_node );
+}
+
+rtems_filesystem_name_cache_status rtems_filesystem_name_cache_lookup(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  rtems_filesystem_name_cache_value *value
+)
+{
+  name_cache_control *cache = &name_cache;
+  rtems_filesystem_name_cache_status status;
+  name_cache_entry *entry;
+
+  if ( cache->entries == NULL || !name_cache_is_cacheable( name, namelen ) ) {
+    return RTEMS_FILESYSTEM_NAME_CACHE_MISS;
+  }
+
+  rtems_mutex_lock( &cache->mutex );
+
+  entry = *name_cache_find( cache, fs_info, dir, name, namelen );
+
+  if ( entry != NULL ) {
+    rtems_chain_extract_unprotected( &entry->lru_node );
+    rtems_chain_append_unprotected( &cache->lru_chain, &entry->lru_node );
+
+    if ( entry->negative ) {
+      ++cache->stats.negative_hits;
+      status = RTEMS_FILESYSTEM_NAME_CACHE_NEGATIVE_HIT;
+    } else {
+      ++cache->stats.hits;
+      *value = entry->value;
+      status = RTEMS_FILESYSTEM_NAME_CACHE_HIT;
+    }
+  } else {
+    ++cache->stats.misses;
+    status = RTEMS_FILESYSTEM_NAME_CACHE_MISS;
+  }
+
+  rtems_mutex_unlock( &cache->mutex );
+
+  return status;
+}
+
+void rtems_filesystem_name_cache_enter(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen,
+  const rtems_filesystem_name_cache_value *value
+)
+{
+  name_cache_control *cache = &name_cache;
+  name_cache_entry **link;
+  name_cache_entry *entry;
+
+  if ( !name_cache_is_cacheable( name, namelen ) ) {
+    return;
+  }
+
+  rtems_mutex_lock( &cache->mutex );
+
+  if ( name_cache_initialize( cache ) ) {
+    link = name_cache_find( cache, fs_info, dir, name, namelen );
+    entry = *link;
+
+    if ( entry == NULL ) {
+      if ( rtems_chain_is_empty( &cache->free_chain ) ) {
+        entry = (name_cache_entry *) rtems_chain_first( &cache->lru_chain );
+        name_cache_free( cache, entry );
+
+        /* The link may point into the freed entry */
+        link = name_cache_find( cache, fs_info, dir, name, namelen );
+      }
+
+      entry = (name_cache_entry *)
+        rtems_chain_get_first_unprotected( &cache->free_chain );
+      entry->fs_info = fs_info;
+      entry->dir = dir;
+      entry->namelen = (uint8_t) namelen;
+      memcpy( entry->name, name, namelen );
+      entry->hash_next = NULL;
+      *link = entry;
+    } else {
+      rtems_chain_extract_unprotected( &entry->lru_node );
+    }
+
+    rtems_chain_append_unprotected( &cache->lru_chain, &entry->lru_node );
+
+    if ( value != NULL ) {
+      entry->negative = false;
+      entry->value = *value;
+    } else {
+      entry->negative = true;
+    }
+  }
+
+  rtems_mutex_unlock( &cache->mutex );
+}
+
+void rtems_filesystem_name_cache_remove(
+  const void *fs_info,
+  uintptr_t dir,
+  const char *name,
+  size_t namelen
+)
+{
+  name_cache_control *cache = &name_cache;
+  name_cache_entry *entry;
+
+  if ( cache->entries == NULL || !name_cache_is_cacheable( name, namelen ) ) {
+    return;
+  }
+
+  rtems_mutex_lock( &cache->mutex );
+
+  entry = *name_cache_find( cache, fs_info, dir, name, namelen );
+
+  if ( entry != NULL ) {
+    name_cache_free( cache, entry );
+  }
+
+  rtems_mutex_unlock( &cache->mutex );
+}
+
+static void name_cache_purge(
+  const void *fs_info,
+  uintptr_t dir,
+  bool any_dir
+)
+{
+  name_cache_control *cache = &name_cache;
+  rtems_chain_node *node;
+  rtems_chain_node *tail;
+
+  if ( cache->entries == NULL ) {
+    return;
+  }
+
+  rtems_mutex_lock( &cache->mutex );
+
+  node = rtems_chain_first( &cache->lru_chain );
+  tail = rtems_chain_tail( &cache->lru_chain );
+
+  while ( node != tail ) {
+    name_cache_entry *entry = (name_cache_entry *) node;
+
+    node = rtems_chain_next( node );
+
+    if ( entry->fs_info == fs_info && ( any_dir || entry->dir == dir ) ) {
+      name_cache_free( cache, entry );
+    }
+  }
+
+  rtems_mutex_unlock( &cache->mutex );
+}
+
+void rtems_filesystem_name_cache_purge_directory(
+  const void *fs_info,
+  uintptr_t dir
+)
+{
+  name_cache_purge( fs_info, dir, false );
+}
+
+void rtems_filesystem_name_cache_purge( const void *fs_info )
+{
+  name_cache_purge( fs_info, 0, true );
+}
+
+void rtems_filesystem_name_cache_get_and_reset_stats(
+  rtems_filesystem_name_cache_stats *stats
+)
+{
+  name_cache_control *cache = &name_cache;
+
+  rtems_mutex_lock( &cache->mutex );
+  *stats = cache->stats;
+  memset( &cache->stats, 0, sizeof( cache->stats ) );
+  rtems_mutex_unlock( &cache->mutex );
+}
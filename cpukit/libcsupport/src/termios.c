@@ -2123,6 +2123,7 @@ static const rtems_filesystem_file_handlers_r rtems_termios_imfs_handler = {
   .fcntl_h = rtems_filesystem_default_fcntl,
   .kqfilter_h = rtems_termios_kqfilter,
   .mmap_h = rtems_termios_mmap,
+  .fallocate_h = rtems_filesystem_default_fallocate,
   .poll_h = rtems_termios_poll,
   .readv_h = rtems_filesystem_default_readv,
   .writev_h = rtems_filesystem_default_writev
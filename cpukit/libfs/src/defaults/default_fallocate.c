@@ -0,0 +1,29 @@
+/**
+ * @file
+ *
+ * @brief Default File System Allocates the Storage of a File Region
+ *
+ * @ingroup LibIOFSHandler
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/libio_.h>
+#include <rtems/seterr.h>
+
+int rtems_filesystem_default_fallocate(
+  rtems_libio_t *iop,
+  off_t          offset,
+  off_t          len
+)
+{
+  rtems_set_errno_and_return_minus_one( EINVAL );
+}
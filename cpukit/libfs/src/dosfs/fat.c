@@ -26,6 +26,7 @@
 
 #include "fat.h"
 #include "fat_fat_operations.h"
+#include "fat_file.h"
 
 static int
  _fat_block_release(fat_fs_info_t *fs_info);
@@ -449,6 +450,145 @@ fat_cluster_write(
       return bytes_written;
 }
 
+static inline uint32_t
+fat_cluster_count_to_block_count(const fat_fs_info_t *fs_info,
+                                 uint32_t             cl_count)
+{
+    return cl_count << (fs_info->vol.bpc_log2 -
+                        fs_info->vol.bytes_per_block_log2);
+}
+
+/* fat_cluster_read_direct --
+ *     This function reads whole clusters from the device into a buffer
+ *     provided by the user bypassing the block buffer cache.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     start_cln - first cluster of consecutive clusters
+ *     cl_count  - count of clusters
+ *     buff      - buffer provided by user
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured
+ *     and errno set appropriately
+ */
+int
+fat_cluster_read_direct(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              start_cln,
+    uint32_t                              cl_count,
+    void                                 *buff)
+{
+    rtems_status_code sc;
+    int               rc;
+
+    /* the cached block may be one of the clusters */
+    rc = fat_buf_release(fs_info);
+    if (rc != RC_OK)
+        return rc;
+
+    sc = rtems_bdbuf_read_direct(fs_info->vol.dd,
+                                 fat_cluster_num_to_block_num(fs_info, start_cln),
+                                 fat_cluster_count_to_block_count(fs_info, cl_count),
+                                 buff);
+    if (sc != RTEMS_SUCCESSFUL)
+        rtems_set_errno_and_return_minus_one(EIO);
+
+    return RC_OK;
+}
+
+/* fat_cluster_write_direct --
+ *     This function writes whole clusters from a buffer provided by the user
+ *     to the device bypassing the block buffer cache.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     start_cln - first cluster of consecutive clusters
+ *     cl_count  - count of clusters
+ *     buff      - buffer provided by user
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured
+ *     and errno set appropriately
+ */
+int
+fat_cluster_write_direct(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              start_cln,
+    uint32_t                              cl_count,
+    const void                           *buff)
+{
+    rtems_status_code sc;
+    int               rc;
+
+    /* the cached block may be one of the clusters */
+    rc = fat_buf_release(fs_info);
+    if (rc != RC_OK)
+        return rc;
+
+    sc = rtems_bdbuf_write_direct(fs_info->vol.dd,
+                                  fat_cluster_num_to_block_num(fs_info, start_cln),
+                                  fat_cluster_count_to_block_count(fs_info, cl_count),
+                                  buff);
+    if (sc != RTEMS_SUCCESSFUL)
+        rtems_set_errno_and_return_minus_one(EIO);
+
+    return RC_OK;
+}
+
+/* fat_cluster_can_transfer_direct --
+ *     Returns true if clusters should be transferred with
+ *     fat_cluster_read_direct() or fat_cluster_write_direct().
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     cl_count  - count of clusters
+ *     buff      - buffer provided by user
+ */
+bool
+fat_cluster_can_transfer_direct(
+    const fat_fs_info_t                  *fs_info,
+    uint32_t                              cl_count,
+    const void                           *buff)
+{
+    return rtems_bdbuf_can_transfer_direct(
+        buff, fat_cluster_count_to_block_count(fs_info, cl_count));
+}
+
+/* fat_cluster_discard --
+ *     This function discards consecutive clusters which are no longer in
+ *     use.  The blocks of the clusters are dropped from the block buffer
+ *     cache and the device is told that their data is obsolete.  A discard
+ *     is only a hint, so errors are ignored.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     start_cln - first cluster of consecutive clusters
+ *     cl_count  - count of clusters
+ */
+void
+fat_cluster_discard(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              start_cln,
+    uint32_t                              cl_count)
+{
+    uint32_t blk = fat_cluster_num_to_block_num(fs_info, start_cln);
+    uint32_t blk_cnt = fat_cluster_count_to_block_count(fs_info, cl_count);
+
+    /* the cached block may be one of the clusters */
+    if (fs_info->c.state != FAT_CACHE_EMPTY)
+    {
+        uint32_t c_blk = fat_sector_num_to_block_num(fs_info,
+                                                     fs_info->c.blk_num);
+
+        if (c_blk >= blk && c_blk - blk < blk_cnt
+            && fat_buf_release(fs_info) != RC_OK)
+            return;
+    }
+
+    rtems_bdbuf_discard(fs_info->vol.dd, blk, blk_cnt);
+}
+
 static bool is_cluster_aligned(const fat_vol_t *vol, uint32_t sec_num)
 {
     return (sec_num & (vol->spc - 1)) == 0;
@@ -862,7 +1002,10 @@ fat_shutdown_drive(fat_fs_info_t *fs_info)
         rtems_chain_control *the_chain = fs_info->vhash + i;
 
         while ( (node = rtems_chain_get_unprotected(the_chain)) != NULL )
+        {
+            fat_file_extent_map_drop((fat_file_fd_t *) node);
             free(node);
+        }
     }
 
     for (i = 0; i < FAT_HASH_SIZE; i++)
@@ -871,7 +1014,10 @@ fat_shutdown_drive(fat_fs_info_t *fs_info)
         rtems_chain_control *the_chain = fs_info->rhash + i;
 
         while ( (node = rtems_chain_get_unprotected(the_chain)) != NULL )
+        {
+            fat_file_extent_map_drop((fat_file_fd_t *) node);
             free(node);
+        }
     }
 
     free(fs_info->vhash);
@@ -879,6 +1025,8 @@ fat_shutdown_drive(fat_fs_info_t *fs_info)
 
     free(fs_info->uino);
     free(fs_info->sec_buf);
+    free(fs_info->free_map.bits);
+    free(fs_info->free_map.group_free);
     close(fs_info->vol.fd);
 
     if (rc)
@@ -336,6 +336,20 @@ typedef struct fat_vol_s
 } fat_vol_t;
 
 
+/*
+ * In-memory copy of the free state of the data clusters.  It is built by the
+ * first cluster allocation and afterwards kept up to date by
+ * fat_set_fat_cluster().  Clusters reserved for the extensions of files are
+ * free in the FAT but not in the map.
+ */
+typedef struct fat_free_map_s
+{
+    uint32_t           *bits;          /* one bit per data cluster, set if free */
+    uint16_t           *group_free;    /* free clusters count of each group */
+    uint32_t            reserved;      /* count of reserved clusters */
+    bool                unavailable;   /* the build failed, do not retry */
+} fat_free_map_t;
+
 typedef struct fat_cache_s
 {
     uint32_t            blk_num;
@@ -359,6 +373,8 @@ typedef struct fat_fs_info_s
     uint32_t             uino_base;
     fat_cache_t          c;             /* cache */
     uint8_t             *sec_buf; /* just placeholder for anything */
+    fat_free_map_t       free_map;      /* free clusters map */
+    uint32_t             reserve_cls;   /* clusters reserved ahead of writes */
 } fat_fs_info_t;
 
 /*
@@ -520,6 +536,28 @@ fat_cluster_set(fat_fs_info_t                        *fs_info,
                   uint32_t                              count,
                   uint8_t                               pattern);
 
+int
+fat_cluster_read_direct(fat_fs_info_t                      *fs_info,
+                        uint32_t                            start_cln,
+                        uint32_t                            cl_count,
+                        void                               *buff);
+
+int
+fat_cluster_write_direct(fat_fs_info_t                     *fs_info,
+                         uint32_t                           start_cln,
+                         uint32_t                           cl_count,
+                         const void                        *buff);
+
+bool
+fat_cluster_can_transfer_direct(const fat_fs_info_t        *fs_info,
+                                uint32_t                    cl_count,
+                                const void                 *buff);
+
+void
+fat_cluster_discard(fat_fs_info_t                          *fs_info,
+                    uint32_t                                start_cln,
+                    uint32_t                                cl_count);
+
 
 int
 fat_init_volume_info(fat_fs_info_t *fs_info, const char *device);
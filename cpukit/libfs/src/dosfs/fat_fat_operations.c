@@ -26,6 +26,281 @@
 #include "fat.h"
 #include "fat_fat_operations.h"
 
+/*
+ * The free map has one bit for each data cluster, the bit of cluster 2 is the
+ * first one.  The clusters are also grouped and each group has a count of its
+ * free clusters, so that searches on a nearly full volume skip the full
+ * regions quickly.  The group size must be a multiple of 32.
+ */
+#define FAT_FREE_MAP_GROUP_SIZE 4096
+
+/*
+ * The count of free runs examined for a best fit allocation.  Afterwards the
+ * search falls back to the first fit, so that the cost of an allocation on a
+ * fragmented volume is bounded.
+ */
+#define FAT_FREE_MAP_BEST_FIT_RUNS 64
+
+static bool
+fat_free_map_test(const fat_free_map_t *map, uint32_t idx)
+{
+    return (map->bits[idx / 32] & (UINT32_C(1) << (idx % 32))) != 0;
+}
+
+/* fat_free_map_mark --
+ *     Update the free map after a change of the FAT entry of a cluster.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     cln      - number of the cluster
+ *     is_free  - the cluster is free now
+ *
+ * RETURNS:
+ *     None
+ */
+static void
+fat_free_map_mark(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              cln,
+    bool                                  is_free
+    )
+{
+    fat_free_map_t *map = &fs_info->free_map;
+    uint32_t        idx = cln - 2;
+    uint32_t        bit = UINT32_C(1) << (idx % 32);
+    uint32_t       *word;
+
+    if (map->bits == NULL)
+        return;
+
+    word = &map->bits[idx / 32];
+
+    if (is_free)
+    {
+        if ((*word & bit) == 0)
+        {
+            *word |= bit;
+            ++map->group_free[idx / FAT_FREE_MAP_GROUP_SIZE];
+        }
+    }
+    else if ((*word & bit) != 0)
+    {
+        *word &= ~bit;
+        --map->group_free[idx / FAT_FREE_MAP_GROUP_SIZE];
+    }
+}
+
+/* fat_free_map_build --
+ *     Build the free map from the FAT unless this was done before.  This
+ *     also establishes the exact count of free clusters.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *
+ * RETURNS:
+ *     true if the free map is available, otherwise false
+ */
+static bool
+fat_free_map_build(
+    fat_fs_info_t                        *fs_info
+    )
+{
+    fat_free_map_t *map = &fs_info->free_map;
+    uint32_t        data_cls = fs_info->vol.data_cls;
+    uint32_t        free_cls = 0;
+    uint32_t        idx = 0;
+
+    if (map->bits != NULL)
+        return true;
+
+    if (map->unavailable)
+        return false;
+
+    map->bits = calloc((data_cls + 31) / 32, sizeof(*map->bits));
+    map->group_free = calloc(
+        (data_cls + FAT_FREE_MAP_GROUP_SIZE - 1) / FAT_FREE_MAP_GROUP_SIZE,
+        sizeof(*map->group_free));
+
+    if (map->bits != NULL && map->group_free != NULL)
+    {
+        for (idx = 0; idx < data_cls; ++idx)
+        {
+            uint32_t next_cln = 0;
+
+            if (fat_get_fat_cluster(fs_info, idx + 2, &next_cln) != RC_OK)
+                break;
+
+            if (next_cln == FAT_GENFAT_FREE)
+            {
+                map->bits[idx / 32] |= UINT32_C(1) << (idx % 32);
+                ++map->group_free[idx / FAT_FREE_MAP_GROUP_SIZE];
+                ++free_cls;
+            }
+        }
+
+        if (idx == data_cls)
+        {
+            fs_info->vol.free_cls = free_cls;
+            return true;
+        }
+    }
+
+    free(map->bits);
+    free(map->group_free);
+    map->bits = NULL;
+    map->group_free = NULL;
+    map->unavailable = true;
+    return false;
+}
+
+/*
+ * Returns the map index of the first free cluster at or after the map index,
+ * or the data clusters count if there is none.
+ */
+static uint32_t
+fat_free_map_find_free(
+    const fat_free_map_t                 *map,
+    uint32_t                              data_cls,
+    uint32_t                              idx
+    )
+{
+    while (idx < data_cls)
+    {
+        uint32_t group = idx / FAT_FREE_MAP_GROUP_SIZE;
+        uint32_t word;
+
+        if (map->group_free[group] == 0)
+        {
+            idx = (group + 1) * FAT_FREE_MAP_GROUP_SIZE;
+            continue;
+        }
+
+        word = map->bits[idx / 32] >> (idx % 32);
+        if (word == 0)
+        {
+            idx = (idx / 32 + 1) * 32;
+            continue;
+        }
+
+        while ((word & 1) == 0)
+        {
+            word >>= 1;
+            ++idx;
+        }
+
+        return idx;
+    }
+
+    return data_cls;
+}
+
+/*
+ * Returns the count of consecutive free clusters starting at the map index.
+ * The bits beyond the last data cluster are never set.
+ */
+static uint32_t
+fat_free_map_run_length(
+    const fat_free_map_t                 *map,
+    uint32_t                              data_cls,
+    uint32_t                              idx
+    )
+{
+    uint32_t end = idx;
+
+    while (end < data_cls)
+    {
+        if (end % 32 == 0 && map->bits[end / 32] == UINT32_MAX)
+            end += 32;
+        else if (fat_free_map_test(map, end))
+            ++end;
+        else
+            break;
+    }
+
+    return end - idx;
+}
+
+/* fat_free_map_next --
+ *     Select the next cluster of an allocation.  The cluster following the
+ *     previously allocated one is used if it is free.  For the first cluster
+ *     a run following the most recently allocated cluster of the volume is
+ *     preferred, so that sequential appends stay contiguous.  Otherwise the
+ *     smallest run which is large enough for the remaining clusters is used
+ *     (best fit), or the largest run if no run is large enough.  The best fit
+ *     considers only the first FAT_FREE_MAP_BEST_FIT_RUNS runs, afterwards
+ *     the first run which is large enough is used (first fit).
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     prev_cln - previously allocated cluster or FAT_UNDEFINED_VALUE
+ *     count    - count of clusters which remain to be allocated
+ *
+ * RETURNS:
+ *     the number of a free cluster, or FAT_UNDEFINED_VALUE if no cluster is
+ *     free
+ */
+static uint32_t
+fat_free_map_next(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              prev_cln,
+    uint32_t                              count
+    )
+{
+    const fat_free_map_t *map = &fs_info->free_map;
+    uint32_t              data_cls = fs_info->vol.data_cls;
+    uint32_t              best = FAT_UNDEFINED_VALUE;
+    uint32_t              best_len = 0;
+    uint32_t              runs = 0;
+    uint32_t              idx;
+
+    if (prev_cln != FAT_UNDEFINED_VALUE)
+    {
+        idx = prev_cln - 1;
+        if (idx < data_cls && fat_free_map_test(map, idx))
+            return prev_cln + 1;
+    }
+    else if (fs_info->vol.next_cl - 2 < data_cls)
+    {
+        idx = fs_info->vol.next_cl - 2;
+        if (!fat_free_map_test(map, idx))
+            ++idx;
+
+        if (idx < data_cls &&
+            fat_free_map_run_length(map, data_cls, idx) >= count)
+            return idx + 2;
+    }
+
+    idx = fat_free_map_find_free(map, data_cls, 0);
+    while (idx < data_cls)
+    {
+        uint32_t len = fat_free_map_run_length(map, data_cls, idx);
+        bool     better;
+
+        ++runs;
+
+        if (len >= count)
+            better = best_len < count || len < best_len;
+        else
+            better = best_len < len;
+
+        if (better)
+        {
+            best = idx + 2;
+            best_len = len;
+
+            if (len == count)
+                break;
+        }
+
+        if (runs >= FAT_FREE_MAP_BEST_FIT_RUNS && best_len >= count)
+            break;
+
+        idx = fat_free_map_find_free(map, data_cls, idx + len);
+    }
+
+    return best;
+}
+
 /* fat_scan_fat_for_free_clusters --
  *     Allocate chain of free clusters from Files Allocation Table
  *
@@ -35,6 +310,9 @@
  *                in  the chain)
  *     count    - count of clusters to allocate (chain length)
  *
+ * The clusters are selected with the free map if it is available, otherwise
+ * the FAT is scanned starting at the next free cluster hint.
+ *
  * RETURNS:
  *     RC_OK on success, or error code if error occured (errno set
  *     appropriately)
@@ -56,6 +334,7 @@ fat_scan_fat_for_free_clusters(
     uint32_t       save_cln = FAT_UNDEFINED_VALUE;
     uint32_t       data_cls_val = fs_info->vol.data_cls + 2;
     uint32_t       i = 2;
+    bool           use_map = fat_free_map_build(fs_info);
 
     if (fs_info->vol.next_cl - 2 < fs_info->vol.data_cls)
         cl4find = fs_info->vol.next_cl;
@@ -69,14 +348,24 @@ fat_scan_fat_for_free_clusters(
      */
     while (*cls_added != count && i < data_cls_val)
     {
-        uint32_t next_cln = 0;
+        uint32_t next_cln = FAT_GENFAT_FREE;
 
-        rc = fat_get_fat_cluster(fs_info, cl4find, &next_cln);
-        if ( rc != RC_OK )
+        if (use_map)
         {
-            if (*cls_added != 0)
-                fat_free_fat_clusters_chain(fs_info, (*chain));
-            return rc;
+            cl4find = fat_free_map_next(fs_info, save_cln,
+                                        count - *cls_added);
+            if (cl4find == FAT_UNDEFINED_VALUE)
+                break;
+        }
+        else
+        {
+            rc = fat_get_fat_cluster(fs_info, cl4find, &next_cln);
+            if ( rc != RC_OK )
+            {
+                if (*cls_added != 0)
+                    fat_free_fat_clusters_chain(fs_info, (*chain));
+                return rc;
+            }
         }
 
         if (next_cln == FAT_GENFAT_FREE)
@@ -181,6 +470,8 @@ fat_free_fat_clusters_chain(
     uint32_t       cur_cln = chain;
     uint32_t       next_cln = 0;
     uint32_t       freed_cls_cnt = 0;
+    uint32_t       discard_cln = 0;
+    uint32_t       discard_cnt = 0;
 
     while ((cur_cln & fs_info->vol.mask) < fs_info->vol.eoc_val)
     {
@@ -190,6 +481,9 @@ fat_free_fat_clusters_chain(
               if(fs_info->vol.free_cls != FAT_UNDEFINED_VALUE)
                 fs_info->vol.free_cls += freed_cls_cnt;
 
+            if (discard_cnt > 0)
+                fat_cluster_discard(fs_info, discard_cln, discard_cnt);
+
             fat_buf_release(fs_info);
             return rc;
         }
@@ -198,6 +492,20 @@ fat_free_fat_clusters_chain(
         if ( rc != RC_OK )
             rc1 = rc;
 
+        /* discard the freed clusters in runs of consecutive clusters */
+        if (discard_cnt > 0 && cur_cln == discard_cln + discard_cnt)
+        {
+            discard_cnt++;
+        }
+        else
+        {
+            if (discard_cnt > 0)
+                fat_cluster_discard(fs_info, discard_cln, discard_cnt);
+
+            discard_cln = cur_cln;
+            discard_cnt = 1;
+        }
+
         freed_cls_cnt++;
         cur_cln = next_cln;
     }
@@ -206,6 +514,9 @@ fat_free_fat_clusters_chain(
         if (fs_info->vol.free_cls != FAT_UNDEFINED_VALUE)
             fs_info->vol.free_cls += freed_cls_cnt;
 
+    if (discard_cnt > 0)
+        fat_cluster_discard(fs_info, discard_cln, discard_cnt);
+
     fat_buf_release(fs_info);
     if (rc1 != RC_OK)
         return rc1;
@@ -213,6 +524,163 @@ fat_free_fat_clusters_chain(
     return RC_OK;
 }
 
+/* fat_reserve_clusters --
+ *     Reserve a run of free clusters for later extensions of a file.  The
+ *     clusters are only taken out of the free map, they stay free in the FAT.
+ *     So a reservation never reaches the disk.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     prev_cln - cluster the run should follow or FAT_UNDEFINED_VALUE
+ *     count    - count of clusters to reserve
+ *     cln      - the number of the first reserved cluster
+ *
+ * RETURNS:
+ *     the count of reserved clusters, which is less than count if there is
+ *     no run large enough, and 0 if no cluster is free or the free map is
+ *     not available
+ */
+uint32_t
+fat_reserve_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              prev_cln,
+    uint32_t                              count,
+    uint32_t                             *cln
+    )
+{
+    fat_free_map_t *map = &fs_info->free_map;
+    uint32_t        first;
+    uint32_t        len;
+    uint32_t        i;
+
+    if (count == 0 || !fat_free_map_build(fs_info))
+        return 0;
+
+    first = fat_free_map_next(fs_info, prev_cln, count);
+    if (first == FAT_UNDEFINED_VALUE)
+        return 0;
+
+    len = fat_free_map_run_length(map, fs_info->vol.data_cls, first - 2);
+    if (len > count)
+        len = count;
+
+    for (i = 0; i < len; ++i)
+        fat_free_map_mark(fs_info, first + i, false);
+
+    map->reserved += len;
+    *cln = first;
+
+    return len;
+}
+
+/* fat_alloc_reserved_clusters --
+ *     Allocate consecutive reserved clusters as a chain in the FAT.  The
+ *     clusters leave the reservation, the ones which could not be allocated
+ *     due to an error are free again.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     prev_cln  - cluster the chain is appended to or FAT_UNDEFINED_VALUE
+ *     cln       - the number of the first reserved cluster
+ *     count     - count of clusters to allocate
+ *     cls_added - count of allocated clusters
+ *     zero_fill - fill the allocated clusters with zeros
+ *
+ * RETURNS:
+ *     RC_OK on success, or error code if error occured (errno set
+ *     appropriately)
+ */
+int
+fat_alloc_reserved_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              prev_cln,
+    uint32_t                              cln,
+    uint32_t                              count,
+    uint32_t                             *cls_added,
+    bool                                  zero_fill
+    )
+{
+    int            rc = RC_OK;
+    uint32_t       i;
+
+    *cls_added = 0;
+    fs_info->free_map.reserved -= count;
+
+    for (i = 0; i < count; ++i)
+    {
+        uint32_t cur_cln = cln + i;
+
+        rc = fat_set_fat_cluster(fs_info, cur_cln, FAT_GENFAT_EOC);
+        if ( rc != RC_OK )
+            break;
+
+        if (prev_cln != FAT_UNDEFINED_VALUE)
+        {
+            rc = fat_set_fat_cluster(fs_info, prev_cln, cur_cln);
+            if ( rc != RC_OK )
+            {
+                (void) fat_set_fat_cluster(fs_info, cur_cln, FAT_GENFAT_FREE);
+                break;
+            }
+        }
+
+        prev_cln = cur_cln;
+        (*cls_added)++;
+
+        if (fs_info->vol.free_cls != FAT_UNDEFINED_VALUE)
+            fs_info->vol.free_cls--;
+
+        if (zero_fill)
+        {
+            ssize_t bytes_written =
+                fat_cluster_set(fs_info, cur_cln, 0, fs_info->vol.bpc, 0);
+
+            if (fs_info->vol.bpc != bytes_written)
+            {
+                rc = -1;
+                ++i;
+                break;
+            }
+        }
+    }
+
+    for ( ; i < count; ++i)
+        fat_free_map_mark(fs_info, cln + i, true);
+
+    if (*cls_added > 0)
+        fs_info->vol.next_cl = prev_cln;
+
+    fat_buf_release(fs_info);
+
+    return rc;
+}
+
+/* fat_release_reserved_clusters --
+ *     Return reserved consecutive clusters to the free clusters.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     cln      - the number of the first reserved cluster
+ *     count    - count of clusters to release
+ *
+ * RETURNS:
+ *     None
+ */
+void
+fat_release_reserved_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              cln,
+    uint32_t                              count
+    )
+{
+    uint32_t       i;
+
+    for (i = 0; i < count; ++i)
+        fat_free_map_mark(fs_info, cln + i, true);
+
+    fs_info->free_map.reserved -= count;
+}
+
 /* fat_get_fat_cluster --
  *     Fetches the contents of the cluster (link to next cluster in the chain)
  *     from Files Allocation Table.
@@ -421,5 +889,7 @@ fat_set_fat_cluster(
 
     }
 
+    fat_free_map_mark(fs_info, cln, in_val == FAT_GENFAT_FREE);
+
     return RC_OK;
 }
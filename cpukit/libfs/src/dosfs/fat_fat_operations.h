@@ -64,6 +64,31 @@ fat_free_fat_clusters_chain(
     uint32_t                              chain
 );
 
+uint32_t
+fat_reserve_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              prev_cln,
+    uint32_t                              count,
+    uint32_t                             *cln
+);
+
+int
+fat_alloc_reserved_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              prev_cln,
+    uint32_t                              cln,
+    uint32_t                              count,
+    uint32_t                             *cls_added,
+    bool                                  zero_fill
+);
+
+void
+fat_release_reserved_clusters(
+    fat_fs_info_t                        *fs_info,
+    uint32_t                              cln,
+    uint32_t                              count
+);
+
 #ifdef __cplusplus
 }
 #endif
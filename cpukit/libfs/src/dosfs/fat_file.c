@@ -33,6 +33,12 @@
 #include "fat_fat_operations.h"
 #include "fat_file.h"
 
+/*
+ * A seek which would walk at least this count of clusters of the chain uses
+ * the extent map of the fat-file.
+ */
+#define FAT_FILE_EXTENT_MAP_MIN_WALK 8
+
 static inline void
 _hash_insert(rtems_chain_control *hash, uint32_t   key1, uint32_t   key2,
              fat_file_fd_t *el);
@@ -58,6 +64,34 @@ fat_file_lseek(
     uint32_t                              *disk_cln
 );
 
+static int
+fat_file_cluster_run(
+    fat_fs_info_t                         *fs_info,
+    uint32_t                              *cln,
+    uint32_t                              *last_cln,
+    uint32_t                               max_count,
+    uint32_t                              *cl_count
+);
+
+static bool
+fat_file_extent_map_lookup(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd,
+    uint32_t                               file_cln,
+    uint32_t                              *disk_cln
+);
+
+static int
+fat_file_alloc_clusters(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd,
+    uint32_t                               count,
+    bool                                   zero_fill,
+    uint32_t                              *chain,
+    uint32_t                              *cls_added,
+    uint32_t                              *last_cl
+);
+
 /* fat_file_open --
  *     Open fat-file. Two hash tables are accessed by key
  *     constructed from cluster num and offset of the node (i.e.
@@ -229,6 +263,7 @@ fat_file_close(
     {
         uint32_t key = fat_construct_key(fs_info, &fat_fd->dir_pos.sname);
 
+        fat_file_release_reservation(fs_info, fat_fd);
         fat_file_update(fs_info, fat_fd);
 
         if (fat_fd->flags & FAT_FILE_REMOVED)
@@ -241,6 +276,7 @@ fat_file_close(
                 if (fat_ino_is_unique(fs_info, fat_fd->ino))
                     fat_free_unique_ino(fs_info, fat_fd->ino);
 
+                fat_file_extent_map_drop(fat_fd);
                 free(fat_fd);
             }
         }
@@ -253,6 +289,7 @@ fat_file_close(
             else
             {
                 _hash_delete(fs_info->vhash, key, fat_fd->ino, fat_fd);
+                fat_file_extent_map_drop(fat_fd);
                 free(fat_fd);
             }
         }
@@ -341,6 +378,31 @@ fat_file_read(
 
     while (count > 0)
     {
+        if ((ofs == 0) &&
+            fat_cluster_can_transfer_direct(fs_info,
+                                            count >> fs_info->vol.bpc_log2,
+                                            buf + cmpltd))
+        {
+            uint32_t first_cln = cur_cln;
+            uint32_t cl_count;
+
+            rc = fat_file_cluster_run(fs_info, &cur_cln, &save_cln,
+                                      count >> fs_info->vol.bpc_log2,
+                                      &cl_count);
+            if ( rc != RC_OK )
+                return rc;
+
+            rc = fat_cluster_read_direct(fs_info, first_cln, cl_count,
+                                         buf + cmpltd);
+            if ( rc != RC_OK )
+                return -1;
+
+            c = cl_count << fs_info->vol.bpc_log2;
+            count -= c;
+            cmpltd += c;
+            continue;
+        }
+
         c = MIN(count, (fs_info->vol.bpc - ofs));
 
         sec = fat_cluster_num_to_sector_num(fs_info, cur_cln);
@@ -370,6 +432,55 @@ fat_file_read(
     return cmpltd;
 }
 
+/* fat_file_cluster_run --
+ *     Count the consecutive clusters of a cluster chain to transfer them
+ *     directly with one request.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     cln       - first cluster of the run, returns the cluster which follows
+ *                 the run in the chain
+ *     last_cln  - returns the last cluster of the run
+ *     max_count - maximum count of clusters of the run
+ *     cl_count  - returns the count of clusters of the run
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured (errno set appropriately)
+ */
+static int
+fat_file_cluster_run(
+    fat_fs_info_t                         *fs_info,
+    uint32_t                              *cln,
+    uint32_t                              *last_cln,
+    uint32_t                               max_count,
+    uint32_t                              *cl_count
+)
+{
+    int      rc;
+    uint32_t cur_cln = *cln;
+    uint32_t next_cln = 0;
+    uint32_t n = 0;
+
+    while (true)
+    {
+        ++n;
+
+        rc = fat_get_fat_cluster(fs_info, cur_cln, &next_cln);
+        if ( rc != RC_OK )
+            return rc;
+
+        if ((n == max_count) || (next_cln != cur_cln + 1))
+            break;
+
+        cur_cln = next_cln;
+    }
+
+    *cln = next_cln;
+    *last_cln = cur_cln;
+    *cl_count = n;
+    return RC_OK;
+}
+
 /* fat_is_fat12_or_fat16_root_dir --
  *     Returns true for FAT12 root directories respectively FAT16
  *     root directories. Returns false for everything else.
@@ -429,6 +540,30 @@ fat_file_write_fat32_or_non_root_dir(
         while (   (RC_OK == rc)
                && (bytes_to_write > 0))
         {
+            if (   (0 == ofs_cln)
+                && fat_cluster_can_transfer_direct(fs_info,
+                                                   bytes_to_write >> fs_info->vol.bpc_log2,
+                                                   &buf[cmpltd]))
+            {
+                uint32_t first_cln = cur_cln;
+                uint32_t cl_count;
+
+                rc = fat_file_cluster_run(fs_info, &cur_cln, &save_cln,
+                                          bytes_to_write >> fs_info->vol.bpc_log2,
+                                          &cl_count);
+                if (RC_OK == rc)
+                  rc = fat_cluster_write_direct(fs_info, first_cln, cl_count,
+                                                &buf[cmpltd]);
+
+                if (RC_OK == rc)
+                {
+                    c = cl_count << fs_info->vol.bpc_log2;
+                    bytes_to_write -= c;
+                    cmpltd += c;
+                }
+                continue;
+            }
+
             c = MIN(bytes_to_write, (fs_info->vol.bpc - ofs_cln));
 
             ret = fat_cluster_write(fs_info,
@@ -633,8 +768,8 @@ fat_file_extend(
 
     cls2add = ((bytes2add - 1) >> fs_info->vol.bpc_log2) + 1;
 
-    rc = fat_scan_fat_for_free_clusters(fs_info, &chain, cls2add,
-                                        &cls_added, &last_cl, zero_fill);
+    rc = fat_file_alloc_clusters(fs_info, fat_fd, cls2add, zero_fill,
+                                 &chain, &cls_added, &last_cl);
 
     /* this means that low level I/O error occured */
     if (rc != RC_OK)
@@ -654,6 +789,8 @@ fat_file_extend(
 
     if (cls_added > 0)
     {
+        fat_file_extent_map_drop(fat_fd);
+
         /* add new chain to the end of existing */
         if ( fat_fd->fat_file_size == 0 )
         {
@@ -755,6 +892,8 @@ fat_file_truncate(
     if (rc != RC_OK)
         return rc;
 
+    fat_file_extent_map_drop(fat_fd);
+
     rc = fat_free_fat_clusters_chain(fs_info, cur_cln);
     if (rc != RC_OK)
         return rc;
@@ -903,6 +1042,7 @@ fat_file_size(
     }
 
     fat_fd->fat_file_size = 0;
+    fat_file_extent_map_drop(fat_fd);
 
     while ((cur_cln & fs_info->vol.mask) < fs_info->vol.eoc_val)
     {
@@ -1031,6 +1171,10 @@ fat_file_lseek(
             count = file_cln;
         }
 
+        if ((count >= FAT_FILE_EXTENT_MAP_MIN_WALK) &&
+            fat_file_extent_map_lookup(fs_info, fat_fd, file_cln, &cur_cln))
+            count = 0;
+
         /* skip over the clusters */
         for (i = 0; i < count; i++)
         {
@@ -1047,3 +1191,382 @@ fat_file_lseek(
     }
     return RC_OK;
 }
+
+/* fat_file_extent_map_drop --
+ *     Free the extent map of the fat-file.
+ *
+ * PARAMETERS:
+ *     fat_fd   - fat-file descriptor
+ *
+ * RETURNS:
+ *     None
+ */
+void
+fat_file_extent_map_drop(fat_file_fd_t *fat_fd)
+{
+    free(fat_fd->map.extents);
+    fat_fd->map.extents = NULL;
+    fat_fd->map.extent_count = 0;
+}
+
+/* fat_file_extent_map_build --
+ *     Walk the cluster chain of the fat-file once and record it as runs of
+ *     consecutive clusters.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *
+ * RETURNS:
+ *     true if the extent map is available, otherwise false
+ */
+static bool
+fat_file_extent_map_build(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd
+    )
+{
+    fat_file_extent_t *extents = NULL;
+    uint32_t           size = 0;
+    uint32_t           count = 0;
+    uint32_t           file_cln = 0;
+    uint32_t           cur_cln = fat_fd->cln;
+
+    while ((cur_cln & fs_info->vol.mask) < fs_info->vol.eoc_val)
+    {
+        uint32_t           next_cln = 0;
+
+        /* a longer chain than the volume has clusters is a loop */
+        if (file_cln == fs_info->vol.data_cls)
+            break;
+
+        if ((count > 0) &&
+            (cur_cln == extents[count - 1].disk_cln + extents[count - 1].count))
+        {
+            ++extents[count - 1].count;
+        }
+        else
+        {
+            if (count == size)
+            {
+                fat_file_extent_t *more;
+
+                size = size == 0 ? 8 : 2 * size;
+                more = realloc(extents, size * sizeof(*extents));
+                if (more == NULL)
+                    break;
+
+                extents = more;
+            }
+
+            extents[count].file_cln = file_cln;
+            extents[count].disk_cln = cur_cln;
+            extents[count].count = 1;
+            ++count;
+        }
+
+        if (fat_get_fat_cluster(fs_info, cur_cln, &next_cln) != RC_OK)
+            break;
+
+        ++file_cln;
+        cur_cln = next_cln;
+    }
+
+    if ((cur_cln & fs_info->vol.mask) < fs_info->vol.eoc_val || count == 0)
+    {
+        free(extents);
+        return false;
+    }
+
+    fat_fd->map.extents = extents;
+    fat_fd->map.extent_count = count;
+    return true;
+}
+
+/* fat_file_extent_map_lookup --
+ *     Map a cluster of the fat-file to its cluster on the volume with a
+ *     binary search in the extent map.  The extent map is built if
+ *     necessary.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *     file_cln - cluster of the fat-file
+ *     disk_cln - placeholder for the cluster on the volume
+ *
+ * RETURNS:
+ *     true if the cluster was found, otherwise false
+ */
+static bool
+fat_file_extent_map_lookup(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd,
+    uint32_t                               file_cln,
+    uint32_t                              *disk_cln
+    )
+{
+    const fat_file_extent_t *extents = fat_fd->map.extents;
+    uint32_t                 low = 0;
+    uint32_t                 high;
+
+    /* the first cluster changes if the fat-file is reused for another node */
+    if ((extents != NULL) && (extents[0].disk_cln != fat_fd->cln))
+        fat_file_extent_map_drop(fat_fd);
+
+    if ((fat_fd->map.extents == NULL) &&
+        !fat_file_extent_map_build(fs_info, fat_fd))
+        return false;
+
+    extents = fat_fd->map.extents;
+    high = fat_fd->map.extent_count;
+
+    /* find the last extent which starts at or before the file cluster */
+    while (high - low > 1)
+    {
+        uint32_t mid = low + (high - low) / 2;
+
+        if (extents[mid].file_cln <= file_cln)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    if (file_cln - extents[low].file_cln >= extents[low].count)
+        return false;
+
+    *disk_cln = extents[low].disk_cln + (file_cln - extents[low].file_cln);
+    return true;
+}
+
+/* fat_file_take_reserved --
+ *     Take clusters for an extension of the fat-file from the front of its
+ *     reservation.  An empty reservation is topped up, so that it covers the
+ *     rest of the extension plus the reservation size of the volume.
+ *     Reserving ahead lets files which grow in turn by small writes get long
+ *     runs of consecutive clusters.  The reservation is kept in the free map
+ *     only, the clusters are allocated in the FAT when they are taken.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     fat_fd    - fat-file descriptor
+ *     count     - count of clusters to add
+ *     zero_fill - fill the taken clusters with zeros
+ *     chain     - the number of the first taken cluster
+ *     cls_added - count of taken clusters
+ *     last_cl   - the number of the last taken cluster
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured (errno set appropriately)
+ */
+static int
+fat_file_take_reserved(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd,
+    uint32_t                               count,
+    bool                                   zero_fill,
+    uint32_t                              *chain,
+    uint32_t                              *cls_added,
+    uint32_t                              *last_cl
+    )
+{
+    int            rc = RC_OK;
+    uint32_t       prev_cln = FAT_UNDEFINED_VALUE;
+
+    *cls_added = 0;
+
+    while (*cls_added < count)
+    {
+        uint32_t first;
+        uint32_t n;
+        uint32_t added = 0;
+
+        if (fat_fd->reserved_cls == 0)
+        {
+            uint32_t hint = prev_cln;
+
+            if (hint == FAT_UNDEFINED_VALUE && fat_fd->fat_file_size > 0)
+                hint = fat_fd->map.last_cln;
+
+            fat_fd->reserved_cls = fat_reserve_clusters(fs_info, hint,
+                count - *cls_added + fs_info->reserve_cls,
+                &fat_fd->reserved_cln);
+            if (fat_fd->reserved_cls == 0)
+                break;
+        }
+
+        first = fat_fd->reserved_cln;
+        n = MIN(count - *cls_added, fat_fd->reserved_cls);
+        rc = fat_alloc_reserved_clusters(fs_info, prev_cln, first, n, &added,
+                                         zero_fill);
+
+        fat_fd->reserved_cln += n;
+        fat_fd->reserved_cls -= n;
+
+        if (added > 0)
+        {
+            if (*cls_added == 0)
+                *chain = first;
+
+            *cls_added += added;
+            prev_cln = first + added - 1;
+        }
+
+        if (rc != RC_OK)
+        {
+            if (*cls_added > 0)
+                fat_free_fat_clusters_chain(fs_info, *chain);
+
+            *cls_added = 0;
+            return rc;
+        }
+    }
+
+    *last_cl = prev_cln;
+
+    return RC_OK;
+}
+
+/* fat_file_release_all_reservations --
+ *     Return the reservations of all fat-files to the free clusters.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *
+ * RETURNS:
+ *     None
+ */
+static void
+fat_file_release_all_reservations(
+    fat_fs_info_t                         *fs_info
+    )
+{
+    int            i;
+
+    for (i = 0; i < FAT_HASH_SIZE; i++)
+    {
+        rtems_chain_node *node;
+
+        for (node = rtems_chain_first(fs_info->vhash + i);
+             !rtems_chain_is_tail(fs_info->vhash + i, node);
+             node = rtems_chain_next(node))
+            fat_file_release_reservation(fs_info, (fat_file_fd_t *) node);
+
+        for (node = rtems_chain_first(fs_info->rhash + i);
+             !rtems_chain_is_tail(fs_info->rhash + i, node);
+             node = rtems_chain_next(node))
+            fat_file_release_reservation(fs_info, (fat_file_fd_t *) node);
+    }
+}
+
+/* fat_file_alloc_clusters --
+ *     Allocate the clusters of an extension of the fat-file.  Files take them
+ *     from their reservation if the volume has a reservation size.  In case
+ *     the free clusters do not suffice, then the reservations of all
+ *     fat-files are returned and the allocation is completed from the free
+ *     clusters.  This also happens if no reservation could be made, e.g. since
+ *     the free map is not available.
+ *
+ * PARAMETERS:
+ *     fs_info   - FS info
+ *     fat_fd    - fat-file descriptor
+ *     count     - count of clusters to add
+ *     zero_fill - fill the allocated clusters with zeros
+ *     chain     - the number of the first allocated cluster
+ *     cls_added - count of allocated clusters
+ *     last_cl   - the number of the last allocated cluster
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured (errno set appropriately)
+ */
+static int
+fat_file_alloc_clusters(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd,
+    uint32_t                               count,
+    bool                                   zero_fill,
+    uint32_t                              *chain,
+    uint32_t                              *cls_added,
+    uint32_t                              *last_cl
+    )
+{
+    int            rc;
+    uint32_t       rchain = 0;
+    uint32_t       radded = 0;
+    uint32_t       rlast = 0;
+
+    if ((fs_info->reserve_cls == 0) || (fat_fd->fat_file_type != FAT_FILE))
+        return fat_scan_fat_for_free_clusters(fs_info, chain, count,
+                                              cls_added, last_cl, zero_fill);
+
+    rc = fat_file_take_reserved(fs_info, fat_fd, count, zero_fill,
+                                chain, cls_added, last_cl);
+    if ((rc != RC_OK) || (*cls_added == count))
+        return rc;
+
+    /*
+     * The reservations may be short of clusters, or there may be none at all
+     * since the free map is not available.  Complete the allocation from the
+     * FAT in both cases.
+     */
+    if (fs_info->free_map.reserved > 0)
+        fat_file_release_all_reservations(fs_info);
+
+    rc = fat_scan_fat_for_free_clusters(fs_info, &rchain, count - *cls_added,
+                                        &radded, &rlast, zero_fill);
+    if ((rc == RC_OK) && (radded > 0))
+    {
+        if (*cls_added == 0)
+        {
+            *chain = rchain;
+        }
+        else
+        {
+            rc = fat_set_fat_cluster(fs_info, *last_cl, rchain);
+            if (rc != RC_OK)
+                fat_free_fat_clusters_chain(fs_info, rchain);
+
+            fat_buf_release(fs_info);
+        }
+
+        if (rc == RC_OK)
+        {
+            *cls_added += radded;
+            *last_cl = rlast;
+        }
+    }
+
+    if ((rc != RC_OK) && (*cls_added > 0))
+    {
+        fat_free_fat_clusters_chain(fs_info, *chain);
+        *cls_added = 0;
+    }
+
+    return rc;
+}
+
+/* fat_file_release_reservation --
+ *     Return the clusters reserved for future extensions of the fat-file to
+ *     the free clusters of the volume.
+ *
+ * PARAMETERS:
+ *     fs_info  - FS info
+ *     fat_fd   - fat-file descriptor
+ *
+ * RETURNS:
+ *     None
+ */
+void
+fat_file_release_reservation(
+    fat_fs_info_t                         *fs_info,
+    fat_file_fd_t                         *fat_fd
+    )
+{
+    if (fat_fd->reserved_cls == 0)
+        return;
+
+    fat_release_reserved_clusters(fs_info, fat_fd->reserved_cln,
+                                  fat_fd->reserved_cls);
+
+    fat_fd->reserved_cln = 0;
+    fat_fd->reserved_cls = 0;
+}
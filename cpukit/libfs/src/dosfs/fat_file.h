@@ -43,6 +43,16 @@ typedef enum {
   FAT_FILE = 4
 } fat_file_type_t;
 
+/**
+ * @brief A run of consecutive clusters of a fat-file.
+ */
+typedef struct fat_file_extent_s
+{
+    uint32_t   file_cln;    /* first cluster of the run in the fat-file */
+    uint32_t   disk_cln;    /* first cluster of the run on the volume */
+    uint32_t   count;       /* count of consecutive clusters of the run */
+} fat_file_extent_t;
+
 /**
  * @brief The "fat-file" representation.
  *
@@ -57,12 +67,20 @@ typedef enum {
  *
  * Such interface hides the architecture of fat-file and represents it like
  * linear file
+ *
+ * The file and disk cluster pair of the map caches the most recent position.
+ * The extents describe the whole cluster chain as runs of consecutive
+ * clusters sorted by the file cluster.  They are built on demand for seeks
+ * which would walk a long part of the chain and are dropped if the chain
+ * changes.
  */
 typedef struct fat_file_map_s
 {
-    uint32_t   file_cln;
-    uint32_t   disk_cln;
-    uint32_t   last_cln;
+    uint32_t           file_cln;
+    uint32_t           disk_cln;
+    uint32_t           last_cln;
+    fat_file_extent_t *extents;
+    uint32_t           extent_count;
 } fat_file_map_t;
 
 /**
@@ -91,6 +109,8 @@ typedef struct fat_file_fd_s
     fat_file_map_t   map;
     time_t           ctime;
     time_t           mtime;
+    uint32_t         reserved_cln;  /* first cluster of the reservation */
+    uint32_t         reserved_cls;  /* count of reserved clusters */
 
 } fat_file_fd_t;
 
@@ -235,6 +255,13 @@ void
 fat_file_mark_removed(fat_fs_info_t                        *fs_info,
                       fat_file_fd_t                        *fat_fd);
 
+void
+fat_file_extent_map_drop(fat_file_fd_t *fat_fd);
+
+void
+fat_file_release_reservation(fat_fs_info_t                        *fs_info,
+                             fat_file_fd_t                        *fat_fd);
+
 int
 fat_file_size(fat_fs_info_t                        *fs_info,
               fat_file_fd_t                        *fat_fd);
@@ -70,6 +70,12 @@ typedef struct msdos_fs_info_s
                                                             */
 
     rtems_dosfs_convert_control      *converter;
+    rtems_chain_control               dir_indexes;        /*
+                                                           * indexes of large
+                                                           * directories, least
+                                                           * recently used
+                                                           * first
+                                                           */
 } msdos_fs_info_t;
 
 RTEMS_INLINE_ROUTINE void msdos_fs_lock(msdos_fs_info_t *fs_info)
@@ -204,6 +210,9 @@ extern const rtems_filesystem_file_handlers_r  msdos_file_handlers;
                                           MSDOS_NAME_MAX_UTF8_BYTES_PER_CHAR)
 #define MSDOS_ENTRY_LFN_UTF8_BYTES       (MSDOS_LFN_LEN_PER_ENTRY *\
                                           MSDOS_NAME_MAX_UTF8_BYTES_PER_CHAR)
+#define MSDOS_LFN_ENTRY_SIZE_UTF8 \
+  ((MSDOS_LFN_LEN_PER_ENTRY + 1 ) * MSDOS_NAME_LFN_BYTES_PER_CHAR \
+    * MSDOS_NAME_MAX_UTF8_BYTES_PER_CHAR)
 
 extern const char *const MSDOS_DOT_NAME;    /* ".", padded to MSDOS_NAME chars */
 extern const char *const MSDOS_DOTDOT_NAME; /* ".", padded to MSDOS_NAME chars */
@@ -344,6 +353,13 @@ msdos_file_ftruncate(
   off_t          length            /* IN  */
 );
 
+int
+msdos_file_fallocate(
+  rtems_libio_t *iop,               /* IN  */
+  off_t          offset,            /* IN  */
+  off_t          len                /* IN  */
+);
+
 int msdos_file_sync(rtems_libio_t *iop);
 
 ssize_t msdos_dir_read(
@@ -380,6 +396,25 @@ int msdos_find_name(
   int                               name_len
 );
 
+/**
+ * @brief Returns the name cache key of a directory.
+ *
+ * The first cluster of a directory does not change during the life time of
+ * the directory, in contrast to the position of its directory entry.
+ */
+static inline uintptr_t msdos_name_cache_dir(
+  const rtems_filesystem_location_info_t *dir_loc
+)
+{
+  const fat_file_fd_t *fat_fd = dir_loc->node_access;
+
+  return fat_fd->cln;
+}
+
+void msdos_name_cache_purge_dir(
+  const rtems_filesystem_location_info_t *dir_loc
+);
+
 int msdos_get_name_node(
   const rtems_filesystem_location_info_t *parent_loc,
   bool                                    create_node,
@@ -439,6 +474,21 @@ msdos_get_utf16_string_from_long_entry (
   bool                        is_first_entry
 );
 
+ssize_t
+msdos_long_entry_to_utf8_name (
+    rtems_dosfs_convert_control *converter,
+    const char                  *entry,
+    const bool                   is_first_entry,
+    uint8_t                     *entry_utf8_buf,
+    const size_t                 buf_size);
+
+ssize_t
+msdos_short_entry_to_utf8_name (
+    rtems_dosfs_convert_control *converter,
+    const char                  *entry,
+    uint8_t                     *buf,
+    const size_t                 buf_size);
+
 void msdos_date_unix2dos(
   unsigned int tsp, uint16_t *ddp,
   uint16_t *dtp);
@@ -487,6 +537,50 @@ int msdos_sync(rtems_libio_t *iop);
 
 uint8_t msdos_lfn_checksum(const void *entry);
 
+typedef struct msdos_dir_index_s msdos_dir_index_t;
+
+uint32_t msdos_dir_index_hash(const void *name, size_t name_len);
+
+msdos_dir_index_t *msdos_dir_index_get(
+    msdos_fs_info_t *fs_info,
+    fat_file_fd_t   *fat_fd,
+    uint32_t         bts2rd
+);
+
+bool msdos_dir_index_next(
+    const msdos_dir_index_t *index,
+    uint32_t                 hash,
+    uint32_t                *position,
+    uint32_t                *first_offset,
+    uint32_t                *end_offset
+);
+
+void msdos_dir_index_get_free_space(
+    const msdos_dir_index_t *index,
+    uint32_t                 entry_count,
+    uint32_t                *empty_file_offset,
+    uint32_t                *empty_entry_count
+);
+
+void msdos_dir_index_add(
+    msdos_fs_info_t     *fs_info,
+    fat_file_fd_t       *fat_fd,
+    msdos_dir_index_t   *index,
+    const fat_dir_pos_t *dir_pos,
+    unsigned int         lfn_entries,
+    uint32_t             long_hash,
+    const char          *name_dir_entry
+);
+
+void msdos_dir_index_remove(
+    msdos_fs_info_t     *fs_info,
+    const fat_dir_pos_t *dir_pos
+);
+
+void msdos_dir_index_drop(msdos_fs_info_t *fs_info, uint32_t cln);
+
+void msdos_dir_index_drop_all(msdos_fs_info_t *fs_info);
+
 #ifdef __cplusplus
 }
 #endif
@@ -164,6 +164,8 @@ msdos_creat_node(const rtems_filesystem_location_info_t  *parent_loc,
         *MSDOS_DIR_ATTR(short_node) |= MSDOS_ATTR_ARCHIVE;
     }
 
+    msdos_name_cache_purge_dir(parent_loc);
+
     /*
      * find free space in the parent directory and write new initialized
      * FAT 32 Bytes Directory Entry Structure to the disk
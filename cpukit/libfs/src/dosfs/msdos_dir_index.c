@@ -0,0 +1,897 @@
+/**
+ * @file
+ *
+ * @brief Directory Index for the MSDOS FileSystem
+ * @ingroup libfs_msdos MSDOS FileSystem
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "fat.h"
+#include "fat_fat_operations.h"
+#include "fat_file.h"
+
+#include "msdos.h"
+
+/*
+ * The index of a directory knows the state of each 32 bytes directory entry
+ * slot and the hashes of the short and long names of the files.  A name
+ * lookup has to read only the slots of the files with a matching hash, a
+ * create finds the free slots without reading the directory.  Only large
+ * directories are indexed, the index of small directories does not pay off.
+ * The count of indexes per volume is limited, the least recently used index
+ * is dropped first.
+ */
+#define MSDOS_DIR_INDEX_MIN_ENTRIES 256
+
+#define MSDOS_DIR_INDEX_MAX 4
+
+#define MSDOS_DIR_INDEX_MIN_TABLE_SIZE 64
+
+#define MSDOS_DIR_INDEX_NO_HASH 0
+
+#define MSDOS_DIR_INDEX_SLOT_FREE 0
+#define MSDOS_DIR_INDEX_SLOT_USED 1
+#define MSDOS_DIR_INDEX_SLOT_NAME 2
+
+typedef struct
+{
+    uint32_t long_hash;
+    uint32_t short_hash;
+    uint8_t  state;
+    uint8_t  lfn_entries;
+} msdos_dir_index_slot_t;
+
+struct msdos_dir_index_s
+{
+    rtems_chain_node        node;
+    uint32_t                cln;               /* first cluster of directory */
+    uint32_t                slots_per_cluster;
+    uint32_t                cluster_count;
+    uint32_t               *clusters;
+    uint32_t                slot_count;
+    msdos_dir_index_slot_t *slots;
+    uint32_t                end_slot;          /* start of the empty rest */
+    uint32_t                free_hint;         /* no free slot below */
+
+    /*
+     * Open addressing hash table with linear probing.  A record is the slot
+     * of the short name entry shifted by one, the lowest bit tells whether
+     * the long or the short name is meant.  Zero marks an empty record.
+     */
+    uint32_t               *records;
+    uint32_t                record_mask;
+    uint32_t                record_count;
+};
+
+uint32_t
+msdos_dir_index_hash(const void *name, size_t name_len)
+{
+    const uint8_t *n = name;
+    uint32_t       hash = 2166136261U;
+    size_t         i;
+
+    for (i = 0; i < name_len; ++i)
+    {
+        hash ^= n[i];
+        hash *= 16777619U;
+    }
+
+    /* Zero marks a missing name */
+    if (hash == MSDOS_DIR_INDEX_NO_HASH)
+        hash = 1;
+
+    return hash;
+}
+
+static uint32_t
+msdos_dir_index_record_hash(const msdos_dir_index_t *index, uint32_t record)
+{
+    const msdos_dir_index_slot_t *slot = &index->slots[(record - 1) >> 1];
+
+    return ((record - 1) & 1) != 0 ? slot->long_hash : slot->short_hash;
+}
+
+static void
+msdos_dir_index_insert_record(msdos_dir_index_t *index, uint32_t hash,
+                              uint32_t record)
+{
+    uint32_t i = hash & index->record_mask;
+
+    while (index->records[i] != 0)
+        i = (i + 1) & index->record_mask;
+
+    index->records[i] = record;
+    ++index->record_count;
+}
+
+static void
+msdos_dir_index_remove_record(msdos_dir_index_t *index, uint32_t hash,
+                              uint32_t record)
+{
+    uint32_t *records = index->records;
+    uint32_t  mask = index->record_mask;
+    uint32_t  i = hash & mask;
+    uint32_t  j;
+
+    while (records[i] != record)
+    {
+        if (records[i] == 0)
+            return;
+
+        i = (i + 1) & mask;
+    }
+
+    --index->record_count;
+
+    /*
+     * Move the following records of the probe sequence back into the free
+     * record, so that lookups need no deleted record markers.
+     */
+    j = i;
+
+    while (true)
+    {
+        uint32_t k;
+
+        j = (j + 1) & mask;
+
+        if (records[j] == 0)
+            break;
+
+        k = msdos_dir_index_record_hash(index, records[j]) & mask;
+
+        /* Move the record unless its home lies cyclically in ( i, j ] */
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+            continue;
+
+        records[i] = records[j];
+        i = j;
+    }
+
+    records[i] = 0;
+}
+
+static void
+msdos_dir_index_insert_name(msdos_dir_index_t *index, uint32_t slot)
+{
+    const msdos_dir_index_slot_t *s = &index->slots[slot];
+    uint32_t                      record = (slot << 1) + 1;
+
+    if (s->short_hash != MSDOS_DIR_INDEX_NO_HASH)
+        msdos_dir_index_insert_record(index, s->short_hash, record);
+
+    if (s->long_hash != MSDOS_DIR_INDEX_NO_HASH)
+        msdos_dir_index_insert_record(index, s->long_hash, record + 1);
+}
+
+static void
+msdos_dir_index_remove_name(msdos_dir_index_t *index, uint32_t slot)
+{
+    const msdos_dir_index_slot_t *s = &index->slots[slot];
+    uint32_t                      record = (slot << 1) + 1;
+
+    if (s->short_hash != MSDOS_DIR_INDEX_NO_HASH)
+        msdos_dir_index_remove_record(index, s->short_hash, record);
+
+    if (s->long_hash != MSDOS_DIR_INDEX_NO_HASH)
+        msdos_dir_index_remove_record(index, s->long_hash, record + 1);
+}
+
+/*
+ * Rebuilds the hash table with the specified size from the slots.
+ */
+static int
+msdos_dir_index_rehash(msdos_dir_index_t *index, uint32_t size)
+{
+    uint32_t *records;
+    uint32_t  slot;
+
+    records = calloc(size, sizeof(*records));
+    if (records == NULL)
+        return -1;
+
+    free(index->records);
+    index->records = records;
+    index->record_mask = size - 1;
+    index->record_count = 0;
+
+    for (slot = 0; slot < index->end_slot; ++slot)
+    {
+        if (index->slots[slot].state == MSDOS_DIR_INDEX_SLOT_NAME)
+            msdos_dir_index_insert_name(index, slot);
+    }
+
+    return RC_OK;
+}
+
+/*
+ * Makes room for two more records and keeps the load factor below 3/4.
+ */
+static int
+msdos_dir_index_reserve_records(msdos_dir_index_t *index)
+{
+    uint32_t size = index->record_mask + 1;
+
+    if (4 * (index->record_count + 2) <= 3 * size)
+        return RC_OK;
+
+    while (4 * (index->record_count + 2) > 3 * size)
+        size *= 2;
+
+    return msdos_dir_index_rehash(index, size);
+}
+
+static void
+msdos_dir_index_destroy(msdos_dir_index_t *index)
+{
+    rtems_chain_extract_unprotected(&index->node);
+    free(index->records);
+    free(index->slots);
+    free(index->clusters);
+    free(index);
+}
+
+/*
+ * Adds the clusters of a grown directory to the index.
+ */
+static int
+msdos_dir_index_update_clusters(msdos_fs_info_t   *fs_info,
+                                fat_file_fd_t     *fat_fd,
+                                msdos_dir_index_t *index)
+{
+    uint32_t                bts2rd =
+        index->slots_per_cluster * MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+    uint32_t                cluster_count = fat_fd->fat_file_size / bts2rd;
+    uint32_t                slot_count;
+    uint32_t               *clusters;
+    msdos_dir_index_slot_t *slots;
+    uint32_t                i;
+
+    if (cluster_count <= index->cluster_count)
+        return RC_OK;
+
+    slot_count = cluster_count * index->slots_per_cluster;
+
+    clusters = realloc(index->clusters, cluster_count * sizeof(*clusters));
+    if (clusters == NULL)
+        return -1;
+
+    index->clusters = clusters;
+
+    slots = realloc(index->slots, slot_count * sizeof(*slots));
+    if (slots == NULL)
+        return -1;
+
+    index->slots = slots;
+    memset(&slots[index->slot_count], 0,
+           (slot_count - index->slot_count) * sizeof(*slots));
+
+    for (i = index->cluster_count; i < cluster_count; ++i)
+    {
+        int rc = fat_file_ioctl(&fs_info->fat, fat_fd, F_CLU_NUM, i * bts2rd,
+                                &clusters[i]);
+        if (rc != RC_OK)
+            return rc;
+
+        index->cluster_count = i + 1;
+        index->slot_count = index->cluster_count * index->slots_per_cluster;
+    }
+
+    return RC_OK;
+}
+
+static void
+msdos_dir_index_update_free_hint(msdos_dir_index_t *index)
+{
+    while (index->free_hint < index->slot_count &&
+           index->slots[index->free_hint].state != MSDOS_DIR_INDEX_SLOT_FREE)
+        ++index->free_hint;
+}
+
+/*
+ * Returns the hash of the normalized short name of the entry.
+ */
+static uint32_t
+msdos_dir_index_short_hash(rtems_dosfs_convert_control *converter,
+                           const char                  *entry)
+{
+    uint8_t utf8[MSDOS_SFN_MAX_WITH_DOT_UTF8_BYTES];
+    uint8_t normalized[MSDOS_LFN_ENTRY_SIZE_UTF8];
+    size_t  normalized_size = sizeof(normalized);
+    ssize_t utf8_size;
+    int     eno;
+
+    if ((*MSDOS_DIR_ATTR(entry) & MSDOS_ATTR_VOLUME_ID) != 0)
+        return MSDOS_DIR_INDEX_NO_HASH;
+
+    utf8_size = msdos_short_entry_to_utf8_name(converter,
+                                               MSDOS_DIR_NAME(entry),
+                                               utf8, sizeof(utf8));
+    if (utf8_size <= 0)
+        return MSDOS_DIR_INDEX_NO_HASH;
+
+    eno = (*converter->handler->utf8_normalize_and_fold)(converter, utf8,
+                                                         utf8_size,
+                                                         normalized,
+                                                         &normalized_size);
+    if (eno != 0)
+        return MSDOS_DIR_INDEX_NO_HASH;
+
+    return msdos_dir_index_hash(normalized, normalized_size);
+}
+
+/*
+ * State of the long file name entries in front of a short name entry during
+ * the directory scan.  The name parts are normalized per entry like in
+ * msdos_find_file_in_directory() and stored from the end of the buffer,
+ * since the last part comes first.
+ */
+typedef struct
+{
+    uint32_t first_slot;
+    int      lfn_entry;
+    int      lfn_entries;
+    uint8_t  checksum;
+    bool     active;
+    size_t   pos;
+    uint8_t  name[MSDOS_NAME_MAX_UTF8_LFN_BYTES];
+} msdos_dir_index_lfn_t;
+
+static void
+msdos_dir_index_scan_lfn(msdos_fs_info_t       *fs_info,
+                         msdos_dir_index_lfn_t *lfn,
+                         const char            *entry,
+                         uint32_t               slot)
+{
+    rtems_dosfs_convert_control *converter = fs_info->converter;
+    uint8_t                      utf8[MSDOS_LFN_ENTRY_SIZE_UTF8];
+    uint8_t                      normalized[MSDOS_LFN_ENTRY_SIZE_UTF8];
+    size_t                       normalized_size = sizeof(normalized);
+    bool                         is_first_entry = !lfn->active;
+    ssize_t                      utf8_size;
+    int                          eno;
+
+    if (is_first_entry)
+    {
+        if ((*MSDOS_DIR_ENTRY_TYPE(entry) & MSDOS_LAST_LONG_ENTRY) == 0)
+            return;
+
+        lfn->first_slot = slot;
+        lfn->lfn_entry = *MSDOS_DIR_ENTRY_TYPE(entry) &
+            MSDOS_LAST_LONG_ENTRY_MASK;
+        lfn->lfn_entries = lfn->lfn_entry;
+        lfn->checksum = *MSDOS_DIR_LFN_CHECKSUM(entry);
+        lfn->pos = sizeof(lfn->name);
+        lfn->active = true;
+    }
+
+    if ((lfn->lfn_entry != (*MSDOS_DIR_ENTRY_TYPE(entry) &
+                            MSDOS_LAST_LONG_ENTRY_MASK)) ||
+        (lfn->checksum != *MSDOS_DIR_LFN_CHECKSUM(entry)))
+    {
+        lfn->active = false;
+        return;
+    }
+
+    lfn->lfn_entry--;
+
+    utf8_size = msdos_long_entry_to_utf8_name(converter, entry,
+                                              is_first_entry, utf8,
+                                              sizeof(utf8));
+    if (utf8_size <= 0)
+    {
+        lfn->active = false;
+        return;
+    }
+
+    eno = (*converter->handler->utf8_normalize_and_fold)(converter, utf8,
+                                                         utf8_size,
+                                                         normalized,
+                                                         &normalized_size);
+    if (eno != 0 || normalized_size > lfn->pos)
+    {
+        lfn->active = false;
+        return;
+    }
+
+    lfn->pos -= normalized_size;
+    memcpy(&lfn->name[lfn->pos], normalized, normalized_size);
+}
+
+/*
+ * Reads the directory and fills the slots of the index.
+ */
+static int
+msdos_dir_index_scan(msdos_fs_info_t   *fs_info,
+                     fat_file_fd_t     *fat_fd,
+                     msdos_dir_index_t *index)
+{
+    uint32_t               bts2rd =
+        index->slots_per_cluster * MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+    msdos_dir_index_lfn_t *lfn;
+    uint32_t               name_count;
+    uint32_t               size;
+    uint32_t               i;
+    int                    rc = RC_OK;
+
+    lfn = malloc(sizeof(*lfn));
+    if (lfn == NULL)
+        return -1;
+
+    lfn->active = false;
+    index->end_slot = index->slot_count;
+
+    for (i = 0; i < index->cluster_count; ++i)
+    {
+        ssize_t  ret;
+        uint32_t j;
+
+        rc = fat_file_ioctl(&fs_info->fat, fat_fd, F_CLU_NUM, i * bts2rd,
+                            &index->clusters[i]);
+        if (rc != RC_OK)
+            break;
+
+        /* The slots of the empty rest stay free */
+        if (index->end_slot < index->slot_count)
+            continue;
+
+        ret = fat_file_read(&fs_info->fat, fat_fd, i * bts2rd, bts2rd,
+                            fs_info->cl_buf);
+        if (ret != (ssize_t) bts2rd)
+        {
+            rc = -1;
+            break;
+        }
+
+        for (j = 0; j < index->slots_per_cluster; ++j)
+        {
+            const char             *entry = (const char *) fs_info->cl_buf +
+                j * MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+            uint32_t                slot = i * index->slots_per_cluster + j;
+            msdos_dir_index_slot_t *s = &index->slots[slot];
+
+            if (*MSDOS_DIR_ENTRY_TYPE(entry) ==
+                MSDOS_THIS_DIR_ENTRY_AND_REST_EMPTY)
+            {
+                index->end_slot = slot;
+                break;
+            }
+
+            if (*MSDOS_DIR_ENTRY_TYPE(entry) == MSDOS_THIS_DIR_ENTRY_EMPTY)
+            {
+                s->state = MSDOS_DIR_INDEX_SLOT_FREE;
+                lfn->active = false;
+            }
+            else if ((*MSDOS_DIR_ATTR(entry) & MSDOS_ATTR_LFN_MASK) ==
+                     MSDOS_ATTR_LFN)
+            {
+                s->state = MSDOS_DIR_INDEX_SLOT_USED;
+                msdos_dir_index_scan_lfn(fs_info, lfn, entry, slot);
+            }
+            else
+            {
+                s->state = MSDOS_DIR_INDEX_SLOT_NAME;
+                s->short_hash =
+                    msdos_dir_index_short_hash(fs_info->converter, entry);
+
+                if (lfn->active &&
+                    lfn->lfn_entry == 0 &&
+                    lfn->checksum == msdos_lfn_checksum(entry))
+                {
+                    s->long_hash =
+                        msdos_dir_index_hash(&lfn->name[lfn->pos],
+                                             sizeof(lfn->name) - lfn->pos);
+                    s->lfn_entries = lfn->lfn_entries;
+                }
+
+                lfn->active = false;
+            }
+        }
+    }
+
+    free(lfn);
+
+    if (rc != RC_OK)
+        return rc;
+
+    index->free_hint = 0;
+    msdos_dir_index_update_free_hint(index);
+
+    name_count = 0;
+
+    for (i = 0; i < index->end_slot; ++i)
+    {
+        if (index->slots[i].state == MSDOS_DIR_INDEX_SLOT_NAME)
+            name_count += 2;
+    }
+
+    size = MSDOS_DIR_INDEX_MIN_TABLE_SIZE;
+
+    while (4 * (name_count + 2) > 3 * size)
+        size *= 2;
+
+    return msdos_dir_index_rehash(index, size);
+}
+
+static msdos_dir_index_t *
+msdos_dir_index_create(msdos_fs_info_t *fs_info,
+                       fat_file_fd_t   *fat_fd,
+                       uint32_t         bts2rd)
+{
+    msdos_dir_index_t *index;
+    int                rc;
+
+    index = calloc(1, sizeof(*index));
+    if (index == NULL)
+        return NULL;
+
+    index->cln = fat_fd->cln;
+    index->slots_per_cluster = bts2rd / MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+    index->cluster_count = fat_fd->fat_file_size / bts2rd;
+    index->slot_count = index->cluster_count * index->slots_per_cluster;
+    index->clusters = calloc(index->cluster_count, sizeof(*index->clusters));
+    index->slots = calloc(index->slot_count, sizeof(*index->slots));
+    index->records = calloc(MSDOS_DIR_INDEX_MIN_TABLE_SIZE,
+                            sizeof(*index->records));
+    index->record_mask = MSDOS_DIR_INDEX_MIN_TABLE_SIZE - 1;
+    rtems_chain_append_unprotected(&fs_info->dir_indexes, &index->node);
+
+    if (index->clusters == NULL ||
+        index->slots == NULL ||
+        index->records == NULL)
+    {
+        msdos_dir_index_destroy(index);
+        return NULL;
+    }
+
+    rc = msdos_dir_index_scan(fs_info, fat_fd, index);
+    if (rc != RC_OK)
+    {
+        msdos_dir_index_destroy(index);
+        return NULL;
+    }
+
+    return index;
+}
+
+/* msdos_dir_index_get --
+ *     Return the index of a directory.  The index is built on the first
+ *     access to a large directory.
+ *
+ * PARAMETERS:
+ *     fs_info - MSDOS file system info
+ *     fat_fd  - fat-file descriptor of the directory
+ *     bts2rd  - bytes of the directory read at once
+ *
+ * RETURNS:
+ *     the index, or NULL if the directory is not indexed
+ */
+msdos_dir_index_t *
+msdos_dir_index_get(msdos_fs_info_t *fs_info,
+                    fat_file_fd_t   *fat_fd,
+                    uint32_t         bts2rd)
+{
+    rtems_chain_node *node = rtems_chain_first(&fs_info->dir_indexes);
+    rtems_chain_node *tail = rtems_chain_tail(&fs_info->dir_indexes);
+    uint32_t          count = 0;
+
+    while (node != tail)
+    {
+        msdos_dir_index_t *index = (msdos_dir_index_t *) node;
+
+        if (index->cln == fat_fd->cln)
+        {
+            rtems_chain_extract_unprotected(&index->node);
+            rtems_chain_append_unprotected(&fs_info->dir_indexes,
+                                           &index->node);
+            return index;
+        }
+
+        ++count;
+        node = rtems_chain_next(node);
+    }
+
+    if (fat_fd->fat_file_size / MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE <
+        MSDOS_DIR_INDEX_MIN_ENTRIES)
+        return NULL;
+
+    if (count >= MSDOS_DIR_INDEX_MAX)
+        msdos_dir_index_destroy(
+            (msdos_dir_index_t *) rtems_chain_first(&fs_info->dir_indexes));
+
+    return msdos_dir_index_create(fs_info, fat_fd, bts2rd);
+}
+
+/* msdos_dir_index_next --
+ *     Return the next file with a name of the specified hash.  The position
+ *     must be zero for the first call.
+ *
+ * PARAMETERS:
+ *     index        - directory index
+ *     hash         - hash of the normalized name
+ *     position     - iteration position
+ *     first_offset - offset of the first directory entry of the file
+ *     end_offset   - offset after the short name entry of the file
+ *
+ * RETURNS:
+ *     true if a file is returned, false otherwise
+ */
+bool
+msdos_dir_index_next(const msdos_dir_index_t *index,
+                     uint32_t                 hash,
+                     uint32_t                *position,
+                     uint32_t                *first_offset,
+                     uint32_t                *end_offset)
+{
+    uint32_t i = *position;
+    uint32_t record;
+
+    if (i == 0)
+        i = hash & index->record_mask;
+    else
+        --i;
+
+    while ((record = index->records[i]) != 0)
+    {
+        i = (i + 1) & index->record_mask;
+
+        if (msdos_dir_index_record_hash(index, record) == hash)
+        {
+            uint32_t slot = (record - 1) >> 1;
+
+            *position = i + 1;
+            *first_offset = (slot - index->slots[slot].lfn_entries) *
+                MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+            *end_offset = (slot + 1) * MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* msdos_dir_index_get_free_space --
+ *     Find the first run of free directory entries which is long enough.
+ *     Otherwise, return the free directory entries at the end of the
+ *     directory, see msdos_add_file().
+ *
+ * PARAMETERS:
+ *     index             - directory index
+ *     entry_count       - count of needed directory entries
+ *     empty_file_offset - offset of the first free directory entry
+ *     empty_entry_count - count of free directory entries
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_dir_index_get_free_space(const msdos_dir_index_t *index,
+                               uint32_t                 entry_count,
+                               uint32_t                *empty_file_offset,
+                               uint32_t                *empty_entry_count)
+{
+    uint32_t run_start = index->slot_count;
+    uint32_t run_length = 0;
+    uint32_t slot;
+
+    for (slot = index->free_hint; slot < index->slot_count; ++slot)
+    {
+        if (index->slots[slot].state == MSDOS_DIR_INDEX_SLOT_FREE)
+        {
+            if (run_length == 0)
+                run_start = slot;
+
+            ++run_length;
+
+            if (run_length == entry_count)
+                break;
+        }
+        else
+        {
+            run_length = 0;
+        }
+    }
+
+    *empty_file_offset = run_start * MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+    *empty_entry_count = run_length;
+}
+
+/*
+ * Returns the slot of the directory entry position or UINT32_MAX.
+ */
+static uint32_t
+msdos_dir_index_slot_of_pos(const msdos_dir_index_t *index,
+                            const fat_pos_t         *pos)
+{
+    uint32_t i;
+
+    for (i = 0; i < index->cluster_count; ++i)
+    {
+        if (index->clusters[i] == pos->cln)
+            return i * index->slots_per_cluster +
+                pos->ofs / MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE;
+    }
+
+    return UINT32_MAX;
+}
+
+/* msdos_dir_index_add --
+ *     Add a file written by msdos_add_file() to the index.  Without memory
+ *     the index is dropped.
+ *
+ * PARAMETERS:
+ *     fs_info        - MSDOS file system info
+ *     fat_fd         - fat-file descriptor of the directory
+ *     index          - directory index
+ *     dir_pos        - position of the directory entries of the file
+ *     lfn_entries    - count of long file name entries
+ *     long_hash      - hash of the normalized long name
+ *     name_dir_entry - short name directory entry
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_dir_index_add(msdos_fs_info_t   *fs_info,
+                    fat_file_fd_t     *fat_fd,
+                    msdos_dir_index_t *index,
+                    const fat_dir_pos_t *dir_pos,
+                    unsigned int       lfn_entries,
+                    uint32_t           long_hash,
+                    const char        *name_dir_entry)
+{
+    msdos_dir_index_slot_t *s;
+    uint32_t                slot;
+    uint32_t                i;
+    int                     rc;
+
+    rc = msdos_dir_index_update_clusters(fs_info, fat_fd, index);
+    if (rc == RC_OK)
+        rc = msdos_dir_index_reserve_records(index);
+
+    slot = msdos_dir_index_slot_of_pos(index, &dir_pos->sname);
+
+    if (rc != RC_OK || slot == UINT32_MAX || slot < lfn_entries)
+    {
+        msdos_dir_index_destroy(index);
+        return;
+    }
+
+    for (i = slot - lfn_entries; i <= slot; ++i)
+    {
+        if (index->slots[i].state != MSDOS_DIR_INDEX_SLOT_FREE)
+        {
+            msdos_dir_index_destroy(index);
+            return;
+        }
+    }
+
+    for (i = slot - lfn_entries; i < slot; ++i)
+        index->slots[i].state = MSDOS_DIR_INDEX_SLOT_USED;
+
+    s = &index->slots[slot];
+    s->state = MSDOS_DIR_INDEX_SLOT_NAME;
+    s->lfn_entries = lfn_entries;
+    s->long_hash = lfn_entries > 0 ? long_hash : MSDOS_DIR_INDEX_NO_HASH;
+    s->short_hash = msdos_dir_index_short_hash(fs_info->converter,
+                                               name_dir_entry);
+    msdos_dir_index_insert_name(index, slot);
+
+    if (slot >= index->end_slot)
+        index->end_slot = slot + 1;
+
+    msdos_dir_index_update_free_hint(index);
+}
+
+/* msdos_dir_index_remove --
+ *     Remove a file from the index of its directory.
+ *
+ * PARAMETERS:
+ *     fs_info - MSDOS file system info
+ *     dir_pos - position of the directory entries of the file
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_dir_index_remove(msdos_fs_info_t     *fs_info,
+                       const fat_dir_pos_t *dir_pos)
+{
+    rtems_chain_node *node = rtems_chain_first(&fs_info->dir_indexes);
+    rtems_chain_node *tail = rtems_chain_tail(&fs_info->dir_indexes);
+
+    while (node != tail)
+    {
+        msdos_dir_index_t *index = (msdos_dir_index_t *) node;
+        uint32_t           slot;
+
+        slot = msdos_dir_index_slot_of_pos(index, &dir_pos->sname);
+
+        if (slot != UINT32_MAX)
+        {
+            msdos_dir_index_slot_t *s = &index->slots[slot];
+            uint32_t                first;
+            uint32_t                i;
+
+            if (s->state != MSDOS_DIR_INDEX_SLOT_NAME)
+            {
+                msdos_dir_index_destroy(index);
+                return;
+            }
+
+            msdos_dir_index_remove_name(index, slot);
+            first = slot - s->lfn_entries;
+
+            for (i = first; i <= slot; ++i)
+                memset(&index->slots[i], 0, sizeof(index->slots[i]));
+
+            if (first < index->free_hint)
+                index->free_hint = first;
+
+            return;
+        }
+
+        node = rtems_chain_next(node);
+    }
+}
+
+/* msdos_dir_index_drop --
+ *     Drop the index of a directory, e.g. if the directory is removed.
+ *
+ * PARAMETERS:
+ *     fs_info - MSDOS file system info
+ *     cln     - first cluster of the directory
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_dir_index_drop(msdos_fs_info_t *fs_info, uint32_t cln)
+{
+    rtems_chain_node *node = rtems_chain_first(&fs_info->dir_indexes);
+    rtems_chain_node *tail = rtems_chain_tail(&fs_info->dir_indexes);
+
+    while (node != tail)
+    {
+        msdos_dir_index_t *index = (msdos_dir_index_t *) node;
+
+        if (index->cln == cln)
+        {
+            msdos_dir_index_destroy(index);
+            return;
+        }
+
+        node = rtems_chain_next(node);
+    }
+}
+
+/* msdos_dir_index_drop_all --
+ *     Drop all directory indexes of the volume.
+ *
+ * PARAMETERS:
+ *     fs_info - MSDOS file system info
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_dir_index_drop_all(msdos_fs_info_t *fs_info)
+{
+    while (!rtems_chain_is_empty(&fs_info->dir_indexes))
+    {
+        msdos_dir_index_destroy(
+            (msdos_dir_index_t *) rtems_chain_first(&fs_info->dir_indexes));
+    }
+}
@@ -195,6 +195,60 @@ msdos_file_ftruncate(rtems_libio_t *iop, off_t length)
     return rc;
 }
 
+/* msdos_file_fallocate --
+ *     Allocate the clusters of a file region.  The file is extended with
+ *     zeros if the region ends after the end of the file.
+ *
+ * PARAMETERS:
+ *     iop    - file control block
+ *     offset - start of the region
+ *     len    - length of the region
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured (errno set appropriately).
+ */
+int
+msdos_file_fallocate(rtems_libio_t *iop, off_t offset, off_t len)
+{
+    int                rc = RC_OK;
+    msdos_fs_info_t   *fs_info = iop->pathinfo.mt_entry->fs_info;
+    fat_file_fd_t     *fat_fd = iop->pathinfo.node_access;
+    off_t              end = offset + len;
+    uint32_t           old_length;
+    uint32_t           new_length;
+
+    if (end > fat_fd->size_limit)
+        rtems_set_errno_and_return_minus_one(EFBIG);
+
+    msdos_fs_lock(fs_info);
+
+    old_length = fat_fd->fat_file_size;
+    if (end > old_length) {
+        rc = fat_file_extend(&fs_info->fat,
+                             fat_fd,
+                             true,
+                             (uint32_t) end,
+                             &new_length);
+        if (rc == RC_OK && end != new_length) {
+            fat_file_truncate(&fs_info->fat, fat_fd, old_length);
+            fat_file_set_file_size(fat_fd, old_length);
+            if (old_length == 0)
+                fat_file_set_first_cluster_num(fat_fd, 0);
+            errno = ENOSPC;
+            rc = -1;
+        }
+
+        if (rc == RC_OK)
+        {
+            fat_file_set_ctime_mtime(fat_fd, time(NULL));
+        }
+    }
+
+    msdos_fs_unlock(fs_info);
+
+    return rc;
+}
+
 /* msdos_file_sync --
  *     Synchronize file - synchronize file data and if file is not removed
  *     synchronize file metadata.
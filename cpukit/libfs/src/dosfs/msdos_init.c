@@ -104,6 +104,12 @@ int rtems_dosfs_initialize(
     rtems_dosfs_convert_control       *converter;
 
 
+    if (mount_options != NULL &&
+        mount_options->reservation_size > RTEMS_DOSFS_RESERVATION_SIZE_MAX) {
+        errno = EINVAL;
+        return -1;
+    }
+
     if (mount_options == NULL || mount_options->converter == NULL) {
         converter = rtems_dosfs_create_default_converter();
     } else {
@@ -116,6 +122,15 @@ int rtems_dosfs_initialize(
                                       &msdos_file_handlers,
                                       &msdos_dir_handlers,
                                       converter);
+
+        if (rc == RC_OK && mount_options != NULL) {
+            msdos_fs_info_t *fs_info = mt_entry->fs_info;
+            fat_vol_t       *vol = &fs_info->fat.vol;
+
+            fs_info->fat.reserve_cls = (uint32_t)
+                (((uint64_t) mount_options->reservation_size + vol->bpc - 1) >>
+                 vol->bpc_log2);
+        }
     } else {
         errno = ENOMEM;
         rc = -1;
@@ -69,6 +69,7 @@ msdos_initialize_support(
     temp_mt_entry->fs_info = fs_info;
 
     fs_info->converter = converter;
+    rtems_chain_initialize_empty(&fs_info->dir_indexes);
 
     rc = fat_init_volume_info(&fs_info->fat, temp_mt_entry->dev);
     if (rc != RC_OK)
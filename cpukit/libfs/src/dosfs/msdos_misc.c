@@ -45,10 +45,6 @@
 #define MSDOS_LFN_ENTRY_SIZE \
   (MSDOS_LFN_LEN_PER_ENTRY * MSDOS_NAME_LFN_BYTES_PER_CHAR)
 
-#define MSDOS_LFN_ENTRY_SIZE_UTF8 \
-  ((MSDOS_LFN_LEN_PER_ENTRY + 1 ) * MSDOS_NAME_LFN_BYTES_PER_CHAR \
-    * MSDOS_NAME_MAX_UTF8_BYTES_PER_CHAR)
-
 /*
  * External strings. Saves space this way.
  */
@@ -322,6 +318,62 @@ msdos_long_to_short(rtems_dosfs_convert_control     *converter,
     return type;
 }
 
+/* msdos_read_short_dir_entry --
+ *     Read the short name directory entry at the specified position.
+ *
+ * PARAMETERS:
+ *     fs_info    - fat fs info
+ *     dir_pos    - position of the directory entry
+ *     node_entry - buffer for the 32 bytes directory entry
+ *
+ * RETURNS:
+ *     RC_OK on success, or -1 if error occured (errno set apropriately)
+ *
+ */
+static int
+msdos_read_short_dir_entry(
+    fat_fs_info_t       *fs_info,
+    const fat_dir_pos_t *dir_pos,
+    char                *node_entry
+    )
+{
+    uint32_t sec;
+    uint32_t byte;
+    ssize_t  ret;
+
+    sec = fat_cluster_num_to_sector_num(fs_info, dir_pos->sname.cln);
+    sec += (dir_pos->sname.ofs >> fs_info->vol.sec_log2);
+    byte = dir_pos->sname.ofs & (fs_info->vol.bps - 1);
+
+    ret = _fat_block_read(fs_info, sec, byte,
+                          MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE, node_entry);
+    if (ret < 0)
+        return -1;
+
+    return RC_OK;
+}
+
+/* msdos_name_cache_purge_dir --
+ *     Remove the names of a directory from the name cache.  This is
+ *     necessary before a directory entry is created or removed.  All names
+ *     are removed since different names may refer to the same entry, e.g.
+ *     the short and long name or names which differ only in case.
+ *
+ * PARAMETERS:
+ *     dir_loc - directory node description
+ *
+ * RETURNS:
+ *     None
+ */
+void
+msdos_name_cache_purge_dir(
+    const rtems_filesystem_location_info_t *dir_loc
+    )
+{
+    rtems_filesystem_name_cache_purge_directory(dir_loc->mt_entry->fs_info,
+                                                msdos_name_cache_dir(dir_loc));
+}
+
 /* msdos_find_name --
  *     Find the node which correspondes to the name, open fat-file which
  *     correspondes to the found node and close fat-file which correspondes
@@ -346,33 +398,77 @@ msdos_find_name(
     int                rc = RC_OK;
     msdos_fs_info_t   *fs_info = parent_loc->mt_entry->fs_info;
     fat_file_fd_t     *fat_fd = NULL;
+    uintptr_t          dir = msdos_name_cache_dir(parent_loc);
     msdos_name_type_t  name_type;
     fat_dir_pos_t      dir_pos;
     unsigned short     time_val = 0;
     unsigned short     date = 0;
     char               node_entry[MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE];
+    rtems_filesystem_name_cache_status cache_status;
+    rtems_filesystem_name_cache_value  value;
 
     memset(node_entry, 0, MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE);
 
-    name_type = msdos_long_to_short (
-        fs_info->converter,
-        name,
-        name_len,
-        MSDOS_DIR_NAME(node_entry),
-        MSDOS_NAME_MAX);
+    cache_status = rtems_filesystem_name_cache_lookup(fs_info, dir, name,
+                                                      name_len, &value);
+    if (cache_status == RTEMS_FILESYSTEM_NAME_CACHE_NEGATIVE_HIT)
+        return MSDOS_NAME_NOT_FOUND_ERR;
 
-    /*
-     * find the node which corresponds to the name in the directory pointed by
-     * 'parent_loc'
-     */
-    rc = msdos_get_name_node(parent_loc, false, name, name_len, name_type,
-                             &dir_pos, node_entry);
-    if (rc != RC_OK)
-        return rc;
+    if (cache_status == RTEMS_FILESYSTEM_NAME_CACHE_HIT)
+    {
+        /*
+         * the cache knows the position of the directory entry, so read the
+         * entry instead of searching the directory
+         */
+        dir_pos.sname.cln = value.data[0];
+        dir_pos.sname.ofs = value.data[1];
+        dir_pos.lname.cln = value.data[2];
+        dir_pos.lname.ofs = value.data[3];
 
-    if (((*MSDOS_DIR_ATTR(node_entry)) & MSDOS_ATTR_VOLUME_ID) ||
-        ((*MSDOS_DIR_ATTR(node_entry) & MSDOS_ATTR_LFN_MASK) == MSDOS_ATTR_LFN))
-        return MSDOS_NAME_NOT_FOUND_ERR;
+        rc = msdos_read_short_dir_entry(&fs_info->fat, &dir_pos, node_entry);
+        if (rc != RC_OK)
+            return rc;
+    }
+    else
+    {
+        name_type = msdos_long_to_short (
+            fs_info->converter,
+            name,
+            name_len,
+            MSDOS_DIR_NAME(node_entry),
+            MSDOS_NAME_MAX);
+
+        /*
+         * find the node which corresponds to the name in the directory
+         * pointed by 'parent_loc'
+         */
+        rc = msdos_get_name_node(parent_loc, false, name, name_len, name_type,
+                                 &dir_pos, node_entry);
+
+        if ((rc == RC_OK) &&
+            (((*MSDOS_DIR_ATTR(node_entry)) & MSDOS_ATTR_VOLUME_ID) ||
+             ((*MSDOS_DIR_ATTR(node_entry) & MSDOS_ATTR_LFN_MASK) ==
+              MSDOS_ATTR_LFN)))
+            rc = MSDOS_NAME_NOT_FOUND_ERR;
+
+        if (rc == RC_OK)
+        {
+            value.data[0] = dir_pos.sname.cln;
+            value.data[1] = dir_pos.sname.ofs;
+            value.data[2] = dir_pos.lname.cln;
+            value.data[3] = dir_pos.lname.ofs;
+            rtems_filesystem_name_cache_enter(fs_info, dir, name, name_len,
+                                              &value);
+        }
+        else if (rc == MSDOS_NAME_NOT_FOUND_ERR)
+        {
+            rtems_filesystem_name_cache_enter(fs_info, dir, name, name_len,
+                                              NULL);
+        }
+
+        if (rc != RC_OK)
+            return rc;
+    }
 
     /* open fat-file corresponded to the found node */
     rc = fat_file_open(&fs_info->fat, &dir_pos, &fat_fd);
@@ -925,6 +1021,9 @@ msdos_set_first_char4file_name(
       }
     }
 
+    if (fchar == MSDOS_THIS_DIR_ENTRY_EMPTY)
+      msdos_dir_index_remove(fs_info, dir_pos);
+
     return  RC_OK;
 }
 
@@ -1158,7 +1257,7 @@ msdos_format_dirent_with_dot(char *dst,const char *src)
   return len;
 }
 
-static ssize_t
+ssize_t
 msdos_long_entry_to_utf8_name (
     rtems_dosfs_convert_control *converter,
     const char                  *entry,
@@ -1200,7 +1299,8 @@ msdos_long_entry_to_utf8_name (
     return retval;
 }
 
-static ssize_t msdos_short_entry_to_utf8_name (
+ssize_t
+msdos_short_entry_to_utf8_name (
   rtems_dosfs_convert_control     *converter,
   const char                      *entry,
   uint8_t                         *buf,
@@ -1313,7 +1413,9 @@ msdos_find_file_in_directory (
     char                                 *name_dir_entry,
     fat_dir_pos_t                        *dir_pos,
     uint32_t                             *empty_file_offset,
-    uint32_t                             *empty_entry_count)
+    uint32_t                             *empty_entry_count,
+    const uint32_t                        scan_begin,
+    const uint32_t                        scan_end)
 {
     int               rc                = RC_OK;
     ssize_t           bytes_read;
@@ -1327,9 +1429,11 @@ msdos_find_file_in_directory (
     uint8_t           entry_utf8_normalized[MSDOS_LFN_ENTRY_SIZE_UTF8];
     size_t            bytes_in_entry;
     bool              filename_matched  = false;
+    bool              scan_end_reached  = false;
     ssize_t           name_len_remaining;
     rtems_dosfs_convert_control *converter = fs_info->converter;
-    uint32_t          dir_offset = 0;
+    uint32_t          dir_offset = scan_begin / bts2rd;
+    uint32_t          first_dir_entry = scan_begin % bts2rd;
 
     /*
      * Scan the directory seeing if the file is present. While
@@ -1356,12 +1460,22 @@ msdos_find_file_in_directory (
         assert(bytes_read == bts2rd);
 
         /* have to look at the DIR_NAME as "raw" 8-bit data */
-        for (dir_entry = 0;
+        for (dir_entry = first_dir_entry;
              dir_entry < bts2rd && rc == RC_OK && (! filename_matched);
              dir_entry += MSDOS_DIRECTORY_ENTRY_STRUCT_SIZE)
         {
             char* entry = (char*) fs_info->cl_buf + dir_entry;
 
+            /*
+             * The scan of a directory index candidate ends after its short
+             * file name entry.
+             */
+            if (dir_offset * bts2rd + dir_entry >= scan_end)
+            {
+                scan_end_reached = true;
+                break;
+            }
+
             /*
              * See if the entry is empty or the remainder of the directory is
              * empty ? Localize to make the code read better.
@@ -1636,9 +1750,10 @@ msdos_find_file_in_directory (
             }
         }
 
-        if (filename_matched || remainder_empty)
+        if (filename_matched || remainder_empty || scan_end_reached)
             break;
 
+        first_dir_entry = 0;
         dir_offset++;
     }
     if ( ! filename_matched ) {
@@ -1657,6 +1772,63 @@ msdos_find_file_in_directory (
     return rc;
 }
 
+/*
+ * Looks up the name with the directory index.  Only the directory entries of
+ * the files with a matching name hash are read.
+ */
+static int
+msdos_find_file_in_index (
+    const msdos_dir_index_t              *index,
+    const uint8_t                        *filename_converted,
+    const size_t                          name_len_for_compare,
+    const size_t                          name_len_for_save,
+    const msdos_name_type_t               name_type,
+    msdos_fs_info_t                      *fs_info,
+    fat_file_fd_t                        *fat_fd,
+    const uint32_t                        bts2rd,
+    const bool                            create_node,
+    const unsigned int                    lfn_entries,
+    const uint32_t                        name_hash,
+    char                                 *name_dir_entry,
+    fat_dir_pos_t                        *dir_pos,
+    uint32_t                             *empty_file_offset,
+    uint32_t                             *empty_entry_count)
+{
+    uint32_t position = 0;
+    uint32_t first_offset;
+    uint32_t end_offset;
+
+    while (msdos_dir_index_next(index, name_hash, &position, &first_offset,
+                                &end_offset))
+    {
+        int rc = msdos_find_file_in_directory (
+            filename_converted,
+            name_len_for_compare,
+            name_len_for_save,
+            name_type,
+            fs_info,
+            fat_fd,
+            bts2rd,
+            false,
+            lfn_entries,
+            name_dir_entry,
+            dir_pos,
+            empty_file_offset,
+            empty_entry_count,
+            first_offset,
+            end_offset);
+        if (rc != MSDOS_NAME_NOT_FOUND_ERR)
+            return rc;
+    }
+
+    if (!create_node)
+        return MSDOS_NAME_NOT_FOUND_ERR;
+
+    msdos_dir_index_get_free_space(index, lfn_entries + 1, empty_file_offset,
+                                   empty_entry_count);
+    return RC_OK;
+}
+
 static int
 msdos_get_pos(
     msdos_fs_info_t *fs_info,
@@ -1857,6 +2029,8 @@ msdos_find_name_in_fat_file (
     rtems_dosfs_convert_control       *converter = fs_info->converter;
     void                              *buffer = converter->buffer.data;
     size_t                             buffer_size = converter->buffer.size;
+    msdos_dir_index_t                 *index = NULL;
+    uint32_t                           name_hash = 0;
 
     assert(name_utf8_len > 0);
 
@@ -1913,21 +2087,45 @@ msdos_find_name_in_fat_file (
         break;
     }
     if (retval == RC_OK) {
+      index = msdos_dir_index_get(fs_info, fat_fd, bts2rd);
+
       /* See if the file/directory does already exist */
-      retval = msdos_find_file_in_directory (
-          buffer,
-          name_len_for_compare,
-          name_len_for_save,
-          name_type,
-          fs_info,
-          fat_fd,
-          bts2rd,
-          create_node,
-          lfn_entries,
-          name_dir_entry,
-          dir_pos,
-          &empty_file_offset,
-          &empty_entry_count);
+      if (index != NULL) {
+        name_hash = msdos_dir_index_hash(buffer, name_len_for_compare);
+        retval = msdos_find_file_in_index (
+            index,
+            buffer,
+            name_len_for_compare,
+            name_len_for_save,
+            name_type,
+            fs_info,
+            fat_fd,
+            bts2rd,
+            create_node,
+            lfn_entries,
+            name_hash,
+            name_dir_entry,
+            dir_pos,
+            &empty_file_offset,
+            &empty_entry_count);
+      } else {
+        retval = msdos_find_file_in_directory (
+            buffer,
+            name_len_for_compare,
+            name_len_for_save,
+            name_type,
+            fs_info,
+            fat_fd,
+            bts2rd,
+            create_node,
+            lfn_entries,
+            name_dir_entry,
+            dir_pos,
+            &empty_file_offset,
+            &empty_entry_count,
+            0,
+            UINT32_MAX);
+      }
     }
     /* Create a non-existing file/directory if requested */
     if (   retval == RC_OK
@@ -1979,6 +2177,10 @@ msdos_find_name_in_fat_file (
                 empty_file_offset,
                 empty_entry_count
             );
+
+        if (retval == RC_OK && index != NULL)
+            msdos_dir_index_add(fs_info, fat_fd, index, dir_pos, lfn_entries,
+                                name_hash, name_dir_entry);
     }
 
     return retval;
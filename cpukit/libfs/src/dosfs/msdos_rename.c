@@ -58,6 +58,8 @@ msdos_rename(
         return rc;
     }
 
+    msdos_name_cache_purge_dir(old_parent_loc);
+
     /*
      * mark file removed
      */
@@ -61,6 +61,14 @@ msdos_rmnod(const rtems_filesystem_location_info_t *parent_pathloc,
          */
     }
 
+    msdos_name_cache_purge_dir(parent_pathloc);
+    if (fat_fd->fat_file_type == FAT_DIRECTORY)
+    {
+        /* the first cluster of the directory may be reused */
+        msdos_name_cache_purge_dir(pathloc);
+        msdos_dir_index_drop(fs_info, fat_fd->cln);
+    }
+
     /* mark file removed */
     rc = msdos_set_first_char4file_name(pathloc->mt_entry, &fat_fd->dir_pos,
                                         MSDOS_THIS_DIR_ENTRY_EMPTY);
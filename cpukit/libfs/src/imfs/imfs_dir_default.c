@@ -131,6 +131,7 @@ static const rtems_filesystem_file_handlers_r IMFS_dir_default_handlers = {
   .fcntl_h = rtems_filesystem_default_fcntl,
   .kqfilter_h = rtems_filesystem_default_kqfilter,
   .mmap_h = rtems_filesystem_default_mmap,
+  .fallocate_h = rtems_filesystem_default_fallocate,
   .poll_h = rtems_filesystem_default_poll,
   .readv_h = rtems_filesystem_default_readv,
   .writev_h = rtems_filesystem_default_writev
@@ -145,3 +146,13 @@ const IMFS_mknod_control IMFS_mknod_control_dir_default = {
   },
   .node_size = sizeof( IMFS_directory_t )
 };
+
+const IMFS_mknod_control IMFS_mknod_control_dir_hashed = {
+  {
+    .handlers = &IMFS_dir_default_handlers,
+    .node_initialize = IMFS_node_initialize_hashed_directory,
+    .node_remove = IMFS_node_remove_directory,
+    .node_destroy = IMFS_node_destroy_hashed_directory
+  },
+  .node_size = sizeof( IMFS_directory_t )
+};
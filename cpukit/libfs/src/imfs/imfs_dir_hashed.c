@@ -0,0 +1,236 @@
+/**
+ * @file
+ *
+ * @brief IMFS Hashed Directory Index
+ * @ingroup IMFS
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/imfs.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ *  The index is an open addressing hash table with linear probing.  It is
+ *  created once a directory has this many entries, below this a linear
+ *  search of the entries chain is fast enough.  The entries chain stays the
+ *  authoritative list of entries, so the readdir() order does not change.
+ */
+#define IMFS_DIRECTORY_HASH_THRESHOLD 32
+
+#define IMFS_DIRECTORY_HASH_MIN_SIZE 64
+
+static uint32_t IMFS_directory_hash( const char *name, size_t namelen )
+{
+  uint32_t hash = 2166136261U;
+  size_t   i;
+
+  for ( i = 0; i < namelen; ++i ) {
+    hash ^= (uint8_t) name[ i ];
+    hash *= 16777619U;
+  }
+
+  return hash;
+}
+
+static void IMFS_directory_hash_insert(
+  IMFS_jnode_t **table,
+  size_t         mask,
+  IMFS_jnode_t  *node
+)
+{
+  size_t i = IMFS_directory_hash( node->name, node->namelen ) & mask;
+
+  while ( table[ i ] != NULL ) {
+    i = ( i + 1 ) & mask;
+  }
+
+  table[ i ] = node;
+}
+
+static void IMFS_directory_hash_drop( IMFS_directory_t *dir )
+{
+  free( dir->hash_table );
+  dir->hash_table = NULL;
+  dir->hash_mask = 0;
+}
+
+/*
+ *  Rebuilds the index from the entries chain.  Without memory the index is
+ *  dropped.
+ */
+static void IMFS_directory_hash_rebuild( IMFS_directory_t *dir, size_t size )
+{
+  IMFS_jnode_t     **table;
+  rtems_chain_node  *current;
+  rtems_chain_node  *tail;
+
+  table = calloc( size, sizeof( *table ) );
+  IMFS_directory_hash_drop( dir );
+
+  if ( table == NULL ) {
+    return;
+  }
+
+  current = rtems_chain_first( &dir->Entries );
+  tail = rtems_chain_tail( &dir->Entries );
+
+  while ( current != tail ) {
+    IMFS_directory_hash_insert( table, size - 1, (IMFS_jnode_t *) current );
+    current = rtems_chain_next( current );
+  }
+
+  dir->hash_table = table;
+  dir->hash_mask = size - 1;
+}
+
+static size_t IMFS_directory_hash_size( size_t entry_count )
+{
+  size_t size = IMFS_DIRECTORY_HASH_MIN_SIZE;
+
+  while ( size < 2 * entry_count ) {
+    size *= 2;
+  }
+
+  return size;
+}
+
+void IMFS_directory_hash_add( IMFS_directory_t *dir, IMFS_jnode_t *node )
+{
+  size_t size;
+
+  ++dir->entry_count;
+
+  if ( dir->hash_table == NULL ) {
+    if ( dir->entry_count >= IMFS_DIRECTORY_HASH_THRESHOLD ) {
+      size = IMFS_directory_hash_size( dir->entry_count );
+      IMFS_directory_hash_rebuild( dir, size );
+    }
+
+    return;
+  }
+
+  size = dir->hash_mask + 1;
+
+  /* Keep the load factor below 3/4 */
+  if ( 4 * dir->entry_count > 3 * size ) {
+    IMFS_directory_hash_rebuild( dir, 2 * size );
+  } else {
+    IMFS_directory_hash_insert( dir->hash_table, dir->hash_mask, node );
+  }
+}
+
+void IMFS_directory_hash_remove( IMFS_directory_t *dir, IMFS_jnode_t *node )
+{
+  IMFS_jnode_t **table = dir->hash_table;
+  size_t         mask = dir->hash_mask;
+  size_t         i;
+  size_t         j;
+
+  --dir->entry_count;
+
+  if ( table == NULL ) {
+    return;
+  }
+
+  if ( dir->entry_count < IMFS_DIRECTORY_HASH_THRESHOLD / 2 ) {
+    IMFS_directory_hash_drop( dir );
+    return;
+  }
+
+  i = IMFS_directory_hash( node->name, node->namelen ) & mask;
+
+  while ( table[ i ] != node ) {
+    IMFS_assert( table[ i ] != NULL );
+    i = ( i + 1 ) & mask;
+  }
+
+  /*
+   *  Move the following entries of the probe sequence back into the free
+   *  slot, so that lookups need no deleted slot markers.
+   */
+  j = i;
+
+  while ( true ) {
+    IMFS_jnode_t *entry;
+    size_t        k;
+
+    j = ( j + 1 ) & mask;
+    entry = table[ j ];
+
+    if ( entry == NULL ) {
+      break;
+    }
+
+    k = IMFS_directory_hash( entry->name, entry->namelen ) & mask;
+
+    /* Move the entry unless its home slot lies cyclically in ( i, j ] */
+    if ( i <= j ? ( i < k && k <= j ) : ( i < k || k <= j ) ) {
+      continue;
+    }
+
+    table[ i ] = entry;
+    i = j;
+  }
+
+  table[ i ] = NULL;
+
+  if (
+    mask + 1 > IMFS_DIRECTORY_HASH_MIN_SIZE
+      && 8 * dir->entry_count < mask + 1
+  ) {
+    IMFS_directory_hash_rebuild( dir, ( mask + 1 ) / 2 );
+  }
+}
+
+IMFS_jnode_t *IMFS_directory_hash_search(
+  const IMFS_directory_t *dir,
+  const char *name,
+  size_t namelen
+)
+{
+  IMFS_jnode_t **table = dir->hash_table;
+  size_t         mask = dir->hash_mask;
+  size_t         i = IMFS_directory_hash( name, namelen ) & mask;
+  IMFS_jnode_t  *entry;
+
+  while ( ( entry = table[ i ] ) != NULL ) {
+    if (
+      entry->namelen == namelen
+        && memcmp( entry->name, name, namelen ) == 0
+    ) {
+      return entry;
+    }
+
+    i = ( i + 1 ) & mask;
+  }
+
+  return NULL;
+}
+
+IMFS_jnode_t *IMFS_node_initialize_hashed_directory(
+  IMFS_jnode_t *node,
+  void *arg
+)
+{
+  node = IMFS_node_initialize_directory( node, arg );
+  node->flags |= IMFS_NODE_FLAG_HASHED_DIRECTORY;
+
+  return node;
+}
+
+void IMFS_node_destroy_hashed_directory( IMFS_jnode_t *node )
+{
+  IMFS_directory_hash_drop( (IMFS_directory_t *) node );
+  IMFS_node_destroy_default( node );
+}
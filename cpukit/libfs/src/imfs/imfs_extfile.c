@@ -0,0 +1,392 @@
+/**
+ * @file
+ *
+ * @brief IMFS Extent File Handlers
+ * @ingroup IMFS
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/imfs.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <rtems/seterr.h>
+
+/*
+ *  The file data is stored in a list of contiguous extents.  Each new extent
+ *  is as large as all existing extents together, so the extent count grows
+ *  only logarithmically with the file size.  The extent size is bounded to
+ *  keep the allocations reasonable for the workspace.
+ */
+#define IMFS_EXTFILE_MIN_EXTENT_SIZE 256
+
+#define IMFS_EXTFILE_MAX_EXTENT_SIZE ( 1024 * 1024 )
+
+#define IMFS_EXTFILE_MIN_EXTENT_CAPACITY 4
+
+static size_t IMFS_extfile_capacity( const IMFS_extfile_t *extfile )
+{
+  const IMFS_extent_t *last;
+
+  if ( extfile->extent_count == 0 )
+    return 0;
+
+  last = &extfile->extents[ extfile->extent_count - 1 ];
+
+  return last->offset + last->size;
+}
+
+static bool IMFS_extent_contains( const IMFS_extent_t *extent, size_t offset )
+{
+  return offset >= extent->offset && offset - extent->offset < extent->size;
+}
+
+/*
+ *  Returns the index of the extent containing the offset.  The offset must be
+ *  less than the capacity.  Sequential access hits the current extent or its
+ *  successor, everything else uses a binary search.
+ */
+static size_t IMFS_extfile_find( IMFS_extfile_t *extfile, size_t offset )
+{
+  size_t current = extfile->current;
+  size_t low;
+  size_t high;
+
+  if ( current < extfile->extent_count ) {
+    if ( IMFS_extent_contains( &extfile->extents[ current ], offset ) )
+      return current;
+
+    ++current;
+
+    if (
+      current < extfile->extent_count
+        && IMFS_extent_contains( &extfile->extents[ current ], offset )
+    ) {
+      extfile->current = current;
+      return current;
+    }
+  }
+
+  low = 0;
+  high = extfile->extent_count - 1;
+
+  while ( low < high ) {
+    size_t middle = low + ( high - low + 1 ) / 2;
+
+    if ( extfile->extents[ middle ].offset <= offset )
+      low = middle;
+    else
+      high = middle - 1;
+  }
+
+  extfile->current = low;
+
+  return low;
+}
+
+static int IMFS_extfile_add_extent(
+  IMFS_extfile_t *extfile,
+  size_t          needed
+)
+{
+  IMFS_extent_t *extent;
+  size_t         capacity;
+  size_t         size;
+  size_t         fallback;
+  uint8_t       *data;
+
+  if ( extfile->extent_count == extfile->extent_capacity ) {
+    size_t         extent_capacity;
+    IMFS_extent_t *extents;
+
+    extent_capacity = 2 * extfile->extent_capacity;
+    if ( extent_capacity < IMFS_EXTFILE_MIN_EXTENT_CAPACITY )
+      extent_capacity = IMFS_EXTFILE_MIN_EXTENT_CAPACITY;
+
+    extents = realloc(
+      extfile->extents,
+      extent_capacity * sizeof( *extents )
+    );
+    if ( extents == NULL )
+      return ENOSPC;
+
+    extfile->extents = extents;
+    extfile->extent_capacity = extent_capacity;
+  }
+
+  capacity = IMFS_extfile_capacity( extfile );
+
+  fallback = needed;
+  if ( fallback > IMFS_EXTFILE_MAX_EXTENT_SIZE )
+    fallback = IMFS_EXTFILE_MAX_EXTENT_SIZE;
+
+  size = capacity;
+  if ( size < IMFS_EXTFILE_MIN_EXTENT_SIZE )
+    size = IMFS_EXTFILE_MIN_EXTENT_SIZE;
+  if ( size > IMFS_EXTFILE_MAX_EXTENT_SIZE )
+    size = IMFS_EXTFILE_MAX_EXTENT_SIZE;
+  if ( size < fallback )
+    size = fallback;
+
+  data = malloc( size );
+  if ( data == NULL && fallback < size ) {
+    size = fallback;
+    data = malloc( size );
+  }
+
+  if ( data == NULL )
+    return ENOSPC;
+
+  extent = &extfile->extents[ extfile->extent_count ];
+  extent->offset = capacity;
+  extent->size = size;
+  extent->data = data;
+  ++extfile->extent_count;
+
+  return 0;
+}
+
+/*
+ *  Ensures that the extents cover the file data up to the new length.
+ */
+static int IMFS_extfile_reserve( IMFS_extfile_t *extfile, size_t new_length )
+{
+  size_t capacity = IMFS_extfile_capacity( extfile );
+
+  while ( capacity < new_length ) {
+    int eno = IMFS_extfile_add_extent( extfile, new_length - capacity );
+
+    if ( eno != 0 )
+      return eno;
+
+    capacity = IMFS_extfile_capacity( extfile );
+  }
+
+  return 0;
+}
+
+/*
+ *  Copies the source to the file data.  A NULL source fills with zeros.
+ */
+static void IMFS_extfile_copy_to(
+  IMFS_extfile_t *extfile,
+  size_t          offset,
+  const uint8_t  *source,
+  size_t          length
+)
+{
+  while ( length > 0 ) {
+    const IMFS_extent_t *extent;
+    size_t               index;
+    size_t               chunk;
+
+    index = IMFS_extfile_find( extfile, offset );
+    extent = &extfile->extents[ index ];
+    chunk = extent->offset + extent->size - offset;
+    if ( chunk > length )
+      chunk = length;
+
+    if ( source != NULL ) {
+      memcpy( &extent->data[ offset - extent->offset ], source, chunk );
+      source += chunk;
+    } else {
+      memset( &extent->data[ offset - extent->offset ], 0, chunk );
+    }
+
+    offset += chunk;
+    length -= chunk;
+  }
+}
+
+static void IMFS_extfile_copy_from(
+  IMFS_extfile_t *extfile,
+  size_t          offset,
+  uint8_t        *destination,
+  size_t          length
+)
+{
+  while ( length > 0 ) {
+    const IMFS_extent_t *extent;
+    size_t               index;
+    size_t               chunk;
+
+    index = IMFS_extfile_find( extfile, offset );
+    extent = &extfile->extents[ index ];
+    chunk = extent->offset + extent->size - offset;
+    if ( chunk > length )
+      chunk = length;
+
+    memcpy( destination, &extent->data[ offset - extent->offset ], chunk );
+    destination += chunk;
+    offset += chunk;
+    length -= chunk;
+  }
+}
+
+/*
+ *  Releases the extents which start at or beyond the new length.
+ */
+static void IMFS_extfile_release( IMFS_extfile_t *extfile, size_t new_length )
+{
+  while (
+    extfile->extent_count > 0
+      && extfile->extents[ extfile->extent_count - 1 ].offset >= new_length
+  ) {
+    --extfile->extent_count;
+    free( extfile->extents[ extfile->extent_count ].data );
+  }
+
+  if ( extfile->extent_count == 0 ) {
+    free( extfile->extents );
+    extfile->extents = NULL;
+    extfile->extent_capacity = 0;
+  }
+
+  extfile->current = 0;
+}
+
+static ssize_t extfile_read(
+  rtems_libio_t *iop,
+  void          *buffer,
+  size_t         count
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  off_t           start = iop->offset;
+  size_t          size = extfile->File.size;
+
+  IMFS_update_atime( &extfile->File.Node );
+
+  if ( start >= (off_t) size )
+    return 0;
+
+  if ( count > size - (size_t) start )
+    count = size - (size_t) start;
+
+  IMFS_extfile_copy_from( extfile, (size_t) start, buffer, count );
+  iop->offset += count;
+
+  return (ssize_t) count;
+}
+
+static ssize_t extfile_write(
+  rtems_libio_t *iop,
+  const void    *buffer,
+  size_t         count
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  size_t          size = extfile->File.size;
+  off_t           start;
+  size_t          last;
+  int             eno;
+
+  if ( rtems_libio_iop_is_append( iop ) )
+    iop->offset = (off_t) size;
+
+  start = iop->offset;
+
+  if ( start > (off_t) SIZE_MAX || count > SIZE_MAX - (size_t) start )
+    rtems_set_errno_and_return_minus_one( EFBIG );
+
+  last = (size_t) start + count;
+
+  eno = IMFS_extfile_reserve( extfile, last );
+  if ( eno != 0 )
+    rtems_set_errno_and_return_minus_one( eno );
+
+  if ( (size_t) start > size )
+    IMFS_extfile_copy_to( extfile, size, NULL, (size_t) start - size );
+
+  IMFS_extfile_copy_to( extfile, (size_t) start, buffer, count );
+
+  if ( last > size )
+    extfile->File.size = last;
+
+  IMFS_mtime_ctime_update( &extfile->File.Node );
+  iop->offset += count;
+
+  return (ssize_t) count;
+}
+
+static int extfile_ftruncate(
+  rtems_libio_t *iop,
+  off_t          length
+)
+{
+  IMFS_extfile_t *extfile = IMFS_iop_to_extfile( iop );
+  size_t          size = extfile->File.size;
+
+  /*
+   *  An extend fills the new area with zeros, see the memfile.  In contrast
+   *  to the memfile a shrink releases the extents beyond the new length.
+   */
+  if ( length > (off_t) size ) {
+    int eno;
+
+    if ( length > (off_t) SIZE_MAX )
+      rtems_set_errno_and_return_minus_one( EFBIG );
+
+    eno = IMFS_extfile_reserve( extfile, (size_t) length );
+    if ( eno != 0 )
+      rtems_set_errno_and_return_minus_one( eno );
+
+    IMFS_extfile_copy_to( extfile, size, NULL, (size_t) length - size );
+  } else {
+    IMFS_extfile_release( extfile, (size_t) length );
+  }
+
+  extfile->File.size = (size_t) length;
+  IMFS_mtime_ctime_update( &extfile->File.Node );
+
+  return 0;
+}
+
+static void IMFS_extfile_destroy( IMFS_jnode_t *node )
+{
+  IMFS_extfile_t *extfile = (IMFS_extfile_t *) node;
+
+  IMFS_extfile_release( extfile, 0 );
+  IMFS_node_destroy_default( node );
+}
+
+static const rtems_filesystem_file_handlers_r IMFS_extfile_handlers = {
+  .open_h = rtems_filesystem_default_open,
+  .close_h = rtems_filesystem_default_close,
+  .read_h = extfile_read,
+  .write_h = extfile_write,
+  .ioctl_h = rtems_filesystem_default_ioctl,
+  .lseek_h = rtems_filesystem_default_lseek_file,
+  .fstat_h = IMFS_stat_file,
+  .ftruncate_h = extfile_ftruncate,
+  .fsync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+  .fdatasync_h = rtems_filesystem_default_fsync_or_fdatasync_success,
+  .fcntl_h = rtems_filesystem_default_fcntl,
+  .kqfilter_h = rtems_filesystem_default_kqfilter,
+  .mmap_h = rtems_filesystem_default_mmap,
+  .fallocate_h = rtems_filesystem_default_fallocate,
+  .poll_h = rtems_filesystem_default_poll,
+  .readv_h = rtems_filesystem_default_readv,
+  .writev_h = rtems_filesystem_default_writev
+};
+
+const IMFS_mknod_control IMFS_mknod_control_extfile = {
+  {
+    .handlers = &IMFS_extfile_handlers,
+    .node_initialize = IMFS_node_initialize_default,
+    .node_remove = IMFS_node_remove_default,
+    .node_destroy = IMFS_extfile_destroy
+  },
+  .node_size = sizeof( IMFS_extfile_t )
+};
@@ -66,6 +66,10 @@ int IMFS_initialize(
     .mknod_controls = &IMFS_default_mknod_controls
   };
 
+  if ( data != NULL ) {
+    mount_data.mknod_controls = data;
+  }
+
   if ( fs_info == NULL ) {
     rtems_set_errno_and_return_minus_one( ENOMEM );
   }
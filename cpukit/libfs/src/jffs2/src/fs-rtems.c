@@ -599,6 +599,7 @@ static const rtems_filesystem_file_handlers_r rtems_jffs2_directory_handlers = {
 	.fcntl_h = rtems_filesystem_default_fcntl,
 	.kqfilter_h = rtems_filesystem_default_kqfilter,
 	.mmap_h = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h = rtems_filesystem_default_poll,
 	.readv_h = rtems_filesystem_default_readv,
 	.writev_h = rtems_filesystem_default_writev
@@ -742,6 +743,7 @@ static const rtems_filesystem_file_handlers_r rtems_jffs2_file_handlers = {
 	.fcntl_h = rtems_filesystem_default_fcntl,
 	.kqfilter_h = rtems_filesystem_default_kqfilter,
 	.mmap_h = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h = rtems_filesystem_default_poll,
 	.readv_h = rtems_filesystem_default_readv,
 	.writev_h = rtems_filesystem_default_writev
@@ -761,6 +763,7 @@ static const rtems_filesystem_file_handlers_r rtems_jffs2_link_handlers = {
 	.fcntl_h = rtems_filesystem_default_fcntl,
 	.kqfilter_h = rtems_filesystem_default_kqfilter,
 	.mmap_h = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h = rtems_filesystem_default_poll,
 	.readv_h = rtems_filesystem_default_readv,
 	.writev_h = rtems_filesystem_default_writev
@@ -2851,6 +2851,7 @@ struct _rtems_filesystem_file_handlers_r nfs_file_file_handlers = {
 	.fcntl_h     = rtems_filesystem_default_fcntl,
 	.kqfilter_h  = rtems_filesystem_default_kqfilter,
 	.mmap_h      = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h      = rtems_filesystem_default_poll,
 	.readv_h     = rtems_filesystem_default_readv,
 	.writev_h    = rtems_filesystem_default_writev
@@ -2872,6 +2873,7 @@ struct _rtems_filesystem_file_handlers_r nfs_dir_file_handlers = {
 	.fcntl_h     = rtems_filesystem_default_fcntl,
 	.kqfilter_h  = rtems_filesystem_default_kqfilter,
 	.mmap_h      = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h      = rtems_filesystem_default_poll,
 	.readv_h     = rtems_filesystem_default_readv,
 	.writev_h    = rtems_filesystem_default_writev
@@ -2893,6 +2895,7 @@ struct _rtems_filesystem_file_handlers_r nfs_link_file_handlers = {
 	.fcntl_h     = rtems_filesystem_default_fcntl,
 	.kqfilter_h  = rtems_filesystem_default_kqfilter,
 	.mmap_h      = rtems_filesystem_default_mmap,
+	.fallocate_h = rtems_filesystem_default_fallocate,
 	.poll_h      = rtems_filesystem_default_poll,
 	.readv_h     = rtems_filesystem_default_readv,
 	.writev_h    = rtems_filesystem_default_writev
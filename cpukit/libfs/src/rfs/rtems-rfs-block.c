@@ -782,6 +782,8 @@ rtems_rfs_block_map_shrink (rtems_rfs_file_system* fs,
     map->last_data_block = 0;
   }
 
+  rtems_rfs_buffer_discard_flush (fs);
+
   /*
    * Keep the position inside the map.
    */
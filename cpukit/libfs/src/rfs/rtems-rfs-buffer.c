@@ -26,6 +26,60 @@
 #include <rtems/rfs/rtems-rfs-buffer.h>
 #include <rtems/rfs/rtems-rfs-file-system.h>
 
+/**
+ * A request of a block from the I/O layer in progress.
+ */
+typedef struct _rtems_rfs_buffer_request
+{
+  /**
+   * The node on the list of requests of the file system.
+   */
+  rtems_chain_node link;
+
+  /**
+   * The requested block number.
+   */
+  rtems_rfs_buffer_block block;
+} rtems_rfs_buffer_request;
+
+/**
+ * Lock the buffer lists of the file system.
+ */
+static void
+rtems_rfs_buffer_lock (rtems_rfs_file_system* fs)
+{
+  rtems_rfs_mutex_lock (&fs->buffer_lock);
+}
+
+/**
+ * Unlock the buffer lists of the file system.
+ */
+static void
+rtems_rfs_buffer_unlock (rtems_rfs_file_system* fs)
+{
+  rtems_rfs_mutex_unlock (&fs->buffer_lock);
+}
+
+/**
+ * Is a request of the block from the I/O layer in progress ?
+ */
+static bool
+rtems_rfs_buffer_requested (rtems_rfs_file_system* fs,
+                            rtems_rfs_buffer_block block)
+{
+  rtems_chain_node* node;
+
+  for (node = rtems_chain_first (&fs->buffer_requests);
+       !rtems_chain_is_tail (&fs->buffer_requests, node);
+       node = rtems_chain_next (node))
+  {
+    if (((rtems_rfs_buffer_request*) node)->block == block)
+      return true;
+  }
+
+  return false;
+}
+
 /**
  * Scan the chain for a buffer that matches the block number.
  *
@@ -108,6 +162,15 @@ rtems_rfs_buffer_handle_request (rtems_rfs_file_system*   fs,
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_HANDLE_REQUEST))
     printf ("rtems-rfs: buffer-request: block=%" PRIu32 "\n", block);
 
+  rtems_rfs_buffer_lock (fs);
+
+  /*
+   * Another request of the block from the I/O layer may be in progress. Wait
+   * for it so the buffer is found below.
+   */
+  while (rtems_rfs_buffer_requested (fs, block))
+    rtems_rfs_condition_wait (&fs->buffer_requests_done, &fs->buffer_lock);
+
   /*
    * First check to see if the buffer has already been requested and is
    * currently attached to a handle. If it is share the access. A buffer could
@@ -160,14 +223,26 @@ rtems_rfs_buffer_handle_request (rtems_rfs_file_system*   fs,
   }
 
   /*
-   * If not located we request the buffer from the I/O layer.
+   * If not located we request the buffer from the I/O layer. The lock is not
+   * held while waiting for the I/O so requests of other blocks can proceed.
    */
   if (!rtems_rfs_buffer_handle_has_block (handle))
   {
+    rtems_rfs_buffer_request request;
+
+    request.block = block;
+    rtems_chain_append_unprotected (&fs->buffer_requests, &request.link);
+    rtems_rfs_buffer_unlock (fs);
+
     rc = rtems_rfs_buffer_io_request (fs, block, read, &handle->buffer);
 
+    rtems_rfs_buffer_lock (fs);
+    rtems_chain_extract_unprotected (&request.link);
+    rtems_rfs_condition_broadcast (&fs->buffer_requests_done);
+
     if (rc > 0)
     {
+      rtems_rfs_buffer_unlock (fs);
       if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_HANDLE_REQUEST))
         printf ("rtems-rfs: buffer-request: block=%" PRIu32 ": bdbuf-%s: %d: %s\n",
                 block, read ? "read" : "get", rc, strerror (rc));
@@ -188,6 +263,8 @@ rtems_rfs_buffer_handle_request (rtems_rfs_file_system*   fs,
   handle->buffer->user = (void*) ((intptr_t) block);
   handle->bnum = block;
 
+  rtems_rfs_buffer_unlock (fs);
+
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_HANDLE_REQUEST))
     printf ("rtems-rfs: buffer-request: block=%" PRIu32 " bdbuf-%s=%" PRIu32 " refs=%d\n",
             block, read ? "read" : "get", handle->buffer->block,
@@ -204,6 +281,8 @@ rtems_rfs_buffer_handle_release (rtems_rfs_file_system*   fs,
 
   if (rtems_rfs_buffer_handle_has_block (handle))
   {
+    rtems_rfs_buffer_lock (fs);
+
     if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_HANDLE_RELEASE))
       printf ("rtems-rfs: buffer-release: block=%" PRIu32 " %s refs=%d %s\n",
               rtems_rfs_buffer_bnum (handle),
@@ -279,11 +358,225 @@ rtems_rfs_buffer_handle_release (rtems_rfs_file_system*   fs,
       }
     }
     handle->buffer = NULL;
+
+    rtems_rfs_buffer_unlock (fs);
   }
 
   return rc;
 }
 
+/**
+ * Is the buffer's block in the range of blocks ?
+ */
+static bool
+rtems_rfs_buffer_in_range (rtems_rfs_buffer*      buffer,
+                           rtems_rfs_buffer_block block,
+                           size_t                 count)
+{
+  rtems_rfs_buffer_block bnum = (rtems_rfs_buffer_block) ((intptr_t) buffer->user);
+  return (bnum >= block) && ((bnum - block) < count);
+}
+
+/**
+ * Release the buffers on the chain in the range of blocks.
+ */
+static int
+rtems_rfs_release_chain_range (rtems_chain_control*   chain,
+                               uint32_t*              count,
+                               bool                   modified,
+                               rtems_rfs_buffer_block block,
+                               size_t                 blocks)
+{
+  rtems_chain_node* node = rtems_chain_first (chain);
+  int               rrc = 0;
+  int               rc;
+
+  while (!rtems_chain_is_tail (chain, node))
+  {
+    rtems_rfs_buffer* buffer = (rtems_rfs_buffer*) node;
+
+    node = rtems_chain_next (node);
+
+    if (rtems_rfs_buffer_in_range (buffer, block, blocks))
+    {
+      rtems_chain_extract_unprotected (&buffer->link);
+      (*count)--;
+
+      buffer->user = (void*) 0;
+
+      rc = rtems_rfs_buffer_io_release (buffer, modified);
+      if ((rc > 0) && (rrc == 0))
+        rrc = rc;
+    }
+  }
+
+  return rrc;
+}
+
+int
+rtems_rfs_buffer_direct (rtems_rfs_file_system* fs,
+                         rtems_rfs_buffer_block block,
+                         size_t                 count,
+                         void*                  data,
+                         bool                   read)
+{
+  rtems_chain_node* node;
+  int               rc;
+
+  if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_HANDLE_REQUEST))
+    printf ("rtems-rfs: buffer-direct: %s block=%" PRIu32 " count=%zu\n",
+            read ? "read" : "write", block, count);
+
+  rtems_rfs_buffer_lock (fs);
+
+  /*
+   * A buffer attached to a handle is held in the cache and would block the
+   * transfer.
+   */
+  for (node = rtems_chain_first (&fs->buffers);
+       !rtems_chain_is_tail (&fs->buffers, node);
+       node = rtems_chain_next (node))
+  {
+    if (rtems_rfs_buffer_in_range ((rtems_rfs_buffer*) node, block, count))
+    {
+      rtems_rfs_buffer_unlock (fs);
+      return EBUSY;
+    }
+  }
+
+  rc = rtems_rfs_release_chain_range (&fs->release, &fs->release_count,
+                                      false, block, count);
+  if (rc == 0)
+    rc = rtems_rfs_release_chain_range (&fs->release_modified,
+                                        &fs->release_modified_count,
+                                        true, block, count);
+
+  rtems_rfs_buffer_unlock (fs);
+
+  if (rc > 0)
+    return rc;
+
+  /*
+   * The blocks belong to the file of the caller which holds the lock of the
+   * file, so no other request of the blocks can start during the transfer.
+   */
+  return rtems_rfs_buffer_io_direct (fs, block, count, data, read);
+}
+
+/**
+ * Is the block attached to a handle ?
+ */
+static bool
+rtems_rfs_buffer_attached (rtems_rfs_file_system* fs,
+                           rtems_rfs_buffer_block block)
+{
+  rtems_chain_node* node;
+
+  for (node = rtems_chain_first (&fs->buffers);
+       !rtems_chain_is_tail (&fs->buffers, node);
+       node = rtems_chain_next (node))
+  {
+    if (rtems_rfs_buffer_in_range ((rtems_rfs_buffer*) node, block, 1))
+      return true;
+  }
+
+  return false;
+}
+
+void
+rtems_rfs_buffer_discard (rtems_rfs_file_system* fs,
+                          rtems_rfs_buffer_block block)
+{
+  rtems_rfs_buffer_lock (fs);
+
+  if (fs->discard_count > 0)
+  {
+    /*
+     * A shrinking map frees the blocks from the end so extend the range in
+     * both directions.
+     */
+    if (block == (fs->discard_block + fs->discard_count))
+    {
+      fs->discard_count++;
+      rtems_rfs_buffer_unlock (fs);
+      return;
+    }
+
+    if ((block + 1) == fs->discard_block)
+    {
+      fs->discard_block = block;
+      fs->discard_count++;
+      rtems_rfs_buffer_unlock (fs);
+      return;
+    }
+
+    rtems_rfs_buffer_discard_flush (fs);
+  }
+
+  fs->discard_block = block;
+  fs->discard_count = 1;
+
+  rtems_rfs_buffer_unlock (fs);
+}
+
+void
+rtems_rfs_buffer_discard_flush (rtems_rfs_file_system* fs)
+{
+  rtems_rfs_buffer_block block;
+  size_t                 count;
+
+  rtems_rfs_buffer_lock (fs);
+
+  block = fs->discard_block;
+  count = fs->discard_count;
+
+  if (count == 0)
+  {
+    rtems_rfs_buffer_unlock (fs);
+    return;
+  }
+
+  fs->discard_count = 0;
+
+  if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_RELEASE))
+    printf ("rtems-rfs: buffer-discard: block=%" PRIu32 " count=%zu\n",
+            block, count);
+
+  while (count > 0)
+  {
+    size_t run = 0;
+    int    rc;
+
+    while ((run < count) && !rtems_rfs_buffer_attached (fs, block + run))
+      run++;
+
+    if (run > 0)
+    {
+      rtems_rfs_release_chain_range (&fs->release, &fs->release_count,
+                                     false, block, run);
+      rtems_rfs_release_chain_range (&fs->release_modified,
+                                     &fs->release_modified_count,
+                                     true, block, run);
+
+      rc = rtems_rfs_buffer_io_discard (fs, block, run);
+      if ((rc > 0) && rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_RELEASE))
+        printf ("rtems-rfs: buffer-discard: io discard failed: %d: %s\n",
+                rc, strerror (rc));
+    }
+
+    /*
+     * Skip the block attached to a handle.
+     */
+    if (run < count)
+      run++;
+
+    block += run;
+    count -= run;
+  }
+
+  rtems_rfs_buffer_unlock (fs);
+}
+
 int
 rtems_rfs_buffer_open (const char* name, rtems_rfs_file_system* fs)
 {
@@ -342,6 +635,10 @@ rtems_rfs_buffer_open (const char* name, rtems_rfs_file_system* fs)
             rtems_rfs_fs_media_blocks (fs),
             rtems_rfs_fs_media_block_size (fs));
 
+  rtems_chain_initialize_empty (&fs->buffer_requests);
+  rtems_rfs_mutex_create (&fs->buffer_lock);
+  rtems_rfs_condition_create (&fs->buffer_requests_done);
+
   return 0;
 }
 
@@ -353,6 +650,8 @@ rtems_rfs_buffer_close (rtems_rfs_file_system* fs)
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_CLOSE))
     printf ("rtems-rfs: buffer-close: closing\n");
 
+  rtems_rfs_buffer_discard_flush (fs);
+
   /*
    * Change the block size to the media device size. It will release and sync
    * all buffers.
@@ -371,6 +670,9 @@ rtems_rfs_buffer_close (rtems_rfs_file_system* fs)
               rc, strerror (rc));
   }
 
+  rtems_rfs_condition_destroy (&fs->buffer_requests_done);
+  rtems_rfs_mutex_destroy (&fs->buffer_lock);
+
   return rc;
 }
 
@@ -385,6 +687,8 @@ rtems_rfs_buffer_sync (rtems_rfs_file_system* fs)
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_SYNC))
     printf ("rtems-rfs: buffer-sync: syncing\n");
 
+  rtems_rfs_buffer_discard_flush (fs);
+
   /*
    * @todo Split in the separate files for each type.
    */
@@ -467,6 +771,8 @@ rtems_rfs_buffers_release (rtems_rfs_file_system* fs)
   int rrc = 0;
   int rc;
 
+  rtems_rfs_buffer_lock (fs);
+
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_BUFFER_RELEASE))
     printf ("rtems-rfs: buffers-release: active:%" PRIu32 " "
             "release:%" PRIu32 " release-modified:%" PRIu32 "\n",
@@ -483,5 +789,7 @@ rtems_rfs_buffers_release (rtems_rfs_file_system* fs)
   if ((rc > 0) && (rrc == 0))
     rrc = rc;
 
+  rtems_rfs_buffer_unlock (fs);
+
   return rrc;
 }
@@ -13,6 +13,10 @@
  *
  * The maximum length can be 1 or 2 bytes depending on the value in the
  * superblock.
+ *
+ * A directory with the index flag set in its inode has a hash index in its
+ * first block. A look up reads the index blocks and a single directory block
+ * rather than all the blocks of the directory.
  */
 
 /*
@@ -29,6 +33,7 @@
 
 #include <inttypes.h>
 #include <rtems/inttypes.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <rtems/rfs/rtems-rfs-block.h>
@@ -38,6 +43,10 @@
 #include <rtems/rfs/rtems-rfs-dir.h>
 #include <rtems/rfs/rtems-rfs-dir-hash.h>
 
+#if __rtems__
+#include <rtems/libio_.h>
+#endif
+
 /**
  * Validate the directory entry data.
  */
@@ -45,6 +54,789 @@
   (((_l) <= RTEMS_RFS_DIR_ENTRY_SIZE) || ((_l) >= rtems_rfs_fs_max_name (_f)) \
    || (_i < RTEMS_RFS_ROOT_INO) || (_i > rtems_rfs_fs_inodes (_f)))
 
+/**
+ * The hash index of a directory. The first block of an indexed directory is
+ * the index root. An index block maps ranges of name hashes to the blocks of
+ * the next level. The root refers to the leaf blocks directly or to up to two
+ * levels of index nodes above the leaf blocks. A leaf block is a normal
+ * directory block holding the entries with a hash in the range of the leaf.
+ * The length field of an index block header is the empty entry length so the
+ * functions reading all the directory blocks skip the index blocks. The linear
+ * add would take the index block for free space, so it refuses to modify a
+ * directory with an index root but without the index flag.
+ *
+ * The index block header is the magic number, the count of index entries,
+ * the levels of index nodes below the block and the empty entry length. An
+ * index entry is the lowest hash of the range and the block number of the
+ * next level relative to the start of the directory. The hash of the first
+ * entry of the root is 0.
+ */
+#define RTEMS_RFS_DIR_INDEX_MAGIC         (0x52465348)
+#define RTEMS_RFS_DIR_INDEX_OFFSET_MAGIC  (0)
+#define RTEMS_RFS_DIR_INDEX_OFFSET_COUNT  (4)
+#define RTEMS_RFS_DIR_INDEX_OFFSET_LEVELS (6)
+#define RTEMS_RFS_DIR_INDEX_HEADER_SIZE   (RTEMS_RFS_DIR_ENTRY_SIZE + 2)
+#define RTEMS_RFS_DIR_INDEX_ENTRY_SIZE    (4 + 4)
+#define RTEMS_RFS_DIR_INDEX_MAX_LEVELS    (2)
+
+#define rtems_rfs_dir_index_magic(_b) \
+  rtems_rfs_read_u32 ((_b) + RTEMS_RFS_DIR_INDEX_OFFSET_MAGIC)
+#define rtems_rfs_dir_index_count(_b) \
+  rtems_rfs_read_u16 ((_b) + RTEMS_RFS_DIR_INDEX_OFFSET_COUNT)
+#define rtems_rfs_dir_index_set_count(_b, _c) \
+  rtems_rfs_write_u16 ((_b) + RTEMS_RFS_DIR_INDEX_OFFSET_COUNT, _c)
+#define rtems_rfs_dir_index_levels(_b) \
+  rtems_rfs_read_u8 ((_b) + RTEMS_RFS_DIR_INDEX_OFFSET_LEVELS)
+#define rtems_rfs_dir_index_entry(_b, _s) \
+  ((_b) + RTEMS_RFS_DIR_INDEX_HEADER_SIZE + \
+   ((_s) * RTEMS_RFS_DIR_INDEX_ENTRY_SIZE))
+#define rtems_rfs_dir_index_hash(_b, _s) \
+  rtems_rfs_read_u32 (rtems_rfs_dir_index_entry (_b, _s))
+#define rtems_rfs_dir_index_bno(_b, _s) \
+  rtems_rfs_read_u32 (rtems_rfs_dir_index_entry (_b, _s) + 4)
+#define rtems_rfs_dir_index_limit(_f) \
+  ((rtems_rfs_fs_block_size (_f) - RTEMS_RFS_DIR_INDEX_HEADER_SIZE) / \
+   RTEMS_RFS_DIR_INDEX_ENTRY_SIZE)
+
+/**
+ * The index blocks and slots walked to reach a leaf block.
+ */
+typedef struct _rtems_rfs_dir_index_path
+{
+  int                levels;
+  rtems_rfs_block_no bno[RTEMS_RFS_DIR_INDEX_MAX_LEVELS + 1];
+  int                slot[RTEMS_RFS_DIR_INDEX_MAX_LEVELS + 1];
+  rtems_rfs_block_no leaf;
+} rtems_rfs_dir_index_path;
+
+/**
+ * An entry of a leaf block being split. An offset of -1 is the entry being
+ * added.
+ */
+typedef struct _rtems_rfs_dir_index_sort
+{
+  uint32_t hash;
+  int      offset;
+  int      length;
+} rtems_rfs_dir_index_sort;
+
+static bool
+rtems_rfs_dir_indexed (rtems_rfs_inode_handle* dir)
+{
+  return (rtems_rfs_inode_get_flags (dir) & RTEMS_RFS_INODE_FLAG_DIR_INDEX) != 0;
+}
+
+static void
+rtems_rfs_dir_index_init (uint8_t* index, int levels)
+{
+  rtems_rfs_write_u32 (index + RTEMS_RFS_DIR_INDEX_OFFSET_MAGIC,
+                       RTEMS_RFS_DIR_INDEX_MAGIC);
+  rtems_rfs_dir_index_set_count (index, 0);
+  rtems_rfs_write_u8 (index + RTEMS_RFS_DIR_INDEX_OFFSET_LEVELS, levels);
+}
+
+static void
+rtems_rfs_dir_index_set_entry (uint8_t*           index,
+                               int                slot,
+                               uint32_t           hash,
+                               rtems_rfs_block_no bno)
+{
+  rtems_rfs_write_u32 (rtems_rfs_dir_index_entry (index, slot), hash);
+  rtems_rfs_write_u32 (rtems_rfs_dir_index_entry (index, slot) + 4, bno);
+}
+
+static void
+rtems_rfs_dir_index_insert (uint8_t*           index,
+                            int                slot,
+                            uint32_t           hash,
+                            rtems_rfs_block_no bno)
+{
+  int count = rtems_rfs_dir_index_count (index);
+
+  memmove (rtems_rfs_dir_index_entry (index, slot + 1),
+           rtems_rfs_dir_index_entry (index, slot),
+           (count - slot) * RTEMS_RFS_DIR_INDEX_ENTRY_SIZE);
+  rtems_rfs_dir_index_set_entry (index, slot, hash, bno);
+  rtems_rfs_dir_index_set_count (index, count + 1);
+}
+
+static bool
+rtems_rfs_dir_index_check (rtems_rfs_file_system* fs,
+                           const uint8_t*         index)
+{
+  int count = rtems_rfs_dir_index_count (index);
+
+  return (rtems_rfs_dir_index_magic (index) == RTEMS_RFS_DIR_INDEX_MAGIC) &&
+    (count > 0) && (count <= rtems_rfs_dir_index_limit (fs)) &&
+    (rtems_rfs_dir_index_levels (index) <= RTEMS_RFS_DIR_INDEX_MAX_LEVELS);
+}
+
+/**
+ * Return the slot of the index block with the range holding the hash. The
+ * hashes of the slots are sorted so use a binary search.
+ */
+static int
+rtems_rfs_dir_index_search (const uint8_t* index, uint32_t hash)
+{
+  int low = 1;
+  int high = rtems_rfs_dir_index_count (index) - 1;
+  int slot = 0;
+
+  while (low <= high)
+  {
+    int mid = (low + high) / 2;
+
+    if (rtems_rfs_dir_index_hash (index, mid) <= hash)
+    {
+      slot = mid;
+      low = mid + 1;
+    }
+    else
+      high = mid - 1;
+  }
+
+  return slot;
+}
+
+/**
+ * Request the buffer of a directory block. The block number is relative to
+ * the start of the directory.
+ */
+static int
+rtems_rfs_dir_index_request (rtems_rfs_file_system*   fs,
+                             rtems_rfs_block_map*     map,
+                             rtems_rfs_buffer_handle* buffer,
+                             rtems_rfs_block_no       bno,
+                             bool                     read)
+{
+  rtems_rfs_block_pos bpos;
+  rtems_rfs_block_no  block;
+  int                 rc;
+
+  rtems_rfs_block_set_bpos_zero (&bpos);
+  bpos.bno = bno;
+
+  rc = rtems_rfs_block_map_find (fs, map, &bpos, &block);
+  if (rc > 0)
+    return rc;
+
+  return rtems_rfs_buffer_handle_request (fs, buffer, block, read);
+}
+
+/**
+ * Add a block set to ones to the end of the directory. The buffer holds the
+ * new block.
+ */
+static int
+rtems_rfs_dir_index_grow (rtems_rfs_file_system*   fs,
+                          rtems_rfs_block_map*     map,
+                          rtems_rfs_buffer_handle* buffer,
+                          rtems_rfs_block_no*      bno)
+{
+  rtems_rfs_block_no block;
+  int                rc;
+
+  *bno = rtems_rfs_block_map_count (map);
+
+  rc = rtems_rfs_block_map_grow (fs, map, 1, &block);
+  if (rc > 0)
+    return rc;
+
+  rc = rtems_rfs_buffer_handle_request (fs, buffer, block, false);
+  if (rc > 0)
+    return rc;
+
+  memset (rtems_rfs_buffer_data (buffer), 0xff, rtems_rfs_fs_block_size (fs));
+  rtems_rfs_buffer_mark_dirty (buffer);
+  return 0;
+}
+
+/**
+ * Create the index root and the first leaf of an empty directory.
+ */
+static int
+rtems_rfs_dir_index_create (rtems_rfs_file_system*   fs,
+                            rtems_rfs_block_map*     map,
+                            rtems_rfs_buffer_handle* buffer)
+{
+  rtems_rfs_block_no root;
+  rtems_rfs_block_no leaf;
+  uint8_t*           index;
+  int                rc;
+
+  rc = rtems_rfs_dir_index_grow (fs, map, buffer, &root);
+  if (rc > 0)
+    return rc;
+
+  index = rtems_rfs_buffer_data (buffer);
+  rtems_rfs_dir_index_init (index, 0);
+  rtems_rfs_dir_index_insert (index, 0, 0, root + 1);
+
+  return rtems_rfs_dir_index_grow (fs, map, buffer, &leaf);
+}
+
+/**
+ * Walk the index from the root to the leaf block for the hash.
+ */
+static int
+rtems_rfs_dir_index_walk (rtems_rfs_file_system*    fs,
+                          rtems_rfs_block_map*      map,
+                          rtems_rfs_buffer_handle*  buffer,
+                          uint32_t                  hash,
+                          rtems_rfs_dir_index_path* path)
+{
+  rtems_rfs_block_no bno = 0;
+  int                level;
+  int                rc;
+
+  path->levels = 0;
+
+  for (level = 0; level <= path->levels; level++)
+  {
+    uint8_t* index;
+
+    rc = rtems_rfs_dir_index_request (fs, map, buffer, bno, true);
+    if (rc > 0)
+      return rc;
+
+    index = rtems_rfs_buffer_data (buffer);
+
+    if (!rtems_rfs_dir_index_check (fs, index))
+      return EIO;
+
+    if (level == 0)
+      path->levels = rtems_rfs_dir_index_levels (index);
+    else if (rtems_rfs_dir_index_levels (index) != (path->levels - level))
+      return EIO;
+
+    path->bno[level] = bno;
+    path->slot[level] = rtems_rfs_dir_index_search (index, hash);
+
+    bno = rtems_rfs_dir_index_bno (index, path->slot[level]);
+    if ((bno == 0) || (bno >= rtems_rfs_block_map_count (map)))
+      return EIO;
+  }
+
+  path->leaf = bno;
+  return 0;
+}
+
+static int
+rtems_rfs_dir_index_lookup (rtems_rfs_file_system*   fs,
+                            rtems_rfs_block_map*     map,
+                            rtems_rfs_buffer_handle* entries,
+                            uint32_t                 hash,
+                            const char*              name,
+                            int                      length,
+                            rtems_rfs_ino*           ino,
+                            uint32_t*                offset)
+{
+  rtems_rfs_dir_index_path path;
+  uint8_t*                 entry;
+  int                      eoffset;
+  int                      rc;
+
+  rc = rtems_rfs_dir_index_walk (fs, map, entries, hash, &path);
+  if (rc > 0)
+    return rc == ENXIO ? ENOENT : rc;
+
+  rc = rtems_rfs_dir_index_request (fs, map, entries, path.leaf, true);
+  if (rc > 0)
+    return rc;
+
+  entry = rtems_rfs_buffer_data (entries);
+  eoffset = 0;
+
+  while (eoffset < (rtems_rfs_fs_block_size (fs) - RTEMS_RFS_DIR_ENTRY_SIZE))
+  {
+    rtems_rfs_ino eino;
+    int           elength;
+
+    elength = rtems_rfs_dir_entry_length (entry);
+    eino    = rtems_rfs_dir_entry_ino (entry);
+
+    if (elength == RTEMS_RFS_DIR_ENTRY_EMPTY)
+      break;
+
+    if (rtems_rfs_dir_entry_valid (fs, elength, eino))
+      return EIO;
+
+    if ((rtems_rfs_dir_entry_hash (entry) == hash) &&
+        (elength == (RTEMS_RFS_DIR_ENTRY_SIZE + length)) &&
+        (memcmp (entry + RTEMS_RFS_DIR_ENTRY_SIZE, name, length) == 0))
+    {
+      *ino = eino;
+      *offset = (path.leaf * rtems_rfs_fs_block_size (fs)) + eoffset;
+      return 0;
+    }
+
+    entry   += elength;
+    eoffset += elength;
+  }
+
+  return ENOENT;
+}
+
+/**
+ * Is the entry of the ino at the offset of the directory block ?
+ */
+static bool
+rtems_rfs_dir_index_entry_at (rtems_rfs_file_system*   fs,
+                              rtems_rfs_buffer_handle* buffer,
+                              rtems_rfs_block_no       block,
+                              uint32_t                 offset,
+                              rtems_rfs_ino            ino)
+{
+  uint8_t* entry;
+  int      eoffset;
+  int      rc;
+
+  rc = rtems_rfs_buffer_handle_request (fs, buffer, block, true);
+  if (rc > 0)
+    return false;
+
+  entry = rtems_rfs_buffer_data (buffer);
+  offset %= rtems_rfs_fs_block_size (fs);
+  eoffset = 0;
+
+  while (eoffset < (rtems_rfs_fs_block_size (fs) - RTEMS_RFS_DIR_ENTRY_SIZE))
+  {
+    rtems_rfs_ino eino;
+    int           elength;
+
+    elength = rtems_rfs_dir_entry_length (entry);
+    eino    = rtems_rfs_dir_entry_ino (entry);
+
+    if ((elength == RTEMS_RFS_DIR_ENTRY_EMPTY) ||
+        rtems_rfs_dir_entry_valid (fs, elength, eino))
+      return false;
+
+    if (eoffset == offset)
+      return eino == ino;
+
+    if (eoffset > offset)
+      return false;
+
+    entry   += elength;
+    eoffset += elength;
+  }
+
+  return false;
+}
+
+/**
+ * Check a directory without the index flag has no index root. The linear add
+ * and delete would break the index of a directory which lost its flag.
+ */
+static int
+rtems_rfs_dir_index_guard (rtems_rfs_file_system*   fs,
+                           rtems_rfs_inode_handle*  dir,
+                           rtems_rfs_block_map*     map,
+                           rtems_rfs_buffer_handle* buffer)
+{
+  rtems_rfs_block_no block;
+  int                rc;
+
+  if (!rtems_rfs_fs_dir_index (fs))
+    return 0;
+
+  rc = rtems_rfs_block_map_seek (fs, map, 0, &block);
+  if (rc > 0)
+    return rc == ENXIO ? 0 : rc;
+
+  rc = rtems_rfs_buffer_handle_request (fs, buffer, block, true);
+  if (rc > 0)
+    return rc;
+
+  if (rtems_rfs_dir_index_check (fs, rtems_rfs_buffer_data (buffer)))
+  {
+    if (rtems_rfs_trace (RTEMS_RFS_TRACE_DIR_ADD_ENTRY |
+                         RTEMS_RFS_TRACE_DIR_DEL_ENTRY))
+      printf ("rtems-rfs: dir: "
+              "index root without index flag for ino %" PRIu32 "\n",
+              rtems_rfs_inode_ino (dir));
+    return EIO;
+  }
+
+  return 0;
+}
+
+/**
+ * Move the entries of a full index root to a new index node so the root
+ * refers to one more level of index nodes.
+ */
+static int
+rtems_rfs_dir_index_push_down (rtems_rfs_file_system*   fs,
+                               rtems_rfs_block_map*     map,
+                               rtems_rfs_buffer_handle* buffer,
+                               uint8_t*                 copy)
+{
+  rtems_rfs_block_no node;
+  uint8_t*           index;
+  int                rc;
+
+  rc = rtems_rfs_dir_index_request (fs, map, buffer, 0, true);
+  if (rc > 0)
+    return rc;
+
+  memcpy (copy, rtems_rfs_buffer_data (buffer), rtems_rfs_fs_block_size (fs));
+
+  if (rtems_rfs_dir_index_levels (copy) >= RTEMS_RFS_DIR_INDEX_MAX_LEVELS)
+    return ENOSPC;
+
+  rc = rtems_rfs_dir_index_grow (fs, map, buffer, &node);
+  if (rc > 0)
+    return rc;
+
+  memcpy (rtems_rfs_buffer_data (buffer), copy, rtems_rfs_fs_block_size (fs));
+
+  rc = rtems_rfs_dir_index_request (fs, map, buffer, 0, true);
+  if (rc > 0)
+    return rc;
+
+  index = rtems_rfs_buffer_data (buffer);
+  rtems_rfs_dir_index_init (index, rtems_rfs_dir_index_levels (copy) + 1);
+  rtems_rfs_dir_index_insert (index, 0, 0, node);
+  rtems_rfs_buffer_mark_dirty (buffer);
+  return 0;
+}
+
+/**
+ * Move the upper half of a full index node of the path to a new index node.
+ * The parent of the node must have room for the new node.
+ */
+static int
+rtems_rfs_dir_index_split_node (rtems_rfs_file_system*    fs,
+                                rtems_rfs_block_map*      map,
+                                rtems_rfs_buffer_handle*  buffer,
+                                rtems_rfs_dir_index_path* path,
+                                int                       level,
+                                uint8_t*                  copy)
+{
+  rtems_rfs_block_no node;
+  uint8_t*           index;
+  int                count;
+  int                half;
+  int                rc;
+
+  rc = rtems_rfs_dir_index_request (fs, map, buffer, path->bno[level], true);
+  if (rc > 0)
+    return rc;
+
+  index = rtems_rfs_buffer_data (buffer);
+  memcpy (copy, index, rtems_rfs_fs_block_size (fs));
+
+  count = rtems_rfs_dir_index_count (copy);
+  half = count / 2;
+
+  rtems_rfs_dir_index_set_count (index, half);
+  rtems_rfs_buffer_mark_dirty (buffer);
+
+  rc = rtems_rfs_dir_index_grow (fs, map, buffer, &node);
+  if (rc > 0)
+    return rc;
+
+  index = rtems_rfs_buffer_data (buffer);
+  rtems_rfs_dir_index_init (index, rtems_rfs_dir_index_levels (copy));
+  memcpy (rtems_rfs_dir_index_entry (index, 0),
+          rtems_rfs_dir_index_entry (copy, half),
+          (count - half) * RTEMS_RFS_DIR_INDEX_ENTRY_SIZE);
+  rtems_rfs_dir_index_set_count (index, count - half);
+
+  rc = rtems_rfs_dir_index_request (fs, map, buffer,
+                                    path->bno[level - 1], true);
+  if (rc > 0)
+    return rc;
+
+  rtems_rfs_dir_index_insert (rtems_rfs_buffer_data (buffer),
+                              path->slot[level - 1] + 1,
+                              rtems_rfs_dir_index_hash (copy, half),
+                              node);
+  rtems_rfs_buffer_mark_dirty (buffer);
+  return 0;
+}
+
+static int
+rtems_rfs_dir_index_compare (const void* a, const void* b)
+{
+  const rtems_rfs_dir_index_sort* sa = a;
+  const rtems_rfs_dir_index_sort* sb = b;
+
+  if (sa->hash < sb->hash)
+    return -1;
+  if (sa->hash > sb->hash)
+    return 1;
+  return 0;
+}
+
+/**
+ * Split a full leaf block at a hash so the entries with a hash above the split
+ * move to a new leaf block. Entries with the same hash stay in one leaf. The
+ * hash of the entry being added is part of the choice of the split.
+ */
+static int
+rtems_rfs_dir_index_split_leaf (rtems_rfs_file_system*    fs,
+                                rtems_rfs_block_map*      map,
+                                rtems_rfs_buffer_handle*  buffer,
+                                rtems_rfs_dir_index_path* path,
+                                uint32_t                  hash,
+                                uint8_t*                  copy)
+{
+  rtems_rfs_dir_index_sort* sort;
+  rtems_rfs_block_no        leaf;
+  uint8_t*                  entry;
+  int                       count;
+  int                       offset;
+  int                       split;
+  int                       s;
+  int                       rc;
+
+  sort = malloc (((rtems_rfs_fs_block_size (fs) /
+                   (RTEMS_RFS_DIR_ENTRY_SIZE + 1)) + 1) * sizeof (*sort));
+  if (!sort)
+    return ENOMEM;
+
+  rc = rtems_rfs_dir_index_request (fs, map, buffer, path->leaf, true);
+  if (rc > 0)
+  {
+    free (sort);
+    return rc;
+  }
+
+  memcpy (copy, rtems_rfs_buffer_data (buffer), rtems_rfs_fs_block_size (fs));
+
+  sort[0].hash = hash;
+  sort[0].offset = -1;
+  sort[0].length = 0;
+  count = 1;
+  offset = 0;
+
+  while (offset < (rtems_rfs_fs_block_size (fs) - RTEMS_RFS_DIR_ENTRY_SIZE))
+  {
+    rtems_rfs_ino eino;
+    int           elength;
+
+    entry   = copy + offset;
+    elength = rtems_rfs_dir_entry_length (entry);
+    eino    = rtems_rfs_dir_entry_ino (entry);
+
+    if (elength == RTEMS_RFS_DIR_ENTRY_EMPTY)
+      break;
+
+    if (rtems_rfs_dir_entry_valid (fs, elength, eino))
+    {
+      free (sort);
+      return EIO;
+    }
+
+    sort[count].hash = rtems_rfs_dir_entry_hash (entry);
+    sort[count].offset = offset;
+    sort[count].length = elength;
+    ++count;
+
+    offset += elength;
+  }
+
+  qsort (sort, count, sizeof (*sort), rtems_rfs_dir_index_compare);
+
+  /*
+   * Split at the first change of the hash at or after the middle. If there is
+   * none use the last change before the middle.
+   */
+  split = count / 2;
+  while ((split > 0) && (split < count) &&
+         (sort[split].hash == sort[split - 1].hash))
+    ++split;
+
+  if (split == count)
+  {
+    split = count / 2;
+    while ((split > 0) && (sort[split].hash == sort[split - 1].hash))
+      --split;
+  }
+
+  if (split == 0)
+  {
+    free (sort);
+    return ENOSPC;
+  }
+
+  rc = rtems_rfs_dir_index_grow (fs, map, buffer, &leaf);
+  if (rc == 0)
+  {
+    entry = rtems_rfs_buffer_data (buffer);
+    for (s = split; s < count; ++s)
+    {
+      if (sort[s].offset >= 0)
+      {
+        memcpy (entry, copy + sort[s].offset, sort[s].length);
+        entry += sort[s].length;
+      }
+    }
+
+    rc = rtems_rfs_dir_index_request (fs, map, buffer, path->leaf, true);
+  }
+
+  if (rc == 0)
+  {
+    entry = rtems_rfs_buffer_data (buffer);
+    memset (entry, 0xff, rtems_rfs_fs_block_size (fs));
+    for (s = 0; s < split; ++s)
+    {
+      if (sort[s].offset >= 0)
+      {
+        memcpy (entry, copy + sort[s].offset, sort[s].length);
+        entry += sort[s].length;
+      }
+    }
+    rtems_rfs_buffer_mark_dirty (buffer);
+
+    rc = rtems_rfs_dir_index_request (fs, map, buffer,
+                                      path->bno[path->levels], true);
+  }
+
+  if (rc == 0)
+  {
+    rtems_rfs_dir_index_insert (rtems_rfs_buffer_data (buffer),
+                                path->slot[path->levels] + 1,
+                                sort[split].hash, leaf);
+    rtems_rfs_buffer_mark_dirty (buffer);
+  }
+
+  free (sort);
+  return rc;
+}
+
+/**
+ * Make room in the leaf block of the path for an entry with the hash. If the
+ * index block referring to the leaf is full the index grows instead and the
+ * caller walks the index again. The index grows by splitting the full index
+ * node below the deepest index block with room or if all the index blocks of
+ * the path are full by adding a level below the root.
+ */
+static int
+rtems_rfs_dir_index_split (rtems_rfs_file_system*    fs,
+                           rtems_rfs_block_map*      map,
+                           rtems_rfs_buffer_handle*  buffer,
+                           rtems_rfs_dir_index_path* path,
+                           uint32_t                  hash)
+{
+  uint8_t* copy;
+  int      level;
+  int      rc = 0;
+
+  copy = malloc (rtems_rfs_fs_block_size (fs));
+  if (!copy)
+    return ENOMEM;
+
+  for (level = path->levels; level >= 0; --level)
+  {
+    rc = rtems_rfs_dir_index_request (fs, map, buffer, path->bno[level], true);
+    if (rc > 0)
+      break;
+
+    if (rtems_rfs_dir_index_count (rtems_rfs_buffer_data (buffer)) <
+        rtems_rfs_dir_index_limit (fs))
+      break;
+  }
+
+  if (rc == 0)
+  {
+    if (level == path->levels)
+      rc = rtems_rfs_dir_index_split_leaf (fs, map, buffer, path, hash, copy);
+    else if (level >= 0)
+      rc = rtems_rfs_dir_index_split_node (fs, map, buffer, path, level + 1,
+                                           copy);
+    else
+      rc = rtems_rfs_dir_index_push_down (fs, map, buffer, copy);
+  }
+
+  free (copy);
+  return rc;
+}
+
+static int
+rtems_rfs_dir_index_add (rtems_rfs_file_system*   fs,
+                         rtems_rfs_inode_handle*  dir,
+                         rtems_rfs_block_map*     map,
+                         rtems_rfs_buffer_handle* buffer,
+                         const char*              name,
+                         size_t                   length,
+                         rtems_rfs_ino            ino)
+{
+  uint32_t hash;
+  int      rc;
+
+  hash = rtems_rfs_dir_hash (name, length);
+
+  if (rtems_rfs_block_map_count (map) == 0)
+  {
+    rc = rtems_rfs_dir_index_create (fs, map, buffer);
+    if (rc > 0)
+      return rc;
+  }
+
+  while (true)
+  {
+    rtems_rfs_dir_index_path path;
+    uint8_t*                 entry;
+    int                      offset;
+
+    rc = rtems_rfs_dir_index_walk (fs, map, buffer, hash, &path);
+    if (rc > 0)
+      return rc;
+
+    rc = rtems_rfs_dir_index_request (fs, map, buffer, path.leaf, true);
+    if (rc > 0)
+      return rc;
+
+    entry  = rtems_rfs_buffer_data (buffer);
+    offset = 0;
+
+    while (offset < (rtems_rfs_fs_block_size (fs) - RTEMS_RFS_DIR_ENTRY_SIZE))
+    {
+      rtems_rfs_ino eino;
+      int           elength;
+
+      elength = rtems_rfs_dir_entry_length (entry);
+      eino    = rtems_rfs_dir_entry_ino (entry);
+
+      if (elength == RTEMS_RFS_DIR_ENTRY_EMPTY)
+        break;
+
+      if (rtems_rfs_dir_entry_valid (fs, elength, eino))
+        return EIO;
+
+      entry  += elength;
+      offset += elength;
+    }
+
+    if ((length + RTEMS_RFS_DIR_ENTRY_SIZE) <
+        (rtems_rfs_fs_block_size (fs) - offset))
+    {
+      rtems_rfs_dir_set_entry_hash (entry, hash);
+      rtems_rfs_dir_set_entry_ino (entry, ino);
+      rtems_rfs_dir_set_entry_length (entry,
+                                      RTEMS_RFS_DIR_ENTRY_SIZE + length);
+      memcpy (entry + RTEMS_RFS_DIR_ENTRY_SIZE, name, length);
+      rtems_rfs_buffer_mark_dirty (buffer);
+      return 0;
+    }
+
+#if __rtems__
+    /*
+     * A split moves the entries of the leaf so the cached offsets of the
+     * names are no longer valid.
+     */
+    rtems_filesystem_name_cache_purge_directory (fs, rtems_rfs_inode_ino (dir));
+#endif
+
+    rc = rtems_rfs_dir_index_split (fs, map, buffer, &path, hash);
+    if (rc > 0)
+      return rc;
+  }
+}
+
 int
 rtems_rfs_dir_lookup_ino (rtems_rfs_file_system*  fs,
                           rtems_rfs_inode_handle* inode,
@@ -98,6 +890,20 @@ rtems_rfs_dir_lookup_ino (rtems_rfs_file_system*  fs,
      */
     hash = rtems_rfs_dir_hash (name, length);
 
+    if (rtems_rfs_dir_indexed (inode))
+    {
+      rc = rtems_rfs_dir_index_lookup (fs, &map, &entries, hash,
+                                       name, length, ino, offset);
+      if ((rc > 0) && (rc != ENOENT) &&
+          rtems_rfs_trace (RTEMS_RFS_TRACE_DIR_LOOKUP_INO))
+        printf ("rtems-rfs: dir-lookup-ino: "
+                "index lookup failed in ino %" PRIu32 ": %d: %s\n",
+                rtems_rfs_inode_ino (inode), rc, strerror (rc));
+      rtems_rfs_buffer_handle_close (fs, &entries);
+      rtems_rfs_block_map_close (fs, &map);
+      return rc;
+    }
+
     /*
      * Locate the first block. The map points to the start after open so just
      * seek 0. If an error the block will be 0.
@@ -242,6 +1048,14 @@ rtems_rfs_dir_add_entry (rtems_rfs_file_system*  fs,
     printf (", len=%zd\n", length);
   }
 
+#if __rtems__
+  /*
+   * The name may be cached as not existing.
+   */
+  rtems_filesystem_name_cache_remove (fs, rtems_rfs_inode_ino (dir),
+                                      name, length);
+#endif
+
   rc = rtems_rfs_block_map_open (fs, dir, &map);
   if (rc > 0)
     return rc;
@@ -253,6 +1067,26 @@ rtems_rfs_dir_add_entry (rtems_rfs_file_system*  fs,
     return rc;
   }
 
+  if (rtems_rfs_dir_indexed (dir))
+  {
+    rc = rtems_rfs_dir_index_add (fs, dir, &map, &buffer, name, length, ino);
+    if ((rc > 0) && rtems_rfs_trace (RTEMS_RFS_TRACE_DIR_ADD_ENTRY))
+      printf ("rtems-rfs: dir-add-entry: "
+              "index add failed for ino %" PRIu32 ": %d: %s\n",
+              rtems_rfs_inode_ino (dir), rc, strerror (rc));
+    rtems_rfs_buffer_handle_close (fs, &buffer);
+    rtems_rfs_block_map_close (fs, &map);
+    return rc;
+  }
+
+  rc = rtems_rfs_dir_index_guard (fs, dir, &map, &buffer);
+  if (rc > 0)
+  {
+    rtems_rfs_buffer_handle_close (fs, &buffer);
+    rtems_rfs_block_map_close (fs, &map);
+    return rc;
+  }
+
   /*
    * Search the map from the beginning to find any empty space.
    */
@@ -383,22 +1217,38 @@ rtems_rfs_dir_del_entry (rtems_rfs_file_system*  fs,
     printf ("rtems-rfs: dir-del-entry: dir=%" PRId32 ", entry=%" PRId32 " offset=%" PRIu32 "\n",
             rtems_rfs_inode_ino (dir), ino, offset);
 
+#if __rtems__
+  /*
+   * The entry has no name here and the removal moves the following entries of
+   * the block, so drop all names of the directory. The entry may be a
+   * directory itself and its inode number may be reused.
+   */
+  rtems_filesystem_name_cache_purge_directory (fs, rtems_rfs_inode_ino (dir));
+  rtems_filesystem_name_cache_purge_directory (fs, ino);
+#endif
+
   rc = rtems_rfs_block_map_open (fs, dir, &map);
   if (rc > 0)
     return rc;
 
-  rc = rtems_rfs_block_map_seek (fs, &map, offset, &block);
+  rc = rtems_rfs_buffer_handle_open (fs, &buffer);
   if (rc > 0)
   {
-    if (rc == ENXIO)
-      rc = ENOENT;
     rtems_rfs_block_map_close (fs, &map);
     return rc;
   }
 
-  rc = rtems_rfs_buffer_handle_open (fs, &buffer);
+  if (!rtems_rfs_dir_indexed (dir))
+    rc = rtems_rfs_dir_index_guard (fs, dir, &map, &buffer);
+
+  if (rc == 0)
+    rc = rtems_rfs_block_map_seek (fs, &map, offset, &block);
+
   if (rc > 0)
   {
+    if (rc == ENXIO)
+      rc = ENOENT;
+    rtems_rfs_buffer_handle_close (fs, &buffer);
     rtems_rfs_block_map_close (fs, &map);
     return rc;
   }
@@ -408,6 +1258,18 @@ rtems_rfs_dir_del_entry (rtems_rfs_file_system*  fs,
    */
   search = offset ? false : true;
 
+  /*
+   * Adding an entry to an indexed directory can split a block and move the
+   * entries. The offset may be from a look up before the split so search the
+   * directory if the entry is no longer at the offset.
+   */
+  if (!search && rtems_rfs_dir_indexed (dir) &&
+      !rtems_rfs_dir_index_entry_at (fs, &buffer, block, offset, ino))
+  {
+    search = true;
+    rc = rtems_rfs_block_map_seek (fs, &map, 0, &block);
+  }
+
   while (rc == 0)
   {
     uint8_t* entry;
@@ -465,7 +1327,8 @@ rtems_rfs_dir_del_entry (rtems_rfs_file_system*  fs,
 
         /*
          * If the remainder of the block is empty and this is the start of the
-         * block and it is the last block in the map shrink the map.
+         * block and it is the last block in the map shrink the map. The index
+         * of an indexed directory refers to the blocks so they stay.
          *
          * @note We could check again to see if the new end block in the map is
          *       also empty. This way we could clean up an empty directory.
@@ -480,7 +1343,8 @@ rtems_rfs_dir_del_entry (rtems_rfs_file_system*  fs,
                   rtems_rfs_block_map_last (&map) ? "yes" : "no");
 
         if ((elength == RTEMS_RFS_DIR_ENTRY_EMPTY) &&
-            (eoffset == 0) && rtems_rfs_block_map_last (&map))
+            (eoffset == 0) && rtems_rfs_block_map_last (&map) &&
+            !rtems_rfs_dir_indexed (dir))
         {
           rc = rtems_rfs_block_map_shrink (fs, &map, 1);
           if (rc > 0)
@@ -73,7 +73,8 @@ rtems_rfs_fs_read_superblock (rtems_rfs_file_system* fs)
 
 #define read_sb(_o) rtems_rfs_read_u32 (sb + (_o))
 
-  if (read_sb (RTEMS_RFS_SB_OFFSET_MAGIC) != RTEMS_RFS_SB_MAGIC)
+  if ((read_sb (RTEMS_RFS_SB_OFFSET_MAGIC) != RTEMS_RFS_SB_MAGIC) &&
+      (read_sb (RTEMS_RFS_SB_OFFSET_MAGIC) != RTEMS_RFS_SB_MAGIC_FEATURES))
   {
     if (rtems_rfs_trace (RTEMS_RFS_TRACE_OPEN))
       printf ("rtems-rfs: read-superblock: invalid superblock, bad magic\n");
@@ -92,16 +93,26 @@ rtems_rfs_fs_read_superblock (rtems_rfs_file_system* fs)
     return EIO;
   }
 
-  if ((read_sb (RTEMS_RFS_SB_OFFSET_VERSION) & RTEMS_RFS_VERSION_MASK) !=
-      (RTEMS_RFS_VERSION * RTEMS_RFS_VERSION_MASK))
+  /*
+   * Features other than the known ones change the format. A feature set in a
+   * superblock with the old magic may have been modified by a file system
+   * without the feature support.
+   */
+  if (((read_sb (RTEMS_RFS_SB_OFFSET_VERSION) & RTEMS_RFS_VERSION_MASK &
+        ~RTEMS_RFS_VERSION_FEATURES) != RTEMS_RFS_VERSION) ||
+      (((read_sb (RTEMS_RFS_SB_OFFSET_VERSION) & RTEMS_RFS_VERSION_FEATURES) != 0) &&
+       (read_sb (RTEMS_RFS_SB_OFFSET_MAGIC) != RTEMS_RFS_SB_MAGIC_FEATURES)))
   {
     if (rtems_rfs_trace (RTEMS_RFS_TRACE_OPEN))
       printf ("rtems-rfs: read-superblock: incompatible version: %08" PRIx32 " (%08" PRIx32 ")\n",
-              read_sb (RTEMS_RFS_SB_OFFSET_VERSION), RTEMS_RFS_VERSION_MASK);
+              read_sb (RTEMS_RFS_SB_OFFSET_VERSION), RTEMS_RFS_VERSION_FEATURES);
     rtems_rfs_buffer_handle_close (fs, &handle);
     return EIO;
   }
 
+  if ((read_sb (RTEMS_RFS_SB_OFFSET_VERSION) & RTEMS_RFS_VERSION_DIR_INDEX) != 0)
+    fs->flags |= RTEMS_RFS_FS_DIR_INDEX;
+
   if (read_sb (RTEMS_RFS_SB_OFFSET_INODE_SIZE) != RTEMS_RFS_INODE_SIZE)
   {
     if (rtems_rfs_trace (RTEMS_RFS_TRACE_OPEN))
@@ -124,6 +124,8 @@ rtems_rfs_file_open (rtems_rfs_file_system*  fs,
     shared->ctime = rtems_rfs_inode_get_ctime (&shared->inode);
     shared->fs = fs;
 
+    rtems_rfs_mutex_create (&shared->lock);
+
     rtems_chain_append_unprotected (&fs->file_shares, &shared->link);
 
     rtems_rfs_inode_unload (fs, &shared->inode, false);
@@ -199,6 +201,7 @@ rtems_rfs_file_close (rtems_rfs_file_system* fs,
     }
 
     rtems_chain_extract_unprotected (&handle->shared->link);
+    rtems_rfs_mutex_destroy (&handle->shared->lock);
     free (handle->shared);
   }
 
@@ -305,13 +308,48 @@ rtems_rfs_file_io_start (rtems_rfs_file_handle* handle,
   return 0;
 }
 
+/**
+ * Update the times and the length of the shared file data after an I/O.
+ */
+static void
+rtems_rfs_file_io_update (rtems_rfs_file_handle* handle,
+                          bool                   read,
+                          bool                   length)
+{
+  bool atime;
+  bool mtime;
+
+  atime  = rtems_rfs_file_update_atime (handle);
+  mtime  = rtems_rfs_file_update_mtime (handle) && !read;
+  length = rtems_rfs_file_update_length (handle) && length;
+
+  if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
+    printf ("rtems-rfs: file-io:   end: pos=%" PRIu32 ":%" PRIu32 " %c %c %c\n",
+            handle->bpos.bno, handle->bpos.boff,
+            atime ? 'A' : '-', mtime ? 'M' : '-', length ? 'L' : '-');
+
+  if (atime || mtime)
+  {
+    time_t now = time (NULL);
+    if (read && atime)
+      handle->shared->atime = now;
+    if (!read && mtime)
+      handle->shared->mtime = now;
+  }
+  if (length)
+  {
+    handle->shared->size.count =
+      rtems_rfs_block_map_count (rtems_rfs_file_map (handle));
+    handle->shared->size.offset =
+      rtems_rfs_block_map_size_offset (rtems_rfs_file_map (handle));
+  }
+}
+
 int
 rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
                        size_t                 size,
                        bool                   read)
 {
-  bool atime;
-  bool mtime;
   bool length;
   int  rc = 0;
 
@@ -353,7 +391,6 @@ rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
   }
 
   length = false;
-  mtime = !read;
 
   if (!read &&
       rtems_rfs_block_map_past_end (rtems_rfs_file_map (handle),
@@ -364,32 +401,126 @@ rtems_rfs_file_io_end (rtems_rfs_file_handle* handle,
     length = true;
   }
 
-  atime  = rtems_rfs_file_update_atime (handle);
-  mtime  = rtems_rfs_file_update_mtime (handle) && mtime;
-  length = rtems_rfs_file_update_length (handle) && length;
+  rtems_rfs_file_io_update (handle, read, length);
+
+  return rc;
+}
+
+int
+rtems_rfs_file_io_direct (rtems_rfs_file_handle* handle,
+                          void*                  data,
+                          size_t*                size,
+                          bool                   read)
+{
+  rtems_rfs_file_system* fs = rtems_rfs_file_fs (handle);
+  rtems_rfs_block_map*   map = rtems_rfs_file_map (handle);
+  size_t                 block_size = rtems_rfs_fs_block_size (fs);
+  size_t                 blocks = *size / block_size;
+  rtems_rfs_buffer_block first = 0;
+  size_t                 count = 0;
+  bool                   length = false;
+  int                    rc;
+
+  *size = 0;
+
+  if (rtems_rfs_file_block_offset (handle) ||
+      rtems_rfs_buffer_handle_has_block (&handle->buffer))
+    return 0;
+
+  if (read)
+  {
+    /*
+     * Only read the whole blocks of the file. A partial last block is read
+     * through the buffers.
+     */
+    rtems_rfs_block_no full = rtems_rfs_block_map_count (map);
+
+    if (full && rtems_rfs_block_map_size_offset (map))
+      --full;
+
+    if (handle->bpos.bno >= full)
+      return 0;
+
+    if (blocks > (full - handle->bpos.bno))
+      blocks = full - handle->bpos.bno;
+  }
+
+  if (!rtems_rfs_buffer_io_can_direct (data, blocks))
+    return 0;
+
+  /*
+   * Collect the run of consecutive blocks. A write grows the file by the
+   * blocks past the end.
+   */
+  while (count < blocks)
+  {
+    rtems_rfs_block_pos    bpos;
+    rtems_rfs_buffer_block block;
+
+    bpos.bno = handle->bpos.bno + count;
+    bpos.boff = 0;
+    bpos.block = 0;
+
+    rc = rtems_rfs_block_map_find (fs, map, &bpos, &block);
+    if (!read && (rc == ENXIO))
+    {
+      rc = rtems_rfs_block_map_grow (fs, map, 1, &block);
+      if (rc == 0)
+        length = true;
+    }
+
+    if (rc > 0)
+    {
+      if (count == 0)
+        return rc;
+      break;
+    }
+
+    if (count == 0)
+      first = block;
+    else if (block != (first + count))
+      break;
+
+    ++count;
+  }
 
   if (rtems_rfs_trace (RTEMS_RFS_TRACE_FILE_IO))
-    printf ("rtems-rfs: file-io:   end: pos=%" PRIu32 ":%" PRIu32 " %c %c %c\n",
-            handle->bpos.bno, handle->bpos.boff,
-            atime ? 'A' : '-', mtime ? 'M' : '-', length ? 'L' : '-');
+    printf ("rtems-rfs: file-io: direct: %s pos=%" PRIu32 " block=%" PRIu32
+            " count=%zu\n",
+            read ? "read" : "write", handle->bpos.bno, first, count);
 
-  if (atime || mtime)
+  rc = rtems_rfs_buffer_direct (fs, first, count, data, read);
+  if (rc == EBUSY)
   {
-    time_t now = time (NULL);
-    if (read && atime)
-      handle->shared->atime = now;
-    if (!read && mtime)
-      handle->shared->mtime = now;
+    /*
+     * The blocks are in use, so let the caller use the buffers. Grown blocks
+     * are written this way.
+     */
+    if (length)
+      rtems_rfs_file_io_update (handle, read, length);
+    return 0;
   }
-  if (length)
+  if (rc > 0)
+    return rc;
+
+  handle->bpos.bno += count;
+
+  /*
+   * A write of the last block fills it.
+   */
+  if (!read &&
+      (handle->bpos.bno == rtems_rfs_block_map_count (map)) &&
+      rtems_rfs_block_map_size_offset (map))
   {
-    handle->shared->size.count =
-      rtems_rfs_block_map_count (rtems_rfs_file_map (handle));
-    handle->shared->size.offset =
-      rtems_rfs_block_map_size_offset (rtems_rfs_file_map (handle));
+    rtems_rfs_block_map_set_size_offset (map, 0);
+    length = true;
   }
 
-  return rc;
+  rtems_rfs_file_io_update (handle, read, length);
+
+  *size = count * block_size;
+
+  return 0;
 }
 
 int
@@ -180,6 +180,9 @@ rtems_rfs_check_config (rtems_rfs_file_system*         fs,
     fs->max_name_length = 512;
   }
 
+  if (config->dir_index)
+    fs->flags |= RTEMS_RFS_FS_DIR_INDEX;
+
   return true;
 }
 
@@ -420,8 +423,17 @@ rtems_rfs_write_superblock (rtems_rfs_file_system* fs)
 
   memset (sb, 0xff, rtems_rfs_fs_block_size (fs));
 
-  write_sb (RTEMS_RFS_SB_OFFSET_MAGIC, RTEMS_RFS_SB_MAGIC);
-  write_sb (RTEMS_RFS_SB_OFFSET_VERSION, RTEMS_RFS_VERSION);
+  if (rtems_rfs_fs_dir_index (fs))
+  {
+    write_sb (RTEMS_RFS_SB_OFFSET_MAGIC, RTEMS_RFS_SB_MAGIC_FEATURES);
+    write_sb (RTEMS_RFS_SB_OFFSET_VERSION,
+              RTEMS_RFS_VERSION | RTEMS_RFS_VERSION_DIR_INDEX);
+  }
+  else
+  {
+    write_sb (RTEMS_RFS_SB_OFFSET_MAGIC, RTEMS_RFS_SB_MAGIC);
+    write_sb (RTEMS_RFS_SB_OFFSET_VERSION, RTEMS_RFS_VERSION);
+  }
   write_sb (RTEMS_RFS_SB_OFFSET_BLOCKS, rtems_rfs_fs_blocks (fs));
   write_sb (RTEMS_RFS_SB_OFFSET_BLOCK_SIZE, rtems_rfs_fs_block_size (fs));
   write_sb (RTEMS_RFS_SB_OFFSET_BAD_BLOCKS, fs->bad_blocks);
@@ -511,6 +523,9 @@ rtems_rfs_write_root_dir (const char* name)
     printf ("rtems-rfs: format: inode initialise failed: %d: %s\n",
             rc, strerror (rc));
 
+  if (rtems_rfs_fs_dir_index (fs))
+    rtems_rfs_inode_set_flags (&inode, RTEMS_RFS_INODE_FLAG_DIR_INDEX);
+
   rc = rtems_rfs_dir_add_entry (fs, &inode, ".", 1, ino);
   if (rc != 0)
     printf ("rtems-rfs: format: directory add failed: %d: %s\n",
@@ -617,6 +632,8 @@ rtems_rfs_format (const char* name, const rtems_rfs_format_config* config)
     printf ("rtems-rfs: format: groups = %u\n", fs.group_count);
     printf ("rtems-rfs: format: group blocks = %zu\n", fs.group_blocks);
     printf ("rtems-rfs: format: group inodes = %zu\n", fs.group_inodes);
+    printf ("rtems-rfs: format: directory index = %s\n",
+            rtems_rfs_fs_dir_index (&fs) ? "yes" : "no");
   }
 
   rc = rtems_rfs_buffer_setblksize (&fs, rtems_rfs_fs_block_size (&fs));
@@ -115,6 +115,8 @@ rtems_rfs_group_open (rtems_rfs_file_system* fs,
     rtems_rfs_bitmap_release_buffer (fs, &group->inode_bitmap);
   }
 
+  rtems_rfs_mutex_create (&group->lock);
+
   return 0;
 }
 
@@ -145,6 +147,8 @@ rtems_rfs_group_close (rtems_rfs_file_system* fs, rtems_rfs_group* group)
   if (rc > 0)
     result = rc;
 
+  rtems_rfs_mutex_destroy (&group->lock);
+
   return result;
 }
 
@@ -223,13 +227,26 @@ rtems_rfs_group_bitmap_alloc (rtems_rfs_file_system* fs,
     else
       bitmap = &fs->groups[group].block_bitmap;
 
+    rtems_rfs_mutex_lock (&fs->groups[group].lock);
+
+    /*
+     * A freed block waiting to be discarded could be allocated again. The
+     * block is added to the blocks waiting to be discarded with the lock of
+     * its group held.
+     */
+    if (!inode)
+      rtems_rfs_buffer_discard_flush (fs);
+
     rc = rtems_rfs_bitmap_map_alloc (bitmap, bit, &allocated, &bit);
-    if (rc > 0)
-      return rc;
 
     if (rtems_rfs_fs_release_bitmaps (fs))
       rtems_rfs_bitmap_release_buffer (fs, bitmap);
 
+    rtems_rfs_mutex_unlock (&fs->groups[group].lock);
+
+    if (rc > 0)
+      return rc;
+
     if (allocated)
     {
       if (inode)
@@ -302,10 +319,18 @@ rtems_rfs_group_bitmap_free (rtems_rfs_file_system* fs,
   else
     bitmap = &fs->groups[group].block_bitmap;
 
+  rtems_rfs_mutex_lock (&fs->groups[group].lock);
+
   rc = rtems_rfs_bitmap_map_clear (bitmap, bit);
 
   rtems_rfs_bitmap_release_buffer (fs, bitmap);
 
+  if ((rc == 0) && !inode)
+    rtems_rfs_buffer_discard (fs,
+                              rtems_rfs_group_block (&fs->groups[group], bit));
+
+  rtems_rfs_mutex_unlock (&fs->groups[group].lock);
+
   return rc;
 }
 
@@ -348,10 +373,14 @@ rtems_rfs_group_bitmap_test (rtems_rfs_file_system* fs,
   else
     bitmap = &fs->groups[group].block_bitmap;
 
+  rtems_rfs_mutex_lock (&fs->groups[group].lock);
+
   rc = rtems_rfs_bitmap_map_test (bitmap, bit, state);
 
   rtems_rfs_bitmap_release_buffer (fs, bitmap);
 
+  rtems_rfs_mutex_unlock (&fs->groups[group].lock);
+
   return rc;
 }
 
@@ -368,12 +397,14 @@ rtems_rfs_group_usage (rtems_rfs_file_system* fs,
   for (g = 0; g < fs->group_count; g++)
   {
     rtems_rfs_group* group = &fs->groups[g];
+    rtems_rfs_mutex_lock (&group->lock);
     *blocks +=
       rtems_rfs_bitmap_map_size(&group->block_bitmap) -
       rtems_rfs_bitmap_map_free (&group->block_bitmap);
     *inodes +=
       rtems_rfs_bitmap_map_size (&group->inode_bitmap) -
       rtems_rfs_bitmap_map_free (&group->inode_bitmap);
+    rtems_rfs_mutex_unlock (&group->lock);
   }
 
   if (*blocks > rtems_rfs_fs_blocks (fs))
@@ -250,6 +250,9 @@ rtems_rfs_inode_create (rtems_rfs_file_system*  fs,
    */
   if (RTEMS_RFS_S_ISDIR (mode))
   {
+    if (rtems_rfs_fs_dir_index (fs))
+      rtems_rfs_inode_set_flags (&inode, RTEMS_RFS_INODE_FLAG_DIR_INDEX);
+
     rc = rtems_rfs_dir_add_entry (fs, &inode, ".", 1, *ino);
     if (rc == 0)
       rc = rtems_rfs_dir_add_entry (fs, &inode, "..", 2, parent);
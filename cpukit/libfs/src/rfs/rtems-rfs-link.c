@@ -25,6 +25,7 @@
 
 #include <rtems/rfs/rtems-rfs-block.h>
 #include <rtems/rfs/rtems-rfs-buffer.h>
+#include <rtems/rfs/rtems-rfs-file.h>
 #include <rtems/rfs/rtems-rfs-file-system.h>
 #include <rtems/rfs/rtems-rfs-trace.h>
 #include <rtems/rfs/rtems-rfs-dir.h>
@@ -189,10 +190,18 @@ rtems_rfs_unlink (rtems_rfs_file_system* fs,
   }
   else
   {
+    rtems_rfs_file_shared* shared;
+
     /*
-     * Erasing the inode releases all blocks attached to it.
+     * Erasing the inode releases all blocks attached to it. An open file of
+     * the inode may be in the middle of an I/O operation.
      */
+    shared = rtems_rfs_file_get_shared (fs, target);
+    if (shared)
+      rtems_rfs_file_shared_lock (shared);
     rc = rtems_rfs_inode_delete (fs, &target_inode);
+    if (shared)
+      rtems_rfs_file_shared_unlock (shared);
     if (rc > 0)
     {
       if (rtems_rfs_trace (RTEMS_RFS_TRACE_UNLINK))
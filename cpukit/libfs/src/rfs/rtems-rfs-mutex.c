@@ -35,3 +35,21 @@ rtems_rfs_mutex_destroy (rtems_rfs_mutex* mutex)
 #endif
   return 0;
 }
+
+int
+rtems_rfs_condition_create (rtems_rfs_condition* condition)
+{
+#if __rtems__
+  rtems_condition_variable_init(condition, "RFS");
+#endif
+  return 0;
+}
+
+int
+rtems_rfs_condition_destroy (rtems_rfs_condition* condition)
+{
+#if __rtems__
+  rtems_condition_variable_destroy(condition);
+#endif
+  return 0;
+}
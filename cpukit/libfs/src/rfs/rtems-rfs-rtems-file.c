@@ -27,6 +27,30 @@
 #include <rtems/rfs/rtems-rfs-file.h>
 #include "rtems-rfs-rtems.h"
 
+/**
+ * Lock the file of the handle. The I/O of a file only needs the lock of the
+ * file so the I/O of other files is not blocked while it waits for the media.
+ *
+ * @param file
+ */
+static void
+rtems_rfs_rtems_file_lock (rtems_rfs_file_handle* file)
+{
+  rtems_rfs_file_shared_lock (file->shared);
+}
+
+/**
+ * Unlock the file of the handle.
+ *
+ * @param file
+ */
+static void
+rtems_rfs_rtems_file_unlock (rtems_rfs_file_handle* file)
+{
+  rtems_rfs_buffers_release (rtems_rfs_file_fs (file));
+  rtems_rfs_file_shared_unlock (file->shared);
+}
+
 /**
  * This routine processes the open() system call.  Note that there is nothing
  * special to be done at open() time.
@@ -119,7 +143,7 @@ rtems_rfs_rtems_file_read (rtems_libio_t* iop,
   if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_FILE_READ))
     printf("rtems-rfs: file-read: handle:%p count:%zd\n", file, count);
 
-  rtems_rfs_rtems_lock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_lock (file);
 
   pos = iop->offset;
 
@@ -127,7 +151,22 @@ rtems_rfs_rtems_file_read (rtems_libio_t* iop,
   {
     while (count)
     {
-      size_t size;
+      size_t size = count;
+
+      rc = rtems_rfs_file_io_direct (file, data, &size, true);
+      if (rc > 0)
+      {
+        read = rtems_rfs_rtems_error ("file-read: read: direct", rc);
+        break;
+      }
+
+      if (size > 0)
+      {
+        data  += size;
+        count -= size;
+        read  += size;
+        continue;
+      }
 
       rc = rtems_rfs_file_io_start (file, &size, true);
       if (rc > 0)
@@ -160,7 +199,7 @@ rtems_rfs_rtems_file_read (rtems_libio_t* iop,
   if (read >= 0)
     iop->offset = pos + read;
 
-  rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_unlock (file);
 
   return read;
 }
@@ -188,7 +227,7 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
   if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_FILE_WRITE))
     printf("rtems-rfs: file-write: handle:%p count:%zd\n", file, count);
 
-  rtems_rfs_rtems_lock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_lock (file);
 
   pos = iop->offset;
   file_size = rtems_rfs_file_size (file);
@@ -202,7 +241,7 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
     rc = rtems_rfs_file_set_size (file, pos);
     if (rc)
     {
-      rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
+      rtems_rfs_rtems_file_unlock (file);
       return rtems_rfs_rtems_error ("file-write: write extend", rc);
     }
 
@@ -214,7 +253,7 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
     rc = rtems_rfs_file_seek (file, pos, &pos);
     if (rc)
     {
-      rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
+      rtems_rfs_rtems_file_unlock (file);
       return rtems_rfs_rtems_error ("file-write: write append seek", rc);
     }
   }
@@ -223,6 +262,24 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
   {
     size_t size = count;
 
+    rc = rtems_rfs_file_io_direct (file, (void*) data, &size, false);
+    if (rc)
+    {
+      if (!write)
+        write = rtems_rfs_rtems_error ("file-write: write direct", rc);
+      break;
+    }
+
+    if (size > 0)
+    {
+      data  += size;
+      count -= size;
+      write += size;
+      continue;
+    }
+
+    size = count;
+
     rc = rtems_rfs_file_io_start (file, &size, false);
     if (rc)
     {
@@ -256,7 +313,7 @@ rtems_rfs_rtems_file_write (rtems_libio_t* iop,
   if (write >= 0)
     iop->offset = pos + write;
 
-  rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_unlock (file);
 
   return write;
 }
@@ -281,7 +338,12 @@ rtems_rfs_rtems_file_lseek (rtems_libio_t* iop,
   if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_FILE_LSEEK))
     printf("rtems-rfs: file-lseek: handle:%p offset:%" PRIdoff_t "\n", file, offset);
 
+  /*
+   * The file system lock is obtained first since the end of the file is
+   * taken from the stat handler.
+   */
   rtems_rfs_rtems_lock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_lock (file);
 
   old_offset = iop->offset;
   new_offset = rtems_filesystem_default_lseek_file (iop, offset, whence);
@@ -298,6 +360,7 @@ rtems_rfs_rtems_file_lseek (rtems_libio_t* iop,
     }
   }
 
+  rtems_rfs_rtems_file_unlock (file);
   rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
 
   return new_offset;
@@ -320,13 +383,58 @@ rtems_rfs_rtems_file_ftruncate (rtems_libio_t* iop,
   if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_FILE_FTRUNC))
     printf("rtems-rfs: file-ftrunc: handle:%p length:%" PRIdoff_t "\n", file, length);
 
-  rtems_rfs_rtems_lock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_lock (file);
 
   rc = rtems_rfs_file_set_size (file, length);
   if (rc)
     rc = rtems_rfs_rtems_error ("file_ftruncate: set size", rc);
 
-  rtems_rfs_rtems_unlock (rtems_rfs_file_fs (file));
+  rtems_rfs_rtems_file_unlock (file);
+
+  return rc;
+}
+
+/**
+ * This routine processes the posix_fallocate() system call.  The blocks of
+ * the file are allocated when the file grows, so only a region which ends
+ * after the end of the file needs new blocks.
+ *
+ * @param iop
+ * @param offset
+ * @param len
+ * @return int
+ */
+static int
+rtems_rfs_rtems_file_fallocate (rtems_libio_t* iop,
+                                off_t          offset,
+                                off_t          len)
+{
+  rtems_rfs_file_handle* file = rtems_rfs_rtems_get_iop_file_handle (iop);
+  rtems_rfs_pos          size;
+  rtems_rfs_pos          new_size = offset + len;
+  int                    rc = 0;
+
+  if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_FILE_FALLOC))
+    printf("rtems-rfs: file-falloc: handle:%p offset:%" PRIdoff_t
+           " len:%" PRIdoff_t "\n", file, offset, len);
+
+  rtems_rfs_rtems_file_lock (file);
+
+  size = rtems_rfs_file_size (file);
+  if (new_size > size)
+  {
+    rc = rtems_rfs_file_set_size (file, new_size);
+    if (rc > 0)
+    {
+      /*
+       * Do not leave a partially grown file behind.
+       */
+      rtems_rfs_file_set_size (file, size);
+      rc = rtems_rfs_rtems_error ("file_fallocate: set size", rc);
+    }
+  }
+
+  rtems_rfs_rtems_file_unlock (file);
 
   return rc;
 }
@@ -349,6 +457,7 @@ const rtems_filesystem_file_handlers_r rtems_rfs_rtems_file_handlers = {
   .fcntl_h     = rtems_filesystem_default_fcntl,
   .kqfilter_h  = rtems_filesystem_default_kqfilter,
   .mmap_h      = rtems_filesystem_default_mmap,
+  .fallocate_h = rtems_rfs_rtems_file_fallocate,
   .poll_h      = rtems_filesystem_default_poll,
   .readv_h     = rtems_filesystem_default_readv,
   .writev_h    = rtems_filesystem_default_writev
@@ -128,7 +128,8 @@ rtems_rfs_rtems_trace_shell_command (int argc, char *argv[])
     "file-read",
     "file-write",
     "file-lseek",
-    "file-ftrunc"
+    "file-ftrunc",
+    "file-falloc"
   };
 
   bool set = true;
@@ -101,6 +101,50 @@ static void rtems_rfs_rtems_follow_link(
   }
 }
 
+/**
+ * Look up a name in a directory. The global name cache is consulted before
+ * the directory is searched and is updated with the result of the search.
+ */
+static int
+rtems_rfs_rtems_lookup (rtems_rfs_file_system*  fs,
+                        rtems_rfs_inode_handle* inode,
+                        const char*             name,
+                        size_t                  length,
+                        rtems_rfs_ino*          ino,
+                        uint32_t*               offset)
+{
+  uintptr_t                         dir = rtems_rfs_inode_ino (inode);
+  rtems_filesystem_name_cache_value value;
+  int                               rc;
+
+  switch (rtems_filesystem_name_cache_lookup (fs, dir, name, length, &value))
+  {
+    case RTEMS_FILESYSTEM_NAME_CACHE_HIT:
+      *ino = value.data[0];
+      *offset = value.data[1];
+      return 0;
+    case RTEMS_FILESYSTEM_NAME_CACHE_NEGATIVE_HIT:
+      return ENOENT;
+    default:
+      break;
+  }
+
+  rc = rtems_rfs_dir_lookup_ino (fs, inode, name, length, ino, offset);
+  if (rc == 0)
+  {
+    memset (&value, 0, sizeof (value));
+    value.data[0] = *ino;
+    value.data[1] = *offset;
+    rtems_filesystem_name_cache_enter (fs, dir, name, length, &value);
+  }
+  else if (rc == ENOENT)
+  {
+    rtems_filesystem_name_cache_enter (fs, dir, name, length, NULL);
+  }
+
+  return rc;
+}
+
 static rtems_filesystem_eval_path_generic_status
 rtems_rfs_rtems_eval_token(
   rtems_filesystem_eval_path_context_t *ctx,
@@ -123,7 +167,7 @@ rtems_rfs_rtems_eval_token(
       rtems_rfs_file_system* fs = rtems_rfs_rtems_pathloc_dev (currentloc);
       rtems_rfs_ino entry_ino;
       uint32_t entry_doff;
-      int rc = rtems_rfs_dir_lookup_ino (
+      int rc = rtems_rfs_rtems_lookup (
         fs,
         inode,
         token,
@@ -425,9 +469,15 @@ rtems_rfs_rtems_fstat (const rtems_filesystem_location_info_t* pathloc,
   if (rtems_rfs_rtems_trace (RTEMS_RFS_RTEMS_DEBUG_STAT))
     printf ("rtems-rfs-rtems: stat: in: ino:%" PRId32 "\n", ino);
 
+  /*
+   * The handler is also used for open files without the file system lock.
+   */
+  rtems_rfs_rtems_lock (fs);
+
   rc = rtems_rfs_inode_open (fs, ino, &inode, true);
   if (rc)
   {
+    rtems_rfs_rtems_unlock (fs);
     return rtems_rfs_rtems_error ("stat: opening inode", rc);
   }
 
@@ -455,6 +505,7 @@ rtems_rfs_rtems_fstat (const rtems_filesystem_location_info_t* pathloc,
 
   if (shared)
   {
+    rtems_rfs_file_shared_lock (shared);
     buf->st_atime   = rtems_rfs_file_shared_get_atime (shared);
     buf->st_mtime   = rtems_rfs_file_shared_get_mtime (shared);
     buf->st_ctime   = rtems_rfs_file_shared_get_ctime (shared);
@@ -464,6 +515,7 @@ rtems_rfs_rtems_fstat (const rtems_filesystem_location_info_t* pathloc,
       buf->st_size = rtems_rfs_file_shared_get_block_offset (shared);
     else
       buf->st_size = rtems_rfs_file_shared_get_size (fs, shared);
+    rtems_rfs_file_shared_unlock (shared);
   }
   else
   {
@@ -481,6 +533,7 @@ rtems_rfs_rtems_fstat (const rtems_filesystem_location_info_t* pathloc,
   buf->st_blksize = rtems_rfs_fs_block_size (fs);
 
   rc = rtems_rfs_inode_close (fs, &inode);
+  rtems_rfs_rtems_unlock (fs);
   if (rc > 0)
   {
     return rtems_rfs_rtems_error ("stat: closing inode", rc);
@@ -702,6 +755,7 @@ const rtems_filesystem_file_handlers_r rtems_rfs_rtems_link_handlers =
   .fcntl_h     = rtems_filesystem_default_fcntl,
   .kqfilter_h  = rtems_filesystem_default_kqfilter,
   .mmap_h      = rtems_filesystem_default_mmap,
+  .fallocate_h = rtems_filesystem_default_fallocate,
   .poll_h      = rtems_filesystem_default_poll,
   .readv_h     = rtems_filesystem_default_readv,
   .writev_h    = rtems_filesystem_default_writev
@@ -81,6 +81,7 @@ int rtems_rfs_rtems_error (const char* mesg, int error);
 #define RTEMS_RFS_RTEMS_DEBUG_FILE_WRITE    (1 << 17)
 #define RTEMS_RFS_RTEMS_DEBUG_FILE_LSEEK    (1 << 18)
 #define RTEMS_RFS_RTEMS_DEBUG_FILE_FTRUNC   (1 << 19)
+#define RTEMS_RFS_RTEMS_DEBUG_FILE_FALLOC   (1 << 20)
 
 /**
  * Call to check if this part is bring traced. If RTEMS_RFS_RTEMS_TRACE is
@@ -143,7 +144,12 @@ int rtems_rfs_rtems_trace_shell_command (int argc, char *argv[]);
 typedef struct rtems_rfs_rtems_private
 {
   /**
-   * The access lock.
+   * The access lock. It serialises the operations on the name space and the
+   * opening and closing of files. The I/O of an open file only holds the lock
+   * of the file. There are no separate directory locks: a name space
+   * operation changes up to two directories, the inode and the group bitmaps,
+   * so it holds this lock, which also protects the directories. The lock
+   * order is this lock, the file lock, the group lock and the buffer lock.
    */
   rtems_rfs_mutex access;
 } rtems_rfs_rtems_private;
@@ -712,6 +712,10 @@ rtems_shell_rfs_format (int argc, char* argv[])
           config.initialise_inodes = true;
           break;
 
+        case 'd':
+          config.dir_index = true;
+          break;
+
         case 'o':
           arg++;
           if (arg >= argc)
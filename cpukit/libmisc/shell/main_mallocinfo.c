@@ -14,6 +14,7 @@
 #endif
 
 #include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <rtems.h>
@@ -38,6 +39,31 @@ static int rtems_shell_main_malloc_info(
     rtems_shell_print_heap_info( "free", &info.Free );
     rtems_shell_print_heap_info( "used", &info.Used );
     rtems_shell_print_heap_stats( &info.Stats );
+
+    if ( rtems_malloc_cache != NULL ) {
+      rtems_malloc_cache_information cache_info;
+      size_t i;
+
+      malloc_cache_info( &cache_info );
+      printf( "Per-processor cache:\n" );
+
+      for ( i = 0; i < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++i ) {
+        const rtems_malloc_cache_class_information *c;
+
+        c = &cache_info.classes[ i ];
+        printf(
+          "  size %4zu: cached %6" PRIu32 ", hits %10" PRIu32
+            ", misses %10" PRIu32 ", refills %10" PRIu32
+            ", drains %10" PRIu32 "\n",
+          c->size,
+          c->cached,
+          c->hits,
+          c->misses,
+          c->refills,
+          c->drains
+        );
+      }
+    }
   }
 
   return 0;
@@ -1050,6 +1050,7 @@ static const rtems_filesystem_file_handlers_r rtems_tftp_handlers = {
    .fcntl_h = rtems_filesystem_default_fcntl,
    .kqfilter_h = rtems_filesystem_default_kqfilter,
    .mmap_h = rtems_filesystem_default_mmap,
+   .fallocate_h = rtems_filesystem_default_fallocate,
    .poll_h = rtems_filesystem_default_poll,
    .readv_h = rtems_filesystem_default_readv,
    .writev_h = rtems_filesystem_default_writev
@@ -0,0 +1,106 @@
+/**
+ * @file
+ *
+ * @brief Receive Several Messages from a Message Queue
+ * @ingroup POSIXAPI
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/posix/mqueueimpl.h>
+#include <rtems/seterr.h>
+
+#include <fcntl.h>
+#include <mqueue.h>
+
+RTEMS_STATIC_ASSERT(
+  sizeof( unsigned int ) == sizeof( uint32_t ),
+  mq_receive_many_np_priorities
+);
+
+ssize_t mq_receive_many_np(
+  mqd_t         mqdes,
+  char         *msg_ptr,
+  size_t        msg_len,
+  size_t       *msg_lens,
+  unsigned int *msg_prios,
+  unsigned int  count
+)
+{
+  POSIX_Message_queue_Control      *the_mq;
+  CORE_message_queue_Batch_context  context;
+  Status_Control                    status;
+  uint32_t                          received;
+  uint32_t                          i;
+
+  if ( msg_lens == NULL ) {
+    rtems_set_errno_and_return_minus_one( EINVAL );
+  }
+
+  _CORE_message_queue_Batch_context_initialize( &context );
+  the_mq = _POSIX_Message_queue_Get( mqdes, &context.Base );
+
+  if ( the_mq == NULL ) {
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  if ( ( the_mq->oflag & O_ACCMODE ) == O_WRONLY ) {
+    _ISR_lock_ISR_enable( &context.Base.Lock_context.Lock_context );
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  if ( msg_len < the_mq->Message_queue.maximum_message_size ) {
+    _ISR_lock_ISR_enable( &context.Base.Lock_context.Lock_context );
+    rtems_set_errno_and_return_minus_one( EMSGSIZE );
+  }
+
+  _Thread_queue_Context_set_enqueue_callout(
+    &context.Base,
+    _Thread_queue_Enqueue_do_nothing_extra
+  );
+
+  _CORE_message_queue_Acquire_critical(
+    &the_mq->Message_queue,
+    &context.Base
+  );
+
+  if ( the_mq->open_count == 0 ) {
+    _CORE_message_queue_Release( &the_mq->Message_queue, &context.Base );
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  status = _CORE_message_queue_Seize_many(
+    &the_mq->Message_queue,
+    _Thread_Executing,
+    msg_ptr,
+    msg_len,
+    msg_lens,
+    (uint32_t *) msg_prios,
+    count,
+    &received,
+    ( the_mq->oflag & O_NONBLOCK ) == 0,
+    &context
+  );
+
+  if ( status != STATUS_SUCCESSFUL ) {
+    rtems_set_errno_and_return_minus_one( _POSIX_Get_error( status ) );
+  }
+
+  if ( msg_prios != NULL ) {
+    for ( i = 0; i < received; ++i ) {
+      msg_prios[ i ] = _POSIX_Message_queue_Priority_from_core(
+        (CORE_message_queue_Submit_types) msg_prios[ i ]
+      );
+    }
+  }
+
+  return (ssize_t) received;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file
+ *
+ * @brief Send Several Messages to a Message Queue
+ * @ingroup POSIXAPI
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/posix/mqueueimpl.h>
+#include <rtems/seterr.h>
+
+#include <fcntl.h>
+#include <mqueue.h>
+
+ssize_t mq_send_many_np(
+  mqd_t         mqdes,
+  const char   *msg_ptr,
+  size_t        msg_len,
+  unsigned int  count,
+  unsigned int  msg_prio
+)
+{
+  POSIX_Message_queue_Control      *the_mq;
+  CORE_message_queue_Batch_context  context;
+  Status_Control                    status;
+  uint32_t                          sent;
+
+  if ( msg_prio > MQ_PRIO_MAX ) {
+    rtems_set_errno_and_return_minus_one( EINVAL );
+  }
+
+  _CORE_message_queue_Batch_context_initialize( &context );
+  the_mq = _POSIX_Message_queue_Get( mqdes, &context.Base );
+
+  if ( the_mq == NULL ) {
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  if ( ( the_mq->oflag & O_ACCMODE ) == O_RDONLY ) {
+    _ISR_lock_ISR_enable( &context.Base.Lock_context.Lock_context );
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  _Thread_queue_Context_set_enqueue_callout(
+    &context.Base,
+    _Thread_queue_Enqueue_do_nothing_extra
+  );
+
+  _CORE_message_queue_Acquire_critical(
+    &the_mq->Message_queue,
+    &context.Base
+  );
+
+  if ( the_mq->open_count == 0 ) {
+    _CORE_message_queue_Release( &the_mq->Message_queue, &context.Base );
+    rtems_set_errno_and_return_minus_one( EBADF );
+  }
+
+  status = _CORE_message_queue_Submit_many(
+    &the_mq->Message_queue,
+    _Thread_Executing,
+    msg_ptr,
+    msg_len,
+    count,
+    &sent,
+    _POSIX_Message_queue_Priority_to_core( msg_prio ),
+    ( the_mq->oflag & O_NONBLOCK ) == 0,
+    &context
+  );
+
+  /*
+   *  Like write(), report a partial transfer as a success.
+   */
+  if ( status != STATUS_SUCCESSFUL && sent == 0 ) {
+    rtems_set_errno_and_return_minus_one( _POSIX_Get_error( status ) );
+  }
+
+  return (ssize_t) sent;
+}
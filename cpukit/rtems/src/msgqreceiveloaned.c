@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @brief RTEMS Message Queue Receive Loaned
+ * @ingroup ClassicMessageQueue
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/rtems/messageimpl.h>
+#include <rtems/rtems/optionsimpl.h>
+#include <rtems/rtems/statusimpl.h>
+
+rtems_status_code rtems_message_queue_receive_loaned(
+  rtems_id         id,
+  void           **buffer,
+  size_t          *size,
+  rtems_option     option_set,
+  rtems_interval   timeout
+)
+{
+  Message_queue_Control             *the_message_queue;
+  Thread_queue_Context               queue_context;
+  Thread_Control                    *executing;
+  CORE_message_queue_Buffer_control *the_message;
+  Status_Control                     status;
+
+  if ( buffer == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  if ( size == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  the_message_queue = _Message_queue_Get( id, &queue_context );
+
+  if ( the_message_queue == NULL ) {
+    return RTEMS_INVALID_ID;
+  }
+
+  _CORE_message_queue_Acquire_critical(
+    &the_message_queue->message_queue,
+    &queue_context
+  );
+
+  executing = _Thread_Executing;
+  _Thread_queue_Context_set_enqueue_timeout_ticks( &queue_context, timeout );
+  the_message = NULL;
+  status = _CORE_message_queue_Seize_loaned(
+    &the_message_queue->message_queue,
+    executing,
+    &the_message,
+    !_Options_Is_no_wait( option_set ),
+    &queue_context
+  );
+
+  if ( status == STATUS_SUCCESSFUL ) {
+    *buffer = the_message->Contents.buffer;
+    *size = the_message->Contents.size;
+  } else if (
+    the_message != NULL
+      && status != STATUS_MESSAGE_QUEUE_WAS_DELETED
+  ) {
+    /*
+     *  The wait was not satisfied, so give the buffer reserved for the
+     *  message back to the message queue.  The message queue may have been
+     *  deleted in the meantime.
+     */
+    the_message_queue = _Message_queue_Get( id, &queue_context );
+
+    if ( the_message_queue != NULL ) {
+      _CORE_message_queue_Acquire_critical(
+        &the_message_queue->message_queue,
+        &queue_context
+      );
+
+      if (
+        _CORE_message_queue_Buffer_of_content(
+          &the_message_queue->message_queue,
+          the_message->Contents.buffer
+        ) == the_message
+      ) {
+        (void) _CORE_message_queue_Return(
+          &the_message_queue->message_queue,
+          the_message,
+          &queue_context
+        );
+      } else {
+        _CORE_message_queue_Release(
+          &the_message_queue->message_queue,
+          &queue_context
+        );
+      }
+    }
+  }
+
+  return _Status_Get( status );
+}
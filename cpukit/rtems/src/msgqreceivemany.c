@@ -0,0 +1,84 @@
+/**
+ * @file
+ *
+ * @brief RTEMS Message Queue Receive Many
+ * @ingroup ClassicMessageQueue
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/rtems/messageimpl.h>
+#include <rtems/rtems/optionsimpl.h>
+#include <rtems/rtems/statusimpl.h>
+
+rtems_status_code rtems_message_queue_receive_many(
+  rtems_id        id,
+  void           *buffer,
+  size_t          slot_size,
+  size_t         *sizes,
+  uint32_t        count,
+  uint32_t       *received,
+  rtems_option    option_set,
+  rtems_interval  timeout
+)
+{
+  Message_queue_Control            *the_message_queue;
+  CORE_message_queue_Batch_context  context;
+  Thread_Control                   *executing;
+  Status_Control                    status;
+
+  if ( buffer == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  if ( sizes == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  if ( received == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  _CORE_message_queue_Batch_context_initialize( &context );
+  the_message_queue = _Message_queue_Get( id, &context.Base );
+
+  if ( the_message_queue == NULL ) {
+    *received = 0;
+    return RTEMS_INVALID_ID;
+  }
+
+  if ( slot_size < the_message_queue->message_queue.maximum_message_size ) {
+    _ISR_lock_ISR_enable( &context.Base.Lock_context.Lock_context );
+    *received = 0;
+    return RTEMS_INVALID_SIZE;
+  }
+
+  _CORE_message_queue_Acquire_critical(
+    &the_message_queue->message_queue,
+    &context.Base
+  );
+
+  executing = _Thread_Executing;
+  _Thread_queue_Context_set_enqueue_timeout_ticks( &context.Base, timeout );
+  status = _CORE_message_queue_Seize_many(
+    &the_message_queue->message_queue,
+    executing,
+    buffer,
+    slot_size,
+    sizes,
+    NULL,
+    count,
+    received,
+    !_Options_Is_no_wait( option_set ),
+    &context
+  );
+  return _Status_Get( status );
+}
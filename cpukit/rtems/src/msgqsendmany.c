@@ -0,0 +1,69 @@
+/**
+ * @file
+ *
+ * @brief RTEMS Message Queue Send Many
+ * @ingroup ClassicMessageQueue
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/rtems/messageimpl.h>
+#include <rtems/rtems/statusimpl.h>
+
+rtems_status_code rtems_message_queue_send_many(
+  rtems_id    id,
+  const void *buffer,
+  size_t      size,
+  uint32_t    count,
+  uint32_t   *sent
+)
+{
+  Message_queue_Control            *the_message_queue;
+  CORE_message_queue_Batch_context  context;
+  Status_Control                    status;
+
+  if ( buffer == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  if ( sent == NULL ) {
+    return RTEMS_INVALID_ADDRESS;
+  }
+
+  _CORE_message_queue_Batch_context_initialize( &context );
+  the_message_queue = _Message_queue_Get( id, &context.Base );
+
+  if ( the_message_queue == NULL ) {
+    *sent = 0;
+    return RTEMS_INVALID_ID;
+  }
+
+  _CORE_message_queue_Acquire_critical(
+    &the_message_queue->message_queue,
+    &context.Base
+  );
+  _Thread_queue_Context_set_MP_callout(
+    &context.Base,
+    _Message_queue_Core_message_queue_mp_support
+  );
+  status = _CORE_message_queue_Submit_many(
+    &the_message_queue->message_queue,
+    _Thread_Executing,
+    buffer,
+    size,
+    count,
+    sent,
+    CORE_MESSAGE_QUEUE_SEND_REQUEST,
+    false,   /* sender does not block */
+    &context
+  );
+  return _Status_Get( status );
+}
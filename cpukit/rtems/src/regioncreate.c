@@ -79,9 +79,15 @@ rtems_status_code rtems_region_create(
         the_region->wait_operations = &_Thread_queue_Operations_FIFO;
       }
 
-      the_region->maximum_segment_size = _Heap_Initialize(
-        &the_region->Memory, starting_address, length, page_size
-      );
+      if ( _Attributes_Is_segregated_fit( attribute_set ) ) {
+        the_region->maximum_segment_size = _Heap_Initialize_segregated_fit(
+          &the_region->Memory, starting_address, length, page_size
+        );
+      } else {
+        the_region->maximum_segment_size = _Heap_Initialize(
+          &the_region->Memory, starting_address, length, page_size
+        );
+      }
 
       if ( !the_region->maximum_segment_size ) {
         _Region_Free( the_region );
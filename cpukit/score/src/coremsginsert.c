@@ -45,8 +45,6 @@ void _CORE_message_queue_Insert_message(
   CORE_message_queue_Submit_types    submit_type
 )
 {
-  Chain_Control *pending_messages;
-
   the_message->Contents.size = content_size;
 
   _CORE_message_queue_Copy_buffer(
@@ -55,6 +53,21 @@ void _CORE_message_queue_Insert_message(
     content_size
   );
 
+  _CORE_message_queue_Enqueue_message(
+    the_message_queue,
+    the_message,
+    submit_type
+  );
+}
+
+void _CORE_message_queue_Enqueue_message(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  CORE_message_queue_Submit_types    submit_type
+)
+{
+  Chain_Control *pending_messages;
+
 #if defined(RTEMS_SCORE_COREMSG_ENABLE_MESSAGE_PRIORITY)
   the_message->priority = submit_type;
 #endif
@@ -0,0 +1,219 @@
+/**
+ * @file
+ *
+ * @brief CORE Message Queue Buffer Loaning
+ *
+ * @ingroup ScoreMessageQueue
+ */
+
+/*
+ *  The license and distribution terms for this file may be
+ *  found in the file LICENSE in this distribution or at
+ *  http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/coremsgimpl.h>
+#include <rtems/score/threadimpl.h>
+#include <rtems/score/statesimpl.h>
+
+/*
+ * A loaned message buffer is on neither the inactive nor the pending message
+ * chain.  Its node is set off chain to detect buffers which are submitted or
+ * returned twice.
+ */
+
+CORE_message_queue_Buffer_control *_CORE_message_queue_Buffer_of_content(
+  const CORE_message_queue_Control *the_message_queue,
+  const void                       *content
+)
+{
+  CORE_message_queue_Buffer_control *the_message;
+  uintptr_t                          begin;
+  uintptr_t                          offset;
+  size_t                             buffer_size;
+
+  the_message = RTEMS_CONTAINER_OF(
+    content,
+    CORE_message_queue_Buffer_control,
+    Contents.buffer
+  );
+  begin = (uintptr_t) the_message_queue->message_buffers;
+  offset = (uintptr_t) the_message - begin;
+  buffer_size = _CORE_message_queue_Buffer_size( the_message_queue );
+
+  if (
+    (uintptr_t) the_message < begin
+      || offset / buffer_size >= the_message_queue->maximum_pending_messages
+      || offset % buffer_size != 0
+  ) {
+    return NULL;
+  }
+
+  return the_message;
+}
+
+Status_Control _CORE_message_queue_Loan(
+  CORE_message_queue_Control         *the_message_queue,
+  CORE_message_queue_Buffer_control **the_message,
+  Thread_queue_Context               *queue_context
+)
+{
+  CORE_message_queue_Buffer_control *loaned;
+
+  loaned = _CORE_message_queue_Allocate_message_buffer( the_message_queue );
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+
+  if ( loaned == NULL ) {
+    return STATUS_TOO_MANY;
+  }
+
+  _Chain_Set_off_chain( &loaned->Node );
+  *the_message = loaned;
+  return STATUS_SUCCESSFUL;
+}
+
+Status_Control _CORE_message_queue_Submit_loaned(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  size_t                             size,
+  CORE_message_queue_Submit_types    submit_type,
+  Thread_queue_Context              *queue_context
+)
+{
+  Thread_Control *the_thread;
+
+  if ( !_Chain_Is_node_off_chain( &the_message->Node ) ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_INCORRECT_STATE;
+  }
+
+  if ( size > the_message_queue->maximum_message_size ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_MESSAGE_INVALID_SIZE;
+  }
+
+  /*
+   *  A waiting thread provides its own receive buffer, so the content must be
+   *  copied in this case.  The loaned buffer returns to the inactive messages
+   *  afterwards.
+   */
+  the_thread = _CORE_message_queue_Dequeue_receiver(
+    the_message_queue,
+    the_message->Contents.buffer,
+    size,
+    submit_type,
+    queue_context
+  );
+  if ( the_thread != NULL ) {
+    _CORE_message_queue_Acquire( the_message_queue, queue_context );
+    _CORE_message_queue_Free_message_buffer( the_message_queue, the_message );
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_SUCCESSFUL;
+  }
+
+  the_message->Contents.size = size;
+  _CORE_message_queue_Enqueue_message(
+    the_message_queue,
+    the_message,
+    submit_type
+  );
+
+#if defined(RTEMS_SCORE_COREMSG_ENABLE_NOTIFICATION)
+  if (
+    the_message_queue->number_of_pending_messages == 1
+      && the_message_queue->notify_handler != NULL
+  ) {
+    ( *the_message_queue->notify_handler )(
+      the_message_queue,
+      queue_context
+    );
+  } else {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+  }
+#else
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+#endif
+
+  return STATUS_SUCCESSFUL;
+}
+
+Status_Control _CORE_message_queue_Seize_loaned(
+  CORE_message_queue_Control         *the_message_queue,
+  Thread_Control                     *executing,
+  CORE_message_queue_Buffer_control **the_message,
+  bool                                wait,
+  Thread_queue_Context               *queue_context
+)
+{
+  CORE_message_queue_Buffer_control *seized;
+
+  seized = _CORE_message_queue_Get_pending_message( the_message_queue );
+  if ( seized != NULL ) {
+    the_message_queue->number_of_pending_messages -= 1;
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+
+    _Chain_Set_off_chain( &seized->Node );
+    executing->Wait.count = _CORE_message_queue_Get_message_priority( seized );
+    *the_message = seized;
+    return STATUS_SUCCESSFUL;
+  }
+
+  if ( !wait ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_UNSATISFIED;
+  }
+
+  /*
+   *  Reserve a buffer for the message of the next sender.  The sender sees an
+   *  ordinary waiting receiver and copies the message into this buffer.
+   */
+  seized = _CORE_message_queue_Allocate_message_buffer( the_message_queue );
+  if ( seized == NULL ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_TOO_MANY;
+  }
+
+  _Chain_Set_off_chain( &seized->Node );
+  *the_message = seized;
+
+  executing->Wait.return_argument_second.mutable_object =
+    seized->Contents.buffer;
+  executing->Wait.return_argument = &seized->Contents.size;
+  /* Wait.count will be filled in with the message priority */
+
+  _Thread_queue_Context_set_thread_state(
+    queue_context,
+    STATES_WAITING_FOR_MESSAGE
+  );
+  _Thread_queue_Enqueue(
+    &the_message_queue->Wait_queue.Queue,
+    the_message_queue->operations,
+    executing,
+    queue_context
+  );
+  return _Thread_Wait_get_status( executing );
+}
+
+Status_Control _CORE_message_queue_Return(
+  CORE_message_queue_Control        *the_message_queue,
+  CORE_message_queue_Buffer_control *the_message,
+  Thread_queue_Context              *queue_context
+)
+{
+  if ( !_Chain_Is_node_off_chain( &the_message->Node ) ) {
+    _CORE_message_queue_Release( the_message_queue, queue_context );
+    return STATUS_INCORRECT_STATE;
+  }
+
+  /*
+   *  Buffer loaning is not available for APIs with blocking sends, so there
+   *  is no sender waiting for this buffer.
+   */
+  _CORE_message_queue_Free_message_buffer( the_message_queue, the_message );
+  _CORE_message_queue_Release( the_message_queue, queue_context );
+  return STATUS_SUCCESSFUL;
+}
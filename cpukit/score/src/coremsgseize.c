@@ -125,3 +125,134 @@ Status_Control _CORE_message_queue_Seize(
   );
   return _Thread_Wait_get_status( executing );
 }
+
+#if defined(RTEMS_SCORE_COREMSG_ENABLE_BLOCKING_SEND)
+static Thread_Control *_CORE_message_queue_Refill_filter(
+  Thread_Control       *the_thread,
+  Thread_queue_Queue   *queue,
+  Thread_queue_Context *queue_context
+)
+{
+  CORE_message_queue_Batch_context  *context;
+  CORE_message_queue_Buffer_control *the_message;
+
+  context = (CORE_message_queue_Batch_context *) queue_context;
+  the_message = _CORE_message_queue_Allocate_message_buffer(
+    context->the_message_queue
+  );
+
+  if ( the_message == NULL ) {
+    return NULL;
+  }
+
+  /*
+   *  Put the message of the waiting sender into the message queue on behalf
+   *  of the sender.
+   */
+  _CORE_message_queue_Insert_message(
+    context->the_message_queue,
+    the_message,
+    the_thread->Wait.return_argument_second.immutable_object,
+    (size_t) the_thread->Wait.option,
+    (CORE_message_queue_Submit_types) the_thread->Wait.count
+  );
+
+  (void) queue;
+  return the_thread;
+}
+#endif
+
+Status_Control _CORE_message_queue_Seize_many(
+  CORE_message_queue_Control       *the_message_queue,
+  Thread_Control                   *executing,
+  void                             *buffer,
+  size_t                            slot_size,
+  size_t                           *sizes,
+  uint32_t                         *priorities,
+  uint32_t                          count,
+  uint32_t                         *received,
+  bool                              wait,
+  CORE_message_queue_Batch_context *context
+)
+{
+  uint32_t        done;
+  Status_Control  status;
+
+  context->the_message_queue = the_message_queue;
+
+  for ( done = 0; done < count; ++done ) {
+    CORE_message_queue_Buffer_control *the_message;
+
+    the_message = _CORE_message_queue_Get_pending_message( the_message_queue );
+    if ( the_message == NULL ) {
+      break;
+    }
+
+    the_message_queue->number_of_pending_messages -= 1;
+
+    sizes[ done ] = the_message->Contents.size;
+
+    if ( priorities != NULL ) {
+      priorities[ done ] =
+        (uint32_t) _CORE_message_queue_Get_message_priority( the_message );
+    }
+
+    _CORE_message_queue_Copy_buffer(
+      the_message->Contents.buffer,
+      (char *) buffer + done * slot_size,
+      the_message->Contents.size
+    );
+    _CORE_message_queue_Free_message_buffer( the_message_queue, the_message );
+  }
+
+  *received = done;
+
+  if ( done > 0 ) {
+  #if defined(RTEMS_SCORE_COREMSG_ENABLE_BLOCKING_SEND)
+    /*
+     *  There were pending messages, so the waiting threads are senders.  Let
+     *  them fill the freed message buffers.
+     */
+    _Thread_queue_Flush_critical(
+      &the_message_queue->Wait_queue.Queue,
+      the_message_queue->operations,
+      _CORE_message_queue_Refill_filter,
+      &context->Base
+    );
+  #else
+    _CORE_message_queue_Release( the_message_queue, &context->Base );
+  #endif
+    return STATUS_SUCCESSFUL;
+  }
+
+  if ( !wait || count == 0 ) {
+    _CORE_message_queue_Release( the_message_queue, &context->Base );
+    return count > 0 ? STATUS_UNSATISFIED : STATUS_SUCCESSFUL;
+  }
+
+  executing->Wait.return_argument_second.mutable_object = buffer;
+  executing->Wait.return_argument = &sizes[ 0 ];
+  /* Wait.count will be filled in with the message priority */
+
+  _Thread_queue_Context_set_thread_state(
+    &context->Base,
+    STATES_WAITING_FOR_MESSAGE
+  );
+  _Thread_queue_Enqueue(
+    &the_message_queue->Wait_queue.Queue,
+    the_message_queue->operations,
+    executing,
+    &context->Base
+  );
+  status = _Thread_Wait_get_status( executing );
+
+  if ( status == STATUS_SUCCESSFUL ) {
+    *received = 1;
+
+    if ( priorities != NULL ) {
+      priorities[ 0 ] = executing->Wait.count;
+    }
+  }
+
+  return status;
+}
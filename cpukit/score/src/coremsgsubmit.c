@@ -144,3 +144,165 @@ Status_Control _CORE_message_queue_Submit(
     return _Thread_Wait_get_status( executing );
   #endif
 }
+
+static Thread_Control *_CORE_message_queue_Deliver_filter(
+  Thread_Control       *the_thread,
+  Thread_queue_Queue   *queue,
+  Thread_queue_Context *queue_context
+)
+{
+  CORE_message_queue_Batch_context *context;
+
+  context = (CORE_message_queue_Batch_context *) queue_context;
+
+  if ( context->done == context->count ) {
+    return NULL;
+  }
+
+  *(size_t *) the_thread->Wait.return_argument = context->size;
+  the_thread->Wait.count = (uint32_t) context->submit_type;
+
+  _CORE_message_queue_Copy_buffer(
+    context->source + context->done * context->size,
+    the_thread->Wait.return_argument_second.mutable_object,
+    context->size
+  );
+
+  ++context->done;
+  (void) queue;
+  return the_thread;
+}
+
+Status_Control _CORE_message_queue_Submit_many(
+  CORE_message_queue_Control       *the_message_queue,
+  Thread_Control                   *executing,
+  const void                       *buffer,
+  size_t                            size,
+  uint32_t                          count,
+  uint32_t                         *sent,
+  CORE_message_queue_Submit_types   submit_type,
+  bool                              wait,
+  CORE_message_queue_Batch_context *context
+)
+{
+  uint32_t pending_before;
+
+  context->the_message_queue = the_message_queue;
+  context->source = buffer;
+  context->size = size;
+  context->count = count;
+  context->done = 0;
+  context->submit_type = submit_type;
+
+  if ( size > the_message_queue->maximum_message_size ) {
+    _CORE_message_queue_Release( the_message_queue, &context->Base );
+    *sent = 0;
+    return STATUS_MESSAGE_INVALID_SIZE;
+  }
+
+  /*
+   *  If there are no pending messages, then the waiting threads are
+   *  receivers.  Hand out one message to each of them.  The flush releases
+   *  the lock, so check again for new receivers after the re-acquire.
+   */
+  while (
+    the_message_queue->number_of_pending_messages == 0
+      && !_Thread_queue_Is_empty( &the_message_queue->Wait_queue.Queue )
+  ) {
+    _Thread_queue_Flush_critical(
+      &the_message_queue->Wait_queue.Queue,
+      the_message_queue->operations,
+      _CORE_message_queue_Deliver_filter,
+      &context->Base
+    );
+
+    if ( context->done == count ) {
+      *sent = count;
+      return STATUS_SUCCESSFUL;
+    }
+
+    _CORE_message_queue_Acquire( the_message_queue, &context->Base );
+  }
+
+  pending_before = the_message_queue->number_of_pending_messages;
+
+  while ( context->done < count ) {
+    CORE_message_queue_Buffer_control *the_message;
+
+    the_message =
+      _CORE_message_queue_Allocate_message_buffer( the_message_queue );
+    if ( the_message == NULL ) {
+      break;
+    }
+
+    _CORE_message_queue_Insert_message(
+      the_message_queue,
+      the_message,
+      context->source + context->done * size,
+      size,
+      submit_type
+    );
+    ++context->done;
+  }
+
+  *sent = context->done;
+
+  if ( context->done == 0 ) {
+  #if defined(RTEMS_SCORE_COREMSG_ENABLE_BLOCKING_SEND)
+    if ( wait && count > 0 && !_ISR_Is_in_progress() ) {
+      /*
+       *  The message queue is full.  Block until the first message of the
+       *  batch is sent like _CORE_message_queue_Submit() does.
+       */
+      Status_Control status;
+
+      executing->Wait.return_argument_second.immutable_object = buffer;
+      executing->Wait.option = (uint32_t) size;
+      executing->Wait.count = submit_type;
+
+      _Thread_queue_Context_set_thread_state(
+        &context->Base,
+        STATES_WAITING_FOR_MESSAGE
+      );
+      _Thread_queue_Enqueue(
+        &the_message_queue->Wait_queue.Queue,
+        the_message_queue->operations,
+        executing,
+        &context->Base
+      );
+      status = _Thread_Wait_get_status( executing );
+
+      if ( status == STATUS_SUCCESSFUL ) {
+        *sent = 1;
+      }
+
+      return status;
+    }
+  #else
+    (void) executing;
+    (void) wait;
+  #endif
+
+    _CORE_message_queue_Release( the_message_queue, &context->Base );
+    return count > 0 ? STATUS_TOO_MANY : STATUS_SUCCESSFUL;
+  }
+
+#if defined(RTEMS_SCORE_COREMSG_ENABLE_NOTIFICATION)
+  if (
+    pending_before == 0
+      && the_message_queue->notify_handler != NULL
+  ) {
+    ( *the_message_queue->notify_handler )(
+      the_message_queue,
+      &context->Base
+    );
+  } else {
+    _CORE_message_queue_Release( the_message_queue, &context->Base );
+  }
+#else
+  (void) pending_before;
+  _CORE_message_queue_Release( the_message_queue, &context->Base );
+#endif
+
+  return context->done == count ? STATUS_SUCCESSFUL : STATUS_TOO_MANY;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ *
+ * @ingroup ScoreHeap
+ *
+ * @brief _Heap_Initialize_segregated_fit() implementation.
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <rtems/score/heapimpl.h>
+
+#include <string.h>
+
+uintptr_t _Heap_Initialize_segregated_fit(
+  Heap_Control *heap,
+  void *heap_area_begin_ptr,
+  uintptr_t heap_area_size,
+  uintptr_t page_size
+)
+{
+  uintptr_t const heap_area_begin = (uintptr_t) heap_area_begin_ptr;
+  uintptr_t const index_begin =
+    _Heap_Align_up( heap_area_begin, CPU_ALIGNMENT );
+  uintptr_t const index_end = index_begin + sizeof( Heap_Segregated_index );
+  Heap_Segregated_index *const index = (Heap_Segregated_index *) index_begin;
+  uintptr_t space_available;
+  Heap_Block *first_block;
+
+  if (
+    index_end < heap_area_begin
+      || index_end - heap_area_begin >= heap_area_size
+  ) {
+    return 0;
+  }
+
+  space_available = _Heap_Initialize(
+    heap,
+    (void *) index_end,
+    heap_area_size - ( index_end - heap_area_begin ),
+    page_size
+  );
+  if ( space_available == 0 ) {
+    return 0;
+  }
+
+  memset( index, 0, sizeof( *index ) );
+
+  first_block = _Heap_Free_list_first( heap );
+  _Heap_Free_list_remove( first_block );
+
+  heap->segregated_index = index;
+  _Heap_Segregated_insert( heap, first_block );
+
+  return space_available;
+}
@@ -138,6 +138,128 @@ static bool _Heap_Walk_is_in_free_list(
   return false;
 }
 
+static bool _Heap_Walk_check_segregated_index(
+  int source,
+  Heap_Walk_printer printer,
+  Heap_Control *heap
+)
+{
+  const Heap_Segregated_index *const index = heap->segregated_index;
+  const Heap_Block *const free_list_tail = _Heap_Free_list_tail( heap );
+  const Heap_Block *free_block = _Heap_Free_list_first( heap );
+  unsigned int prev_fl = 0;
+  unsigned int prev_sl = 0;
+  unsigned int fl;
+  unsigned int sl;
+
+  while ( free_block != free_list_tail ) {
+    bool is_first_of_size_class;
+
+    _Heap_Segregated_map( _Heap_Block_size( free_block ), &fl, &sl );
+
+    if ( fl < prev_fl || ( fl == prev_fl && sl < prev_sl ) ) {
+      (*printer)(
+        source,
+        true,
+        "free block 0x%08x: free list not sorted by size class\n",
+        free_block
+      );
+
+      return false;
+    }
+
+    is_first_of_size_class = free_block->prev == free_list_tail
+      || fl != prev_fl || sl != prev_sl;
+
+    if ( is_first_of_size_class && index->first[ fl ][ sl ] != free_block ) {
+      (*printer)(
+        source,
+        true,
+        "free block 0x%08x: not the first block of size class %u:%u\n",
+        free_block,
+        fl,
+        sl
+      );
+
+      return false;
+    }
+
+    prev_fl = fl;
+    prev_sl = sl;
+    free_block = free_block->next;
+  }
+
+  for ( fl = 0; fl < HEAP_SEGREGATED_FL_COUNT; ++fl ) {
+    uintptr_t const sl_bitmap = index->sl_bitmap[ fl ];
+    bool const fl_bit = ( ( index->fl_bitmap >> fl ) & 1 ) != 0;
+
+    if ( fl_bit != ( sl_bitmap != 0 ) ) {
+      (*printer)(
+        source,
+        true,
+        "size class %u: inconsistent first level bitmap\n",
+        fl
+      );
+
+      return false;
+    }
+
+    for ( sl = 0; sl < HEAP_SEGREGATED_SL_COUNT; ++sl ) {
+      Heap_Block *const first = index->first[ fl ][ sl ];
+      bool const sl_bit = ( ( sl_bitmap >> sl ) & 1 ) != 0;
+
+      if ( sl_bit != ( first != NULL ) ) {
+        (*printer)(
+          source,
+          true,
+          "size class %u:%u: inconsistent second level bitmap\n",
+          fl,
+          sl
+        );
+
+        return false;
+      }
+
+      if ( first != NULL ) {
+        unsigned int first_fl;
+        unsigned int first_sl;
+
+        if ( !_Heap_Walk_is_in_free_list( heap, first ) ) {
+          (*printer)(
+            source,
+            true,
+            "size class %u:%u: first block 0x%08x not in free list\n",
+            fl,
+            sl,
+            first
+          );
+
+          return false;
+        }
+
+        _Heap_Segregated_map( _Heap_Block_size( first ), &first_fl, &first_sl );
+
+        if ( first_fl != fl || first_sl != sl ) {
+          (*printer)(
+            source,
+            true,
+            "size class %u:%u: first block 0x%08x in size class %u:%u\n",
+            fl,
+            sl,
+            first,
+            first_fl,
+            first_sl
+          );
+
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
 static bool _Heap_Walk_check_control(
   int source,
   Heap_Walk_printer printer,
@@ -237,7 +359,15 @@ static bool _Heap_Walk_check_control(
     return false;
   }
 
-  return _Heap_Walk_check_free_list( source, printer, heap );
+  if ( !_Heap_Walk_check_free_list( source, printer, heap ) ) {
+    return false;
+  }
+
+  if ( _Heap_Is_segregated_fit( heap ) ) {
+    return _Heap_Walk_check_segregated_index( source, printer, heap );
+  }
+
+  return true;
 }
 
 static bool _Heap_Walk_check_free_block(
@@ -19,6 +19,7 @@
 #include <rtems/score/objectimpl.h>
 #include <rtems/score/assert.h>
 #include <rtems/score/chainimpl.h>
+#include <rtems/config.h>
 
 Objects_Maximum _Objects_Active_count(
   const Objects_Information *information
@@ -30,6 +31,17 @@ Objects_Maximum _Objects_Active_count(
   _Assert( _Objects_Allocator_is_owner() );
 
   inactive = _Chain_Node_count_unprotected( &information->Inactive );
+
+  if ( information->inactive_caches != NULL ) {
+    uint32_t cpu_max;
+    uint32_t cpu_index;
+
+    cpu_max = rtems_configuration_get_maximum_processors();
+
+    for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+      inactive += information->inactive_caches[ cpu_index ].count;
+    }
+  }
   maximum  = information->maximum;
 
   return (Objects_Maximum) ( maximum - inactive );
@@ -33,6 +33,10 @@ static Objects_Control *_Objects_Get_inactive(
   Objects_Information *information
 )
 {
+  if ( information->inactive_caches != NULL ) {
+    return _Objects_Inactive_cache_get( information );
+  }
+
   return (Objects_Control *) _Chain_Get_unprotected( &information->Inactive );
 }
 
@@ -25,6 +25,7 @@ void _Objects_Close(
   Objects_Control           *the_object
 )
 {
+  _Objects_Name_index_remove( information, the_object );
   _Objects_Invalidate_Id( information, the_object );
 
   _Objects_Namespace_remove_u32( information, the_object );
@@ -25,6 +25,7 @@
 #include <rtems/score/isrlevel.h>
 #include <rtems/score/sysstate.h>
 #include <rtems/score/wkspace.h>
+#include <rtems/config.h>
 
 #include <string.h>  /* for memcpy() */
 
@@ -113,14 +114,17 @@ void _Objects_Extend_information(
    *  Do we need to grow the tables?
    */
   if ( do_extend ) {
-    ISR_lock_Context  lock_context;
-    Objects_Control **object_blocks;
-    Objects_Control **local_table;
-    Objects_Maximum  *inactive_per_block;
-    void             *old_tables;
-    size_t            table_size;
-    uintptr_t         object_blocks_size;
-    uintptr_t         local_table_size;
+    ISR_lock_Context    lock_context;
+    Objects_Control   **object_blocks;
+    Objects_Control   **local_table;
+    Objects_Maximum    *inactive_per_block;
+    Objects_Name_index *name_index;
+    void               *old_tables;
+    size_t              table_size;
+    uintptr_t           object_blocks_size;
+    uintptr_t           local_table_size;
+    uintptr_t           inactive_per_block_size;
+    uintptr_t           name_index_size;
 
     /*
      *  Growing the tables means allocating a new area, doing a copy and
@@ -131,9 +135,10 @@ void _Objects_Extend_information(
      *
      *  The allocation has:
      *
-     *      Objects_Control *object_blocks[ block_count ];
-     *      Objects_Control *local_table[ maximum ];
-     *      Objects_Maximum  inactive_count[ block_count ];
+     *      Objects_Control    *object_blocks[ block_count ];
+     *      Objects_Control    *local_table[ maximum ];
+     *      Objects_Name_index  name_index;
+     *      Objects_Maximum     inactive_count[ block_count ];
      *
      *  This is the order in memory. Watch changing the order. See the memcpy
      *  below.
@@ -149,9 +154,18 @@ void _Objects_Extend_information(
      */
     object_blocks_size = block_count * sizeof( *object_blocks );
     local_table_size = ( maximum + minimum_index ) * sizeof( *local_table );
+    inactive_per_block_size = block_count * sizeof( *inactive_per_block );
+
+    if ( rtems_configuration_get_objects_name_index() ) {
+      name_index_size = _Objects_Name_index_size( maximum );
+    } else {
+      name_index_size = 0;
+    }
+
     table_size = object_blocks_size
       + local_table_size
-      + block_count * sizeof( *inactive_per_block );
+      + inactive_per_block_size
+      + name_index_size;
     if ( information->auto_extend ) {
       object_blocks = _Workspace_Allocate( table_size );
       if ( !object_blocks ) {
@@ -169,9 +183,23 @@ void _Objects_Extend_information(
       object_blocks,
       object_blocks_size
     );
+
+    /*
+     *  The name index follows the pointer aligned local table, since it
+     *  starts with a 32-bit generation.
+     */
+    if ( name_index_size != 0 ) {
+      name_index = _Addresses_Add_offset(
+        local_table,
+        local_table_size
+      );
+    } else {
+      name_index = NULL;
+    }
+
     inactive_per_block = _Addresses_Add_offset(
       local_table,
-      local_table_size
+      local_table_size + name_index_size
     );
 
     /*
@@ -216,6 +244,15 @@ void _Objects_Extend_information(
       local_table[ index ] = NULL;
     }
 
+    if ( name_index != NULL ) {
+      _Objects_Name_index_build(
+        information,
+        local_table,
+        maximum,
+        name_index
+      );
+    }
+
     /* FIXME: https://devel.rtems.org/ticket/2280 */
     _ISR_lock_ISR_disable( &lock_context );
 
@@ -224,6 +261,7 @@ void _Objects_Extend_information(
     information->object_blocks = object_blocks;
     information->inactive_per_block = inactive_per_block;
     information->local_table = local_table;
+    information->name_index = name_index;
     information->maximum = (Objects_Maximum) maximum;
     information->maximum_id = _Objects_Build_id(
       information->the_api,
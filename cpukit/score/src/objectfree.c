@@ -31,7 +31,11 @@ void _Objects_Free(
 
   _Assert( _Objects_Allocator_is_owner() );
 
-  _Chain_Append_unprotected( &information->Inactive, &the_object->Node );
+  if ( information->inactive_caches != NULL ) {
+    _Objects_Inactive_cache_put( information, the_object );
+  } else {
+    _Chain_Append_unprotected( &information->Inactive, &the_object->Node );
+  }
 
   if ( information->auto_extend ) {
     uint32_t    block;
@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * @ingroup ScoreObject
+ *
+ * @brief Per-Processor Caches of Inactive Objects
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/objectimpl.h>
+#include <rtems/score/assert.h>
+#include <rtems/score/chainimpl.h>
+#include <rtems/score/smp.h>
+#include <rtems/score/sysstate.h>
+#include <rtems/score/wkspace.h>
+#include <rtems/config.h>
+
+/*
+ * The caches do not avoid the object allocator mutex, since the object
+ * creation and deletion needs it for other resources, e.g. the thread stacks.
+ * They only move the inactive objects between the processors and the inactive
+ * chain in batches.
+ *
+ * The object identifiers have no generation count, so an identifier of a
+ * deleted object must be reused as late as possible to not alias a new object
+ * through an identifier still held by the application.  Each cache is
+ * therefore a first in, first out queue like the inactive chain.  Objects are
+ * freed to the tail and allocated from the head.  A full cache returns its
+ * most recently freed objects to the tail of the inactive chain.
+ */
+
+static Objects_Inactive_cache *_Objects_Get_inactive_cache(
+  const Objects_Information *information
+)
+{
+  return &information->inactive_caches[ _SMP_Get_current_processor() ];
+}
+
+static void _Objects_Move_inactive(
+  Chain_Control *to,
+  Chain_Node    *node
+)
+{
+  _Chain_Extract_unprotected( node );
+  _Chain_Append_unprotected( to, node );
+}
+
+void _Objects_Initialize_inactive_caches(
+  Objects_Information *information
+)
+{
+  Objects_Inactive_cache *caches;
+  uint32_t                cpu_max;
+  uint32_t                cpu_index;
+
+  cpu_max = rtems_configuration_get_maximum_processors();
+
+  if ( !rtems_configuration_get_objects_inactive_cache() || cpu_max <= 1 ) {
+    return;
+  }
+
+  caches = _Workspace_Allocate_or_fatal_error( cpu_max * sizeof( *caches ) );
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    _Chain_Initialize_empty( &caches[ cpu_index ].Inactive );
+    caches[ cpu_index ].count = 0;
+  }
+
+  information->inactive_caches = caches;
+}
+
+Objects_Control *_Objects_Inactive_cache_get(
+  Objects_Information *information
+)
+{
+  Objects_Inactive_cache *cache;
+
+  _Assert(
+    _Objects_Allocator_is_owner()
+      || !_System_state_Is_up( _System_state_Get() )
+  );
+
+  cache = _Objects_Get_inactive_cache( information );
+
+  if ( cache->count == 0 ) {
+    Chain_Control *inactive;
+
+    inactive = &information->Inactive;
+
+    while (
+      cache->count < OBJECTS_INACTIVE_CACHE_BATCH
+        && !_Chain_Is_empty( inactive )
+    ) {
+      _Objects_Move_inactive( &cache->Inactive, _Chain_First( inactive ) );
+      ++cache->count;
+    }
+  }
+
+  if ( cache->count == 0 ) {
+    uint32_t cpu_max;
+    uint32_t cpu_index;
+
+    cpu_max = rtems_configuration_get_maximum_processors();
+
+    for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+      cache = &information->inactive_caches[ cpu_index ];
+
+      if ( cache->count > 0 ) {
+        break;
+      }
+    }
+
+    if ( cache->count == 0 ) {
+      return NULL;
+    }
+  }
+
+  --cache->count;
+  return (Objects_Control *) _Chain_Get_first_unprotected( &cache->Inactive );
+}
+
+void _Objects_Inactive_cache_put(
+  Objects_Information *information,
+  Objects_Control     *the_object
+)
+{
+  Objects_Inactive_cache *cache;
+
+  _Assert( _Objects_Allocator_is_owner() );
+
+  cache = _Objects_Get_inactive_cache( information );
+  _Chain_Append_unprotected( &cache->Inactive, &the_object->Node );
+  ++cache->count;
+
+  if ( cache->count > 2 * OBJECTS_INACTIVE_CACHE_BATCH ) {
+    Chain_Node *node;
+    uint32_t    i;
+
+    node = _Chain_Last( &cache->Inactive );
+
+    for ( i = 1; i < OBJECTS_INACTIVE_CACHE_BATCH; ++i ) {
+      node = _Chain_Previous( node );
+    }
+
+    for ( i = 0; i < OBJECTS_INACTIVE_CACHE_BATCH; ++i ) {
+      Chain_Node *next;
+
+      next = _Chain_Next( node );
+      _Objects_Move_inactive( &information->Inactive, node );
+      node = next;
+    }
+
+    cache->count -= OBJECTS_INACTIVE_CACHE_BATCH;
+  }
+}
+
+void _Objects_Flush_inactive_caches( Objects_Information *information )
+{
+  uint32_t cpu_max;
+  uint32_t cpu_index;
+
+  if ( information->inactive_caches == NULL ) {
+    return;
+  }
+
+  cpu_max = rtems_configuration_get_maximum_processors();
+
+  for ( cpu_index = 0; cpu_index < cpu_max; ++cpu_index ) {
+    Objects_Inactive_cache *cache;
+
+    cache = &information->inactive_caches[ cpu_index ];
+
+    while ( !_Chain_Is_empty( &cache->Inactive ) ) {
+      _Objects_Move_inactive(
+        &information->Inactive,
+        _Chain_First( &cache->Inactive )
+      );
+    }
+
+    cache->count = 0;
+  }
+}
@@ -48,6 +48,8 @@ void _Objects_Do_initialize_information(
   information->local_table        = 0;
   information->inactive_per_block = 0;
   information->object_blocks      = 0;
+  information->name_index         = NULL;
+  information->inactive_caches    = NULL;
   information->inactive           = 0;
   information->is_string          = is_string;
 
@@ -113,6 +115,7 @@ void _Objects_Do_initialize_information(
      *  figures are create are met.  If the user moves past the maximum
      *  number then a performance hit is taken.
      */
+    _Objects_Initialize_inactive_caches( information );
     _Objects_Extend_information( information );
   }
 
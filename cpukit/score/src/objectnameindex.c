@@ -0,0 +1,395 @@
+/**
+ * @file
+ *
+ * @ingroup ScoreObject
+ *
+ * @brief Object Name Index
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/objectimpl.h>
+#include <rtems/score/atomic.h>
+#include <rtems/score/sysstate.h>
+
+#include <string.h>
+
+/*
+ * The name index is a hash table with separate chaining.  The chains are
+ * formed by object indices, so that the object control blocks need no
+ * additional link field.  The chains are sorted by ascending object index, so
+ * that a lookup returns the object with the lowest index of all objects with
+ * the requested name, just like the linear search of the local table.
+ *
+ * An insert or remove modifies at most one index entry which is visible to a
+ * concurrent lookup, so lookups need no lock.  The entry is stored with
+ * release semantics and loaded with acquire semantics, so that a lookup which
+ * observes an inserted index also observes its chain successor and the name
+ * of the object.  The successor of a removed index is cleared, so that a
+ * lookup cannot follow a stale successor after the index was reused.  Each
+ * chain successor is greater than its index at any time, so a lookup always
+ * terminates.
+ *
+ * A lookup which stands on a removed index or follows a moved index ends
+ * early and may miss an object of the chain.  Inserts and removes therefore
+ * update the generation of the name index like a sequence lock.  A lookup
+ * which found no object is repeated if the generation was odd at the start
+ * or changed during the lookup.  Lookups of string names are done with the
+ * object allocator lock owned and need no retry.
+ */
+
+#define NAME_INDEX_MASK( name_index ) ( name_index )->bucket_mask
+
+#define NAME_INDEX_BUCKETS( name_index ) ( &( name_index )->entries[ 0 ] )
+
+#define NAME_INDEX_NEXT( name_index ) \
+  ( &( name_index )->entries[ 1 + NAME_INDEX_MASK( name_index ) ] )
+
+static Objects_Maximum _Objects_Name_index_load_acquire(
+  const Objects_Maximum *entry
+)
+{
+  Objects_Maximum index;
+
+  index = *(const volatile Objects_Maximum *) entry;
+  _Atomic_Fence( ATOMIC_ORDER_ACQUIRE );
+
+  return index;
+}
+
+static void _Objects_Name_index_store_release(
+  Objects_Maximum *entry,
+  Objects_Maximum  index
+)
+{
+  _Atomic_Fence( ATOMIC_ORDER_RELEASE );
+  *(volatile Objects_Maximum *) entry = index;
+}
+
+static void _Objects_Name_index_begin_update( Objects_Name_index *name_index )
+{
+  volatile uint32_t *generation;
+
+  generation = &name_index->generation;
+  *generation = *generation + 1;
+  _Atomic_Fence( ATOMIC_ORDER_RELEASE );
+}
+
+static void _Objects_Name_index_end_update( Objects_Name_index *name_index )
+{
+  volatile uint32_t *generation;
+
+  generation = &name_index->generation;
+  _Atomic_Fence( ATOMIC_ORDER_RELEASE );
+  *generation = *generation + 1;
+}
+
+static uint32_t _Objects_Name_index_read_begin(
+  const Objects_Name_index *name_index
+)
+{
+  uint32_t generation;
+
+  generation = *(const volatile uint32_t *) &name_index->generation;
+  _Atomic_Fence( ATOMIC_ORDER_ACQUIRE );
+
+  return generation;
+}
+
+static bool _Objects_Name_index_read_retry(
+  const Objects_Name_index *name_index,
+  uint32_t                  generation
+)
+{
+  _Atomic_Fence( ATOMIC_ORDER_ACQUIRE );
+
+  return ( generation & 1 ) != 0
+    || *(const volatile uint32_t *) &name_index->generation != generation;
+}
+
+static uint32_t _Objects_Name_index_hash_u32( uint32_t name )
+{
+  uint32_t h;
+
+  h = name * UINT32_C( 2654435761 );
+  return h ^ ( h >> 16 );
+}
+
+static uint32_t _Objects_Name_index_hash_string(
+  const char *name,
+  size_t      name_length
+)
+{
+  uint32_t h;
+  size_t   i;
+
+  h = UINT32_C( 2166136261 );
+
+  for ( i = 0; i < name_length; ++i ) {
+    h ^= (unsigned char) name[ i ];
+    h *= UINT32_C( 16777619 );
+  }
+
+  return h;
+}
+
+static bool _Objects_Name_index_hash_object(
+  const Objects_Information *information,
+  const Objects_Control     *the_object,
+  uint32_t                  *hash
+)
+{
+  if ( information->is_string ) {
+    const char *name;
+
+    name = the_object->name.name_p;
+
+    if ( name == NULL ) {
+      return false;
+    }
+
+    *hash = _Objects_Name_index_hash_string(
+      name,
+      strnlen( name, information->name_length )
+    );
+  } else {
+    uint32_t name;
+
+    name = the_object->name.name_u32;
+
+    if ( name == 0 ) {
+      return false;
+    }
+
+    *hash = _Objects_Name_index_hash_u32( name );
+  }
+
+  return true;
+}
+
+static uint32_t _Objects_Name_index_bucket_count( uint32_t maximum )
+{
+  uint32_t count;
+
+  count = 1;
+
+  while ( count < maximum ) {
+    count <<= 1;
+  }
+
+  return count;
+}
+
+size_t _Objects_Name_index_size( uint32_t maximum )
+{
+  return sizeof( Objects_Name_index )
+    + ( _Objects_Name_index_bucket_count( maximum ) + maximum + 1 )
+      * sizeof( Objects_Maximum );
+}
+
+void _Objects_Name_index_build(
+  const Objects_Information  *information,
+  Objects_Control           **local_table,
+  uint32_t                    maximum,
+  Objects_Name_index         *name_index
+)
+{
+  uint32_t         bucket_mask;
+  Objects_Maximum *buckets;
+  Objects_Maximum *next;
+  uint32_t         index;
+
+  bucket_mask = _Objects_Name_index_bucket_count( maximum ) - 1;
+  memset( name_index, 0, _Objects_Name_index_size( maximum ) );
+  NAME_INDEX_MASK( name_index ) = (Objects_Maximum) bucket_mask;
+  buckets = NAME_INDEX_BUCKETS( name_index );
+  next = NAME_INDEX_NEXT( name_index );
+
+  /*
+   * Insert at the chain heads in descending index order to get chains sorted
+   * by ascending index.
+   */
+  for ( index = maximum; index >= 1; --index ) {
+    const Objects_Control *the_object;
+    uint32_t               hash;
+
+    the_object = local_table[ index ];
+
+    if (
+      the_object != NULL
+        && _Objects_Name_index_hash_object( information, the_object, &hash )
+    ) {
+      hash &= bucket_mask;
+      next[ index ] = buckets[ hash ];
+      buckets[ hash ] = (Objects_Maximum) index;
+    }
+  }
+}
+
+void _Objects_Name_index_insert(
+  const Objects_Information *information,
+  Objects_Control           *the_object
+)
+{
+  Objects_Name_index *name_index;
+  uint32_t            hash;
+  Objects_Maximum     index;
+  Objects_Maximum    *next;
+  Objects_Maximum    *previous;
+
+  _Assert( _Objects_Has_name_index( information ) );
+  _Assert(
+    _Objects_Allocator_is_owner()
+      || !_System_state_Is_up( _System_state_Get() )
+  );
+
+  if ( !_Objects_Name_index_hash_object( information, the_object, &hash ) ) {
+    return;
+  }
+
+  name_index = information->name_index;
+  index = _Objects_Get_index( the_object->id );
+  next = NAME_INDEX_NEXT( name_index );
+  previous = &NAME_INDEX_BUCKETS( name_index )[
+    hash & NAME_INDEX_MASK( name_index )
+  ];
+
+  while ( *previous != 0 && *previous < index ) {
+    previous = &next[ *previous ];
+  }
+
+  _Objects_Name_index_begin_update( name_index );
+  next[ index ] = *previous;
+  _Objects_Name_index_store_release( previous, index );
+  _Objects_Name_index_end_update( name_index );
+}
+
+void _Objects_Name_index_remove(
+  const Objects_Information *information,
+  Objects_Control           *the_object
+)
+{
+  Objects_Name_index *name_index;
+  uint32_t            hash;
+  Objects_Maximum     index;
+  Objects_Maximum    *next;
+  Objects_Maximum    *previous;
+
+  name_index = information->name_index;
+
+  if ( name_index == NULL ) {
+    return;
+  }
+
+  if ( !_Objects_Name_index_hash_object( information, the_object, &hash ) ) {
+    return;
+  }
+
+  index = _Objects_Get_index( the_object->id );
+  next = NAME_INDEX_NEXT( name_index );
+  previous = &NAME_INDEX_BUCKETS( name_index )[
+    hash & NAME_INDEX_MASK( name_index )
+  ];
+
+  while ( *previous != 0 ) {
+    if ( *previous == index ) {
+      _Objects_Name_index_begin_update( name_index );
+      _Objects_Name_index_store_release( previous, next[ index ] );
+      next[ index ] = 0;
+      _Objects_Name_index_end_update( name_index );
+      return;
+    }
+
+    previous = &next[ *previous ];
+  }
+}
+
+Objects_Control *_Objects_Name_index_find_u32(
+  const Objects_Information *information,
+  uint32_t                   name
+)
+{
+  const Objects_Name_index *name_index;
+  uint32_t                  hash;
+  uint32_t                  generation;
+
+  name_index = information->name_index;
+  hash = _Objects_Name_index_hash_u32( name ) & NAME_INDEX_MASK( name_index );
+
+  do {
+    uint32_t index;
+
+    generation = _Objects_Name_index_read_begin( name_index );
+    index = _Objects_Name_index_load_acquire(
+      &NAME_INDEX_BUCKETS( name_index )[ hash ]
+    );
+
+    while ( index != 0 ) {
+      Objects_Control *the_object;
+
+      the_object = information->local_table[ index ];
+
+      if ( the_object != NULL && the_object->name.name_u32 == name ) {
+        return the_object;
+      }
+
+      index = _Objects_Name_index_load_acquire(
+        &NAME_INDEX_NEXT( name_index )[ index ]
+      );
+    }
+  } while ( _Objects_Name_index_read_retry( name_index, generation ) );
+
+  return NULL;
+}
+
+Objects_Control *_Objects_Name_index_find_string(
+  const Objects_Information *information,
+  const char                *name,
+  size_t                     name_length
+)
+{
+  const Objects_Name_index *name_index;
+  uint32_t                  hash;
+  uint32_t                  index;
+
+  _Assert( _Objects_Allocator_is_owner() );
+
+  name_index = information->name_index;
+  hash = _Objects_Name_index_hash_string( name, name_length )
+    & NAME_INDEX_MASK( name_index );
+  index = _Objects_Name_index_load_acquire(
+    &NAME_INDEX_BUCKETS( name_index )[ hash ]
+  );
+
+  while ( index != 0 ) {
+    Objects_Control *the_object;
+
+    the_object = information->local_table[ index ];
+
+    if (
+      the_object != NULL
+        && the_object->name.name_p != NULL
+        && strncmp(
+          name,
+          the_object->name.name_p,
+          information->name_length
+        ) == 0
+    ) {
+      return the_object;
+    }
+
+    index = _Objects_Name_index_load_acquire(
+      &NAME_INDEX_NEXT( name_index )[ index ]
+    );
+  }
+
+  return NULL;
+}
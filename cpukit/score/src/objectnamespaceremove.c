@@ -28,6 +28,7 @@ void _Objects_Namespace_remove_u32(
 )
 {
   _Assert( !information->is_string );
+  _Objects_Name_index_remove( information, the_object );
   the_object->name.name_u32 = 0;
 }
 
@@ -39,6 +40,7 @@ void _Objects_Namespace_remove_string(
   char *name;
 
   _Assert( information->is_string );
+  _Objects_Name_index_remove( information, the_object );
   name = RTEMS_DECONST( char *, the_object->name.name_p );
   the_object->name.name_p = NULL;
   _Workspace_Free( name );
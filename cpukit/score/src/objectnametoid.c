@@ -51,7 +51,13 @@ Objects_Name_or_id_lookup_errors _Objects_Name_to_id_u32(
       ))
    search_local_node = true;
 
-  if ( search_local_node ) {
+  if ( search_local_node && _Objects_Has_name_index( information ) ) {
+    the_object = _Objects_Name_index_find_u32( information, name );
+    if ( the_object != NULL ) {
+      *id = the_object->id;
+      return OBJECTS_NAME_OR_ID_LOOKUP_SUCCESSFUL;
+    }
+  } else if ( search_local_node ) {
     for ( index = 1; index <= information->maximum; index++ ) {
       the_object = information->local_table[ index ];
       if ( !the_object )
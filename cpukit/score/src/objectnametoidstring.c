@@ -52,6 +52,23 @@ Objects_Control *_Objects_Get_by_name(
     *name_length_p = name_length;
   }
 
+  if ( _Objects_Has_name_index( information ) ) {
+    Objects_Control *the_object;
+
+    the_object = _Objects_Name_index_find_string(
+      information,
+      name,
+      name_length
+    );
+
+    if ( the_object != NULL ) {
+      return the_object;
+    }
+
+    *error = OBJECTS_GET_BY_NAME_NO_OBJECT;
+    return NULL;
+  }
+
   for ( index = 1; index <= information->maximum; index++ ) {
     Objects_Control *the_object;
 
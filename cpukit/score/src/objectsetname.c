@@ -42,6 +42,7 @@ bool _Objects_Set_name(
     if ( !d )
       return false;
 
+    _Objects_Name_index_remove( information, the_object );
     _Workspace_Free( (void *)the_object->name.name_p );
     the_object->name.name_p = NULL;
 
@@ -49,6 +50,7 @@ bool _Objects_Set_name(
     d[length] = '\0';
     the_object->name.name_p = d;
   } else {
+    _Objects_Name_index_remove( information, the_object );
     the_object->name.name_u32 =  _Objects_Build_name(
       ((length)     ? s[ 0 ] : ' '),
       ((length > 1) ? s[ 1 ] : ' '),
@@ -57,5 +59,13 @@ bool _Objects_Set_name(
     );
   }
 
+  if (
+    _Objects_Has_name_index( information )
+      && information->local_table[ _Objects_Get_index( the_object->id ) ]
+        == the_object
+  ) {
+    _Objects_Name_index_insert( information, the_object );
+  }
+
   return true;
 }
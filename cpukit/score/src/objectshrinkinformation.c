@@ -44,10 +44,18 @@ void _Objects_Shrink_information(
   for ( block = 0; block < block_count; block++ ) {
     if ( information->inactive_per_block[ block ] ==
          information->allocation_size ) {
-      Chain_Node       *node = _Chain_First( &information->Inactive );
-      const Chain_Node *tail = _Chain_Immutable_tail( &information->Inactive );
+      Chain_Node       *node;
+      const Chain_Node *tail;
       uint32_t          index_end = index_base + information->allocation_size;
 
+      /*
+       *  Objects of the block may reside in the per-processor caches
+       */
+      _Objects_Flush_inactive_caches( information );
+
+      node = _Chain_First( &information->Inactive );
+      tail = _Chain_Immutable_tail( &information->Inactive );
+
       while ( node != tail ) {
         Objects_Control *object = (Objects_Control *) node;
         uint32_t         index = _Objects_Get_index( object->id );
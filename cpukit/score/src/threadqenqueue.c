@@ -26,6 +26,7 @@
 #include <rtems/score/threadimpl.h>
 #include <rtems/score/status.h>
 #include <rtems/score/watchdogimpl.h>
+#include <rtems/sysinit.h>
 
 #define THREAD_QUEUE_INTEND_TO_BLOCK \
   (THREAD_WAIT_CLASS_OBJECT | THREAD_WAIT_STATE_INTEND_TO_BLOCK)
@@ -38,70 +39,120 @@
 
 #if defined(RTEMS_SMP)
 /*
- * A global registry of active thread queue links is used to provide deadlock
+ * A registry of active thread queue links is used to provide deadlock
  * detection on SMP configurations.  This is simple to implement and no
- * additional storage is required for the thread queues.  The disadvantage is
- * the global registry is not scalable and may lead to lock contention.
- * However, the registry is only used in case of nested resource conflicts.  In
- * this case, the application is already in trouble.
+ * additional storage is required for the thread queues.  The registry is only
+ * used in case of nested resource conflicts.
+ *
+ * The links are kept in hash buckets indexed by the source thread queue.  Each
+ * bucket has its own lock and there is no registry-wide lock.  A link exists
+ * only while its owner acquires or releases a thread queue path, so the count
+ * of links is bounded by the processor count times the nesting depth and the
+ * bucket count is derived from the processor count.
+ *
+ * To add a link, it is first inserted into its bucket in the pending state.
+ * Afterwards, the path starting at the target is walked.  The fence between
+ * the insertion and the walk ensures that of two concurrent additions closing
+ * a cycle at least one sees the link of the other.  In case the walk returns
+ * to the source, there is a deadlock.  It is reported by exactly one addition:
+ * the one with the lowest link address of the pending links in the cycle.  An
+ * addition which sees a pending link with a lower address in the cycle walks
+ * the path again until the state of this link changes.
  */
 
+#define THREAD_QUEUE_LINKS_BUCKET_COUNT ( 2 * CPU_MAXIMUM_PROCESSORS )
+
 typedef struct {
-  ISR_lock_Control Lock;
+  ISR_lock_Control Lock RTEMS_ALIGNED( CPU_CACHE_LINE_BYTES );
 
-  RBTree_Control Links;
-} Thread_queue_Links;
+  Thread_queue_Link *first;
+} Thread_queue_Links_bucket;
 
-static Thread_queue_Links _Thread_queue_Links = {
-  ISR_LOCK_INITIALIZER( "Thread Queue Links" ),
-  RBTREE_INITIALIZER_EMPTY( _Thread_queue_Links.Links )
-};
+static Thread_queue_Links_bucket
+_Thread_queue_Links[ THREAD_QUEUE_LINKS_BUCKET_COUNT ];
 
-static bool _Thread_queue_Link_equal(
-  const void        *left,
-  const RBTree_Node *right
-)
+static void _Thread_queue_Links_initialize( void )
 {
-  const Thread_queue_Queue *the_left;
-  const Thread_queue_Link  *the_right;
+  size_t i;
 
-  the_left = left;
-  the_right = (Thread_queue_Link *) right;
-
-  return the_left == the_right->source;
+  for ( i = 0; i < THREAD_QUEUE_LINKS_BUCKET_COUNT; ++i ) {
+    _ISR_lock_Initialize(
+      &_Thread_queue_Links[ i ].Lock,
+      "Thread Queue Links"
+    );
+  }
 }
 
-static bool _Thread_queue_Link_less(
-  const void        *left,
-  const RBTree_Node *right
+RTEMS_SYSINIT_ITEM(
+  _Thread_queue_Links_initialize,
+  RTEMS_SYSINIT_DATA_STRUCTURES,
+  RTEMS_SYSINIT_ORDER_FIRST
+);
+
+static Thread_queue_Links_bucket *_Thread_queue_Links_get_bucket(
+  const Thread_queue_Queue *source
 )
 {
-  const Thread_queue_Queue *the_left;
-  const Thread_queue_Link  *the_right;
+  uint32_t hash;
 
-  the_left = left;
-  the_right = (Thread_queue_Link *) right;
+  hash = (uint32_t) ( (uintptr_t) source / sizeof( *source ) );
+  hash *= UINT32_C( 2654435761 );
 
-  return (uintptr_t) the_left < (uintptr_t) the_right->source;
+  return &_Thread_queue_Links[ hash % THREAD_QUEUE_LINKS_BUCKET_COUNT ];
 }
 
-static void *_Thread_queue_Link_map( RBTree_Node *node )
+static Thread_queue_Queue *_Thread_queue_Link_find_target(
+  Thread_queue_Queue        *source,
+  const Thread_queue_Link  **pending
+)
 {
-  return node;
+  Thread_queue_Links_bucket *bucket;
+  Thread_queue_Link         *link;
+  Thread_queue_Queue        *target;
+  ISR_lock_Context           lock_context;
+
+  bucket = _Thread_queue_Links_get_bucket( source );
+  target = NULL;
+  *pending = NULL;
+
+  _ISR_lock_Acquire( &bucket->Lock, &lock_context );
+
+  for ( link = bucket->first; link != NULL; link = link->Registry_next ) {
+    if ( link->source == source ) {
+      target = link->target;
+
+      if ( link->Registry_pending ) {
+        *pending = link;
+      }
+
+      break;
+    }
+  }
+
+  _ISR_lock_Release( &bucket->Lock, &lock_context );
+  return target;
 }
 
-static Thread_queue_Link *_Thread_queue_Link_find(
-  Thread_queue_Links *links,
-  Thread_queue_Queue *source
-)
+static void _Thread_queue_Link_remove( Thread_queue_Link *link )
 {
-  return _RBTree_Find_inline(
-    &links->Links,
-    source,
-    _Thread_queue_Link_equal,
-    _Thread_queue_Link_less,
-    _Thread_queue_Link_map
-  );
+  Thread_queue_Links_bucket  *bucket;
+  Thread_queue_Link         **previous;
+  ISR_lock_Context            lock_context;
+
+  bucket = _Thread_queue_Links_get_bucket( link->source );
+
+  _ISR_lock_Acquire( &bucket->Lock, &lock_context );
+
+  previous = &bucket->first;
+
+  while ( *previous != link ) {
+    _Assert( *previous != NULL );
+    previous = &( *previous )->Registry_next;
+  }
+
+  *previous = link->Registry_next;
+
+  _ISR_lock_Release( &bucket->Lock, &lock_context );
 }
 
 static bool _Thread_queue_Link_add(
@@ -110,56 +161,60 @@ static bool _Thread_queue_Link_add(
   Thread_queue_Queue *target
 )
 {
-  Thread_queue_Links *links;
-  Thread_queue_Queue *recursive_target;
-  ISR_lock_Context    lock_context;
+  Thread_queue_Links_bucket *bucket;
+  ISR_lock_Context           lock_context;
 
   link->source = source;
   link->target = target;
 
-  links = &_Thread_queue_Links;
-  recursive_target = target;
+  bucket = _Thread_queue_Links_get_bucket( source );
+  _ISR_lock_Acquire( &bucket->Lock, &lock_context );
+  link->Registry_pending = true;
+  link->Registry_next = bucket->first;
+  bucket->first = link;
+  _ISR_lock_Release( &bucket->Lock, &lock_context );
 
-  _ISR_lock_Acquire( &links->Lock, &lock_context );
+  _Atomic_Fence( ATOMIC_ORDER_SEQ_CST );
 
   while ( true ) {
-    Thread_queue_Link *recursive_link;
+    Thread_queue_Queue      *recursive_target;
+    const Thread_queue_Link *lowest_pending;
 
-    recursive_link = _Thread_queue_Link_find( links, recursive_target );
-
-    if ( recursive_link == NULL ) {
-      break;
-    }
+    recursive_target = target;
+    lowest_pending = link;
 
-    recursive_target = recursive_link->target;
+    while ( true ) {
+      const Thread_queue_Link *pending;
 
-    if ( recursive_target == source ) {
-      _ISR_lock_Release( &links->Lock, &lock_context );
-      return false;
-    }
-  }
-
-  _RBTree_Insert_inline(
-    &links->Links,
-    &link->Registry_node,
-    source,
-    _Thread_queue_Link_less
-  );
+      recursive_target = _Thread_queue_Link_find_target(
+        recursive_target,
+        &pending
+      );
 
-  _ISR_lock_Release( &links->Lock, &lock_context );
-  return true;
-}
+      if ( recursive_target == NULL ) {
+        _ISR_lock_Acquire( &bucket->Lock, &lock_context );
+        link->Registry_pending = false;
+        _ISR_lock_Release( &bucket->Lock, &lock_context );
+        return true;
+      }
 
-static void _Thread_queue_Link_remove( Thread_queue_Link *link )
-{
-  Thread_queue_Links *links;
-  ISR_lock_Context    lock_context;
+      if (
+        pending != NULL
+          && (uintptr_t) pending < (uintptr_t) lowest_pending
+      ) {
+        lowest_pending = pending;
+      }
 
-  links = &_Thread_queue_Links;
+      if ( recursive_target == source ) {
+        break;
+      }
+    }
 
-  _ISR_lock_Acquire( &links->Lock, &lock_context );
-  _RBTree_Extract( &links->Links, &link->Registry_node );
-  _ISR_lock_Release( &links->Lock, &lock_context );
+    if ( lowest_pending == link ) {
+      _Thread_queue_Link_remove( link );
+      return false;
+    }
+  }
 }
 #endif
 
@@ -286,7 +341,6 @@ bool _Thread_queue_Path_acquire_critical(
     &queue_context->Path.Start.Lock_context.Wait.Gate.Node
   );
   link = &queue_context->Path.Start;
-  _RBTree_Initialize_node( &link->Registry_node );
   _Chain_Initialize_node( &link->Path_node );
 
   do {
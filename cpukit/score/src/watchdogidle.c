@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @ingroup ScoreWatchdog
+ *
+ * @brief Watchdog Support for Tickless Idle
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/watchdogimpl.h>
+#include <rtems/score/smpimpl.h>
+#include <rtems/score/thread.h>
+#include <rtems/score/threaddispatch.h>
+#include <rtems/score/timecounter.h>
+
+static uint32_t _Watchdog_Idle_ticks_of_ticks(
+  const Watchdog_Header *header,
+  uint64_t               ticks,
+  uint32_t               maximum
+)
+{
+  const Watchdog_Control *first;
+  uint64_t                delta;
+
+  if ( header->wheel != NULL ) {
+    return _Watchdog_Wheel_idle_ticks( header->wheel, maximum );
+  }
+
+  first = _Watchdog_Header_first( header );
+
+  if ( first == NULL ) {
+    return maximum;
+  }
+
+  if ( first->expire <= ticks ) {
+    return 1;
+  }
+
+  delta = first->expire - ticks;
+  return delta < maximum ? (uint32_t) delta : maximum;
+}
+
+/*
+ * The clock tick which follows a point in time by N nanoseconds is at most N
+ * nanoseconds away, so rounding down yields a lower bound.
+ */
+static uint32_t _Watchdog_Idle_ticks_of_clock(
+  const Watchdog_Header *header,
+  const struct timespec *now,
+  uint32_t               maximum
+)
+{
+  const Watchdog_Control *first;
+  uint64_t                expire_seconds;
+  uint32_t                expire_nanoseconds;
+  uint64_t                delta;
+
+  first = _Watchdog_Header_first( header );
+
+  if ( first == NULL ) {
+    return maximum;
+  }
+
+  if ( first->expire <= _Watchdog_Ticks_from_timespec( now ) ) {
+    return 1;
+  }
+
+  expire_seconds = first->expire >> WATCHDOG_BITS_FOR_1E9_NANOSECONDS;
+  expire_nanoseconds = (uint32_t) first->expire
+    & ( ( 1U << WATCHDOG_BITS_FOR_1E9_NANOSECONDS ) - 1 );
+  delta = ( expire_seconds - (uint64_t) now->tv_sec )
+    * WATCHDOG_NANOSECONDS_PER_SECOND;
+  delta += expire_nanoseconds;
+  delta -= (uint32_t) now->tv_nsec;
+  delta /= _Watchdog_Nanoseconds_per_tick;
+
+  if ( delta == 0 ) {
+    return 1;
+  }
+
+  return delta < maximum ? (uint32_t) delta : maximum;
+}
+
+uint32_t _Watchdog_Get_idle_ticks( uint32_t maximum )
+{
+  const Per_CPU_Control *cpu_self;
+  struct timespec        uptime;
+  struct timespec        tod;
+  uint32_t               idle_ticks;
+  uint32_t               cpu_count;
+  uint32_t               cpu_index;
+
+  _Assert( maximum > 0 );
+  _Assert( !_Thread_Dispatch_is_enabled() );
+
+  cpu_self = _Per_CPU_Get();
+  _Timecounter_Getnanouptime( &uptime );
+  _Timecounter_Getnanotime( &tod );
+  idle_ticks = maximum;
+  cpu_count = _SMP_Get_processor_count();
+
+  for ( cpu_index = 0; cpu_index < cpu_count; ++cpu_index ) {
+    Per_CPU_Control  *cpu;
+    ISR_lock_Context  lock_context;
+
+    cpu = _Per_CPU_Get_by_index( cpu_index );
+
+    if ( !_Per_CPU_Is_processor_online( cpu ) ) {
+      continue;
+    }
+
+    /*
+     * The executing thread of another processor is only a snapshot.  A thread
+     * which starts to execute there afterwards may see a delayed time slice.
+     */
+    if ( cpu != cpu_self && !cpu->executing->is_idle ) {
+      return 1;
+    }
+
+    _ISR_lock_ISR_disable_and_acquire( &cpu->Watchdog.Lock, &lock_context );
+    idle_ticks = _Watchdog_Idle_ticks_of_ticks(
+      &cpu->Watchdog.Header[ PER_CPU_WATCHDOG_TICKS ],
+      cpu->Watchdog.ticks,
+      idle_ticks
+    );
+    idle_ticks = _Watchdog_Idle_ticks_of_clock(
+      &cpu->Watchdog.Header[ PER_CPU_WATCHDOG_MONOTONIC ],
+      &uptime,
+      idle_ticks
+    );
+    idle_ticks = _Watchdog_Idle_ticks_of_clock(
+      &cpu->Watchdog.Header[ PER_CPU_WATCHDOG_REALTIME ],
+      &tod,
+      idle_ticks
+    );
+    _ISR_lock_Release_and_ISR_enable( &cpu->Watchdog.Lock, &lock_context );
+  }
+
+  return idle_ticks;
+}
+
+void _Watchdog_Skip_ticks( uint32_t ticks )
+{
+  uint32_t cpu_count;
+  uint32_t cpu_index;
+
+  cpu_count = _SMP_Get_processor_count();
+
+  for ( cpu_index = 0; cpu_index < cpu_count; ++cpu_index ) {
+    Per_CPU_Control  *cpu;
+    ISR_lock_Context  lock_context;
+
+    cpu = _Per_CPU_Get_by_index( cpu_index );
+
+    if ( !_Per_CPU_Is_processor_online( cpu ) ) {
+      continue;
+    }
+
+    _ISR_lock_ISR_disable_and_acquire( &cpu->Watchdog.Lock, &lock_context );
+    cpu->Watchdog.ticks += ticks;
+    _ISR_lock_Release_and_ISR_enable( &cpu->Watchdog.Lock, &lock_context );
+  }
+
+  _Watchdog_Ticks_since_boot += ticks;
+}
@@ -73,7 +73,14 @@ void _Watchdog_Tick( Per_CPU_Control *cpu )
   header = &cpu->Watchdog.Header[ PER_CPU_WATCHDOG_TICKS ];
   first = _Watchdog_Header_first( header );
 
-  if ( first != NULL ) {
+  if ( header->wheel != NULL ) {
+    _Watchdog_Wheel_tickle(
+      header->wheel,
+      ticks,
+      &cpu->Watchdog.Lock,
+      &lock_context
+    );
+  } else if ( first != NULL ) {
     _Watchdog_Tickle(
       header,
       first,
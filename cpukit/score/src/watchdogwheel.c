@@ -0,0 +1,294 @@
+/**
+ * @file
+ *
+ * @ingroup ScoreWatchdog
+ *
+ * @brief Watchdog Timing Wheel
+ */
+
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/score/watchdogimpl.h>
+#include <rtems/score/chainimpl.h>
+#include <rtems/score/percpudata.h>
+#include <rtems/score/smp.h>
+
+/*
+ * A watchdog is placed on the lowest level which covers the distance between
+ * its expiration time and the next clock tick to process.  Within a level the
+ * slot is selected by the corresponding bits of the expiration time.  Each
+ * time the index of a level wraps around, the current slot of the next higher
+ * level is cascaded, i.e. its watchdogs are distributed to the lower levels.
+ * So the slot of level zero which belongs to the current clock tick contains
+ * exactly the watchdogs which expire with this clock tick.
+ */
+
+#define WATCHDOG_WHEEL_SLOT_MASK ( WATCHDOG_WHEEL_SLOT_COUNT - 1 )
+
+static PER_CPU_DATA_ITEM( Watchdog_Wheel, _Watchdog_Wheel );
+
+static uint32_t _Watchdog_Wheel_index( uint64_t ticks, uint32_t level )
+{
+  return (uint32_t) ( ticks >> ( level * WATCHDOG_WHEEL_SLOT_BITS ) )
+    & WATCHDOG_WHEEL_SLOT_MASK;
+}
+
+/*
+ * Returns the chain for the watchdog relative to the clock tick base, which
+ * is the next clock tick to process.
+ */
+static Chain_Control *_Watchdog_Wheel_chain(
+  Watchdog_Wheel *wheel,
+  uint64_t        expire,
+  uint64_t        base
+)
+{
+  uint64_t delta;
+  uint32_t level;
+
+  if ( expire <= base ) {
+    return &wheel->Slots[ 0 ][ _Watchdog_Wheel_index( base, 0 ) ];
+  }
+
+  delta = expire - base;
+
+  for ( level = 0; level < WATCHDOG_WHEEL_LEVEL_COUNT; ++level ) {
+    delta >>= WATCHDOG_WHEEL_SLOT_BITS;
+
+    if ( delta == 0 ) {
+      return &wheel->Slots[ level ][ _Watchdog_Wheel_index( expire, level ) ];
+    }
+  }
+
+  return &wheel->Overflow;
+}
+
+/*
+ * Moves all nodes of the source chain to the empty destination chain.
+ */
+static void _Watchdog_Wheel_move( Chain_Control *to, Chain_Control *from )
+{
+  Chain_Node *head;
+  Chain_Node *tail;
+  Chain_Node *first;
+  Chain_Node *last;
+
+  if ( _Chain_Is_empty( from ) ) {
+    return;
+  }
+
+  head = _Chain_Head( to );
+  tail = _Chain_Tail( to );
+  first = _Chain_First( from );
+  last = _Chain_Last( from );
+  head->next = first;
+  first->previous = head;
+  last->next = tail;
+  tail->previous = last;
+  _Chain_Initialize_empty( from );
+}
+
+static void _Watchdog_Wheel_cascade(
+  Watchdog_Wheel *wheel,
+  Chain_Control  *chain,
+  uint64_t        base
+)
+{
+  Chain_Control  pending;
+  Chain_Node    *node;
+
+  _Chain_Initialize_empty( &pending );
+  _Watchdog_Wheel_move( &pending, chain );
+
+  while ( ( node = _Chain_Get_unprotected( &pending ) ) != NULL ) {
+    Watchdog_Control *the_watchdog;
+
+    the_watchdog = RTEMS_CONTAINER_OF( node, Watchdog_Control, Node.Chain );
+    _Chain_Append_unprotected(
+      _Watchdog_Wheel_chain( wheel, the_watchdog->expire, base ),
+      node
+    );
+  }
+}
+
+static void _Watchdog_Wheel_advance( Watchdog_Wheel *wheel, uint64_t base )
+{
+  uint32_t level;
+
+  for ( level = 1; level < WATCHDOG_WHEEL_LEVEL_COUNT; ++level ) {
+    uint32_t index;
+
+    index = _Watchdog_Wheel_index( base, level );
+    _Watchdog_Wheel_cascade( wheel, &wheel->Slots[ level ][ index ], base );
+
+    if ( index != 0 ) {
+      return;
+    }
+  }
+
+  _Watchdog_Wheel_cascade( wheel, &wheel->Overflow, base );
+}
+
+void _Watchdog_Wheel_insert(
+  Watchdog_Wheel   *wheel,
+  Watchdog_Control *the_watchdog,
+  uint64_t          expire
+)
+{
+  _Assert( _Watchdog_Get_state( the_watchdog ) == WATCHDOG_INACTIVE );
+
+  the_watchdog->expire = expire;
+  _Chain_Append_unprotected(
+    _Watchdog_Wheel_chain( wheel, expire, wheel->ticks + 1 ),
+    &the_watchdog->Node.Chain
+  );
+  _Watchdog_Set_state( the_watchdog, WATCHDOG_SCHEDULED_BLACK );
+  ++wheel->count;
+}
+
+void _Watchdog_Wheel_remove(
+  Watchdog_Wheel   *wheel,
+  Watchdog_Control *the_watchdog
+)
+{
+  _Assert( _Watchdog_Is_scheduled( the_watchdog ) );
+
+  _Chain_Extract_unprotected( &the_watchdog->Node.Chain );
+  _Watchdog_Set_state( the_watchdog, WATCHDOG_INACTIVE );
+  --wheel->count;
+}
+
+void _Watchdog_Wheel_do_tickle(
+  Watchdog_Wheel   *wheel,
+  uint64_t          now,
+#ifdef RTEMS_SMP
+  ISR_lock_Control *lock,
+#endif
+  ISR_lock_Context *lock_context
+)
+{
+  while ( wheel->ticks < now ) {
+    uint64_t      base;
+    Chain_Control expired;
+
+    base = wheel->ticks + 1;
+    wheel->ticks = base;
+
+    if ( wheel->count == 0 ) {
+      continue;
+    }
+
+    if ( _Watchdog_Wheel_index( base, 0 ) == 0 ) {
+      _Watchdog_Wheel_advance( wheel, base );
+    }
+
+    /*
+     * Take all watchdogs of this clock tick at once.  The service routines
+     * may insert watchdogs into the slot of this clock tick which expire one
+     * full revolution of level zero later.  A concurrent remove of a taken
+     * watchdog extracts it from the local chain.
+     */
+    _Chain_Initialize_empty( &expired );
+    _Watchdog_Wheel_move(
+      &expired,
+      &wheel->Slots[ 0 ][ _Watchdog_Wheel_index( base, 0 ) ]
+    );
+
+    while ( !_Chain_Is_empty( &expired ) ) {
+      Watchdog_Control               *the_watchdog;
+      Watchdog_Service_routine_entry  routine;
+
+      the_watchdog = RTEMS_CONTAINER_OF(
+        _Chain_Get_first_unprotected( &expired ),
+        Watchdog_Control,
+        Node.Chain
+      );
+      _Watchdog_Set_state( the_watchdog, WATCHDOG_INACTIVE );
+      --wheel->count;
+      routine = the_watchdog->routine;
+
+      _ISR_lock_Release_and_ISR_enable( lock, lock_context );
+      ( *routine )( the_watchdog );
+      _ISR_lock_ISR_disable_and_acquire( lock, lock_context );
+    }
+  }
+}
+
+uint32_t _Watchdog_Wheel_idle_ticks(
+  const Watchdog_Wheel *wheel,
+  uint32_t              maximum
+)
+{
+  uint32_t delta;
+
+  if ( wheel->count == 0 ) {
+    return maximum;
+  }
+
+  /*
+   * Only the slots of level zero up to the next cascade are examined.  The
+   * next cascade is a conservative bound for watchdogs on higher levels.
+   */
+  for ( delta = 1; delta < maximum; ++delta ) {
+    uint32_t index;
+
+    index = _Watchdog_Wheel_index( wheel->ticks + delta, 0 );
+
+    if ( index == 0 || !_Chain_Is_empty( &wheel->Slots[ 0 ][ index ] ) ) {
+      break;
+    }
+  }
+
+  return delta;
+}
+
+void _Watchdog_Header_initialize_wheel(
+  Watchdog_Header *header,
+  Watchdog_Wheel  *wheel,
+  uint64_t         ticks
+)
+{
+  uint32_t level;
+  uint32_t index;
+
+  _Assert( _Watchdog_Header_first( header ) == NULL );
+
+  wheel->ticks = ticks;
+  wheel->count = 0;
+
+  for ( level = 0; level < WATCHDOG_WHEEL_LEVEL_COUNT; ++level ) {
+    for ( index = 0; index < WATCHDOG_WHEEL_SLOT_COUNT; ++index ) {
+      _Chain_Initialize_empty( &wheel->Slots[ level ][ index ] );
+    }
+  }
+
+  _Chain_Initialize_empty( &wheel->Overflow );
+  header->wheel = wheel;
+}
+
+void _Watchdog_Wheel_initialize( void )
+{
+  uint32_t cpu_count;
+  uint32_t cpu_index;
+
+  cpu_count = _SMP_Get_processor_count();
+
+  for ( cpu_index = 0; cpu_index < cpu_count; ++cpu_index ) {
+    Per_CPU_Control *cpu;
+
+    cpu = _Per_CPU_Get_by_index( cpu_index );
+    _Watchdog_Header_initialize_wheel(
+      &cpu->Watchdog.Header[ PER_CPU_WATCHDOG_TICKS ],
+      PER_CPU_DATA_GET( cpu, Watchdog_Wheel, _Watchdog_Wheel ),
+      cpu->Watchdog.ticks
+    );
+  }
+}
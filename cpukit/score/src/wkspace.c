@@ -172,15 +172,19 @@ void _Workspace_Handler_initialization(
   remaining += _Workspace_Space_for_TLS( page_size );
   remaining += _Workspace_Space_for_per_CPU_data( page_size );
 
-  init_or_extend = _Heap_Initialize;
+  init_or_extend = _Workspace_Initialize_handler;
   do_zero = rtems_configuration_get_do_zero_of_workspace();
   unified = rtems_configuration_get_unified_work_area();
-  overhead = _Heap_Area_overhead( page_size );
 
   for ( i = 0; i < area_count; ++i ) {
     Heap_Area *area;
 
     area = &areas[ i ];
+    overhead = _Heap_Area_overhead( page_size );
+
+    if ( init_or_extend == _Heap_Initialize_segregated_fit ) {
+      overhead += HEAP_SEGREGATED_INDEX_OVERHEAD;
+    }
 
     if ( do_zero ) {
       memset( area->begin, 0, area->size );
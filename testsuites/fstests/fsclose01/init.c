@@ -299,7 +299,8 @@ static const rtems_filesystem_file_handlers_r node_handlers = {
   .fdatasync_h = handler_fdatasync,
   .fcntl_h = handler_fcntl,
   .readv_h = handler_readv,
-  .writev_h = handler_writev
+  .writev_h = handler_writev,
+  .fallocate_h = rtems_filesystem_default_fallocate
 };
 
 static const IMFS_node_control node_control = {
@@ -0,0 +1,304 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/dosfs.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "FSDOSFSDIRINDEX 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 8192U
+
+#define FILE_COUNT 5000U
+
+#define LONG_FILE_COUNT 100U
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char dir[] = "/mnt/dcim";
+
+static void make_path(
+  char *path,
+  size_t size,
+  const char *format,
+  unsigned int i
+)
+{
+  char name[32];
+  int n;
+
+  n = snprintf(name, sizeof(name), format, i);
+  rtems_test_assert(n > 0 && (size_t) n < sizeof(name));
+
+  n = snprintf(path, size, "%s/%s", dir, name);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+static void create_file(const char *path)
+{
+  int fd;
+  int rv;
+
+  fd = open(path, O_WRONLY | O_CREAT | O_EXCL, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void open_file(const char *path, bool exists)
+{
+  int fd;
+  int rv;
+
+  errno = 0;
+  fd = open(path, O_RDONLY);
+
+  if (exists) {
+    rtems_test_assert(fd >= 0);
+    rv = close(fd);
+    rtems_test_assert(rv == 0);
+  } else {
+    rtems_test_assert(fd == -1);
+    rtems_test_assert(errno == ENOENT);
+  }
+}
+
+static uint32_t nanoseconds_per_file(rtems_counter_ticks ticks)
+{
+  uint64_t ns = rtems_counter_ticks_to_nanoseconds(ticks);
+
+  return (uint32_t) (ns / FILE_COUNT);
+}
+
+static off_t directory_size(void)
+{
+  struct stat st;
+  int rv;
+
+  rv = stat(dir, &st);
+  rtems_test_assert(rv == 0);
+
+  return st.st_size;
+}
+
+static unsigned int count_entries(void)
+{
+  DIR *d;
+  unsigned int count;
+  int rv;
+
+  d = opendir(dir);
+  rtems_test_assert(d != NULL);
+
+  count = 0;
+
+  while (readdir(d) != NULL) {
+    ++count;
+  }
+
+  rv = closedir(d);
+  rtems_test_assert(rv == 0);
+
+  /* Without the "." and ".." entries */
+  return count - 2;
+}
+
+static void do_mount(void)
+{
+  int rv;
+
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_DOSFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+/*
+ * The files with an odd number are removed, the files with an even number
+ * are renamed.
+ */
+static void check_files(void)
+{
+  char path[64];
+  unsigned int i;
+
+  for (i = 0; i < FILE_COUNT; ++i) {
+    make_path(path, sizeof(path), "img_%04u.jpg", i);
+    open_file(path, false);
+
+    if (i % 2 == 0) {
+      make_path(path, sizeof(path), "new_%04u.jpg", i);
+      open_file(path, true);
+    }
+  }
+
+  for (i = 0; i < LONG_FILE_COUNT; ++i) {
+    make_path(path, sizeof(path), "LONG FILE NAME %03u.JPEG", i);
+    open_file(path, true);
+  }
+
+  rtems_test_assert(count_entries() == FILE_COUNT / 2 + LONG_FILE_COUNT);
+}
+
+static void test(void)
+{
+  static const msdos_format_request_param_t config = {
+    .quick_format = true
+  };
+  rtems_counter_ticks start;
+  rtems_counter_ticks create_ticks;
+  rtems_counter_ticks open_ticks;
+  rtems_status_code sc;
+  char path[64];
+  char new_path[64];
+  unsigned int i;
+  off_t size;
+  ramdisk *rd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = msdos_format(rda, &config);
+  rtems_test_assert(rv == 0);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  do_mount();
+
+  rv = mkdir(dir, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < FILE_COUNT; ++i) {
+    make_path(path, sizeof(path), "img_%04u.jpg", i);
+    create_file(path);
+  }
+
+  create_ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < FILE_COUNT; ++i) {
+    make_path(path, sizeof(path), "IMG_%04u.JPG", FILE_COUNT - 1 - i);
+    open_file(path, true);
+  }
+
+  open_ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  make_path(path, sizeof(path), "img_%04u.jpg", FILE_COUNT);
+  open_file(path, false);
+
+  for (i = 0; i < LONG_FILE_COUNT; ++i) {
+    make_path(path, sizeof(path), "long file name %03u.jpeg", i);
+    create_file(path);
+  }
+
+  /* The new files reuse the directory entries of the removed files */
+  for (i = 1; i < FILE_COUNT; i += 2) {
+    make_path(path, sizeof(path), "img_%04u.jpg", i);
+    rv = unlink(path);
+    rtems_test_assert(rv == 0);
+    open_file(path, false);
+  }
+
+  size = directory_size();
+
+  for (i = 0; i < FILE_COUNT; i += 2) {
+    make_path(path, sizeof(path), "img_%04u.jpg", i);
+    make_path(new_path, sizeof(new_path), "new_%04u.jpg", i);
+    rv = rename(path, new_path);
+    rtems_test_assert(rv == 0);
+  }
+
+  rtems_test_assert(directory_size() == size);
+
+  check_files();
+
+  /* The index is built again from the directory entries */
+  do_unmount();
+  do_mount();
+  check_files();
+  do_unmount();
+
+  printf(
+    "<FSDOSFSDirIndex01><Directory entries=\"%u\"><CreateNsPerFile>%" PRIu32
+      "</CreateNsPerFile><OpenNsPerFile>%" PRIu32
+      "</OpenNsPerFile></Directory></FSDOSFSDirIndex01>\n",
+    FILE_COUNT,
+    nanoseconds_per_file(create_ticks),
+    nanoseconds_per_file(open_ticks)
+  );
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
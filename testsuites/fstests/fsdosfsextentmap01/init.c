@@ -0,0 +1,330 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/dosfs.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "FSDOSFSEXTENTMAP 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 16384U
+
+#define CLUSTER_SIZE BLOCK_SIZE
+
+#define FILE_SIZE (2U * 1024U * 1024U)
+
+#define CHUNK_SIZE (64U * 1024U)
+
+#define READ_SIZE 256U
+
+#define READ_COUNT 2000U
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char contiguous_path[] = "/mnt/contig";
+
+static const char fragmented_path[] = "/mnt/frag";
+
+static const char other_path[] = "/mnt/other";
+
+static uint32_t buf[CHUNK_SIZE / sizeof(uint32_t)];
+
+static uint32_t random_state = 1;
+
+static uint32_t next_random(void)
+{
+  random_state = random_state * 1664525U + 1013904223U;
+
+  return random_state >> 8;
+}
+
+/* Each word of a file contains its offset combined with a file specific seed */
+static void fill_buffer(off_t offset, size_t size, uint32_t seed)
+{
+  size_t i;
+
+  for (i = 0; i < size / sizeof(buf[0]); ++i) {
+    buf[i] = (uint32_t) offset + i * sizeof(buf[0]) + seed;
+  }
+}
+
+static void write_chunk(int fd, off_t offset, size_t size, uint32_t seed)
+{
+  ssize_t n;
+
+  fill_buffer(offset, size, seed);
+  n = write(fd, buf, size);
+  rtems_test_assert(n == (ssize_t) size);
+}
+
+static void check_read(int fd, off_t offset, size_t size, uint32_t seed)
+{
+  uint32_t expected[READ_SIZE / sizeof(uint32_t)];
+  off_t off;
+  ssize_t n;
+  size_t i;
+
+  for (i = 0; i < size / sizeof(expected[0]); ++i) {
+    expected[i] = (uint32_t) offset + i * sizeof(expected[0]) + seed;
+  }
+
+  off = lseek(fd, offset, SEEK_SET);
+  rtems_test_assert(off == offset);
+
+  n = read(fd, buf, size);
+  rtems_test_assert(n == (ssize_t) size);
+  rtems_test_assert(memcmp(buf, expected, size) == 0);
+}
+
+static off_t random_offset(off_t size)
+{
+  return (off_t) (next_random() % (uint32_t) (size / READ_SIZE)) * READ_SIZE;
+}
+
+static void create_contiguous_file(void)
+{
+  off_t offset;
+  int fd;
+  int rv;
+
+  fd = open(contiguous_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  for (offset = 0; offset < FILE_SIZE; offset += CHUNK_SIZE) {
+    write_chunk(fd, offset, CHUNK_SIZE, 0);
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+/*
+ * Appends to two files cluster by cluster in turn, so that no two
+ * consecutive clusters of a file are adjacent on the volume.
+ */
+static void create_fragmented_file(void)
+{
+  off_t offset;
+  int fd;
+  int other_fd;
+  int rv;
+
+  fd = open(fragmented_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  other_fd = open(other_path, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(other_fd >= 0);
+
+  for (offset = 0; offset < FILE_SIZE; offset += CLUSTER_SIZE) {
+    write_chunk(fd, offset, CLUSTER_SIZE, 0);
+    write_chunk(other_fd, offset, CLUSTER_SIZE, 1);
+  }
+
+  rv = close(other_fd);
+  rtems_test_assert(rv == 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static uint32_t random_reads(const char *path, off_t size, uint32_t seed)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks ticks;
+  uint32_t i;
+  int fd;
+  int rv;
+
+  fd = open(path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < READ_COUNT; ++i) {
+    check_read(fd, random_offset(size), READ_SIZE, seed);
+  }
+
+  ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  return (uint32_t) (rtems_counter_ticks_to_nanoseconds(ticks) / READ_COUNT);
+}
+
+/*
+ * The extent map must follow the changes of the cluster chain by truncate
+ * and extend.
+ */
+static void test_truncate_and_extend(void)
+{
+  off_t size;
+  off_t offset;
+  uint32_t i;
+  int fd;
+  int rv;
+
+  fd = open(fragmented_path, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  for (i = 0; i < 100; ++i) {
+    check_read(fd, random_offset(FILE_SIZE), READ_SIZE, 0);
+  }
+
+  size = FILE_SIZE / 2 + CLUSTER_SIZE / 2;
+  rv = ftruncate(fd, size);
+  rtems_test_assert(rv == 0);
+
+  for (i = 0; i < 100; ++i) {
+    check_read(fd, random_offset(size), READ_SIZE, 0);
+  }
+
+  /* The freed clusters of the other file interleave the new ones */
+  rv = unlink(other_path);
+  rtems_test_assert(rv == 0);
+
+  offset = lseek(fd, size, SEEK_SET);
+  rtems_test_assert(offset == size);
+  write_chunk(fd, size, CLUSTER_SIZE / 2, 0);
+
+  for (offset = FILE_SIZE / 2 + CLUSTER_SIZE; offset < FILE_SIZE;
+       offset += CHUNK_SIZE) {
+    write_chunk(fd, offset, MIN(CHUNK_SIZE, FILE_SIZE - offset), 0);
+  }
+
+  for (i = 0; i < 100; ++i) {
+    check_read(fd, random_offset(FILE_SIZE), READ_SIZE, 0);
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_mount(void)
+{
+  int rv;
+
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_DOSFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+static void test(void)
+{
+  static const msdos_format_request_param_t config = {
+    .sectors_per_cluster = 1,
+    .quick_format = true
+  };
+  rtems_status_code sc;
+  uint32_t contiguous_ns;
+  uint32_t fragmented_ns;
+  ramdisk *rd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = msdos_format(rda, &config);
+  rtems_test_assert(rv == 0);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  do_mount();
+
+  create_contiguous_file();
+  create_fragmented_file();
+
+  contiguous_ns = random_reads(contiguous_path, FILE_SIZE, 0);
+  fragmented_ns = random_reads(fragmented_path, FILE_SIZE, 0);
+  random_reads(other_path, FILE_SIZE, 1);
+
+  test_truncate_and_extend();
+
+  /* The extent maps are built again after a remount */
+  do_unmount();
+  do_mount();
+  random_reads(contiguous_path, FILE_SIZE, 0);
+  random_reads(fragmented_path, FILE_SIZE, 0);
+  do_unmount();
+
+  printf(
+    "<FSDOSFSExtentMap01><File size=\"%u\" type=\"contiguous\">"
+      "<RandomReadNs>%" PRIu32 "</RandomReadNs></File>"
+      "<File size=\"%u\" type=\"fragmented\"><RandomReadNs>%" PRIu32
+      "</RandomReadNs></File></FSDOSFSExtentMap01>\n",
+    FILE_SIZE,
+    contiguous_ns,
+    FILE_SIZE,
+    fragmented_ns
+  );
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
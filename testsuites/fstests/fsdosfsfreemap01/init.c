@@ -0,0 +1,337 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/dosfs.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "FSDOSFSFREEMAP 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 16384U
+
+#define CLUSTER_SIZE BLOCK_SIZE
+
+#define FILL_CLUSTERS 8U
+
+#define REMOVE_STEP 20U
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char dir[] = "/mnt/fill";
+
+static const char append_path[] = "/mnt/append";
+
+static uint8_t buf[FILL_CLUSTERS * CLUSTER_SIZE];
+
+static uint8_t check_buf[CLUSTER_SIZE];
+
+static void make_path(char *path, size_t size, unsigned int i)
+{
+  int n;
+
+  n = snprintf(path, size, "%s/F%04u", dir, i);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+static void fill_buffer(uint8_t *b, size_t size, unsigned int seed)
+{
+  size_t i;
+
+  for (i = 0; i < size; ++i) {
+    b[i] = (uint8_t) (seed + i / CLUSTER_SIZE);
+  }
+}
+
+static uint32_t free_clusters(void)
+{
+  struct statvfs st;
+  int rv;
+
+  rv = statvfs(mnt, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.f_frsize == CLUSTER_SIZE);
+
+  return (uint32_t) st.f_bfree;
+}
+
+static void do_mount(void)
+{
+  int rv;
+
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_DOSFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+/*
+ * Fills the volume with files of equal size.  Returns the count of complete
+ * files.
+ */
+static unsigned int fill_volume(void)
+{
+  char path[32];
+  unsigned int i;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  i = 0;
+
+  while (true) {
+    make_path(path, sizeof(path), i);
+    fd = open(path, O_WRONLY | O_CREAT | O_EXCL, S_IRWXU);
+
+    if (fd < 0) {
+      rtems_test_assert(errno == ENOSPC);
+      break;
+    }
+
+    fill_buffer(buf, sizeof(buf), i);
+    n = write(fd, buf, sizeof(buf));
+
+    rv = close(fd);
+    rtems_test_assert(rv == 0);
+
+    if (n != (ssize_t) sizeof(buf)) {
+      rv = unlink(path);
+      rtems_test_assert(rv == 0);
+      break;
+    }
+
+    ++i;
+  }
+
+  return i;
+}
+
+static void check_file(const char *path, size_t size, unsigned int seed)
+{
+  struct stat st;
+  size_t offset;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  rv = stat(path, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.st_size == (off_t) size);
+
+  fd = open(path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  for (offset = 0; offset < size; offset += CLUSTER_SIZE) {
+    n = read(fd, check_buf, CLUSTER_SIZE);
+    rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+    fill_buffer(buf, CLUSTER_SIZE, seed + offset / CLUSTER_SIZE);
+    rtems_test_assert(memcmp(check_buf, buf, CLUSTER_SIZE) == 0);
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void check_fill_files(unsigned int file_count)
+{
+  char path[32];
+  unsigned int i;
+
+  for (i = 0; i < file_count; ++i) {
+    make_path(path, sizeof(path), i);
+
+    if (i % REMOVE_STEP == 0) {
+      struct stat st;
+      int rv;
+
+      errno = 0;
+      rv = stat(path, &st);
+      rtems_test_assert(rv == -1);
+      rtems_test_assert(errno == ENOENT);
+    } else {
+      check_file(path, sizeof(buf), i);
+    }
+  }
+}
+
+static void test(void)
+{
+  static const msdos_format_request_param_t config = {
+    .sectors_per_cluster = 1,
+    .quick_format = true
+  };
+  uint64_t total_ns;
+  uint64_t max_ns;
+  rtems_status_code sc;
+  char path[32];
+  unsigned int file_count;
+  uint32_t total_free;
+  uint32_t free_before;
+  uint32_t append_count;
+  uint32_t i;
+  ramdisk *rd;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = msdos_format(rda, &config);
+  rtems_test_assert(rv == 0);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  do_mount();
+
+  total_free = free_clusters();
+
+  rv = mkdir(dir, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  file_count = fill_volume();
+  rtems_test_assert(file_count > 0);
+  rtems_test_assert(free_clusters() < FILL_CLUSTERS);
+
+  /* Leave a volume which is 95% full with the free space in small holes */
+  for (i = 0; i < file_count; i += REMOVE_STEP) {
+    make_path(path, sizeof(path), i);
+    rv = unlink(path);
+    rtems_test_assert(rv == 0);
+  }
+
+  /* The free map is built from the FAT after the remount */
+  do_unmount();
+  do_mount();
+
+  free_before = free_clusters();
+  rtems_test_assert(
+    free_before >= (file_count / REMOVE_STEP) * FILL_CLUSTERS
+  );
+
+  append_count = free_before / 2;
+  total_ns = 0;
+  max_ns = 0;
+
+  fd = open(append_path, O_WRONLY | O_CREAT | O_APPEND, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  for (i = 0; i < append_count; ++i) {
+    rtems_counter_ticks start;
+    uint64_t ns;
+
+    fill_buffer(buf, CLUSTER_SIZE, i);
+
+    start = rtems_counter_read();
+    n = write(fd, buf, CLUSTER_SIZE);
+    ns = rtems_counter_ticks_to_nanoseconds(
+      rtems_counter_difference(rtems_counter_read(), start)
+    );
+
+    rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+
+    total_ns += ns;
+
+    if (ns > max_ns) {
+      max_ns = ns;
+    }
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rtems_test_assert(free_clusters() == free_before - append_count);
+  check_file(append_path, append_count * CLUSTER_SIZE, 0);
+  check_fill_files(file_count);
+
+  /* The free clusters count of the FAT agrees with the free map */
+  do_unmount();
+  do_mount();
+  rtems_test_assert(free_clusters() == free_before - append_count);
+
+  rv = unlink(append_path);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(free_clusters() == free_before);
+
+  check_fill_files(file_count);
+  do_unmount();
+
+  printf(
+    "<FSDOSFSFreeMap01><Volume clusters=\"%" PRIu32 "\" free=\"%" PRIu32
+      "\"><AppendNsAverage>%" PRIu64 "</AppendNsAverage><AppendNsMax>%"
+      PRIu64 "</AppendNsMax></Volume></FSDOSFSFreeMap01>\n",
+    total_free,
+    free_before,
+    total_ns / append_count,
+    max_ns
+  );
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -985,6 +985,7 @@ static void test_compatibility( void )
   struct dirent            *dp;
 
 
+  memset( &mount_opts, 0, sizeof( mount_opts ) );
   mount_opts.converter = rtems_dosfs_create_utf8_converter( "CP850" );
   rtems_test_assert( mount_opts.converter != NULL );
 
@@ -1201,6 +1202,8 @@ static void test( void )
   char start_dir[MOUNT_DIR_SIZE + START_DIR_SIZE + 2];
   rtems_dosfs_mount_options mount_opts[2];
 
+  memset( &mount_opts[0], 0, sizeof( mount_opts ) );
+
   rc = mkdir( MOUNT_DIR, S_IRWXU | S_IRWXG | S_IRWXO );
   rtems_test_assert( rc == 0 );
 
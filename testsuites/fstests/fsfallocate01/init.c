@@ -0,0 +1,609 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+#include "format_support.h"
+
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/dosfs.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "FSFALLOCATE 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 16384U
+
+#define CLUSTER_SIZE BLOCK_SIZE
+
+#define WRITER_COUNT 4
+
+#define FILE_SIZE (256U * 1024U)
+
+#define FILE_CLUSTERS (FILE_SIZE / CLUSTER_SIZE)
+
+#define RESERVATION_SIZE (64U * CLUSTER_SIZE)
+
+#define RECLAIM_RESERVATION_SIZE (BLOCK_COUNT / 2 * BLOCK_SIZE)
+
+#define TOO_BIG_SIZE (2 * BLOCK_COUNT * BLOCK_SIZE)
+
+#define MAX_DIR_ENTRIES 512U
+
+typedef enum {
+  MODE_PLAIN,
+  MODE_FALLOCATE,
+  MODE_RESERVATION
+} writer_mode;
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char file_path[] = "/mnt/F";
+
+static const char imfs_path[] = "/F";
+
+static const char * const writer_paths[WRITER_COUNT] = {
+  "/mnt/W0",
+  "/mnt/W1",
+  "/mnt/W2",
+  "/mnt/W3"
+};
+
+/* The short names of the writer files in the directory entries */
+static const char writer_names[WRITER_COUNT][12] = {
+  "W0         ",
+  "W1         ",
+  "W2         ",
+  "W3         "
+};
+
+static uint32_t buf[CLUSTER_SIZE / sizeof(uint32_t)];
+
+static uint32_t check_buf[CLUSTER_SIZE / sizeof(uint32_t)];
+
+static uint8_t sector[BLOCK_SIZE];
+
+static uint8_t root_dir[MAX_DIR_ENTRIES * 32];
+
+/* Each word of a file contains its offset combined with a file specific seed */
+static void fill_buffer(uint32_t *b, off_t offset, uint32_t seed)
+{
+  size_t i;
+
+  for (i = 0; i < CLUSTER_SIZE / sizeof(b[0]); ++i) {
+    b[i] = (uint32_t) offset + i * sizeof(b[0]) + seed;
+  }
+}
+
+static void check_file(int fd, uint32_t seed)
+{
+  off_t offset;
+  ssize_t n;
+
+  offset = lseek(fd, 0, SEEK_SET);
+  rtems_test_assert(offset == 0);
+
+  for (offset = 0; offset < FILE_SIZE; offset += CLUSTER_SIZE) {
+    n = read(fd, check_buf, CLUSTER_SIZE);
+    rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+    fill_buffer(buf, offset, seed);
+    rtems_test_assert(memcmp(check_buf, buf, CLUSTER_SIZE) == 0);
+  }
+}
+
+static void check_zeros(int fd, off_t offset, off_t size)
+{
+  off_t off;
+
+  off = lseek(fd, offset, SEEK_SET);
+  rtems_test_assert(off == offset);
+
+  while (size > 0) {
+    size_t chunk = size < CLUSTER_SIZE ? (size_t) size : CLUSTER_SIZE;
+    ssize_t n;
+    size_t i;
+
+    n = read(fd, check_buf, chunk);
+    rtems_test_assert(n == (ssize_t) chunk);
+
+    for (i = 0; i < chunk; ++i) {
+      rtems_test_assert(((const uint8_t *) check_buf)[i] == 0);
+    }
+
+    size -= chunk;
+  }
+}
+
+static off_t file_size(int fd)
+{
+  struct stat st;
+  int rv;
+
+  rv = fstat(fd, &st);
+  rtems_test_assert(rv == 0);
+
+  return st.st_size;
+}
+
+static uint32_t free_clusters(void)
+{
+  struct statvfs st;
+  int rv;
+
+  rv = statvfs(mnt, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.f_frsize == CLUSTER_SIZE);
+
+  return (uint32_t) st.f_bfree;
+}
+
+static void do_mount(const char *type, const void *data)
+{
+  int rv;
+
+  rv = mount(rda, mnt, type, RTEMS_FILESYSTEM_READ_WRITE, data);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+static uint32_t le16(const uint8_t *p)
+{
+  return (uint32_t) p[0] | ((uint32_t) p[1] << 8);
+}
+
+static void read_device(int fd, off_t offset, void *b, size_t size)
+{
+  off_t off;
+  ssize_t n;
+
+  off = lseek(fd, offset, SEEK_SET);
+  rtems_test_assert(off == offset);
+
+  n = read(fd, b, size);
+  rtems_test_assert(n == (ssize_t) size);
+}
+
+/*
+ * Counts the runs of consecutive clusters of a file in the root directory of
+ * the unmounted FAT16 volume.
+ */
+static uint32_t count_extents(const char *name)
+{
+  uint32_t bps;
+  uint32_t fat_start;
+  uint32_t fat_size;
+  uint32_t root_entries;
+  uint8_t *fat;
+  uint32_t cln;
+  uint32_t prev_cln;
+  uint32_t clusters;
+  uint32_t extents;
+  uint32_t i;
+  int fd;
+  int rv;
+
+  fd = open(rda, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  read_device(fd, 0, sector, sizeof(sector));
+  bps = le16(&sector[11]);
+  fat_start = le16(&sector[14]) * bps;
+  fat_size = le16(&sector[22]) * bps;
+  root_entries = le16(&sector[17]);
+  rtems_test_assert(fat_size > 0);
+  rtems_test_assert(root_entries <= MAX_DIR_ENTRIES);
+
+  fat = malloc(fat_size);
+  rtems_test_assert(fat != NULL);
+
+  read_device(fd, fat_start, fat, fat_size);
+  read_device(
+    fd,
+    fat_start + sector[16] * fat_size,
+    root_dir,
+    root_entries * 32
+  );
+
+  cln = 0;
+
+  for (i = 0; i < root_entries; ++i) {
+    const uint8_t *entry = &root_dir[i * 32];
+
+    if (entry[0] == 0x00) {
+      break;
+    }
+
+    if (
+      entry[0] != 0xe5
+        && entry[11] != 0x0f
+        && memcmp(entry, name, 11) == 0
+    ) {
+      cln = le16(&entry[26]);
+      break;
+    }
+  }
+
+  rtems_test_assert(cln >= 2);
+
+  clusters = 0;
+  extents = 0;
+  prev_cln = 0;
+
+  while (cln >= 2 && cln < 0xfff8) {
+    rtems_test_assert(2 * cln < fat_size);
+
+    if (cln != prev_cln + 1) {
+      ++extents;
+    }
+
+    ++clusters;
+    prev_cln = cln;
+    cln = le16(&fat[2 * cln]);
+  }
+
+  rtems_test_assert(clusters == FILE_CLUSTERS);
+
+  free(fat);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  return extents;
+}
+
+/*
+ * Several writers append to their files in turn one cluster at a time.
+ * Without help this places the clusters of the files alternately on the
+ * volume.
+ */
+static uint32_t test_writers(const char *mode_name, writer_mode mode)
+{
+  rtems_dosfs_mount_options options;
+  rtems_counter_ticks start;
+  uint64_t ns;
+  uint32_t free_before;
+  uint32_t extents;
+  off_t offset;
+  int fds[WRITER_COUNT];
+  int i;
+  int rv;
+
+  memset(&options, 0, sizeof(options));
+
+  if (mode == MODE_RESERVATION) {
+    options.reservation_size = RESERVATION_SIZE;
+  }
+
+  format_dosfs(rda, 1);
+  do_mount(RTEMS_FILESYSTEM_TYPE_DOSFS, &options);
+
+  free_before = free_clusters();
+
+  for (i = 0; i < WRITER_COUNT; ++i) {
+    fds[i] = open(writer_paths[i], O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+    rtems_test_assert(fds[i] >= 0);
+  }
+
+  start = rtems_counter_read();
+
+  if (mode == MODE_FALLOCATE) {
+    for (i = 0; i < WRITER_COUNT; ++i) {
+      rv = posix_fallocate(fds[i], 0, FILE_SIZE);
+      rtems_test_assert(rv == 0);
+    }
+  }
+
+  for (offset = 0; offset < FILE_SIZE; offset += CLUSTER_SIZE) {
+    for (i = 0; i < WRITER_COUNT; ++i) {
+      ssize_t n;
+
+      fill_buffer(buf, offset, (uint32_t) i);
+      n = write(fds[i], buf, CLUSTER_SIZE);
+      rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+    }
+  }
+
+  /* The reservations are not allocated in the FAT */
+  rtems_test_assert(
+    free_clusters() == free_before - WRITER_COUNT * FILE_CLUSTERS
+  );
+
+  for (i = 0; i < WRITER_COUNT; ++i) {
+    rv = fsync(fds[i]);
+    rtems_test_assert(rv == 0);
+  }
+
+  ns = rtems_counter_ticks_to_nanoseconds(
+    rtems_counter_difference(rtems_counter_read(), start)
+  );
+
+  for (i = 0; i < WRITER_COUNT; ++i) {
+    rtems_test_assert(file_size(fds[i]) == FILE_SIZE);
+    check_file(fds[i], (uint32_t) i);
+
+    rv = close(fds[i]);
+    rtems_test_assert(rv == 0);
+  }
+
+  do_unmount();
+
+  extents = 0;
+
+  for (i = 0; i < WRITER_COUNT; ++i) {
+    extents += count_extents(writer_names[i]);
+  }
+
+  if (ns == 0) {
+    ns = 1;
+  }
+
+  printf(
+    "  <Writers mode=\"%s\"><Extents>%" PRIu32 "</Extents>"
+      "<WriteKiBPerSecond>%" PRIu64 "</WriteKiBPerSecond></Writers>\n",
+    mode_name,
+    extents,
+    (uint64_t) (WRITER_COUNT * FILE_SIZE / 1024) * UINT64_C(1000000000) / ns
+  );
+
+  return extents;
+}
+
+/*
+ * A too large reservation size is rejected.  The first file reserves half of
+ * the volume.  The second file gets these
+ * clusters once all other clusters are in use, and the first file gets the
+ * last one.
+ */
+static void test_reservation_reclaim(void)
+{
+  rtems_dosfs_mount_options options;
+  uint32_t free_before;
+  uint32_t i;
+  ssize_t n;
+  int fd_a;
+  int fd_b;
+  int rv;
+
+  memset(&options, 0, sizeof(options));
+  options.reservation_size = RTEMS_DOSFS_RESERVATION_SIZE_MAX + 1;
+
+  format_dosfs(rda, 1);
+
+  errno = 0;
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_DOSFS,
+    RTEMS_FILESYSTEM_READ_WRITE, &options);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == EINVAL);
+
+  options.reservation_size = RECLAIM_RESERVATION_SIZE;
+  do_mount(RTEMS_FILESYSTEM_TYPE_DOSFS, &options);
+
+  fd_a = open(writer_paths[0], O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd_a >= 0);
+
+  fd_b = open(writer_paths[1], O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd_b >= 0);
+
+  fill_buffer(buf, 0, 0);
+
+  n = write(fd_a, buf, CLUSTER_SIZE);
+  rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+
+  free_before = free_clusters();
+  rtems_test_assert(free_before > RECLAIM_RESERVATION_SIZE / CLUSTER_SIZE);
+
+  for (i = 0; i < free_before - 1; ++i) {
+    n = write(fd_b, buf, CLUSTER_SIZE);
+    rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+  }
+
+  n = write(fd_a, buf, CLUSTER_SIZE);
+  rtems_test_assert(n == (ssize_t) CLUSTER_SIZE);
+  rtems_test_assert(free_clusters() == 0);
+
+  errno = 0;
+  n = write(fd_b, buf, CLUSTER_SIZE);
+  rtems_test_assert(n == -1);
+  rtems_test_assert(errno == ENOSPC);
+
+  rv = close(fd_a);
+  rtems_test_assert(rv == 0);
+
+  rv = close(fd_b);
+  rtems_test_assert(rv == 0);
+
+  do_unmount();
+}
+
+static void test_dosfs_fallocate(void)
+{
+  uint32_t free_before;
+  int fd;
+  int rv;
+
+  format_dosfs(rda, 1);
+  do_mount(RTEMS_FILESYSTEM_TYPE_DOSFS, NULL);
+
+  fd = open(file_path, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rtems_test_assert(posix_fallocate(fd, 0, 0) == EINVAL);
+  rtems_test_assert(posix_fallocate(fd, -1, 1) == EINVAL);
+  rtems_test_assert(posix_fallocate(-1, 0, 1) == EBADF);
+  rtems_test_assert(posix_fallocate(fd, 0xffffffff, 2) == EFBIG);
+
+  /* A failed allocation leaves the file and the volume unchanged */
+  free_before = free_clusters();
+  errno = 0;
+  rtems_test_assert(posix_fallocate(fd, 0, TOO_BIG_SIZE) == ENOSPC);
+  rtems_test_assert(errno == 0);
+  rtems_test_assert(file_size(fd) == 0);
+  rtems_test_assert(free_clusters() == free_before);
+
+  rv = posix_fallocate(fd, 1000, 3000);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(file_size(fd) == 4000);
+  rtems_test_assert(free_clusters() == free_before - 8);
+  check_zeros(fd, 0, 4000);
+
+  /* A region inside the file changes nothing */
+  rv = posix_fallocate(fd, 0, 100);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(file_size(fd) == 4000);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  fd = open(file_path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+  rtems_test_assert(posix_fallocate(fd, 0, 1) == EBADF);
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  do_unmount();
+}
+
+static void test_rfs_fallocate(void)
+{
+  int fd;
+  int rv;
+
+  format_rfs(rda, BLOCK_SIZE);
+  do_mount(RTEMS_FILESYSTEM_TYPE_RFS, NULL);
+
+  fd = open(file_path, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rv = posix_fallocate(fd, 0, FILE_SIZE);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(file_size(fd) == FILE_SIZE);
+  check_zeros(fd, 0, FILE_SIZE);
+
+  rtems_test_assert(posix_fallocate(fd, 0, TOO_BIG_SIZE) == ENOSPC);
+  rtems_test_assert(file_size(fd) == FILE_SIZE);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  do_unmount();
+}
+
+static void test_imfs_fallocate(void)
+{
+  int fd;
+  int rv;
+
+  fd = open(imfs_path, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rtems_test_assert(posix_fallocate(fd, 0, 1) == EINVAL);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rv = unlink(imfs_path);
+  rtems_test_assert(rv == 0);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  uint32_t plain_extents;
+  uint32_t fallocate_extents;
+  uint32_t reservation_extents;
+  ramdisk *rd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  test_imfs_fallocate();
+  test_dosfs_fallocate();
+  test_rfs_fallocate();
+  test_reservation_reclaim();
+
+  printf("<FSFallocate01>\n");
+
+  plain_extents = test_writers("plain", MODE_PLAIN);
+  fallocate_extents = test_writers("fallocate", MODE_FALLOCATE);
+  reservation_extents = test_writers("reservation", MODE_RESERVATION);
+
+  printf("</FSFallocate01>\n");
+
+  rtems_test_assert(fallocate_extents <= 2 * WRITER_COUNT);
+  rtems_test_assert(
+    reservation_extents
+      <= WRITER_COUNT * (FILE_SIZE / RESERVATION_SIZE + 1)
+  );
+  rtems_test_assert(reservation_extents < plain_extents);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,240 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/counter.h>
+#include <rtems/imfs.h>
+
+const char rtems_test_name[] = "FSIMFSDIRHASH 1";
+
+#define ENTRY_COUNT 10000
+
+static const char linear_mnt[] = "/linear";
+
+static const char hashed_mnt[] = "/hashed";
+
+static const IMFS_mknod_controls hashed_mknod_controls = {
+  .directory = &IMFS_mknod_control_dir_hashed,
+  .device = &IMFS_mknod_control_device,
+  .file = &IMFS_mknod_control_memfile,
+  .fifo = &IMFS_mknod_control_enosys
+};
+
+static void make_path(
+  char *path,
+  size_t size,
+  const char *mnt,
+  const char *prefix,
+  unsigned int i
+)
+{
+  int n;
+
+  n = snprintf(path, size, "%s/%s%05u", mnt, prefix, i);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+static uint32_t nanoseconds_per_entry(rtems_counter_ticks ticks)
+{
+  uint64_t ns = rtems_counter_ticks_to_nanoseconds(ticks);
+
+  return (uint32_t) (ns / ENTRY_COUNT);
+}
+
+static void check_readdir_order(const char *mnt, unsigned int step)
+{
+  DIR *dir;
+  struct dirent *de;
+  unsigned int i;
+  int rv;
+
+  dir = opendir(mnt);
+  rtems_test_assert(dir != NULL);
+
+  i = 0;
+
+  while ((de = readdir(dir)) != NULL) {
+    char name[16];
+    int n;
+
+    n = snprintf(name, sizeof(name), "f%05u", i);
+    rtems_test_assert(n > 0 && (size_t) n < sizeof(name));
+    rtems_test_assert(strcmp(de->d_name, name) == 0);
+    i += step;
+  }
+
+  rtems_test_assert(i == ENTRY_COUNT);
+
+  rv = closedir(dir);
+  rtems_test_assert(rv == 0);
+}
+
+/*
+ * Create, look up, rename and remove many entries in one directory.  The
+ * directory order must be the creation order.
+ */
+static void test_directory(const char *type, const char *mnt)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks create_ticks;
+  rtems_counter_ticks lookup_ticks;
+  rtems_counter_ticks unlink_ticks;
+  char path[32];
+  char new_path[32];
+  struct stat st;
+  unsigned int i;
+  int fd;
+  int rv;
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    make_path(path, sizeof(path), mnt, "f", i);
+    fd = open(path, O_WRONLY | O_CREAT | O_EXCL, S_IRWXU);
+    rtems_test_assert(fd >= 0);
+    rv = close(fd);
+    rtems_test_assert(rv == 0);
+  }
+
+  create_ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    make_path(path, sizeof(path), mnt, "f", ENTRY_COUNT - 1 - i);
+    rv = stat(path, &st);
+    rtems_test_assert(rv == 0);
+    rtems_test_assert(S_ISREG(st.st_mode));
+  }
+
+  lookup_ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  make_path(path, sizeof(path), mnt, "f", ENTRY_COUNT);
+  rv = stat(path, &st);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == ENOENT);
+
+  check_readdir_order(mnt, 1);
+
+  /* The entries move to the end of the directory and back */
+  for (i = 1; i < ENTRY_COUNT; i += 2) {
+    make_path(path, sizeof(path), mnt, "f", i);
+    make_path(new_path, sizeof(new_path), mnt, "r", i);
+    rv = rename(path, new_path);
+    rtems_test_assert(rv == 0);
+  }
+
+  for (i = 1; i < ENTRY_COUNT; i += 2) {
+    make_path(path, sizeof(path), mnt, "f", i);
+    rv = stat(path, &st);
+    rtems_test_assert(rv == -1);
+    rtems_test_assert(errno == ENOENT);
+
+    make_path(new_path, sizeof(new_path), mnt, "r", i);
+    rv = unlink(new_path);
+    rtems_test_assert(rv == 0);
+  }
+
+  check_readdir_order(mnt, 2);
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < ENTRY_COUNT; i += 2) {
+    make_path(path, sizeof(path), mnt, "f", i);
+    rv = unlink(path);
+    rtems_test_assert(rv == 0);
+  }
+
+  unlink_ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  check_readdir_order(mnt, ENTRY_COUNT);
+
+  printf(
+    "  <Directory type=\"%s\"><CreateNsPerEntry>%" PRIu32
+      "</CreateNsPerEntry><LookupNsPerEntry>%" PRIu32
+      "</LookupNsPerEntry><UnlinkNsPerEntry>%" PRIu32
+      "</UnlinkNsPerEntry></Directory>\n",
+    type,
+    nanoseconds_per_entry(create_ticks),
+    nanoseconds_per_entry(lookup_ticks),
+    nanoseconds_per_entry(unlink_ticks)
+  );
+}
+
+static void do_mount(const char *mnt, const IMFS_mknod_controls *controls)
+{
+  int rv;
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  rv = mount(
+    NULL,
+    mnt,
+    RTEMS_FILESYSTEM_TYPE_IMFS,
+    RTEMS_FILESYSTEM_READ_WRITE,
+    controls
+  );
+  rtems_test_assert(rv == 0);
+}
+
+static void test(void)
+{
+  do_mount(linear_mnt, NULL);
+  do_mount(hashed_mnt, &hashed_mknod_controls);
+
+  printf("<FSIMFSDirHash01>\n");
+
+  test_directory("linear", linear_mnt);
+  test_directory("hashed", hashed_mnt);
+
+  printf("</FSIMFSDirHash01>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_FILESYSTEM_IMFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (16 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,365 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems/counter.h>
+#include <rtems/imfs.h>
+#include <rtems/libcsupport.h>
+
+const char rtems_test_name[] = "FSIMFSEXTFILE 1";
+
+#define FILE_SIZE (1024U * 1024U)
+
+#define SMALL_CHUNK_SIZE 512U
+
+static const char memfile_mnt[] = "/memfile";
+
+static const char extfile_mnt[] = "/extfile";
+
+static const IMFS_mknod_controls extfile_mknod_controls = {
+  .directory = &IMFS_mknod_control_dir_default,
+  .device = &IMFS_mknod_control_device,
+  .file = &IMFS_mknod_control_extfile,
+  .fifo = &IMFS_mknod_control_enosys
+};
+
+typedef struct {
+  uint8_t *data;
+  uint8_t *check;
+  char path[32];
+} test_context;
+
+static test_context test_instance;
+
+static uintptr_t heap_used(void)
+{
+  Heap_Information_block info;
+  int rv;
+
+  rv = malloc_info(&info);
+  rtems_test_assert(rv == 0);
+
+  return info.Used.total;
+}
+
+static uint32_t kib_per_second(rtems_counter_ticks ticks)
+{
+  uint64_t ns = rtems_counter_ticks_to_nanoseconds(ticks);
+
+  if (ns == 0) {
+    ns = 1;
+  }
+
+  return (uint32_t) (((uint64_t) (FILE_SIZE / 1024) * 1000000000) / ns);
+}
+
+static void set_path(test_context *ctx, const char *mnt)
+{
+  int n;
+
+  n = snprintf(ctx->path, sizeof(ctx->path), "%s/file", mnt);
+  rtems_test_assert(n > 0 && (size_t) n < sizeof(ctx->path));
+}
+
+static void read_and_compare(
+  const test_context *ctx,
+  const uint8_t *expected,
+  size_t size
+)
+{
+  struct stat st;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  rv = stat(ctx->path, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.st_size == (off_t) size);
+
+  fd = open(ctx->path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  n = read(fd, ctx->check, FILE_SIZE);
+  rtems_test_assert(n == (ssize_t) size);
+  rtems_test_assert(memcmp(ctx->check, expected, size) == 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_holes_append_and_truncate(test_context *ctx)
+{
+  static const uint8_t abc[] = { 'a', 'b', 'c' };
+  uint8_t *expected;
+  ssize_t n;
+  off_t off;
+  int fd;
+  int rv;
+
+  expected = calloc(1, FILE_SIZE);
+  rtems_test_assert(expected != NULL);
+
+  fd = open(ctx->path, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  /* A write beyond the end of file leaves a hole filled with zeros */
+  off = lseek(fd, 1000, SEEK_SET);
+  rtems_test_assert(off == 1000);
+  n = write(fd, abc, sizeof(abc));
+  rtems_test_assert(n == (ssize_t) sizeof(abc));
+  memcpy(&expected[1000], abc, sizeof(abc));
+  read_and_compare(ctx, expected, 1003);
+
+  /* Overwrite across extent boundaries */
+  off = lseek(fd, 100, SEEK_SET);
+  rtems_test_assert(off == 100);
+  n = write(fd, ctx->data, 2000);
+  rtems_test_assert(n == 2000);
+  memcpy(&expected[100], ctx->data, 2000);
+  read_and_compare(ctx, expected, 2100);
+
+  /* A shrink followed by an extend exposes only zeros */
+  rv = ftruncate(fd, 10);
+  rtems_test_assert(rv == 0);
+  rv = ftruncate(fd, 5000);
+  rtems_test_assert(rv == 0);
+  memset(&expected[10], 0, FILE_SIZE - 10);
+  read_and_compare(ctx, expected, 5000);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  /* Appends ignore the file position */
+  fd = open(ctx->path, O_WRONLY | O_APPEND);
+  rtems_test_assert(fd >= 0);
+
+  off = lseek(fd, 0, SEEK_SET);
+  rtems_test_assert(off == 0);
+  n = write(fd, abc, sizeof(abc));
+  rtems_test_assert(n == (ssize_t) sizeof(abc));
+  memcpy(&expected[5000], abc, sizeof(abc));
+  read_and_compare(ctx, expected, 5003);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  /* A truncate to zero releases all data */
+  rv = truncate(ctx->path, 0);
+  rtems_test_assert(rv == 0);
+  read_and_compare(ctx, expected, 0);
+
+  rv = unlink(ctx->path);
+  rtems_test_assert(rv == 0);
+
+  free(expected);
+}
+
+static uint32_t write_file(
+  const test_context *ctx,
+  size_t chunk_size,
+  uintptr_t *overhead
+)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks duration;
+  uintptr_t used;
+  size_t offset;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  used = heap_used();
+
+  fd = open(ctx->path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  start = rtems_counter_read();
+
+  for (offset = 0; offset < FILE_SIZE; offset += chunk_size) {
+    n = write(fd, &ctx->data[offset], chunk_size);
+    rtems_test_assert(n == (ssize_t) chunk_size);
+  }
+
+  duration = rtems_counter_difference(rtems_counter_read(), start);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  *overhead = heap_used() - used - FILE_SIZE;
+
+  return kib_per_second(duration);
+}
+
+static uint32_t read_file(const test_context *ctx, size_t chunk_size)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks duration;
+  size_t offset;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  memset(ctx->check, 0, FILE_SIZE);
+
+  fd = open(ctx->path, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  start = rtems_counter_read();
+
+  for (offset = 0; offset < FILE_SIZE; offset += chunk_size) {
+    n = read(fd, &ctx->check[offset], chunk_size);
+    rtems_test_assert(n == (ssize_t) chunk_size);
+  }
+
+  duration = rtems_counter_difference(rtems_counter_read(), start);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rtems_test_assert(memcmp(ctx->data, ctx->check, FILE_SIZE) == 0);
+
+  return kib_per_second(duration);
+}
+
+/*
+ * Append a file of 1MiB in small chunks, read it back in small chunks and
+ * with a single read.  Returns the heap used by the file beyond its data.
+ */
+static uintptr_t test_file_system(
+  test_context *ctx,
+  const char *type,
+  const char *mnt
+)
+{
+  uintptr_t used;
+  uintptr_t overhead;
+  uint32_t write_rate;
+  uint32_t small_read_rate;
+  uint32_t large_read_rate;
+  int rv;
+
+  set_path(ctx, mnt);
+
+  used = heap_used();
+  write_rate = write_file(ctx, SMALL_CHUNK_SIZE, &overhead);
+  small_read_rate = read_file(ctx, SMALL_CHUNK_SIZE);
+  large_read_rate = read_file(ctx, FILE_SIZE);
+
+  rv = unlink(ctx->path);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(heap_used() == used);
+
+  printf(
+    "  <File type=\"%s\"><WriteKiBPerSecond>%" PRIu32
+      "</WriteKiBPerSecond><SmallReadKiBPerSecond>%" PRIu32
+      "</SmallReadKiBPerSecond><LargeReadKiBPerSecond>%" PRIu32
+      "</LargeReadKiBPerSecond><OverheadBytes>%" PRIuPTR
+      "</OverheadBytes></File>\n",
+    type,
+    write_rate,
+    small_read_rate,
+    large_read_rate,
+    overhead
+  );
+
+  return overhead;
+}
+
+static void do_mount(const char *mnt, const IMFS_mknod_controls *controls)
+{
+  int rv;
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  rv = mount(
+    NULL,
+    mnt,
+    RTEMS_FILESYSTEM_TYPE_IMFS,
+    RTEMS_FILESYSTEM_READ_WRITE,
+    controls
+  );
+  rtems_test_assert(rv == 0);
+}
+
+static void test(test_context *ctx)
+{
+  uintptr_t memfile_overhead;
+  uintptr_t extfile_overhead;
+  size_t i;
+
+  ctx->data = malloc(FILE_SIZE);
+  rtems_test_assert(ctx->data != NULL);
+
+  ctx->check = malloc(FILE_SIZE);
+  rtems_test_assert(ctx->check != NULL);
+
+  for (i = 0; i < FILE_SIZE; ++i) {
+    ctx->data[i] = (uint8_t) (i % 251);
+  }
+
+  do_mount(memfile_mnt, NULL);
+  do_mount(extfile_mnt, &extfile_mknod_controls);
+
+  set_path(ctx, extfile_mnt);
+  test_holes_append_and_truncate(ctx);
+
+  set_path(ctx, memfile_mnt);
+  test_holes_append_and_truncate(ctx);
+
+  printf("<FSIMFSExtFile01>\n");
+
+  memfile_overhead = test_file_system(ctx, "memfile", memfile_mnt);
+  extfile_overhead = test_file_system(ctx, "extfile", extfile_mnt);
+
+  printf("</FSIMFSExtFile01>\n");
+
+  rtems_test_assert(extfile_overhead < memfile_overhead);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test(&test_instance);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_FILESYSTEM_IMFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (16 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
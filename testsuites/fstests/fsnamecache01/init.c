@@ -0,0 +1,305 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+#include "format_support.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/libio_.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "FSNAMECACHE 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 4096U
+
+#define DEPTH 8
+
+#define FILE_COUNT 32
+
+#define STAT_COUNT 1000
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static void create_file(const char *path)
+{
+  int fd;
+  int rv;
+
+  fd = open(path, O_WRONLY | O_CREAT | O_EXCL, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void check_exists(const char *path, bool exists)
+{
+  struct stat st;
+  int rv;
+
+  errno = 0;
+  rv = stat(path, &st);
+
+  if (exists) {
+    rtems_test_assert(rv == 0);
+  } else {
+    rtems_test_assert(rv == -1);
+    rtems_test_assert(errno == ENOENT);
+  }
+}
+
+/*
+ * Returns the path of the directory at the depth.  The files of the deepest
+ * directory are the lookup targets.
+ */
+static void make_dir_path(char *path, size_t size, int depth)
+{
+  int n;
+  int i;
+
+  n = snprintf(path, size, "%s", mnt);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+
+  for (i = 0; i < depth; ++i) {
+    int m;
+
+    m = snprintf(&path[n], size - (size_t) n, "/dir%i", i);
+    rtems_test_assert(m > 0 && (size_t) m < size - (size_t) n);
+    n += m;
+  }
+}
+
+static void make_file_path(char *path, size_t size, int i)
+{
+  char dir[128];
+  int n;
+
+  make_dir_path(dir, sizeof(dir), DEPTH);
+  n = snprintf(path, size, "%s/file%02i", dir, i);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+static void create_tree(void)
+{
+  char path[160];
+  int rv;
+  int i;
+
+  for (i = 1; i <= DEPTH; ++i) {
+    make_dir_path(path, sizeof(path), i);
+    rv = mkdir(path, S_IRWXU);
+    rtems_test_assert(rv == 0);
+  }
+
+  for (i = 0; i < FILE_COUNT; ++i) {
+    make_file_path(path, sizeof(path), i);
+    create_file(path);
+  }
+}
+
+static uint32_t stat_tree(void)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks duration;
+  char path[160];
+  struct stat st;
+  int rv;
+  int i;
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < STAT_COUNT; ++i) {
+    make_file_path(path, sizeof(path), i % FILE_COUNT);
+    rv = stat(path, &st);
+    rtems_test_assert(rv == 0);
+    rtems_test_assert(S_ISREG(st.st_mode));
+  }
+
+  duration = rtems_counter_difference(rtems_counter_read(), start);
+
+  return (uint32_t) (rtems_counter_ticks_to_nanoseconds(duration) / STAT_COUNT);
+}
+
+/*
+ * The cached names and the cached negative results must follow the changes
+ * of the directories.
+ */
+static void test_invalidation(void)
+{
+  char dir[128];
+  char path[160];
+  char new_path[160];
+  int rv;
+
+  make_dir_path(dir, sizeof(dir), DEPTH);
+
+  /* A negative entry goes away with the create */
+  rv = snprintf(path, sizeof(path), "%s/new", dir);
+  rtems_test_assert(rv > 0 && (size_t) rv < sizeof(path));
+  check_exists(path, false);
+  check_exists(path, false);
+  create_file(path);
+  check_exists(path, true);
+
+  /* The old name goes away with the rename */
+  rv = snprintf(new_path, sizeof(new_path), "%s/renamed", dir);
+  rtems_test_assert(rv > 0 && (size_t) rv < sizeof(new_path));
+  check_exists(new_path, false);
+  rv = rename(path, new_path);
+  rtems_test_assert(rv == 0);
+  check_exists(path, false);
+  check_exists(new_path, true);
+
+  /* The name goes away with the unlink */
+  rv = unlink(new_path);
+  rtems_test_assert(rv == 0);
+  check_exists(new_path, false);
+
+  /* The names of a removed directory go away with it */
+  rv = snprintf(path, sizeof(path), "%s/sub", dir);
+  rtems_test_assert(rv > 0 && (size_t) rv < sizeof(path));
+  rv = mkdir(path, S_IRWXU);
+  rtems_test_assert(rv == 0);
+  rv = snprintf(new_path, sizeof(new_path), "%s/sub/file", dir);
+  rtems_test_assert(rv > 0 && (size_t) rv < sizeof(new_path));
+  create_file(new_path);
+  check_exists(new_path, true);
+  rv = unlink(new_path);
+  rtems_test_assert(rv == 0);
+  rv = rmdir(path);
+  rtems_test_assert(rv == 0);
+  check_exists(new_path, false);
+  rv = mkdir(path, S_IRWXU);
+  rtems_test_assert(rv == 0);
+  check_exists(new_path, false);
+  rv = rmdir(path);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_file_system(const char *type)
+{
+  rtems_filesystem_name_cache_stats stats;
+  uint32_t cold_ns;
+  uint32_t warm_ns;
+  int rv;
+
+  rv = mount(rda, mnt, type, RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+
+  create_tree();
+  test_invalidation();
+
+  /* A new mount starts with an empty name cache */
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+  rv = mount(rda, mnt, type, RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+
+  rtems_filesystem_name_cache_get_and_reset_stats(&stats);
+
+  cold_ns = stat_tree();
+  warm_ns = stat_tree();
+
+  rtems_filesystem_name_cache_get_and_reset_stats(&stats);
+  rtems_test_assert(stats.misses == DEPTH + FILE_COUNT);
+  rtems_test_assert(
+    stats.hits == 2 * STAT_COUNT * (DEPTH + 1) - DEPTH - FILE_COUNT
+  );
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+
+  printf(
+    "  <Lookup fs=\"%s\"><FirstStatNs>%" PRIu32
+      "</FirstStatNs><SecondStatNs>%" PRIu32
+      "</SecondStatNs><Hits>%" PRIu32 "</Hits><Misses>%" PRIu32
+      "</Misses></Lookup>\n",
+    type,
+    cold_ns,
+    warm_ns,
+    stats.hits,
+    stats.misses
+  );
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  ramdisk *rd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  printf("<FSNameCache01>\n");
+
+  format_rfs(rda, BLOCK_SIZE);
+  test_file_system(RTEMS_FILESYSTEM_TYPE_RFS);
+  format_dosfs(rda, 0);
+  test_file_system(RTEMS_FILESYSTEM_TYPE_DOSFS);
+
+  printf("</FSNameCache01>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_FILESYSTEM_NAME_CACHE_ENTRIES 128
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
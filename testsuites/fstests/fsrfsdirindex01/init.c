@@ -0,0 +1,489 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+#include <rtems/rtems-rfs-format.h>
+#include <rtems/rfs/rtems-rfs-dir.h>
+#include <rtems/rfs/rtems-rfs-file-system.h>
+#include <rtems/rfs/rtems-rfs-inode.h>
+
+const char rtems_test_name[] = "FSRFSDIRINDEX 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 1024U
+
+#define BLOCK_COUNT 8192U
+
+#define GROUP_BLOCKS 1024U
+
+#define GROUP_INODES 7000U
+
+#define ENTRY_COUNT 50000U
+
+#define LOOKUP_COUNT 1000U
+
+#define RENAME_COUNT 1000U
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char dir[] = "/mnt/dir";
+
+static uint8_t seen[(ENTRY_COUNT + 7) / 8];
+
+static void make_path(char *path, size_t size, unsigned int i)
+{
+  int n;
+
+  n = snprintf(path, size, "%s/file%05u", dir, i);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+static void do_format(bool dir_index)
+{
+  rtems_rfs_format_config config = {
+    .block_size = BLOCK_SIZE,
+    .group_blocks = GROUP_BLOCKS,
+    .group_inodes = GROUP_INODES,
+    .dir_index = dir_index
+  };
+  int rv;
+
+  rv = rtems_rfs_format(rda, &config);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_mount(void)
+{
+  int rv;
+
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_RFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+static void create_file(unsigned int i)
+{
+  char path[32];
+  int fd;
+  int rv;
+
+  make_path(path, sizeof(path), i);
+
+  fd = open(path, O_WRONLY | O_CREAT | O_EXCL, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void check_exists(unsigned int i, bool exists)
+{
+  struct stat st;
+  char path[32];
+  int rv;
+
+  make_path(path, sizeof(path), i);
+
+  errno = 0;
+  rv = stat(path, &st);
+
+  if (exists) {
+    rtems_test_assert(rv == 0);
+    rtems_test_assert(S_ISREG(st.st_mode));
+  } else {
+    rtems_test_assert(rv == -1);
+    rtems_test_assert(errno == ENOENT);
+  }
+}
+
+static uint64_t create_files(void)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks ticks;
+  unsigned int i;
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    create_file(i);
+  }
+
+  ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  return rtems_counter_ticks_to_nanoseconds(ticks) / ENTRY_COUNT;
+}
+
+/*
+ * Each name is looked up once, so that the names are not in the name cache.
+ */
+static uint64_t lookup_files(void)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks ticks;
+  unsigned int i;
+
+  start = rtems_counter_read();
+
+  for (i = 0; i < ENTRY_COUNT; i += ENTRY_COUNT / LOOKUP_COUNT) {
+    check_exists(i, true);
+  }
+
+  ticks = rtems_counter_difference(rtems_counter_read(), start);
+
+  return rtems_counter_ticks_to_nanoseconds(ticks) / LOOKUP_COUNT;
+}
+
+/* Every name of the directory must show up once in the directory read */
+static void check_read_dir(unsigned int step)
+{
+  struct dirent *de;
+  unsigned int count;
+  unsigned int i;
+  DIR *d;
+  int rv;
+
+  memset(seen, 0, sizeof(seen));
+  count = 0;
+
+  d = opendir(dir);
+  rtems_test_assert(d != NULL);
+
+  while ((de = readdir(d)) != NULL) {
+    if (strcmp(de->d_name, ".") == 0 || strcmp(de->d_name, "..") == 0) {
+      continue;
+    }
+
+    rtems_test_assert(strncmp(de->d_name, "file", 4) == 0);
+    i = (unsigned int) strtoul(&de->d_name[4], NULL, 10);
+    rtems_test_assert(i < ENTRY_COUNT);
+    rtems_test_assert((seen[i / 8] & (1U << (i % 8))) == 0);
+    seen[i / 8] |= 1U << (i % 8);
+    ++count;
+  }
+
+  rv = closedir(d);
+  rtems_test_assert(rv == 0);
+
+  rtems_test_assert(count == (ENTRY_COUNT + step - 1) / step);
+
+  for (i = 0; i < ENTRY_COUNT; i += step) {
+    rtems_test_assert((seen[i / 8] & (1U << (i % 8))) != 0);
+  }
+}
+
+static void check_index(void)
+{
+  char old_path[32];
+  char new_path[32];
+  unsigned int i;
+  int rv;
+
+  check_read_dir(1);
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    check_exists(i, true);
+  }
+
+  for (i = 1; i < ENTRY_COUNT; i += 2) {
+    char path[32];
+
+    make_path(path, sizeof(path), i);
+    rv = unlink(path);
+    rtems_test_assert(rv == 0);
+  }
+
+  check_read_dir(2);
+
+  /*
+   * The new names of a rename may split the block of the old name.
+   */
+  for (i = 0; i < 2 * RENAME_COUNT; i += 2) {
+    make_path(old_path, sizeof(old_path), i);
+    make_path(new_path, sizeof(new_path), i + 1);
+    rv = rename(old_path, new_path);
+    rtems_test_assert(rv == 0);
+  }
+
+  do_unmount();
+  do_mount();
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    bool even = (i % 2) == 0;
+
+    check_exists(i, i < 2 * RENAME_COUNT ? !even : even);
+  }
+
+  for (i = 0; i < ENTRY_COUNT; ++i) {
+    if (i < 2 * RENAME_COUNT ? (i % 2) != 0 : (i % 2) == 0) {
+      char path[32];
+
+      make_path(path, sizeof(path), i);
+      rv = unlink(path);
+      rtems_test_assert(rv == 0);
+    }
+  }
+
+  rv = rmdir(dir);
+  rtems_test_assert(rv == 0);
+}
+
+static ino_t get_ino(const char *path)
+{
+  struct stat st;
+  int rv;
+
+  rv = stat(path, &st);
+  rtems_test_assert(rv == 0);
+
+  return st.st_ino;
+}
+
+/*
+ * The linear add and delete of a file system without the index support must
+ * not modify an indexed directory.  Clear the index flag of the directory
+ * inode and check that they refuse to change it.
+ */
+static void check_lost_index_flag(rtems_rfs_ino dir_ino, rtems_rfs_ino ino)
+{
+  rtems_rfs_file_system *fs;
+  rtems_rfs_inode_handle inode;
+  uint16_t flags;
+  int rv;
+
+  rv = rtems_rfs_fs_open(rda, NULL, 0, RTEMS_RFS_FS_MAX_HELD_BUFFERS, &fs);
+  rtems_test_assert(rv == 0);
+
+  rv = rtems_rfs_inode_open(fs, dir_ino, &inode, true);
+  rtems_test_assert(rv == 0);
+
+  flags = rtems_rfs_inode_get_flags(&inode);
+  rtems_test_assert((flags & RTEMS_RFS_INODE_FLAG_DIR_INDEX) != 0);
+  rtems_rfs_inode_set_flags(&inode, flags & ~RTEMS_RFS_INODE_FLAG_DIR_INDEX);
+
+  rv = rtems_rfs_dir_add_entry(fs, &inode, "lost", 4, ino);
+  rtems_test_assert(rv == EIO);
+
+  rv = rtems_rfs_dir_del_entry(fs, &inode, ino, 0);
+  rtems_test_assert(rv == EIO);
+
+  rtems_rfs_inode_set_flags(&inode, flags);
+
+  rv = rtems_rfs_inode_close(fs, &inode);
+  rtems_test_assert(rv == 0);
+
+  rv = rtems_rfs_fs_close(fs);
+  rtems_test_assert(rv == 0);
+}
+
+static void test_dir(bool dir_index)
+{
+  uint64_t create_ns;
+  uint64_t lookup_ns;
+  int rv;
+
+  do_format(dir_index);
+  do_mount();
+
+  rv = mkdir(dir, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  create_ns = create_files();
+
+  do_unmount();
+  do_mount();
+
+  lookup_ns = lookup_files();
+
+  if (dir_index) {
+    char path[32];
+    rtems_rfs_ino dir_ino;
+    rtems_rfs_ino ino;
+
+    make_path(path, sizeof(path), 0);
+    dir_ino = get_ino(dir);
+    ino = get_ino(path);
+
+    do_unmount();
+    check_lost_index_flag(dir_ino, ino);
+    do_mount();
+
+    check_exists(0, true);
+    check_index();
+  }
+
+  do_unmount();
+
+  printf(
+    "  <Directory entries=\"%u\" index=\"%s\"><CreateNs>%" PRIu64
+      "</CreateNs><LookupNs>%" PRIu64 "</LookupNs></Directory>\n",
+    ENTRY_COUNT,
+    dir_index ? "yes" : "no",
+    create_ns,
+    lookup_ns
+  );
+}
+
+static uint32_t read_sb(int fd, off_t offset)
+{
+  uint8_t data[4];
+  ssize_t n;
+
+  n = pread(fd, data, sizeof(data), offset);
+  rtems_test_assert(n == (ssize_t) sizeof(data));
+
+  return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) |
+    ((uint32_t) data[2] << 8) | data[3];
+}
+
+static void write_sb(int fd, off_t offset, uint32_t value)
+{
+  uint8_t data[4];
+  ssize_t n;
+
+  data[0] = (uint8_t) (value >> 24);
+  data[1] = (uint8_t) (value >> 16);
+  data[2] = (uint8_t) (value >> 8);
+  data[3] = (uint8_t) value;
+
+  n = pwrite(fd, data, sizeof(data), offset);
+  rtems_test_assert(n == (ssize_t) sizeof(data));
+}
+
+static void check_mount_fails(void)
+{
+  int rv;
+
+  errno = 0;
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_RFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == -1);
+  rtems_test_assert(errno == EIO);
+}
+
+/*
+ * File systems without the index support check only the old magic, so an
+ * indexed file system has another magic.  Unknown version bits and the index
+ * bit with the old magic are rejected.
+ */
+static void test_superblock(void)
+{
+  uint32_t magic;
+  uint32_t version;
+  int fd;
+  int rv;
+
+  do_format(true);
+
+  fd = open(rda, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  magic = read_sb(fd, RTEMS_RFS_SB_OFFSET_MAGIC);
+  version = read_sb(fd, RTEMS_RFS_SB_OFFSET_VERSION);
+  rtems_test_assert(magic == RTEMS_RFS_SB_MAGIC_FEATURES);
+  rtems_test_assert(
+    version == (RTEMS_RFS_VERSION | RTEMS_RFS_VERSION_DIR_INDEX)
+  );
+
+  write_sb(fd, RTEMS_RFS_SB_OFFSET_VERSION, version | 0x80000000);
+  check_mount_fails();
+
+  write_sb(fd, RTEMS_RFS_SB_OFFSET_VERSION, version);
+  write_sb(fd, RTEMS_RFS_SB_OFFSET_MAGIC, RTEMS_RFS_SB_MAGIC);
+  check_mount_fails();
+
+  write_sb(fd, RTEMS_RFS_SB_OFFSET_MAGIC, magic);
+  do_mount();
+  do_unmount();
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  ramdisk *rd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  printf("<FSRFSDirIndex01>\n");
+  test_dir(false);
+  test_dir(true);
+  printf("</FSRFSDirIndex01>\n");
+
+  test_superblock();
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,425 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/blkdev.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+#include <rtems/rtems-rfs-format.h>
+
+const char rtems_test_name[] = "FSRFSLOCK 1";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define READER_COUNT 4
+
+#define BLOCK_SIZE 1024U
+
+#define BLOCK_COUNT 4096U
+
+#define FILE_SIZE (256U * 1024U)
+
+/*
+ * The files of the writers are grown to the extended size, truncated and
+ * unlinked in each iteration.
+ */
+#define WRITER_FILE_SIZE (32U * 1024U)
+
+#define WRITER_EXTENDED_SIZE (2U * WRITER_FILE_SIZE)
+
+/*
+ * Reads of one and a half blocks use both the buffers and the direct block
+ * transfers.
+ */
+#define CHUNK_SIZE (3U * BLOCK_SIZE / 2U)
+
+#define DURATION_IN_SECONDS 1
+
+#define MASTER_PRIORITY 1
+
+#define READER_PRIORITY 2
+
+#define READER_STACK_SIZE (8 * 1024)
+
+typedef struct {
+  rtems_id done;
+  rtems_id reader_ids[READER_COUNT];
+  int fds[READER_COUNT];
+  volatile bool stop;
+  volatile bool write;
+  unsigned long bytes[READER_COUNT];
+  uint32_t bufs[READER_COUNT][CHUNK_SIZE / sizeof(uint32_t)];
+} test_context;
+
+static test_context test_instance;
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static void make_path(char *path, size_t size, size_t i)
+{
+  int n;
+
+  n = snprintf(path, size, "%s/file%zu", mnt, i);
+  rtems_test_assert(n > 0 && (size_t) n < size);
+}
+
+/* Each word of a file contains its offset combined with a file specific seed */
+static uint32_t pattern(off_t offset, size_t i)
+{
+  return (uint32_t) offset + (uint32_t) i * 0x01000193U;
+}
+
+static void write_file(test_context *ctx, int fd, size_t i, size_t file_size)
+{
+  uint32_t *buf = ctx->bufs[i];
+  off_t offset;
+
+  for (offset = 0; offset < file_size; offset += CHUNK_SIZE) {
+    size_t size = MIN(CHUNK_SIZE, file_size - (size_t) offset);
+    size_t j;
+    ssize_t n;
+
+    for (j = 0; j < size / sizeof(buf[0]); ++j) {
+      buf[j] = pattern(offset + j * sizeof(buf[0]), i);
+    }
+
+    n = write(fd, buf, size);
+    rtems_test_assert(n == (ssize_t) size);
+  }
+}
+
+static void create_file(test_context *ctx, size_t i)
+{
+  char path[32];
+  int fd;
+  int rv;
+
+  make_path(path, sizeof(path), i);
+
+  fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  write_file(ctx, fd, i, FILE_SIZE);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void read_chunk_of_fd(
+  test_context *ctx,
+  int fd,
+  size_t i,
+  off_t offset,
+  size_t size
+)
+{
+  uint32_t *buf = ctx->bufs[i];
+  size_t j;
+  ssize_t n;
+
+  n = read(fd, buf, size);
+  rtems_test_assert(n == (ssize_t) size);
+
+  for (j = 0; j < size / sizeof(buf[0]); ++j) {
+    rtems_test_assert(buf[j] == pattern(offset + j * sizeof(buf[0]), i));
+  }
+}
+
+static void read_chunk(test_context *ctx, size_t i, off_t offset, size_t size)
+{
+  read_chunk_of_fd(ctx, ctx->fds[i], i, offset, size);
+}
+
+static void assert_size(int fd, off_t size)
+{
+  struct stat st;
+  int rv;
+
+  rv = fstat(fd, &st);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(st.st_size == size);
+}
+
+/*
+ * Writes, extends, truncates, verifies and unlinks a file of its own.  All
+ * files are in the same group, so the block allocations and frees of the
+ * writers contend for the bitmap lock of this group while each writer holds
+ * the lock of its file.  The unlink obtains the file system lock first.
+ */
+static unsigned long write_iteration(test_context *ctx, size_t i)
+{
+  char path[32];
+  off_t offset;
+  off_t off;
+  int fd;
+  int rv;
+
+  make_path(path, sizeof(path), READER_COUNT + i);
+
+  fd = open(path, O_RDWR | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  write_file(ctx, fd, i, WRITER_FILE_SIZE);
+  assert_size(fd, WRITER_FILE_SIZE);
+
+  rv = ftruncate(fd, WRITER_EXTENDED_SIZE);
+  rtems_test_assert(rv == 0);
+  assert_size(fd, WRITER_EXTENDED_SIZE);
+
+  rv = ftruncate(fd, WRITER_FILE_SIZE / 2);
+  rtems_test_assert(rv == 0);
+  assert_size(fd, WRITER_FILE_SIZE / 2);
+
+  off = lseek(fd, 0, SEEK_SET);
+  rtems_test_assert(off == 0);
+
+  for (offset = 0; offset < WRITER_FILE_SIZE / 2; offset += CHUNK_SIZE) {
+    size_t size = MIN(CHUNK_SIZE, WRITER_FILE_SIZE / 2 - (size_t) offset);
+
+    read_chunk_of_fd(ctx, fd, i, offset, size);
+  }
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rv = unlink(path);
+  rtems_test_assert(rv == 0);
+
+  return WRITER_FILE_SIZE;
+}
+
+static void reader_task(rtems_task_argument arg)
+{
+  test_context *ctx = &test_instance;
+  size_t reader_index = arg;
+
+  while (true) {
+    rtems_status_code sc;
+    unsigned long bytes = 0;
+    off_t offset = 0;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    ASSERT_SC(sc);
+
+    while (ctx->write && !ctx->stop) {
+      bytes += write_iteration(ctx, reader_index);
+    }
+
+    while (!ctx->write && !ctx->stop) {
+      size_t size = MIN(CHUNK_SIZE, FILE_SIZE - (size_t) offset);
+
+      read_chunk(ctx, reader_index, offset, size);
+      bytes += size;
+      offset += size;
+
+      if (offset == FILE_SIZE) {
+        off_t off;
+
+        off = lseek(ctx->fds[reader_index], 0, SEEK_SET);
+        rtems_test_assert(off == 0);
+        offset = 0;
+      }
+    }
+
+    ctx->bytes[reader_index] = bytes;
+
+    sc = rtems_semaphore_release(ctx->done);
+    ASSERT_SC(sc);
+  }
+}
+
+static unsigned long bytes_transferred(
+  test_context *ctx,
+  size_t reader_count,
+  bool write
+)
+{
+  rtems_status_code sc;
+  unsigned long total = 0;
+  size_t i;
+
+  for (i = 0; i < reader_count; ++i) {
+    off_t off;
+
+    off = lseek(ctx->fds[i], 0, SEEK_SET);
+    rtems_test_assert(off == 0);
+  }
+
+  ctx->write = write;
+  ctx->stop = false;
+
+  for (i = 0; i < reader_count; ++i) {
+    sc = rtems_event_transient_send(ctx->reader_ids[i]);
+    ASSERT_SC(sc);
+  }
+
+  sc = rtems_task_wake_after(
+    DURATION_IN_SECONDS * rtems_clock_get_ticks_per_second()
+  );
+  ASSERT_SC(sc);
+
+  ctx->stop = true;
+
+  for (i = 0; i < reader_count; ++i) {
+    sc = rtems_semaphore_obtain(ctx->done, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    ASSERT_SC(sc);
+
+    rtems_test_assert(ctx->bytes[i] > 0);
+    total += ctx->bytes[i];
+  }
+
+  return total;
+}
+
+static void test(test_context *ctx)
+{
+  static const rtems_rfs_format_config config = {
+    .block_size = BLOCK_SIZE
+  };
+  rtems_status_code sc;
+  ramdisk *rd;
+  size_t reader_count;
+  size_t i;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = rtems_rfs_format(rda, &config);
+  rtems_test_assert(rv == 0);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  rv = mount(rda, mnt, RTEMS_FILESYSTEM_TYPE_RFS,
+    RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+
+  sc = rtems_semaphore_create(
+    rtems_build_name('D', 'O', 'N', 'E'),
+    0,
+    RTEMS_COUNTING_SEMAPHORE,
+    0,
+    &ctx->done
+  );
+  ASSERT_SC(sc);
+
+  for (i = 0; i < READER_COUNT; ++i) {
+    char path[32];
+
+    create_file(ctx, i);
+
+    make_path(path, sizeof(path), i);
+    ctx->fds[i] = open(path, O_RDONLY);
+    rtems_test_assert(ctx->fds[i] >= 0);
+
+    sc = rtems_task_create(
+      rtems_build_name('R', 'E', 'A', 'D'),
+      READER_PRIORITY,
+      READER_STACK_SIZE,
+      RTEMS_TIMESLICE,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &ctx->reader_ids[i]
+    );
+    ASSERT_SC(sc);
+
+    sc = rtems_task_start(ctx->reader_ids[i], reader_task, i);
+    ASSERT_SC(sc);
+  }
+
+  printf("<FSRFSLock01>\n");
+
+  for (reader_count = 1; reader_count <= READER_COUNT; reader_count *= 2) {
+    printf(
+      "  <Readers count=\"%zu\"><BytesPerSecond>%lu</BytesPerSecond>"
+        "</Readers>\n",
+      reader_count,
+      bytes_transferred(ctx, reader_count, false) / DURATION_IN_SECONDS
+    );
+  }
+
+  for (reader_count = 1; reader_count <= READER_COUNT; reader_count *= 2) {
+    printf(
+      "  <Writers count=\"%zu\"><BytesPerSecond>%lu</BytesPerSecond>"
+        "</Writers>\n",
+      reader_count,
+      bytes_transferred(ctx, reader_count, true) / DURATION_IN_SECONDS
+    );
+  }
+
+  printf("</FSRFSLock01>\n");
+
+  for (i = 0; i < READER_COUNT; ++i) {
+    sc = rtems_task_delete(ctx->reader_ids[i]);
+    ASSERT_SC(sc);
+
+    rv = close(ctx->fds[i]);
+    rtems_test_assert(rv == 0);
+  }
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test(&test_instance);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS (4 + 2 * READER_COUNT)
+
+#define CONFIGURE_MAXIMUM_PROCESSORS READER_COUNT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+/*
+ * Switch between the readers often, so that the file operations interleave.
+ */
+#define CONFIGURE_TICKS_PER_TIMESLICE 1
+
+#define CONFIGURE_INIT_TASK_PRIORITY MASTER_PRIORITY
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_DEFAULT_ATTRIBUTES
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
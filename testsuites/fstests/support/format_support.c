@@ -0,0 +1,40 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <rtems/dosfs.h>
+#include <rtems/rtems-rfs-format.h>
+
+#include "format_support.h"
+#include "tmacros.h"
+
+void
+format_rfs (const char *device, size_t block_size)
+{
+  rtems_rfs_format_config config = {
+    .block_size = block_size
+  };
+  int rc;
+
+  rc = rtems_rfs_format (device, &config);
+  rtems_test_assert (rc == 0);
+}
+
+void
+format_dosfs (const char *device, uint32_t sectors_per_cluster)
+{
+  msdos_format_request_param_t config = {
+    .sectors_per_cluster = sectors_per_cluster,
+    .quick_format = true
+  };
+  int rc;
+
+  rc = msdos_format (device, &config);
+  rtems_test_assert (rc == 0);
+}
@@ -0,0 +1,32 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifndef __FORMAT_SUPPORT_H
+#define __FORMAT_SUPPORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Formats the device with a RFS file system of the block size.
+ */
+extern void format_rfs(const char *device, size_t block_size);
+
+/*
+ * Formats the device quickly with a FAT file system.  A sectors per cluster
+ * value of zero selects the default of the format.
+ */
+extern void format_dosfs(const char *device, uint32_t sectors_per_cluster);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
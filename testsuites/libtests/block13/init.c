@@ -57,11 +57,11 @@ static const int action_sequence [READ_COUNT] = {
 static const int expected_block_access_counts [READ_COUNT] [BLOCK_COUNT] = {
    { 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
    { 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0 },
-   { 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0 },
-   { 1, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0 },
-   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+   { 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+   { 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+   { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
    { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
    { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
    { 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
@@ -76,7 +76,7 @@ static const int expected_block_access_counts [READ_COUNT] [BLOCK_COUNT] = {
    { 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1 },
    UNUSED_LINE,
    { 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0 },
-   { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1 },
+   { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0 },
    { 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1 }
 };
 
@@ -85,7 +85,7 @@ static const int expected_block_access_counts [READ_COUNT] [BLOCK_COUNT] = {
 #define TRIGGER_AFTER_RESET RTEMS_DISK_READ_AHEAD_NO_TRIGGER
 
 static const rtems_blkdev_bnum trigger [READ_COUNT] = {
-  1, 3, 5, 5, 8, 8, 8, NO_TRIGGER, NO_TRIGGER, NO_TRIGGER,
+  1, 3, 5, 5, 7, 7, NO_TRIGGER, NO_TRIGGER, NO_TRIGGER, NO_TRIGGER,
   TRIGGER_AFTER_RESET,
   11,
   TRIGGER_AFTER_RESET,
@@ -93,7 +93,7 @@ static const rtems_blkdev_bnum trigger [READ_COUNT] = {
   TRIGGER_AFTER_RESET,
   9,
   TRIGGER_AFTER_RESET,
-  8, NO_TRIGGER,
+  8, 10,
   TRIGGER_AFTER_RESET,
   7, 9, NO_TRIGGER
 };
@@ -101,17 +101,17 @@ static const rtems_blkdev_bnum trigger [READ_COUNT] = {
 #define NOT_CHANGED_BY_RESET(i) (i)
 
 static const rtems_blkdev_bnum next [READ_COUNT] = {
-  2, 4, 7, 7, 10, 10, 10, 10, 10, 10,
-  NOT_CHANGED_BY_RESET(10),
+  2, 4, 6, 6, 9, 9, 9, 9, 9, 9,
+  NOT_CHANGED_BY_RESET(9),
   12,
   NOT_CHANGED_BY_RESET(12),
   11,
   NOT_CHANGED_BY_RESET(11),
   10,
   NOT_CHANGED_BY_RESET(10),
-  9, 9,
-  NOT_CHANGED_BY_RESET(9),
-  8, 11, 11
+  9, 11,
+  NOT_CHANGED_BY_RESET(11),
+  8, 10, 10
 };
 
 static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
@@ -141,6 +141,29 @@ static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
   return rv;
 }
 
+/*
+ * The read-ahead window of a stream starts at one block and doubles each time
+ * the stream reaches its trigger up to the maximum read-ahead blocks.  Check
+ * the most recently used stream.
+ */
+static const rtems_blkdev_read_ahead_stream *get_stream(
+  const rtems_disk_device *dd
+)
+{
+  const rtems_blkdev_read_ahead_stream *stream = &dd->read_ahead.streams [0];
+  size_t i;
+
+  for (i = 1; i < RTEMS_DISK_READ_AHEAD_STREAM_COUNT; ++i) {
+    const rtems_blkdev_read_ahead_stream *other = &dd->read_ahead.streams [i];
+
+    if ((int32_t) (other->last_use - stream->last_use) > 0) {
+      stream = other;
+    }
+  }
+
+  return stream;
+}
+
 static void test_read_ahead(rtems_disk_device *dd)
 {
   int i;
@@ -175,8 +198,8 @@ static void test_read_ahead(rtems_disk_device *dd)
       memset(&block_access_counts, 0, sizeof(block_access_counts));
     }
 
-    rtems_test_assert(trigger [i] == dd->read_ahead.trigger);
-    rtems_test_assert(next [i] == dd->read_ahead.next);
+    rtems_test_assert(trigger [i] == get_stream(dd)->trigger);
+    rtems_test_assert(next [i] == get_stream(dd)->next);
   }
 
   printf("\n");
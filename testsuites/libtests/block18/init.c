@@ -0,0 +1,289 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "BLOCK 18";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define READER_COUNT 8
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 256U
+
+#define DURATION_IN_SECONDS 1
+
+/*
+ * A block of the maximum buffer size uses a group.  The blocks are two
+ * partition extents, so the partition of an extent needs twice the groups it
+ * owns initially.
+ */
+#define HOLD_BLOCK_SIZE 4096U
+
+#define HOLD_BLOCK_COUNT 64U
+
+#define MASTER_PRIORITY 1
+
+#define READER_PRIORITY 2
+
+typedef struct {
+  rtems_disk_device *dd;
+  rtems_id done;
+  rtems_id reader_ids[READER_COUNT];
+  volatile bool stop;
+  unsigned long lookups[READER_COUNT];
+  rtems_bdbuf_buffer *held[HOLD_BLOCK_COUNT];
+} test_context;
+
+static test_context test_instance;
+
+static const char rda[] = "/dev/rda";
+
+static const char rdb[] = "/dev/rdb";
+
+static void read_block(test_context *ctx, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(ctx->dd, block, &bd);
+  ASSERT_SC(sc);
+
+  sc = rtems_bdbuf_release(bd);
+  ASSERT_SC(sc);
+}
+
+static void reader_task(rtems_task_argument arg)
+{
+  test_context *ctx = &test_instance;
+  size_t reader_index = arg;
+  uint32_t seed = (uint32_t) arg + 1;
+
+  while (true) {
+    rtems_status_code sc;
+    unsigned long lookups = 0;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    ASSERT_SC(sc);
+
+    while (!ctx->stop) {
+      seed = seed * 1103515245U + 12345U;
+      read_block(ctx, (seed >> 16) % BLOCK_COUNT);
+      ++lookups;
+    }
+
+    ctx->lookups[reader_index] = lookups;
+
+    sc = rtems_semaphore_release(ctx->done);
+    ASSERT_SC(sc);
+  }
+}
+
+static unsigned long lookups(test_context *ctx, size_t reader_count)
+{
+  rtems_status_code sc;
+  unsigned long total = 0;
+  size_t i;
+
+  ctx->stop = false;
+
+  for (i = 0; i < reader_count; ++i) {
+    sc = rtems_event_transient_send(ctx->reader_ids[i]);
+    ASSERT_SC(sc);
+  }
+
+  sc = rtems_task_wake_after(
+    DURATION_IN_SECONDS * rtems_clock_get_ticks_per_second()
+  );
+  ASSERT_SC(sc);
+
+  ctx->stop = true;
+
+  for (i = 0; i < reader_count; ++i) {
+    sc = rtems_semaphore_obtain(ctx->done, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    ASSERT_SC(sc);
+
+    total += ctx->lookups[i];
+  }
+
+  return total;
+}
+
+/*
+ * Get more buffers at once than a partition owns initially.  The partitions
+ * of the blocks have to take groups from other partitions.
+ */
+static void test_hold_many(test_context *ctx)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  ramdisk *rd;
+  rtems_blkdev_bnum block;
+  int fd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, HOLD_BLOCK_SIZE, HOLD_BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(
+    rdb,
+    HOLD_BLOCK_SIZE,
+    HOLD_BLOCK_COUNT,
+    ramdisk_ioctl,
+    rd
+  );
+  ASSERT_SC(sc);
+
+  fd = open(rdb, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &dd);
+  rtems_test_assert(rv == 0);
+
+  for (block = 0; block < HOLD_BLOCK_COUNT; ++block) {
+    sc = rtems_bdbuf_get(dd, block, &ctx->held[block]);
+    ASSERT_SC(sc);
+  }
+
+  for (block = 0; block < HOLD_BLOCK_COUNT; ++block) {
+    sc = rtems_bdbuf_release(ctx->held[block]);
+    ASSERT_SC(sc);
+  }
+
+  rtems_bdbuf_purge_dev(dd);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test(test_context *ctx)
+{
+  rtems_status_code sc;
+  ramdisk *rd;
+  rtems_blkdev_bnum block;
+  size_t reader_count;
+  size_t i;
+  int fd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  fd = open(rda, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &ctx->dd);
+  rtems_test_assert(rv == 0);
+
+  sc = rtems_semaphore_create(
+    rtems_build_name('D', 'O', 'N', 'E'),
+    0,
+    RTEMS_COUNTING_SEMAPHORE,
+    0,
+    &ctx->done
+  );
+  ASSERT_SC(sc);
+
+  for (i = 0; i < READER_COUNT; ++i) {
+    sc = rtems_task_create(
+      rtems_build_name('R', 'E', 'A', 'D'),
+      READER_PRIORITY,
+      RTEMS_MINIMUM_STACK_SIZE,
+      RTEMS_TIMESLICE,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &ctx->reader_ids[i]
+    );
+    ASSERT_SC(sc);
+
+    sc = rtems_task_start(ctx->reader_ids[i], reader_task, i);
+    ASSERT_SC(sc);
+  }
+
+  /*
+   * Fill the cache, so that the readers measure the cache look-up.
+   */
+  for (block = 0; block < BLOCK_COUNT; ++block) {
+    read_block(ctx, block);
+  }
+
+  printf("<Block18>\n");
+
+  for (reader_count = 1; reader_count <= READER_COUNT; reader_count *= 2) {
+    printf(
+      "  <Readers count=\"%zu\"><LookupsPerSecond>%lu</LookupsPerSecond>"
+        "</Readers>\n",
+      reader_count,
+      lookups(ctx, reader_count) / DURATION_IN_SECONDS
+    );
+  }
+
+  printf("</Block18>\n");
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test_hold_many(&test_instance);
+  test(&test_instance);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+/*
+ * Each partition should be able to cache the blocks of its extents.
+ */
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (4 * BLOCK_COUNT * BLOCK_SIZE)
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_BUFFER_MAX_SIZE HOLD_BLOCK_SIZE
+#define CONFIGURE_BDBUF_PARTITIONS READER_COUNT
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 5
+
+#define CONFIGURE_MAXIMUM_PROCESSORS READER_COUNT
+
+#define CONFIGURE_MAXIMUM_TASKS (1 + READER_COUNT)
+#define CONFIGURE_MAXIMUM_SEMAPHORES 1
+
+#define CONFIGURE_INIT_TASK_PRIORITY MASTER_PRIORITY
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_DEFAULT_ATTRIBUTES
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
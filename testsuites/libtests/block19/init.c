@@ -0,0 +1,164 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "BLOCK 19";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define CACHE_BUFFER_COUNT 64U
+
+#define HOT_BLOCK_COUNT 8U
+
+#define SCAN_BLOCK_COUNT CACHE_BUFFER_COUNT
+
+#define BLOCK_COUNT (HOT_BLOCK_COUNT + 2 * SCAN_BLOCK_COUNT)
+
+static const char rda[] = "/dev/rda";
+
+static void read_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  sc = rtems_bdbuf_release(bd);
+  ASSERT_SC(sc);
+}
+
+static void read_hot_blocks(rtems_disk_device *dd)
+{
+  rtems_blkdev_bnum block;
+
+  for (block = 0; block < HOT_BLOCK_COUNT; ++block) {
+    read_block(dd, block);
+  }
+}
+
+static void scan(rtems_disk_device *dd, rtems_blkdev_bnum begin)
+{
+  rtems_blkdev_bnum block;
+
+  for (block = begin; block < begin + SCAN_BLOCK_COUNT; ++block) {
+    read_block(dd, block);
+  }
+}
+
+static void check_stats(
+  rtems_disk_device *dd,
+  uint32_t read_hits,
+  uint32_t read_misses,
+  uint32_t read_ghost_hits
+)
+{
+  rtems_blkdev_stats stats;
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.read_hits == read_hits);
+  rtems_test_assert(stats.read_misses == read_misses);
+  rtems_test_assert(stats.read_ghost_hits == read_ghost_hits);
+  rtems_bdbuf_reset_device_stats(dd);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  ramdisk *rd;
+  int fd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  fd = open(rda, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &dd);
+  rtems_test_assert(rv == 0);
+
+  /*
+   * The first scan recycles the hot blocks read only once so far.
+   */
+  read_hot_blocks(dd);
+  scan(dd, HOT_BLOCK_COUNT);
+  check_stats(dd, 0, HOT_BLOCK_COUNT + SCAN_BLOCK_COUNT, 0);
+
+  /*
+   * The hot blocks are read again shortly after they were recycled.  They are
+   * frequently used blocks now and the second scan does not recycle them.
+   */
+  read_hot_blocks(dd);
+  check_stats(dd, 0, HOT_BLOCK_COUNT, HOT_BLOCK_COUNT);
+  scan(dd, HOT_BLOCK_COUNT + SCAN_BLOCK_COUNT);
+  check_stats(dd, 0, SCAN_BLOCK_COUNT, 0);
+
+  read_hot_blocks(dd);
+  check_stats(dd, HOT_BLOCK_COUNT, 0, 0);
+
+  rtems_blkdev_print_stats(
+    &dd->stats,
+    dd->media_block_size,
+    dd->size,
+    dd->block_size,
+    &rtems_test_printer
+  );
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (CACHE_BUFFER_COUNT * BLOCK_SIZE)
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_REPLACEMENT_POLICY RTEMS_BDBUF_REPLACEMENT_2Q
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,179 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "BLOCK 20";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define STREAM_COUNT RTEMS_DISK_READ_AHEAD_STREAM_COUNT
+
+#define BLOCKS_PER_STREAM 64U
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT (STREAM_COUNT * BLOCKS_PER_STREAM)
+
+#define LATENCY_IN_NANOSECONDS 100000
+
+static const char rda[] = "/dev/rda";
+
+/*
+ * Each transfer request has a fixed latency like a real device.
+ */
+static int latency_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_counter_delay_nanoseconds(LATENCY_IN_NANOSECONDS);
+  }
+
+  return ramdisk_ioctl(dd, req, arg);
+}
+
+static void read_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  sc = rtems_bdbuf_release(bd);
+  ASSERT_SC(sc);
+}
+
+/*
+ * Each stream reads its own area of the disk sequentially.  The reads of the
+ * streams are interleaved.
+ */
+static void read_interleaved(rtems_disk_device *dd, uint32_t stream_count)
+{
+  rtems_blkdev_stats stats;
+  rtems_blkdev_bnum block;
+  uint32_t stream;
+
+  rtems_bdbuf_purge_dev(dd);
+  rtems_bdbuf_reset_device_stats(dd);
+
+  for (block = 0; block < BLOCKS_PER_STREAM; ++block) {
+    for (stream = 0; stream < stream_count; ++stream) {
+      read_block(dd, stream * BLOCKS_PER_STREAM + block);
+    }
+  }
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+
+  /*
+   * Only the first two blocks of each stream are read synchronously.
+   */
+  rtems_test_assert(stats.read_misses == 2 * stream_count);
+  rtems_test_assert(
+    stats.read_hits == stream_count * (BLOCKS_PER_STREAM - 2)
+  );
+
+  printf(
+    "  <Streams count=\"%" PRIu32 "\"><SynchronousReads>%" PRIu32
+      "</SynchronousReads><ReadAheadTransfers>%" PRIu32
+      "</ReadAheadTransfers></Streams>\n",
+    stream_count,
+    stats.read_misses,
+    stats.read_ahead_transfers
+  );
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  ramdisk *rd;
+  uint32_t stream_count;
+  int fd;
+  int rv;
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(
+    rda,
+    BLOCK_SIZE,
+    BLOCK_COUNT,
+    latency_disk_ioctl,
+    rd
+  );
+  ASSERT_SC(sc);
+
+  fd = open(rda, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &dd);
+  rtems_test_assert(rv == 0);
+
+  printf("<Block20>\n");
+
+  for (stream_count = 1; stream_count <= STREAM_COUNT; ++stream_count) {
+    read_interleaved(dd, stream_count);
+  }
+
+  printf("</Block20>\n");
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+/*
+ * The cache holds all blocks of the disk and the read-ahead task completes a
+ * request before the reader continues.
+ */
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (2 * BLOCK_COUNT * BLOCK_SIZE)
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_MAX_READ_AHEAD_BLOCKS 8
+#define CONFIGURE_BDBUF_READ_AHEAD_TASK_PRIORITY 1
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_PRIORITY 2
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
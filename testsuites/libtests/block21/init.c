@@ -0,0 +1,326 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+
+const char rtems_test_name[] = "BLOCK 21";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 256U
+
+#define MAX_QUEUE_DEPTH 16U
+
+#define LATENCY_IN_TICKS 2
+
+#define COMPLETION_TASK_PRIORITY 5
+
+typedef struct {
+  uint32_t queue_depth;
+  uint32_t in_flight;
+  uint32_t max_in_flight;
+  uint8_t area[BLOCK_COUNT * BLOCK_SIZE];
+} test_disk;
+
+typedef struct {
+  test_disk *disk;
+  rtems_blkdev_request *req;
+  rtems_interval submit_time;
+} test_message;
+
+static test_disk test_disks[3] = {
+  { .queue_depth = 1 },
+  { .queue_depth = 4 },
+  { .queue_depth = MAX_QUEUE_DEPTH }
+};
+
+static rtems_id queue_id;
+
+static void transfer(test_disk *disk, rtems_blkdev_request *req)
+{
+  uint32_t i;
+
+  for (i = 0; i < req->bufnum; ++i) {
+    rtems_blkdev_sg_buffer *sg = &req->bufs[i];
+    uint8_t *area = &disk->area[sg->block * BLOCK_SIZE];
+
+    if (req->req == RTEMS_BLKDEV_REQ_READ) {
+      memcpy(sg->buffer, area, sg->length);
+    } else {
+      memcpy(area, sg->buffer, sg->length);
+    }
+  }
+}
+
+/*
+ * The disk accepts up to its queue depth requests at a time.  Each request is
+ * done by the completion task after a fixed latency.
+ */
+static int test_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *arg)
+{
+  test_disk *disk = rtems_disk_get_driver_data(dd);
+  int rv = 0;
+
+  if (req == RTEMS_BLKIO_REQUEST) {
+    rtems_status_code sc;
+    test_message msg;
+
+    ++disk->in_flight;
+    rtems_test_assert(disk->in_flight <= disk->queue_depth);
+
+    if (disk->in_flight > disk->max_in_flight) {
+      disk->max_in_flight = disk->in_flight;
+    }
+
+    transfer(disk, arg);
+
+    msg.disk = disk;
+    msg.req = arg;
+    msg.submit_time = rtems_clock_get_ticks_since_boot();
+
+    sc = rtems_message_queue_send(queue_id, &msg, sizeof(msg));
+    ASSERT_SC(sc);
+  } else if (req == RTEMS_BLKIO_CAPABILITIES) {
+    *(uint32_t *) arg = RTEMS_BLKDEV_CAP_QUEUED_REQUESTS;
+  } else if (req == RTEMS_BLKIO_GETQUEUEDEPTH) {
+    *(uint32_t *) arg = disk->queue_depth;
+  } else {
+    rv = rtems_blkdev_ioctl(dd, req, arg);
+  }
+
+  return rv;
+}
+
+static void completion_task(rtems_task_argument arg)
+{
+  (void) arg;
+
+  while (true) {
+    rtems_status_code sc;
+    test_message msg;
+    size_t size;
+    rtems_interval now;
+    rtems_interval done_time;
+
+    sc = rtems_message_queue_receive(
+      queue_id,
+      &msg,
+      &size,
+      RTEMS_WAIT,
+      RTEMS_NO_TIMEOUT
+    );
+    ASSERT_SC(sc);
+    rtems_test_assert(size == sizeof(msg));
+
+    now = rtems_clock_get_ticks_since_boot();
+    done_time = msg.submit_time + LATENCY_IN_TICKS;
+
+    if ((int32_t) (done_time - now) > 0) {
+      sc = rtems_task_wake_after(done_time - now);
+      ASSERT_SC(sc);
+    }
+
+    --msg.disk->in_flight;
+    rtems_blkdev_request_done(msg.req, RTEMS_SUCCESSFUL);
+  }
+}
+
+static void write_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_get(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  memset(bd->buffer, (int) block, BLOCK_SIZE);
+
+  sc = rtems_bdbuf_release_modified(bd);
+  ASSERT_SC(sc);
+}
+
+/*
+ * Modify all blocks in random order and write them with one sync.  The
+ * swapout sorts the blocks and merges adjacent blocks into requests of the
+ * maximum write blocks, so the transfer count is independent of the queue
+ * depth.
+ */
+static void sync_disk(const char *name, test_disk *disk)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  rtems_blkdev_stats stats;
+  static rtems_blkdev_bnum order[BLOCK_COUNT];
+  rtems_interval start;
+  rtems_interval duration;
+  uint32_t i;
+  int fd;
+  int rv;
+
+  sc = rtems_blkdev_create(
+    name,
+    BLOCK_SIZE,
+    BLOCK_COUNT,
+    test_disk_ioctl,
+    disk
+  );
+  ASSERT_SC(sc);
+
+  fd = open(name, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &dd);
+  rtems_test_assert(rv == 0);
+  rtems_test_assert(dd->queue_depth == disk->queue_depth);
+
+  for (i = 0; i < BLOCK_COUNT; ++i) {
+    order[i] = i;
+  }
+
+  for (i = BLOCK_COUNT - 1; i > 0; --i) {
+    uint32_t j = (uint32_t) rand() % (i + 1);
+    rtems_blkdev_bnum tmp = order[i];
+
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+
+  for (i = 0; i < BLOCK_COUNT; ++i) {
+    write_block(dd, order[i]);
+  }
+
+  start = rtems_clock_get_ticks_since_boot();
+
+  sc = rtems_bdbuf_syncdev(dd);
+  ASSERT_SC(sc);
+
+  duration = rtems_clock_get_ticks_since_boot() - start;
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.write_blocks == BLOCK_COUNT);
+  rtems_test_assert(
+    stats.write_transfers
+      == BLOCK_COUNT / rtems_bdbuf_configuration.max_write_blocks
+  );
+  rtems_test_assert(stats.write_errors == 0);
+  rtems_test_assert(disk->in_flight == 0);
+  rtems_test_assert(disk->max_in_flight == disk->queue_depth);
+
+  for (i = 0; i < BLOCK_COUNT; ++i) {
+    rtems_test_assert(disk->area[i * BLOCK_SIZE] == (uint8_t) i);
+  }
+
+  printf(
+    "  <QueueDepth value=\"%" PRIu32 "\"><WriteTransfers>%" PRIu32
+      "</WriteTransfers><SyncTimeInTicks>%" PRIu32
+      "</SyncTimeInTicks></QueueDepth>\n",
+    disk->queue_depth,
+    stats.write_transfers,
+    (uint32_t) duration
+  );
+
+  rtems_bdbuf_purge_dev(dd);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void test(void)
+{
+  static const char * const names[] = {
+    "/dev/rda",
+    "/dev/rdb",
+    "/dev/rdc"
+  };
+  rtems_status_code sc;
+  rtems_id task_id;
+  size_t i;
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('C', 'O', 'M', 'P'),
+    MAX_QUEUE_DEPTH,
+    sizeof(test_message),
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &queue_id
+  );
+  ASSERT_SC(sc);
+
+  sc = rtems_task_create(
+    rtems_build_name('C', 'O', 'M', 'P'),
+    COMPLETION_TASK_PRIORITY,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &task_id
+  );
+  ASSERT_SC(sc);
+
+  sc = rtems_task_start(task_id, completion_task, 0);
+  ASSERT_SC(sc);
+
+  printf("<Block21>\n");
+
+  for (i = 0; i < RTEMS_ARRAY_SIZE(test_disks); ++i) {
+    sync_disk(names[i], &test_disks[i]);
+  }
+
+  printf("</Block21>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (2 * BLOCK_COUNT * BLOCK_SIZE)
+#define CONFIGURE_BDBUF_BUFFER_MIN_SIZE BLOCK_SIZE
+#define CONFIGURE_BDBUF_SWAPOUT_QUEUE_DEPTH MAX_QUEUE_DEPTH
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 4
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MAX_QUEUE_DEPTH, sizeof(test_message))
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_PRIORITY 10
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,285 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+#include "format_support.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/counter.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+
+const char rtems_test_name[] = "BLOCK 22";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 8192U
+
+#define FILE_SIZE (1024U * 1024U)
+
+/*
+ * The chunks of the cached transfers stay below the direct transfer minimum
+ * of both file systems.
+ */
+#define CACHED_CHUNK_SIZE (16U * 1024U)
+
+#define DIRECT_TRANSFER_MIN_BLOCKS 64
+
+static const char rda[] = "/dev/rda";
+
+static const char mnt[] = "/mnt";
+
+static const char file[] = "/mnt/file";
+
+typedef struct {
+  rtems_disk_device *dd;
+  uint8_t *data;
+  uint8_t *check;
+} test_context;
+
+static test_context test_instance;
+
+static void do_mount(const char *type)
+{
+  int rv;
+
+  rv = mount(rda, mnt, type, RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+}
+
+static void do_unmount(void)
+{
+  int rv;
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+}
+
+static uint32_t kib_per_second(rtems_counter_ticks ticks)
+{
+  uint64_t ns = rtems_counter_ticks_to_nanoseconds(ticks);
+
+  if (ns == 0) {
+    ns = 1;
+  }
+
+  return (uint32_t) (((uint64_t) (FILE_SIZE / 1024) * 1000000000) / ns);
+}
+
+static uint32_t write_file(const test_context *ctx, size_t chunk_size)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks duration;
+  size_t offset;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  start = rtems_counter_read();
+
+  for (offset = 0; offset < FILE_SIZE; offset += chunk_size) {
+    n = write(fd, &ctx->data[offset], chunk_size);
+    rtems_test_assert(n == (ssize_t) chunk_size);
+  }
+
+  rv = fsync(fd);
+  rtems_test_assert(rv == 0);
+
+  duration = rtems_counter_difference(rtems_counter_read(), start);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  return kib_per_second(duration);
+}
+
+static uint32_t read_file(
+  const test_context *ctx,
+  size_t chunk_size,
+  uint32_t *cache_accesses
+)
+{
+  rtems_counter_ticks start;
+  rtems_counter_ticks duration;
+  rtems_blkdev_stats stats;
+  size_t offset;
+  ssize_t n;
+  int fd;
+  int rv;
+
+  memset(ctx->check, 0, FILE_SIZE);
+  rtems_bdbuf_reset_device_stats(ctx->dd);
+
+  fd = open(file, O_RDONLY);
+  rtems_test_assert(fd >= 0);
+
+  start = rtems_counter_read();
+
+  for (offset = 0; offset < FILE_SIZE; offset += chunk_size) {
+    n = read(fd, &ctx->check[offset], chunk_size);
+    rtems_test_assert(n == (ssize_t) chunk_size);
+  }
+
+  duration = rtems_counter_difference(rtems_counter_read(), start);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rtems_test_assert(memcmp(ctx->data, ctx->check, FILE_SIZE) == 0);
+
+  rtems_bdbuf_get_device_stats(ctx->dd, &stats);
+  *cache_accesses = stats.read_hits + stats.read_misses;
+
+  return kib_per_second(duration);
+}
+
+/*
+ * Write and read a file of 1MiB once in chunks which use the cache and once
+ * with a single transfer which bypasses the cache.  The file system is
+ * mounted again before the read, so that the read starts with a cold cache.
+ */
+static void test_file_system(
+  test_context *ctx,
+  const char *type
+)
+{
+  static const struct {
+    const char *name;
+    size_t chunk_size;
+  } modes[] = {
+    { "cached", CACHED_CHUNK_SIZE },
+    { "direct", FILE_SIZE }
+  };
+  uint32_t cache_accesses[RTEMS_ARRAY_SIZE(modes)];
+  size_t i;
+
+  for (i = 0; i < RTEMS_ARRAY_SIZE(modes); ++i) {
+    uint32_t write_rate;
+    uint32_t read_rate;
+
+    memset(ctx->data, (int) (i + 1), FILE_SIZE);
+
+    do_mount(type);
+    write_rate = write_file(ctx, modes[i].chunk_size);
+    do_unmount();
+
+    do_mount(type);
+    read_rate = read_file(ctx, modes[i].chunk_size, &cache_accesses[i]);
+    do_unmount();
+
+    printf(
+      "  <Transfer fs=\"%s\" mode=\"%s\"><WriteKiBPerSecond>%" PRIu32
+        "</WriteKiBPerSecond><ReadKiBPerSecond>%" PRIu32
+        "</ReadKiBPerSecond></Transfer>\n",
+      type,
+      modes[i].name,
+      write_rate,
+      read_rate
+    );
+  }
+
+  /*
+   * The direct read uses the cache only for the meta-data.
+   */
+  rtems_test_assert(cache_accesses[1] < cache_accesses[0] / 4);
+}
+
+static void test(test_context *ctx)
+{
+  rtems_status_code sc;
+  ramdisk *rd;
+  int fd;
+  int rv;
+
+  ctx->data = rtems_cache_aligned_malloc(FILE_SIZE);
+  rtems_test_assert(ctx->data != NULL);
+
+  ctx->check = rtems_cache_aligned_malloc(FILE_SIZE);
+  rtems_test_assert(ctx->check != NULL);
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  fd = open(rda, O_RDWR);
+  rtems_test_assert(fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(fd, &ctx->dd);
+  rtems_test_assert(rv == 0);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  printf("<Block22>\n");
+
+  format_rfs(rda, BLOCK_SIZE);
+  test_file_system(ctx, RTEMS_FILESYSTEM_TYPE_RFS);
+  format_dosfs(rda, 8);
+  test_file_system(ctx, RTEMS_FILESYSTEM_TYPE_DOSFS);
+
+  printf("</Block22>\n");
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test(&test_instance);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_BDBUF_CACHE_MEMORY_SIZE (256 * 1024)
+#define CONFIGURE_BDBUF_DIRECT_TRANSFER_MIN_BLOCKS DIRECT_TRANSFER_MIN_BLOCKS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
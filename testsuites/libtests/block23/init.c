@@ -0,0 +1,456 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+#include "format_support.h"
+
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <rtems.h>
+#include <rtems/bdbuf.h>
+#include <rtems/blkdev.h>
+#include <rtems/libio.h>
+#include <rtems/ramdisk.h>
+#include <rtems/sparse-disk.h>
+
+const char rtems_test_name[] = "BLOCK 23";
+
+#define ASSERT_SC(sc) rtems_test_assert((sc) == RTEMS_SUCCESSFUL)
+
+#define BLOCK_SIZE 512U
+
+#define BLOCK_COUNT 4096U
+
+#define FILE_SIZE (64U * 1024U)
+
+#define PATTERN 0xa5
+
+#define SPARSE_BLOCKS_WITH_BUFFER 8U
+
+#define SPARSE_BLOCK_COUNT 64U
+
+#define SPARSE_FILL_PATTERN 0xff
+
+#define LARGE_BLOCK_SIZE 4096U
+
+#define LARGE_BLOCK_COUNT (2U * 1024U * 1024U)
+
+#define LARGE_MAX_REQUESTS 4U
+
+typedef struct {
+  rtems_sparse_disk sparse_disk;
+  rtems_sparse_disk_key keytable[SPARSE_BLOCKS_WITH_BUFFER];
+  uint8_t data[BLOCK_SIZE * SPARSE_BLOCKS_WITH_BUFFER];
+} sparse_disk_container;
+
+static const char rda[] = "/dev/rda";
+
+static const char sda[] = "/dev/sda";
+
+static const char lda[] = "/dev/lda";
+
+static const char mnt[] = "/mnt";
+
+static const char file[] = "/mnt/file";
+
+static sparse_disk_container sparse_disk;
+
+typedef struct {
+  size_t count;
+  rtems_blkdev_bnum block[LARGE_MAX_REQUESTS];
+  uint32_t length[LARGE_MAX_REQUESTS];
+} large_disk_discards;
+
+static large_disk_discards large_disk;
+
+static uint8_t file_data[FILE_SIZE];
+
+static rtems_disk_device *open_disk(const char *path, int *fd)
+{
+  rtems_disk_device *dd;
+  int rv;
+
+  *fd = open(path, O_RDWR);
+  rtems_test_assert(*fd >= 0);
+
+  rv = rtems_disk_fd_get_disk_device(*fd, &dd);
+  rtems_test_assert(rv == 0);
+
+  return dd;
+}
+
+static void close_disk(int fd)
+{
+  int rv;
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+}
+
+static bool block_has_value(const uint8_t *area, uint8_t value)
+{
+  size_t i;
+
+  for (i = 0; i < BLOCK_SIZE; ++i) {
+    if (area[i] != value) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static uint32_t count_pattern_blocks(const uint8_t *area)
+{
+  uint32_t count = 0;
+  uint32_t i;
+
+  for (i = 0; i < BLOCK_COUNT; ++i) {
+    if (block_has_value(&area[i * BLOCK_SIZE], PATTERN)) {
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+static void write_block(rtems_disk_device *dd, rtems_blkdev_bnum block)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_get(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  memset(bd->buffer, PATTERN, BLOCK_SIZE);
+
+  sc = rtems_bdbuf_release_modified(bd);
+  ASSERT_SC(sc);
+}
+
+static void check_block(
+  rtems_disk_device *dd,
+  rtems_blkdev_bnum block,
+  uint8_t value
+)
+{
+  rtems_status_code sc;
+  rtems_bdbuf_buffer *bd;
+
+  sc = rtems_bdbuf_read(dd, block, &bd);
+  ASSERT_SC(sc);
+
+  rtems_test_assert(block_has_value(bd->buffer, value));
+
+  sc = rtems_bdbuf_release(bd);
+  ASSERT_SC(sc);
+}
+
+/*
+ * Modified buffers of discarded blocks are dropped without a write and the
+ * RAM disk returns zero for discarded blocks.
+ */
+static void test_bdbuf_discard(const uint8_t *area)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  rtems_blkdev_stats stats;
+  rtems_blkdev_bnum block;
+  int fd;
+
+  dd = open_disk(rda, &fd);
+  rtems_bdbuf_reset_device_stats(dd);
+
+  for (block = 0; block < 4; ++block) {
+    write_block(dd, block);
+  }
+
+  sc = rtems_bdbuf_discard(dd, 1, 2);
+  ASSERT_SC(sc);
+
+  sc = rtems_bdbuf_syncdev(dd);
+  ASSERT_SC(sc);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.write_blocks == 2);
+  rtems_test_assert(stats.discard_requests == 1);
+  rtems_test_assert(stats.discard_blocks == 2);
+
+  rtems_test_assert(block_has_value(&area[0 * BLOCK_SIZE], PATTERN));
+  rtems_test_assert(block_has_value(&area[1 * BLOCK_SIZE], 0));
+  rtems_test_assert(block_has_value(&area[2 * BLOCK_SIZE], 0));
+  rtems_test_assert(block_has_value(&area[3 * BLOCK_SIZE], PATTERN));
+
+  check_block(dd, 3, PATTERN);
+
+  sc = rtems_bdbuf_discard(dd, 0, 4);
+  ASSERT_SC(sc);
+
+  rtems_test_assert(block_has_value(&area[0 * BLOCK_SIZE], 0));
+  rtems_test_assert(block_has_value(&area[3 * BLOCK_SIZE], 0));
+
+  check_block(dd, 3, 0);
+
+  sc = rtems_bdbuf_discard(dd, BLOCK_COUNT - 1, 2);
+  rtems_test_assert(sc == RTEMS_INVALID_ID);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.write_blocks == 2);
+  rtems_test_assert(stats.discard_requests == 2);
+  rtems_test_assert(stats.discard_blocks == 6);
+
+  close_disk(fd);
+}
+
+/*
+ * The sparse disk gives the buffers of discarded blocks back, so that other
+ * blocks can use them.
+ */
+static void test_sparse_disk_discard(void)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  rtems_blkdev_stats stats;
+  rtems_blkdev_bnum block;
+  int fd;
+
+  sc = rtems_sparse_disk_register(
+    sda,
+    &sparse_disk.sparse_disk,
+    BLOCK_SIZE,
+    SPARSE_BLOCKS_WITH_BUFFER,
+    SPARSE_BLOCK_COUNT,
+    SPARSE_FILL_PATTERN,
+    NULL
+  );
+  ASSERT_SC(sc);
+
+  dd = open_disk(sda, &fd);
+
+  for (block = 0; block < SPARSE_BLOCKS_WITH_BUFFER; ++block) {
+    write_block(dd, 2 * block);
+  }
+
+  sc = rtems_bdbuf_syncdev(dd);
+  ASSERT_SC(sc);
+  rtems_test_assert(
+    sparse_disk.sparse_disk.used_count == SPARSE_BLOCKS_WITH_BUFFER
+  );
+
+  sc = rtems_bdbuf_discard(dd, 4, 8);
+  ASSERT_SC(sc);
+  rtems_test_assert(
+    sparse_disk.sparse_disk.used_count == SPARSE_BLOCKS_WITH_BUFFER - 4
+  );
+
+  check_block(dd, 2, PATTERN);
+  check_block(dd, 6, SPARSE_FILL_PATTERN);
+  check_block(dd, 12, PATTERN);
+
+  for (block = 0; block < 4; ++block) {
+    write_block(dd, 32 + block);
+  }
+
+  sc = rtems_bdbuf_syncdev(dd);
+  ASSERT_SC(sc);
+  rtems_test_assert(
+    sparse_disk.sparse_disk.used_count == SPARSE_BLOCKS_WITH_BUFFER
+  );
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.write_errors == 0);
+  rtems_test_assert(stats.discard_blocks == 8);
+
+  close_disk(fd);
+}
+
+/*
+ * The large disk has no storage, it only records the discard requests.
+ */
+static int large_disk_ioctl(rtems_disk_device *dd, uint32_t req, void *argp)
+{
+  large_disk_discards *discards = rtems_disk_get_driver_data(dd);
+  rtems_blkdev_request *r;
+
+  switch (req) {
+    case RTEMS_BLKIO_REQUEST:
+      r = argp;
+      rtems_test_assert(r->req == RTEMS_BLKDEV_REQ_DISCARD);
+      rtems_test_assert(r->bufnum == 1);
+      rtems_test_assert(discards->count < LARGE_MAX_REQUESTS);
+      discards->block[discards->count] = r->bufs[0].block;
+      discards->length[discards->count] = r->bufs[0].length;
+      ++discards->count;
+      rtems_blkdev_request_done(r, RTEMS_SUCCESSFUL);
+      return 0;
+    case RTEMS_BLKIO_CAPABILITIES:
+      *(uint32_t *) argp = RTEMS_BLKDEV_CAP_DISCARD;
+      return 0;
+    default:
+      return rtems_blkdev_ioctl(dd, req, argp);
+  }
+}
+
+/*
+ * A discard of 4GiB and more does not fit into the 32-bit length of a single
+ * request, so it is issued as several requests.
+ */
+static void test_large_discard(void)
+{
+  rtems_status_code sc;
+  rtems_disk_device *dd;
+  rtems_blkdev_stats stats;
+  uint32_t max_chunk;
+  int fd;
+
+  sc = rtems_blkdev_create(
+    lda,
+    LARGE_BLOCK_SIZE,
+    LARGE_BLOCK_COUNT,
+    large_disk_ioctl,
+    &large_disk
+  );
+  ASSERT_SC(sc);
+
+  dd = open_disk(lda, &fd);
+  rtems_bdbuf_reset_device_stats(dd);
+
+  sc = rtems_bdbuf_discard(dd, 1, LARGE_BLOCK_COUNT - 1);
+  ASSERT_SC(sc);
+
+  max_chunk = UINT32_MAX / LARGE_BLOCK_SIZE;
+
+  rtems_test_assert(large_disk.count == 2);
+  rtems_test_assert(large_disk.block[0] == 1);
+  rtems_test_assert(large_disk.length[0] == max_chunk * LARGE_BLOCK_SIZE);
+  rtems_test_assert(large_disk.block[1] == 1 + max_chunk);
+  rtems_test_assert(
+    large_disk.length[1]
+      == (LARGE_BLOCK_COUNT - 1 - max_chunk) * LARGE_BLOCK_SIZE
+  );
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.discard_requests == 2);
+  rtems_test_assert(stats.discard_blocks == LARGE_BLOCK_COUNT - 1);
+
+  close_disk(fd);
+}
+
+/*
+ * The blocks of a removed file are discarded by the file system.  None of the
+ * file data remains on the RAM disk.
+ */
+static void test_file_system_discard(
+  const uint8_t *area,
+  const char *type
+)
+{
+  rtems_disk_device *dd;
+  rtems_blkdev_stats stats;
+  ssize_t n;
+  int disk_fd;
+  int fd;
+  int rv;
+
+  rv = mount(rda, mnt, type, RTEMS_FILESYSTEM_READ_WRITE, NULL);
+  rtems_test_assert(rv == 0);
+
+  fd = open(file, O_WRONLY | O_CREAT | O_TRUNC, S_IRWXU);
+  rtems_test_assert(fd >= 0);
+
+  n = write(fd, file_data, FILE_SIZE);
+  rtems_test_assert(n == (ssize_t) FILE_SIZE);
+
+  rv = fsync(fd);
+  rtems_test_assert(rv == 0);
+
+  rv = close(fd);
+  rtems_test_assert(rv == 0);
+
+  rtems_test_assert(count_pattern_blocks(area) == FILE_SIZE / BLOCK_SIZE);
+
+  dd = open_disk(rda, &disk_fd);
+  rtems_bdbuf_reset_device_stats(dd);
+
+  rv = unlink(file);
+  rtems_test_assert(rv == 0);
+
+  rv = unmount(mnt);
+  rtems_test_assert(rv == 0);
+
+  rtems_bdbuf_get_device_stats(dd, &stats);
+  rtems_test_assert(stats.discard_blocks >= FILE_SIZE / BLOCK_SIZE);
+  rtems_test_assert(count_pattern_blocks(area) == 0);
+
+  close_disk(disk_fd);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  ramdisk *rd;
+  int rv;
+
+  memset(file_data, PATTERN, sizeof(file_data));
+
+  rd = ramdisk_allocate(NULL, BLOCK_SIZE, BLOCK_COUNT, false);
+  rtems_test_assert(rd != NULL);
+
+  sc = rtems_blkdev_create(rda, BLOCK_SIZE, BLOCK_COUNT, ramdisk_ioctl, rd);
+  ASSERT_SC(sc);
+
+  rv = mkdir(mnt, S_IRWXU);
+  rtems_test_assert(rv == 0);
+
+  test_bdbuf_discard(rd->area);
+  test_sparse_disk_discard();
+  test_large_discard();
+  format_rfs(rda, BLOCK_SIZE);
+  test_file_system_discard(rd->area, RTEMS_FILESYSTEM_TYPE_RFS);
+  format_dosfs(rda, 1);
+  test_file_system_discard(rd->area, RTEMS_FILESYSTEM_TYPE_DOSFS);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_APPLICATION_NEEDS_LIBBLOCK
+
+#define CONFIGURE_FILESYSTEM_RFS
+#define CONFIGURE_FILESYSTEM_DOSFS
+
+#define CONFIGURE_LIBIO_MAXIMUM_FILE_DESCRIPTORS 8
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_INIT_TASK_STACK_SIZE (32 * 1024)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,224 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <tmacros.h>
+#include <rtems/malloc.h>
+#include <rtems/score/threaddispatch.h>
+
+#include <stdlib.h>
+
+const char rtems_test_name[] = "MALLOC 5";
+
+#define OBJECT_COUNT 64
+
+static void *objects[ OBJECT_COUNT ];
+
+static void get_info( rtems_malloc_cache_information *info )
+{
+  int rv;
+
+  rv = malloc_cache_info( info );
+  rtems_test_assert( rv == 0 );
+}
+
+static void test_class_sizes( void )
+{
+  rtems_malloc_cache_information info;
+  size_t i;
+
+  get_info( &info );
+
+  for ( i = 0; i < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++i ) {
+    rtems_test_assert(
+      info.classes[ i ].size == (size_t) RTEMS_MALLOC_CACHE_MINIMUM_SIZE << i
+    );
+  }
+
+  rtems_test_assert(
+    info.classes[ RTEMS_MALLOC_CACHE_CLASS_COUNT - 1 ].size
+      == RTEMS_MALLOC_CACHE_MAXIMUM_SIZE
+  );
+  rtems_test_assert( malloc_cache_info( NULL ) == -1 );
+}
+
+static void test_hit_and_miss( void )
+{
+  rtems_malloc_cache_information before;
+  rtems_malloc_cache_information after;
+  const rtems_malloc_cache_class_information *b;
+  const rtems_malloc_cache_class_information *a;
+  void *p;
+  void *q;
+
+  /* A request of 24 bytes is served by the 32 bytes class */
+  get_info( &before );
+  p = malloc( 24 );
+  rtems_test_assert( p != NULL );
+  get_info( &after );
+
+  b = &before.classes[ 1 ];
+  a = &after.classes[ 1 ];
+  rtems_test_assert( a->hits + a->misses == b->hits + b->misses + 1 );
+
+  if ( a->misses != b->misses ) {
+    rtems_test_assert( a->refills == b->refills + 1 );
+  }
+
+  /* The last freed object is the next one to allocate */
+  free( p );
+  get_info( &before );
+  q = malloc( 24 );
+  get_info( &after );
+  rtems_test_assert( q == p );
+
+  b = &before.classes[ 1 ];
+  a = &after.classes[ 1 ];
+  rtems_test_assert( a->hits == b->hits + 1 );
+  rtems_test_assert( a->cached + 1 == b->cached );
+
+  free( q );
+}
+
+static void test_refill_and_drain( void )
+{
+  rtems_malloc_cache_information before;
+  rtems_malloc_cache_information after;
+  const rtems_malloc_cache_class_information *b;
+  const rtems_malloc_cache_class_information *a;
+  size_t i;
+
+  get_info( &before );
+
+  for ( i = 0; i < OBJECT_COUNT; ++i ) {
+    objects[ i ] = malloc( 100 );
+    rtems_test_assert( objects[ i ] != NULL );
+  }
+
+  for ( i = 0; i < OBJECT_COUNT; ++i ) {
+    free( objects[ i ] );
+  }
+
+  get_info( &after );
+
+  b = &before.classes[ 3 ];
+  a = &after.classes[ 3 ];
+  rtems_test_assert( a->hits + a->misses == b->hits + b->misses + OBJECT_COUNT );
+  rtems_test_assert( a->refills > b->refills );
+  rtems_test_assert( a->drains > b->drains );
+  rtems_test_assert( a->cached > 0 );
+  rtems_test_assert( a->cached <= OBJECT_COUNT );
+}
+
+static void test_uncached( void )
+{
+  rtems_malloc_cache_information before;
+  rtems_malloc_cache_information after;
+  size_t i;
+  void *p;
+
+  get_info( &before );
+  p = malloc( 4 * RTEMS_MALLOC_CACHE_MAXIMUM_SIZE );
+  rtems_test_assert( p != NULL );
+  free( p );
+  get_info( &after );
+
+  for ( i = 0; i < RTEMS_MALLOC_CACHE_CLASS_COUNT; ++i ) {
+    const rtems_malloc_cache_class_information *b;
+    const rtems_malloc_cache_class_information *a;
+
+    b = &before.classes[ i ];
+    a = &after.classes[ i ];
+    rtems_test_assert( a->cached == b->cached );
+    rtems_test_assert( a->hits == b->hits );
+    rtems_test_assert( a->misses == b->misses );
+  }
+}
+
+static void test_deferred_free( void )
+{
+  rtems_malloc_cache_information before;
+  rtems_malloc_cache_information after;
+  void *p;
+  void *q;
+
+  p = malloc( 24 );
+  rtems_test_assert( p != NULL );
+
+  /* With thread dispatching disabled the free is deferred */
+  _Thread_Dispatch_disable();
+  free( p );
+  _Thread_Dispatch_enable( _Per_CPU_Get() );
+
+  /* The cache hit processes the deferred free first */
+  get_info( &before );
+  q = malloc( 24 );
+  get_info( &after );
+  rtems_test_assert( q == p );
+  rtems_test_assert( after.classes[ 1 ].hits == before.classes[ 1 ].hits + 1 );
+
+  free( q );
+}
+
+static void *double_free_object;
+
+static void test_double_free( void )
+{
+  double_free_object = malloc( 24 );
+  rtems_test_assert( double_free_object != NULL );
+  free( double_free_object );
+  free( double_free_object );
+  rtems_test_assert( 0 );
+}
+
+static void Init( rtems_task_argument arg )
+{
+  TEST_BEGIN();
+
+  rtems_test_assert( rtems_malloc_cache == &rtems_malloc_per_cpu_cache );
+
+  test_class_sizes();
+  test_hit_and_miss();
+  test_refill_and_drain();
+  test_uncached();
+  test_deferred_free();
+  test_double_free();
+}
+
+static void fatal_extension(
+  rtems_fatal_source source,
+  bool always_set_to_false,
+  rtems_fatal_code error
+)
+{
+  if (
+    source == RTEMS_FATAL_SOURCE_INVALID_HEAP_FREE
+      && !always_set_to_false
+      && error == (rtems_fatal_code) double_free_object
+  ) {
+    TEST_END();
+  }
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_MALLOC_PER_CPU_CACHE
+
+#define CONFIGURE_INITIAL_EXTENSIONS \
+  { .fatal = fatal_extension }, \
+  RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -57,7 +57,8 @@ static const rtems_filesystem_file_handlers_r node_handlers = {
   .kqfilter_h = rtems_filesystem_default_kqfilter,
   .mmap_h = handler_mmap,
   .readv_h = rtems_filesystem_default_readv,
-  .writev_h = rtems_filesystem_default_writev
+  .writev_h = rtems_filesystem_default_writev,
+  .fallocate_h = rtems_filesystem_default_fallocate
 };
 
 const IMFS_node_control node_control = IMFS_GENERIC_INITIALIZER(
@@ -0,0 +1,226 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pmacros.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
+#include <tmacros.h>
+
+const char rtems_test_name[] = "PSXMSGQ 5";
+
+#define MESSAGE_COUNT 4
+
+/* forward declarations to avoid warnings */
+void *POSIX_Init(void *argument);
+
+static mqd_t Queue;
+
+static void set_nonblock( bool nonblock )
+{
+  struct mq_attr attr;
+  int            sc;
+
+  attr.mq_flags = nonblock ? O_NONBLOCK : 0;
+  sc = mq_setattr( Queue, &attr, NULL );
+  rtems_test_assert( sc == 0 );
+}
+
+static void *blocked_sender( void *argument )
+{
+  int     message;
+  ssize_t n;
+
+  (void) argument;
+
+  puts( "Sender - mq_send_many_np - blocks until a buffer is free" );
+  message = 42;
+  n = mq_send_many_np( Queue, (const char *) &message, sizeof(message), 1, 5 );
+  rtems_test_assert( n == 1 );
+
+  return NULL;
+}
+
+void *POSIX_Init(
+  void *argument
+)
+{
+  struct mq_attr attr;
+  int            messages[ 2 * MESSAGE_COUNT ];
+  size_t         lengths[ 2 * MESSAGE_COUNT ];
+  unsigned int   priorities[ 2 * MESSAGE_COUNT ];
+  ssize_t        n;
+  int            sc;
+  pthread_t      sender;
+  size_t         i;
+
+  TEST_BEGIN();
+
+  attr.mq_maxmsg = MESSAGE_COUNT;
+  attr.mq_msgsize = sizeof(int);
+
+  puts( "Init - Open message queue" );
+  Queue = mq_open( "Queue", O_CREAT | O_RDWR | O_NONBLOCK, 0x777, &attr );
+  rtems_test_assert( Queue != (-1) );
+
+  for ( i = 0; i < RTEMS_ARRAY_SIZE( messages ); ++i ) {
+    messages[ i ] = (int) i;
+  }
+
+  puts( "Init - mq_send_many_np - EINVAL" );
+  n = mq_send_many_np(
+    Queue,
+    (const char *) messages,
+    sizeof(int),
+    1,
+    MQ_PRIO_MAX + 1
+  );
+  rtems_test_assert( n == -1 );
+  rtems_test_assert( errno == EINVAL );
+
+  puts( "Init - mq_send_many_np - EMSGSIZE" );
+  n = mq_send_many_np(
+    Queue,
+    (const char *) messages,
+    sizeof(int) + 1,
+    1,
+    0
+  );
+  rtems_test_assert( n == -1 );
+  rtems_test_assert( errno == EMSGSIZE );
+
+  puts( "Init - mq_send_many_np - two batches with different priorities" );
+  n = mq_send_many_np( Queue, (const char *) &messages[ 0 ], sizeof(int), 2, 1 );
+  rtems_test_assert( n == 2 );
+  n = mq_send_many_np( Queue, (const char *) &messages[ 2 ], sizeof(int), 4, 3 );
+  rtems_test_assert( n == 2 );
+
+  puts( "Init - mq_send_many_np - EAGAIN" );
+  n = mq_send_many_np( Queue, (const char *) messages, sizeof(int), 1, 0 );
+  rtems_test_assert( n == -1 );
+  rtems_test_assert( errno == EAGAIN );
+
+  puts( "Init - mq_receive_many_np - EMSGSIZE" );
+  n = mq_receive_many_np(
+    Queue,
+    (char *) messages,
+    sizeof(int) - 1,
+    lengths,
+    priorities,
+    1
+  );
+  rtems_test_assert( n == -1 );
+  rtems_test_assert( errno == EMSGSIZE );
+
+  puts( "Init - mq_receive_many_np - higher priority messages first" );
+  n = mq_receive_many_np(
+    Queue,
+    (char *) messages,
+    sizeof(int),
+    lengths,
+    priorities,
+    RTEMS_ARRAY_SIZE( messages )
+  );
+  rtems_test_assert( n == MESSAGE_COUNT );
+  rtems_test_assert( messages[ 0 ] == 2 && priorities[ 0 ] == 3 );
+  rtems_test_assert( messages[ 1 ] == 3 && priorities[ 1 ] == 3 );
+  rtems_test_assert( messages[ 2 ] == 0 && priorities[ 2 ] == 1 );
+  rtems_test_assert( messages[ 3 ] == 1 && priorities[ 3 ] == 1 );
+
+  for ( i = 0; i < MESSAGE_COUNT; ++i ) {
+    rtems_test_assert( lengths[ i ] == sizeof(int) );
+  }
+
+  puts( "Init - mq_receive_many_np - EAGAIN" );
+  n = mq_receive_many_np(
+    Queue,
+    (char *) messages,
+    sizeof(int),
+    lengths,
+    NULL,
+    1
+  );
+  rtems_test_assert( n == -1 );
+  rtems_test_assert( errno == EAGAIN );
+
+  puts( "Init - Fill message queue" );
+  n = mq_send_many_np(
+    Queue,
+    (const char *) messages,
+    sizeof(int),
+    MESSAGE_COUNT,
+    0
+  );
+  rtems_test_assert( n == MESSAGE_COUNT );
+
+  set_nonblock( false );
+
+  sc = pthread_create( &sender, NULL, blocked_sender, NULL );
+  rtems_test_assert( sc == 0 );
+
+  sched_yield();
+
+  puts( "Init - mq_receive_many_np - blocked sender refills the queue" );
+  n = mq_receive_many_np(
+    Queue,
+    (char *) messages,
+    sizeof(int),
+    lengths,
+    priorities,
+    RTEMS_ARRAY_SIZE( messages )
+  );
+  rtems_test_assert( n == MESSAGE_COUNT );
+
+  n = mq_receive_many_np(
+    Queue,
+    (char *) messages,
+    sizeof(int),
+    lengths,
+    priorities,
+    RTEMS_ARRAY_SIZE( messages )
+  );
+  rtems_test_assert( n == 1 );
+  rtems_test_assert( messages[ 0 ] == 42 && priorities[ 0 ] == 5 );
+
+  sc = pthread_join( sender, NULL );
+  rtems_test_assert( sc == 0 );
+
+  puts( "Init - Unlink and close message queue" );
+  sc = mq_unlink( "Queue" );
+  rtems_test_assert( sc == 0 );
+
+  sc = mq_close( Queue );
+  rtems_test_assert( sc == 0 );
+
+  TEST_END();
+  rtems_test_exit( 0 );
+
+  return NULL; /* just so the compiler thinks we returned something */
+}
+
+/* configuration information */
+
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+
+#define CONFIGURE_POSIX_INIT_THREAD_TABLE
+
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+    CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MESSAGE_COUNT, sizeof(int))
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_MAXIMUM_POSIX_THREADS                   2
+#define CONFIGURE_MAXIMUM_POSIX_MESSAGE_QUEUES            1
+
+#define CONFIGURE_INIT
+#include <rtems/confdefs.h>
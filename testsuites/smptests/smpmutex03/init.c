@@ -0,0 +1,221 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include <rtems.h>
+#include <rtems/test.h>
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "SMPMUTEX 3";
+
+#define CPU_COUNT 32
+
+#define TEST_COUNT 2
+
+typedef struct {
+  rtems_test_parallel_context base;
+  rtems_id mtx_ids[CPU_COUNT];
+  unsigned long local_counter[CPU_COUNT][TEST_COUNT][CPU_COUNT];
+} test_context;
+
+static test_context test_instance;
+
+static void obtain(rtems_id id)
+{
+  rtems_status_code sc;
+
+  sc = rtems_semaphore_obtain(id, RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void release(rtems_id id)
+{
+  rtems_status_code sc;
+
+  sc = rtems_semaphore_release(id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static rtems_interval test_init(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers
+)
+{
+  return rtems_clock_get_ticks_per_second();
+}
+
+static void test_fini(
+  test_context *ctx,
+  const char *name,
+  size_t test,
+  size_t active_workers
+)
+{
+  unsigned long sum = 0;
+  size_t i;
+
+  for (i = 0; i < active_workers; ++i) {
+    sum += ctx->local_counter[active_workers - 1][test][i];
+  }
+
+  printf(
+    "  <%s activeWorker=\"%zu\"><Enqueues>%lu</Enqueues></%s>\n",
+    name,
+    active_workers,
+    sum,
+    name
+  );
+}
+
+/*
+ * All workers contend for one mutex.  The owner of the mutex never blocks, so
+ * the enqueue needs no thread queue link.
+ */
+static void test_0_body(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers,
+  size_t worker_index
+)
+{
+  test_context *ctx = (test_context *) base;
+  unsigned long counter = 0;
+
+  while (!rtems_test_parallel_stop_job(&ctx->base)) {
+    obtain(ctx->mtx_ids[0]);
+    release(ctx->mtx_ids[0]);
+    ++counter;
+  }
+
+  ctx->local_counter[active_workers - 1][0][worker_index] = counter;
+}
+
+static void test_0_fini(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers
+)
+{
+  test_fini((test_context *) base, "Single", 0, active_workers);
+}
+
+/*
+ * Each worker obtains its own mutex and then the mutex of the next worker.  An
+ * enqueue on the mutex of the next worker adds a thread queue link in case the
+ * next worker is blocked on its successor.  The chain of owners is acyclic, so
+ * there are no deadlocks.
+ */
+static void test_1_body(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers,
+  size_t worker_index
+)
+{
+  test_context *ctx = (test_context *) base;
+  unsigned long counter = 0;
+  bool nested = worker_index + 1 < active_workers;
+
+  while (!rtems_test_parallel_stop_job(&ctx->base)) {
+    obtain(ctx->mtx_ids[worker_index]);
+
+    if (nested) {
+      obtain(ctx->mtx_ids[worker_index + 1]);
+      release(ctx->mtx_ids[worker_index + 1]);
+    }
+
+    release(ctx->mtx_ids[worker_index]);
+    ++counter;
+  }
+
+  ctx->local_counter[active_workers - 1][1][worker_index] = counter;
+}
+
+static void test_1_fini(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers
+)
+{
+  test_fini((test_context *) base, "Chain", 1, active_workers);
+}
+
+static const rtems_test_parallel_job test_jobs[TEST_COUNT] = {
+  {
+    .init = test_init,
+    .body = test_0_body,
+    .fini = test_0_fini,
+    .cascade = true
+  }, {
+    .init = test_init,
+    .body = test_1_body,
+    .fini = test_1_fini,
+    .cascade = true
+  }
+};
+
+static void test(void)
+{
+  test_context *ctx = &test_instance;
+  size_t i;
+
+  for (i = 0; i < CPU_COUNT; ++i) {
+    rtems_status_code sc;
+
+    sc = rtems_semaphore_create(
+      rtems_build_name('M', 'U', 'T', 'X'),
+      1,
+      RTEMS_BINARY_SEMAPHORE | RTEMS_PRIORITY | RTEMS_INHERIT_PRIORITY,
+      0,
+      &ctx->mtx_ids[i]
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  printf("<SMPMutex03>\n");
+  rtems_test_parallel(&ctx->base, NULL, &test_jobs[0], TEST_COUNT);
+  printf("</SMPMutex03>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_PROCESSORS CPU_COUNT
+
+#define CONFIGURE_MAXIMUM_TASKS CPU_COUNT
+
+#define CONFIGURE_MAXIMUM_SEMAPHORES CPU_COUNT
+
+#define CONFIGURE_MAXIMUM_TIMERS 1
+
+#define CONFIGURE_INIT_TASK_PRIORITY 1
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_DEFAULT_ATTRIBUTES
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
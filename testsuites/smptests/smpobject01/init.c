@@ -0,0 +1,253 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <stdio.h>
+
+#include <rtems.h>
+#include <rtems/test.h>
+#include <rtems/rtems/semimpl.h>
+#include <rtems/rtems/tasksimpl.h>
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "SMPOBJECT 1";
+
+#define CPU_COUNT 32
+
+#define TEST_COUNT 4
+
+typedef struct {
+  rtems_test_parallel_context base;
+  Objects_Inactive_cache *semaphore_caches;
+  Objects_Inactive_cache *task_caches;
+  unsigned long local_counter[CPU_COUNT][TEST_COUNT][CPU_COUNT];
+} test_context;
+
+static test_context test_instance;
+
+static const char * const test_names[TEST_COUNT] = {
+  "Semaphore",
+  "Task",
+  "SemaphoreWithoutCache",
+  "TaskWithoutCache"
+};
+
+static size_t test_index(void *arg)
+{
+  return (size_t) (uintptr_t) arg;
+}
+
+/*
+ * The tests without caches measure the baseline with the inactive chain of
+ * the object information only.
+ */
+static void set_caches(test_context *ctx, bool enabled)
+{
+  Objects_Information *semaphores = &_Semaphore_Information;
+  Objects_Information *tasks = &_RTEMS_tasks_Information.Objects;
+
+  _Objects_Allocator_lock();
+
+  if (enabled) {
+    semaphores->inactive_caches = ctx->semaphore_caches;
+    tasks->inactive_caches = ctx->task_caches;
+  } else {
+    _Objects_Flush_inactive_caches(semaphores);
+    semaphores->inactive_caches = NULL;
+    _Objects_Flush_inactive_caches(tasks);
+    tasks->inactive_caches = NULL;
+  }
+
+  _Objects_Allocator_unlock();
+}
+
+static rtems_interval test_init(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers
+)
+{
+  set_caches((test_context *) base, test_index(arg) < 2);
+
+  return rtems_clock_get_ticks_per_second();
+}
+
+static void test_fini(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers
+)
+{
+  test_context *ctx = (test_context *) base;
+  size_t test = test_index(arg);
+  const char *name = test_names[test];
+  unsigned long sum = 0;
+  size_t i;
+
+  for (i = 0; i < active_workers; ++i) {
+    sum += ctx->local_counter[active_workers - 1][test][i];
+  }
+
+  printf(
+    "  <%s activeWorker=\"%zu\"><CreateDelete>%lu</CreateDelete></%s>\n",
+    name,
+    active_workers,
+    sum,
+    name
+  );
+}
+
+static void semaphore_body(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers,
+  size_t worker_index
+)
+{
+  test_context *ctx = (test_context *) base;
+  unsigned long counter = 0;
+
+  while (!rtems_test_parallel_stop_job(&ctx->base)) {
+    rtems_status_code sc;
+    rtems_id id;
+
+    sc = rtems_semaphore_create(
+      rtems_build_name('S', 'E', 'M', 'A'),
+      0,
+      RTEMS_COUNTING_SEMAPHORE,
+      0,
+      &id
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    sc = rtems_semaphore_delete(id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    ++counter;
+  }
+
+  ctx->local_counter[active_workers - 1][test_index(arg)][worker_index] =
+    counter;
+}
+
+static void task_body(
+  rtems_test_parallel_context *base,
+  void *arg,
+  size_t active_workers,
+  size_t worker_index
+)
+{
+  test_context *ctx = (test_context *) base;
+  unsigned long counter = 0;
+
+  while (!rtems_test_parallel_stop_job(&ctx->base)) {
+    rtems_status_code sc;
+    rtems_id id;
+
+    sc = rtems_task_create(
+      rtems_build_name('T', 'A', 'S', 'K'),
+      2,
+      RTEMS_MINIMUM_STACK_SIZE,
+      RTEMS_DEFAULT_MODES,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &id
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    sc = rtems_task_delete(id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    ++counter;
+  }
+
+  ctx->local_counter[active_workers - 1][test_index(arg)][worker_index] =
+    counter;
+}
+
+static const rtems_test_parallel_job test_jobs[TEST_COUNT] = {
+  {
+    .init = test_init,
+    .body = semaphore_body,
+    .fini = test_fini,
+    .arg = (void *) 0,
+    .cascade = true
+  }, {
+    .init = test_init,
+    .body = task_body,
+    .fini = test_fini,
+    .arg = (void *) 1,
+    .cascade = true
+  }, {
+    .init = test_init,
+    .body = semaphore_body,
+    .fini = test_fini,
+    .arg = (void *) 2,
+    .cascade = true
+  }, {
+    .init = test_init,
+    .body = task_body,
+    .fini = test_fini,
+    .arg = (void *) 3,
+    .cascade = true
+  }
+};
+
+static void test(void)
+{
+  test_context *ctx = &test_instance;
+
+  ctx->semaphore_caches = _Semaphore_Information.inactive_caches;
+  ctx->task_caches = _RTEMS_tasks_Information.Objects.inactive_caches;
+  rtems_test_assert(ctx->semaphore_caches != NULL);
+  rtems_test_assert(ctx->task_caches != NULL);
+
+  printf("<SMPObject01>\n");
+  rtems_test_parallel(&ctx->base, NULL, &test_jobs[0], TEST_COUNT);
+  printf("</SMPObject01>\n");
+
+  set_caches(ctx, true);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_PROCESSORS CPU_COUNT
+
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_MAXIMUM_TASKS (1 + 2 * CPU_COUNT)
+
+#define CONFIGURE_MAXIMUM_SEMAPHORES rtems_resource_unlimited(8)
+
+#define CONFIGURE_MAXIMUM_TIMERS 1
+
+#define CONFIGURE_OBJECTS_PER_CPU_CACHE
+
+#define CONFIGURE_INIT_TASK_PRIORITY 1
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_DEFAULT_ATTRIBUTES
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,181 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <rtems.h>
+#include <rtems/score/atomic.h>
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "SMPSCHEDULER 8";
+
+#define CPU_COUNT 32
+
+#define WORKERS_PER_CPU 4
+
+#define WORKER_COUNT (WORKERS_PER_CPU * CPU_COUNT)
+
+#define WORK_ITERATIONS 10000
+
+#define MASTER_PRIORITY 1
+
+#define WORKER_PRIORITY 2
+
+typedef struct {
+  rtems_id master_id;
+  rtems_id worker_ids[WORKER_COUNT];
+  Atomic_Uint pending;
+  volatile unsigned long sink;
+} test_context;
+
+static test_context test_instance;
+
+static void do_work(test_context *ctx)
+{
+  unsigned long value = 0;
+  int i;
+
+  for (i = 0; i < WORK_ITERATIONS; ++i) {
+    value += (unsigned long) i;
+  }
+
+  ctx->sink = value;
+}
+
+static void worker_task(rtems_task_argument arg)
+{
+  test_context *ctx = &test_instance;
+
+  (void) arg;
+
+  while (true) {
+    rtems_status_code sc;
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    do_work(ctx);
+
+    if (
+      _Atomic_Fetch_sub_uint(&ctx->pending, 1, ATOMIC_ORDER_RELEASE) == 1
+    ) {
+      sc = rtems_event_transient_send(ctx->master_id);
+      rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    }
+  }
+}
+
+/*
+ * Each burst releases all workers at once.  The workers have equal priority,
+ * so with more workers than processors most of them are queued until a
+ * processor becomes available.
+ */
+static unsigned long bursts(test_context *ctx, uint32_t worker_count)
+{
+  rtems_interval duration = rtems_clock_get_ticks_per_second();
+  rtems_interval start;
+  unsigned long count = 0;
+
+  start = rtems_clock_get_ticks_since_boot();
+
+  while (rtems_clock_get_ticks_since_boot() - start < duration) {
+    rtems_status_code sc;
+    uint32_t i;
+
+    _Atomic_Store_uint(&ctx->pending, worker_count, ATOMIC_ORDER_RELAXED);
+
+    for (i = 0; i < worker_count; ++i) {
+      sc = rtems_event_transient_send(ctx->worker_ids[i]);
+      rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    }
+
+    sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    rtems_test_assert(
+      _Atomic_Load_uint(&ctx->pending, ATOMIC_ORDER_ACQUIRE) == 0
+    );
+
+    ++count;
+  }
+
+  return count;
+}
+
+static void test(test_context *ctx)
+{
+  uint32_t cpu_count = rtems_get_processor_count();
+  uint32_t n;
+  uint32_t i;
+
+  ctx->master_id = rtems_task_self();
+  _Atomic_Init_uint(&ctx->pending, 0);
+
+  for (i = 0; i < WORKER_COUNT; ++i) {
+    rtems_status_code sc;
+
+    sc = rtems_task_create(
+      rtems_build_name('W', 'O', 'R', 'K'),
+      WORKER_PRIORITY,
+      RTEMS_MINIMUM_STACK_SIZE,
+      RTEMS_DEFAULT_MODES,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &ctx->worker_ids[i]
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    sc = rtems_task_start(ctx->worker_ids[i], worker_task, 0);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  printf("<SMPScheduler08>\n");
+
+  for (n = 1; n <= WORKERS_PER_CPU; n *= 2) {
+    uint32_t worker_count = n * cpu_count;
+
+    printf(
+      "  <FanOut workers=\"%" PRIu32 "\"><Bursts>%lu</Bursts></FanOut>\n",
+      worker_count,
+      bursts(ctx, worker_count)
+    );
+  }
+
+  printf("</SMPScheduler08>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test(&test_instance);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_PROCESSORS CPU_COUNT
+
+#define CONFIGURE_MAXIMUM_TASKS (1 + WORKER_COUNT)
+
+#define CONFIGURE_INIT_TASK_PRIORITY MASTER_PRIORITY
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_DEFAULT_ATTRIBUTES
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -57,7 +57,8 @@ static const rtems_filesystem_file_handlers_r node_handlers = {
   .open_h = rtems_filesystem_default_open,
   .close_h = handler_close,
   .fstat_h = rtems_filesystem_default_fstat,
-  .fcntl_h = rtems_filesystem_default_fcntl
+  .fcntl_h = rtems_filesystem_default_fcntl,
+  .fallocate_h = rtems_filesystem_default_fallocate
 };
 
 static const IMFS_node_control node_control = {
@@ -0,0 +1,448 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <string.h>
+
+const char rtems_test_name[] = "SPMSGQLOAN 1";
+
+#define MESSAGE_COUNT 2
+
+#define MESSAGE_SIZE 64
+
+#define EVENT_RECEIVE RTEMS_EVENT_0
+
+#define EVENT_RECEIVE_LOANED RTEMS_EVENT_1
+
+#define EVENT_DONE RTEMS_EVENT_2
+
+typedef struct {
+  rtems_id main_task;
+  rtems_id worker_task;
+  rtems_id queue;
+  rtems_status_code worker_status;
+  size_t worker_size;
+  char worker_message[MESSAGE_SIZE];
+} test_context;
+
+static test_context test_instance;
+
+static void send_event(rtems_id task, rtems_event_set event)
+{
+  rtems_status_code sc;
+
+  sc = rtems_event_send(task, event);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static rtems_event_set wait_for_events(void)
+{
+  rtems_status_code sc;
+  rtems_event_set events;
+
+  sc = rtems_event_receive(
+    RTEMS_ALL_EVENTS,
+    RTEMS_EVENT_ANY | RTEMS_WAIT,
+    RTEMS_NO_TIMEOUT,
+    &events
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  return events;
+}
+
+static void worker(rtems_task_argument arg)
+{
+  test_context *ctx;
+
+  ctx = (test_context *) arg;
+
+  while (true) {
+    rtems_event_set events;
+
+    events = wait_for_events();
+
+    if ((events & EVENT_RECEIVE) != 0) {
+      ctx->worker_status = rtems_message_queue_receive(
+        ctx->queue,
+        ctx->worker_message,
+        &ctx->worker_size,
+        RTEMS_WAIT,
+        RTEMS_NO_TIMEOUT
+      );
+    }
+
+    if ((events & EVENT_RECEIVE_LOANED) != 0) {
+      void *buffer;
+
+      ctx->worker_status = rtems_message_queue_receive_loaned(
+        ctx->queue,
+        &buffer,
+        &ctx->worker_size,
+        RTEMS_WAIT,
+        RTEMS_NO_TIMEOUT
+      );
+
+      if (ctx->worker_status == RTEMS_SUCCESSFUL) {
+        rtems_status_code sc;
+
+        memcpy(ctx->worker_message, buffer, ctx->worker_size);
+        sc = rtems_message_queue_return(ctx->queue, buffer);
+        rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+      }
+    }
+
+    send_event(ctx->main_task, EVENT_DONE);
+  }
+}
+
+static void assert_all_buffers_available(test_context *ctx)
+{
+  rtems_status_code sc;
+  void *buffers[MESSAGE_COUNT];
+  void *buffer;
+  size_t i;
+
+  for (i = 0; i < MESSAGE_COUNT; ++i) {
+    sc = rtems_message_queue_loan(ctx->queue, &buffers[i]);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  sc = rtems_message_queue_loan(ctx->queue, &buffer);
+  rtems_test_assert(sc == RTEMS_TOO_MANY);
+
+  for (i = 0; i < MESSAGE_COUNT; ++i) {
+    sc = rtems_message_queue_return(ctx->queue, buffers[i]);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+}
+
+static void test_invalid_parameters(test_context *ctx)
+{
+  rtems_status_code sc;
+  void *buffer;
+  size_t size;
+  char other[MESSAGE_SIZE];
+
+  sc = rtems_message_queue_loan(ctx->queue, NULL);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_loan(0, &buffer);
+  rtems_test_assert(sc == RTEMS_INVALID_ID);
+
+  sc = rtems_message_queue_submit(ctx->queue, NULL, 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_submit(ctx->queue, other, 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    NULL,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    NULL,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_return(ctx->queue, other);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_loan(ctx->queue, &buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_return(ctx->queue, (char *) buffer + 1);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_submit(ctx->queue, buffer, MESSAGE_SIZE + 1);
+  rtems_test_assert(sc == RTEMS_INVALID_SIZE);
+
+  sc = rtems_message_queue_return(ctx->queue, buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_return(ctx->queue, buffer);
+  rtems_test_assert(sc == RTEMS_INCORRECT_STATE);
+
+  sc = rtems_message_queue_submit(ctx->queue, buffer, 1);
+  rtems_test_assert(sc == RTEMS_INCORRECT_STATE);
+
+  assert_all_buffers_available(ctx);
+}
+
+static void test_zero_copy(test_context *ctx)
+{
+  rtems_status_code sc;
+  void *buffers[MESSAGE_COUNT];
+  void *buffer;
+  char message[MESSAGE_SIZE];
+  size_t size;
+  size_t i;
+
+  for (i = 0; i < MESSAGE_COUNT; ++i) {
+    sc = rtems_message_queue_loan(ctx->queue, &buffers[i]);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    rtems_test_assert(((uintptr_t) buffers[i] % sizeof(uintptr_t)) == 0);
+    memset(buffers[i], (int) i + 1, MESSAGE_SIZE);
+  }
+
+  sc = rtems_message_queue_send(ctx->queue, message, 1);
+  rtems_test_assert(sc == RTEMS_TOO_MANY);
+
+  for (i = 0; i < MESSAGE_COUNT; ++i) {
+    sc = rtems_message_queue_submit(ctx->queue, buffers[i], i + 1);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  sc = rtems_message_queue_submit(ctx->queue, buffers[0], 1);
+  rtems_test_assert(sc == RTEMS_INCORRECT_STATE);
+
+  /* The receiver gets the submitted buffers themselves in FIFO order */
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(buffer == buffers[0]);
+  rtems_test_assert(size == 1);
+  rtems_test_assert(((char *) buffer)[0] == 1);
+
+  /* A loaned receive buffer may be forwarded without a copy */
+  sc = rtems_message_queue_submit(ctx->queue, buffer, MESSAGE_SIZE);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /* Copy receive of a submitted message */
+  sc = rtems_message_queue_receive(
+    ctx->queue,
+    message,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == 2);
+  rtems_test_assert(message[0] == 2 && message[1] == 2);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(buffer == buffers[0]);
+  rtems_test_assert(size == MESSAGE_SIZE);
+
+  sc = rtems_message_queue_return(ctx->queue, buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /* Loaned receive of a copied message */
+  memset(message, 0x55, sizeof(message));
+  sc = rtems_message_queue_send(ctx->queue, message, 3);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == 3);
+  rtems_test_assert(memcmp(buffer, message, size) == 0);
+
+  sc = rtems_message_queue_return(ctx->queue, buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_UNSATISFIED);
+
+  assert_all_buffers_available(ctx);
+}
+
+static void test_waiting_receivers(test_context *ctx)
+{
+  rtems_status_code sc;
+  void *buffers[MESSAGE_COUNT];
+  void *buffer;
+  size_t size;
+  char message[MESSAGE_SIZE];
+
+  /* Submit to a waiting copy receiver */
+  send_event(ctx->worker_task, EVENT_RECEIVE);
+
+  sc = rtems_message_queue_loan(ctx->queue, &buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  memset(buffer, 0x11, MESSAGE_SIZE);
+
+  sc = rtems_message_queue_submit(ctx->queue, buffer, 5);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(wait_for_events() == EVENT_DONE);
+  rtems_test_assert(ctx->worker_status == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->worker_size == 5);
+  rtems_test_assert(ctx->worker_message[4] == 0x11);
+
+  assert_all_buffers_available(ctx);
+
+  /* Copy send to a waiting loaned receiver */
+  send_event(ctx->worker_task, EVENT_RECEIVE_LOANED);
+
+  memset(message, 0x22, sizeof(message));
+  sc = rtems_message_queue_send(ctx->queue, message, 7);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(wait_for_events() == EVENT_DONE);
+  rtems_test_assert(ctx->worker_status == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->worker_size == 7);
+  rtems_test_assert(ctx->worker_message[6] == 0x22);
+
+  assert_all_buffers_available(ctx);
+
+  /* Submit to a waiting loaned receiver */
+  send_event(ctx->worker_task, EVENT_RECEIVE_LOANED);
+
+  sc = rtems_message_queue_loan(ctx->queue, &buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  memset(buffer, 0x33, MESSAGE_SIZE);
+
+  sc = rtems_message_queue_submit(ctx->queue, buffer, MESSAGE_SIZE);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(wait_for_events() == EVENT_DONE);
+  rtems_test_assert(ctx->worker_status == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->worker_size == MESSAGE_SIZE);
+  rtems_test_assert(ctx->worker_message[MESSAGE_SIZE - 1] == 0x33);
+
+  assert_all_buffers_available(ctx);
+
+  /* The reserved buffer returns to the message queue after a timeout */
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_WAIT,
+    1
+  );
+  rtems_test_assert(sc == RTEMS_TIMEOUT);
+
+  assert_all_buffers_available(ctx);
+
+  /* A waiting loaned receiver needs a buffer */
+  sc = rtems_message_queue_loan(ctx->queue, &buffers[0]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_loan(ctx->queue, &buffers[1]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_loaned(
+    ctx->queue,
+    &buffer,
+    &size,
+    RTEMS_WAIT,
+    1
+  );
+  rtems_test_assert(sc == RTEMS_TOO_MANY);
+
+  sc = rtems_message_queue_return(ctx->queue, buffers[0]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_return(ctx->queue, buffers[1]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  assert_all_buffers_available(ctx);
+}
+
+static void test(void)
+{
+  test_context *ctx;
+  rtems_status_code sc;
+
+  ctx = &test_instance;
+  ctx->main_task = rtems_task_self();
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('M', 'S', 'G', 'Q'),
+    MESSAGE_COUNT,
+    MESSAGE_SIZE,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &ctx->queue
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_create(
+    rtems_build_name('W', 'O', 'R', 'K'),
+    1,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_DEFAULT_MODES,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &ctx->worker_task
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(ctx->worker_task, worker, (rtems_task_argument) ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  test_invalid_parameters(ctx);
+  test_zero_copy(ctx);
+  test_waiting_receivers(ctx);
+
+  sc = rtems_task_delete(ctx->worker_task);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_delete(ctx->queue);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MESSAGE_COUNT, MESSAGE_SIZE)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_INIT_TASK_PRIORITY 2
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
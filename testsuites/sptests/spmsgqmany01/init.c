@@ -0,0 +1,361 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+const char rtems_test_name[] = "SPMSGQMANY 1";
+
+#define MESSAGE_COUNT 4
+
+#define WORKER_COUNT 2
+
+#define EVENT_RECEIVE RTEMS_EVENT_0
+
+#define EVENT_RECEIVE_MANY RTEMS_EVENT_1
+
+#define EVENT_DONE RTEMS_EVENT_2
+
+typedef struct {
+  rtems_id main_task;
+  rtems_id worker_tasks[WORKER_COUNT];
+  rtems_id queue;
+  rtems_status_code status[WORKER_COUNT];
+  uint64_t message[WORKER_COUNT];
+  size_t size[WORKER_COUNT];
+  uint32_t received[WORKER_COUNT];
+} test_context;
+
+static test_context test_instance;
+
+static void send_event(rtems_id task, rtems_event_set event)
+{
+  rtems_status_code sc;
+
+  sc = rtems_event_send(task, event);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static rtems_event_set wait_for_events(rtems_event_set events)
+{
+  rtems_status_code sc;
+  rtems_event_set out;
+
+  sc = rtems_event_receive(
+    events,
+    RTEMS_EVENT_ALL | RTEMS_WAIT,
+    RTEMS_NO_TIMEOUT,
+    &out
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  return out;
+}
+
+static void worker(rtems_task_argument index)
+{
+  test_context *ctx;
+
+  ctx = &test_instance;
+
+  while (true) {
+    rtems_status_code sc;
+    rtems_event_set events;
+
+    sc = rtems_event_receive(
+      EVENT_RECEIVE | EVENT_RECEIVE_MANY,
+      RTEMS_EVENT_ANY | RTEMS_WAIT,
+      RTEMS_NO_TIMEOUT,
+      &events
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    if ((events & EVENT_RECEIVE_MANY) != 0) {
+      uint64_t messages[MESSAGE_COUNT];
+      size_t sizes[MESSAGE_COUNT];
+
+      ctx->status[index] = rtems_message_queue_receive_many(
+        ctx->queue,
+        messages,
+        sizeof(messages[0]),
+        sizes,
+        MESSAGE_COUNT,
+        &ctx->received[index],
+        RTEMS_WAIT,
+        RTEMS_NO_TIMEOUT
+      );
+      ctx->message[index] = messages[0];
+      ctx->size[index] = sizes[0];
+    } else {
+      ctx->status[index] = rtems_message_queue_receive(
+        ctx->queue,
+        &ctx->message[index],
+        &ctx->size[index],
+        RTEMS_WAIT,
+        RTEMS_NO_TIMEOUT
+      );
+      ctx->received[index] = 1;
+    }
+
+    send_event(ctx->main_task, EVENT_DONE << index);
+  }
+}
+
+static void init_messages(uint64_t *messages, size_t n, uint64_t first)
+{
+  size_t i;
+
+  for (i = 0; i < n; ++i) {
+    messages[i] = first + i;
+  }
+}
+
+static void test_send_and_receive_many(test_context *ctx)
+{
+  rtems_status_code sc;
+  uint64_t messages[2 * MESSAGE_COUNT];
+  size_t sizes[2 * MESSAGE_COUNT];
+  uint32_t sent;
+  uint32_t received;
+  uint32_t count;
+
+  init_messages(messages, RTEMS_ARRAY_SIZE(messages), 0);
+
+  sc = rtems_message_queue_send_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]) + 1,
+    1,
+    &sent
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_SIZE);
+  rtems_test_assert(sent == 0);
+
+  sc = rtems_message_queue_send_many(ctx->queue, messages, 1, 1, NULL);
+  rtems_test_assert(sc == RTEMS_INVALID_ADDRESS);
+
+  sc = rtems_message_queue_send_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    MESSAGE_COUNT + 2,
+    &sent
+  );
+  rtems_test_assert(sc == RTEMS_TOO_MANY);
+  rtems_test_assert(sent == MESSAGE_COUNT);
+
+  sc = rtems_message_queue_get_number_pending(ctx->queue, &count);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(count == MESSAGE_COUNT);
+
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]) - 1,
+    sizes,
+    1,
+    &received,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_INVALID_SIZE);
+  rtems_test_assert(received == 0);
+
+  init_messages(messages, RTEMS_ARRAY_SIZE(messages), 100);
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    sizes,
+    3,
+    &received,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received == 3);
+  rtems_test_assert(messages[0] == 0 && sizes[0] == sizeof(messages[0]));
+  rtems_test_assert(messages[1] == 1 && sizes[1] == sizeof(messages[0]));
+  rtems_test_assert(messages[2] == 2 && sizes[2] == sizeof(messages[0]));
+  rtems_test_assert(messages[3] == 103);
+
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    sizes,
+    RTEMS_ARRAY_SIZE(messages),
+    &received,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received == 1);
+  rtems_test_assert(messages[0] == 3);
+
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    sizes,
+    RTEMS_ARRAY_SIZE(messages),
+    &received,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_UNSATISFIED);
+  rtems_test_assert(received == 0);
+
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    sizes,
+    1,
+    &received,
+    RTEMS_WAIT,
+    1
+  );
+  rtems_test_assert(sc == RTEMS_TIMEOUT);
+  rtems_test_assert(received == 0);
+}
+
+static void test_waiting_receivers(test_context *ctx)
+{
+  rtems_status_code sc;
+  uint64_t messages[MESSAGE_COUNT];
+  size_t sizes[MESSAGE_COUNT];
+  uint32_t sent;
+  uint32_t received;
+
+  /* Each waiting receiver gets one message of the batch in order */
+  send_event(ctx->worker_tasks[0], EVENT_RECEIVE);
+  send_event(ctx->worker_tasks[1], EVENT_RECEIVE_MANY);
+
+  init_messages(messages, RTEMS_ARRAY_SIZE(messages), 10);
+  sc = rtems_message_queue_send_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    3,
+    &sent
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(sent == 3);
+
+  wait_for_events(EVENT_DONE | (EVENT_DONE << 1));
+  rtems_test_assert(ctx->status[0] == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->message[0] == 10);
+  rtems_test_assert(ctx->size[0] == sizeof(messages[0]));
+  rtems_test_assert(ctx->status[1] == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->received[1] == 1);
+  rtems_test_assert(ctx->message[1] == 11);
+  rtems_test_assert(ctx->size[1] == sizeof(messages[0]));
+
+  /* The rest of the batch is pending */
+  sc = rtems_message_queue_receive_many(
+    ctx->queue,
+    messages,
+    sizeof(messages[0]),
+    sizes,
+    MESSAGE_COUNT,
+    &received,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(received == 1);
+  rtems_test_assert(messages[0] == 12);
+
+  /* A single send satisfies a waiting batch receiver */
+  send_event(ctx->worker_tasks[1], EVENT_RECEIVE_MANY);
+
+  messages[0] = 20;
+  sc = rtems_message_queue_send(ctx->queue, &messages[0], 4);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  wait_for_events(EVENT_DONE << 1);
+  rtems_test_assert(ctx->status[1] == RTEMS_SUCCESSFUL);
+  rtems_test_assert(ctx->received[1] == 1);
+  rtems_test_assert(ctx->size[1] == 4);
+}
+
+static void test(void)
+{
+  test_context *ctx;
+  rtems_status_code sc;
+  size_t i;
+
+  ctx = &test_instance;
+  ctx->main_task = rtems_task_self();
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('M', 'S', 'G', 'Q'),
+    MESSAGE_COUNT,
+    sizeof(uint64_t),
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &ctx->queue
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  for (i = 0; i < WORKER_COUNT; ++i) {
+    sc = rtems_task_create(
+      rtems_build_name('W', 'O', 'R', 'K'),
+      1,
+      RTEMS_MINIMUM_STACK_SIZE,
+      RTEMS_DEFAULT_MODES,
+      RTEMS_DEFAULT_ATTRIBUTES,
+      &ctx->worker_tasks[i]
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    sc = rtems_task_start(ctx->worker_tasks[i], worker, i);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  test_send_and_receive_many(ctx);
+  test_waiting_receivers(ctx);
+
+  for (i = 0; i < WORKER_COUNT; ++i) {
+    sc = rtems_task_delete(ctx->worker_tasks[i]);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  sc = rtems_message_queue_delete(ctx->queue);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS (1 + WORKER_COUNT)
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MESSAGE_COUNT, sizeof(uint64_t))
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_INIT_TASK_PRIORITY 2
+#define CONFIGURE_INIT_TASK_INITIAL_MODES RTEMS_DEFAULT_MODES
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,202 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <rtems/score/threaddispatch.h>
+#include <rtems/score/watchdogimpl.h>
+
+const char rtems_test_name[] = "SPTICKLESS 1";
+
+#define MAXIMUM_IDLE_TICKS 1000
+
+typedef struct {
+  rtems_id main_task;
+  rtems_id timers[2];
+  rtems_interval fired_at;
+} test_context;
+
+static test_context test_instance;
+
+static uint32_t get_idle_ticks(uint32_t maximum)
+{
+  Per_CPU_Control *cpu_self;
+  uint32_t idle_ticks;
+
+  cpu_self = _Thread_Dispatch_disable();
+  idle_ticks = _Watchdog_Get_idle_ticks(maximum);
+  _Thread_Dispatch_enable(cpu_self);
+
+  return idle_ticks;
+}
+
+static void synchronize_with_clock_tick(void)
+{
+  rtems_status_code sc;
+
+  sc = rtems_task_wake_after(1);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void timer_routine(rtems_id timer, void *arg)
+{
+  test_context *ctx = arg;
+  rtems_status_code sc;
+
+  ctx->fired_at = rtems_clock_get_ticks_since_boot();
+  sc = rtems_event_transient_send(ctx->main_task);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void never(rtems_id timer, void *arg)
+{
+  rtems_test_assert(0);
+}
+
+static void test_no_watchdogs(void)
+{
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == MAXIMUM_IDLE_TICKS);
+  rtems_test_assert(get_idle_ticks(1) == 1);
+}
+
+static void test_ticks(test_context *ctx)
+{
+  rtems_status_code sc;
+
+  synchronize_with_clock_tick();
+
+  sc = rtems_timer_fire_after(ctx->timers[0], 30, never, ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_fire_after(ctx->timers[1], 5, never, ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == 5);
+  rtems_test_assert(get_idle_ticks(3) == 3);
+
+  sc = rtems_timer_cancel(ctx->timers[1]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == 30);
+
+  sc = rtems_timer_cancel(ctx->timers[0]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == MAXIMUM_IDLE_TICKS);
+}
+
+static void test_time_of_day(test_context *ctx)
+{
+  rtems_status_code sc;
+  rtems_time_of_day tod;
+  uint32_t idle_ticks;
+  uint32_t ticks_per_second;
+
+  build_time(&tod, 12, 31, 1988, 9, 0, 0, 0);
+  ticks_per_second = rtems_clock_get_ticks_per_second();
+
+  synchronize_with_clock_tick();
+
+  sc = rtems_clock_set(&tod);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  tod.second = 2;
+  sc = rtems_timer_fire_when(ctx->timers[0], &tod, never, ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /*
+   * Less than one clock tick passed since the time of day was set, so the
+   * lower bound is one clock tick less than the exact time interval.
+   */
+  idle_ticks = get_idle_ticks(MAXIMUM_IDLE_TICKS);
+  rtems_test_assert(idle_ticks >= 2 * ticks_per_second - 1);
+  rtems_test_assert(idle_ticks <= 2 * ticks_per_second);
+
+  sc = rtems_timer_cancel(ctx->timers[0]);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void test_skip_ticks(test_context *ctx)
+{
+  rtems_status_code sc;
+  rtems_interval start;
+  rtems_interval now;
+  rtems_interrupt_level level;
+  uint32_t idle_ticks;
+
+  synchronize_with_clock_tick();
+
+  start = rtems_clock_get_ticks_since_boot();
+  sc = rtems_timer_fire_after(ctx->timers[0], 20, timer_routine, ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  /*
+   * Emulate a tickless idle period which ends with the next clock tick.  The
+   * timer must fire exactly with the clock tick of its expiration time.
+   */
+  rtems_interrupt_local_disable(level);
+  now = rtems_clock_get_ticks_since_boot();
+  idle_ticks = get_idle_ticks(MAXIMUM_IDLE_TICKS);
+  rtems_test_assert(idle_ticks == start + 20 - now);
+  _Watchdog_Skip_ticks(idle_ticks - 1);
+  rtems_test_assert(rtems_clock_get_ticks_since_boot() == start + 19);
+  rtems_interrupt_local_enable(level);
+
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == 1);
+
+  sc = rtems_event_transient_receive(RTEMS_WAIT, RTEMS_NO_TIMEOUT);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  rtems_test_assert(ctx->fired_at == start + 20);
+  rtems_test_assert(get_idle_ticks(MAXIMUM_IDLE_TICKS) == MAXIMUM_IDLE_TICKS);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  test_context *ctx = &test_instance;
+  rtems_status_code sc;
+  size_t i;
+
+  TEST_BEGIN();
+
+  ctx->main_task = rtems_task_self();
+
+  for (i = 0; i < RTEMS_ARRAY_SIZE(ctx->timers); ++i) {
+    sc = rtems_timer_create(
+      rtems_build_name('T', 'I', 'M', '0' + i),
+      &ctx->timers[i]
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  test_no_watchdogs();
+  test_ticks(ctx);
+  test_time_of_day(ctx);
+  test_skip_ticks(ctx);
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+#define CONFIGURE_MAXIMUM_TIMERS 2
+
+#define CONFIGURE_TICKLESS_IDLE
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
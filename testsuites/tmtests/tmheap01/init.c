@@ -0,0 +1,236 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rtems.h>
+#include <rtems/counter.h>
+#include <rtems/score/heapimpl.h>
+
+const char rtems_test_name[] = "TMHEAP 1";
+
+#define HEAP_AREA_SIZE (256 * 1024)
+
+#define BLOCK_COUNT 4096
+
+#define TAIL_BLOCK_COUNT 64
+
+#define SAMPLE_COUNT 64
+
+typedef struct {
+  const char *name;
+  Heap_Initialization_or_extend_handler initialize;
+} test_engine;
+
+typedef struct {
+  Heap_Control heap;
+  void *blocks[ BLOCK_COUNT ];
+  size_t block_count;
+  uint32_t seed;
+  RTEMS_ALIGNED( CPU_HEAP_ALIGNMENT ) char area[ HEAP_AREA_SIZE ];
+} test_context;
+
+static test_context test_instance;
+
+static const test_engine test_engines[] = {
+  { "FirstFit", _Heap_Initialize },
+  { "SegregatedFit", _Heap_Initialize_segregated_fit }
+};
+
+static const uintptr_t test_sizes[] = {
+  16, 64, 256, 1024, 4096
+};
+
+static uint32_t next_random( test_context *ctx )
+{
+  ctx->seed = ctx->seed * 1103515245 + 12345;
+
+  return ctx->seed >> 16;
+}
+
+/*
+ * Fill the heap with blocks of random size.  Free the blocks at the end of
+ * the heap first to get a large free block.  Then free every second block to
+ * get a lot of small free blocks.  With the first fit method these small free
+ * blocks are in front of the large free block in the free list.
+ */
+static void fragment_heap( test_context *ctx )
+{
+  size_t i;
+
+  ctx->seed = 0x12345678;
+  ctx->block_count = 0;
+
+  while ( ctx->block_count < BLOCK_COUNT ) {
+    uintptr_t size = 16 + next_random( ctx ) % 496;
+    void *p = _Heap_Allocate( &ctx->heap, size );
+
+    if ( p == NULL ) {
+      break;
+    }
+
+    ctx->blocks[ ctx->block_count ] = p;
+    ++ctx->block_count;
+  }
+
+  rtems_test_assert( ctx->block_count > TAIL_BLOCK_COUNT );
+
+  for ( i = ctx->block_count - TAIL_BLOCK_COUNT; i < ctx->block_count; ++i ) {
+    _Heap_Free( &ctx->heap, ctx->blocks[ i ] );
+    ctx->blocks[ i ] = NULL;
+  }
+
+  for ( i = 0; i < ctx->block_count - TAIL_BLOCK_COUNT; i += 2 ) {
+    _Heap_Free( &ctx->heap, ctx->blocks[ i ] );
+    ctx->blocks[ i ] = NULL;
+  }
+
+  rtems_test_assert( _Heap_Walk( &ctx->heap, 0, false ) );
+}
+
+static void release_heap( test_context *ctx )
+{
+  size_t i;
+
+  for ( i = 0; i < ctx->block_count; ++i ) {
+    _Heap_Free( &ctx->heap, ctx->blocks[ i ] );
+  }
+
+  rtems_test_assert( _Heap_Walk( &ctx->heap, 0, false ) );
+}
+
+static void test_size( test_context *ctx, uintptr_t size )
+{
+  rtems_counter_ticks max_alloc = 0;
+  rtems_counter_ticks max_free = 0;
+  uint64_t sum_alloc = 0;
+  size_t i;
+
+  ctx->heap.stats.max_search = 0;
+
+  for ( i = 0; i < SAMPLE_COUNT; ++i ) {
+    rtems_interrupt_level level;
+    rtems_counter_ticks a;
+    rtems_counter_ticks b;
+    rtems_counter_ticks c;
+    rtems_counter_ticks d;
+    void *p;
+    bool ok;
+
+    rtems_interrupt_local_disable( level );
+    a = rtems_counter_read();
+    p = _Heap_Allocate( &ctx->heap, size );
+    b = rtems_counter_read();
+    ok = _Heap_Free( &ctx->heap, p );
+    c = rtems_counter_read();
+    rtems_interrupt_local_enable( level );
+
+    rtems_test_assert( p != NULL );
+    rtems_test_assert( ok );
+
+    d = rtems_counter_difference( b, a );
+    sum_alloc += d;
+
+    if ( d > max_alloc ) {
+      max_alloc = d;
+    }
+
+    d = rtems_counter_difference( c, b );
+
+    if ( d > max_free ) {
+      max_free = d;
+    }
+  }
+
+  printf(
+    "    <Sample>\n"
+    "      <Size>%" PRIuPTR "</Size>"
+    "<MaxSearch>%" PRIu32 "</MaxSearch>"
+    "<MaxAllocate unit=\"ns\">%" PRIu64 "</MaxAllocate>"
+    "<AvgAllocate unit=\"ns\">%" PRIu64 "</AvgAllocate>"
+    "<MaxFree unit=\"ns\">%" PRIu64 "</MaxFree>\n"
+    "    </Sample>\n",
+    size,
+    ctx->heap.stats.max_search,
+    rtems_counter_ticks_to_nanoseconds( max_alloc ),
+    rtems_counter_ticks_to_nanoseconds( sum_alloc / SAMPLE_COUNT ),
+    rtems_counter_ticks_to_nanoseconds( max_free )
+  );
+}
+
+static void test_engine_run( test_context *ctx, const test_engine *engine )
+{
+  uintptr_t space_available;
+  size_t i;
+
+  space_available = ( *engine->initialize )(
+    &ctx->heap,
+    ctx->area,
+    sizeof( ctx->area ),
+    0
+  );
+  rtems_test_assert( space_available > 0 );
+
+  fragment_heap( ctx );
+
+  printf(
+    "  <Engine name=\"%s\" freeBlocks=\"%" PRIu32 "\">\n",
+    engine->name,
+    ctx->heap.stats.free_blocks
+  );
+
+  for ( i = 0; i < RTEMS_ARRAY_SIZE( test_sizes ); ++i ) {
+    test_size( ctx, test_sizes[ i ] );
+  }
+
+  printf( "  </Engine>\n" );
+
+  release_heap( ctx );
+}
+
+static void test( void )
+{
+  test_context *ctx = &test_instance;
+  size_t i;
+
+  printf( "<TMHeap01>\n" );
+
+  for ( i = 0; i < RTEMS_ARRAY_SIZE( test_engines ); ++i ) {
+    test_engine_run( ctx, &test_engines[ i ] );
+  }
+
+  printf( "</TMHeap01>\n" );
+}
+
+static void Init( rtems_task_argument arg )
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,421 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rtems.h>
+#include <rtems/counter.h>
+#include <rtems/rtems/timerimpl.h>
+
+const char rtems_test_name[] = "TMIDENT 1";
+
+#define TIMER_COUNT 10000
+
+#define SAMPLE_COUNT 100
+
+#define PLACEHOLDER_COUNT 32
+
+#define SAME_BUCKET_COUNT 2
+
+#define CHURN_DURATION_IN_TICKS 100
+
+#define CHURN_PRIORITY 1
+
+typedef struct {
+  rtems_name same_bucket[SAME_BUCKET_COUNT];
+  volatile bool stop;
+  volatile unsigned long churns;
+} test_context;
+
+static test_context test_instance;
+
+static rtems_name name_of_index(size_t i)
+{
+  return rtems_build_name('T', 0, 0, 0) | (rtems_name) i;
+}
+
+static rtems_counter_ticks measure_ident(
+  rtems_name n,
+  rtems_status_code expected
+)
+{
+  rtems_counter_ticks max;
+  size_t i;
+
+  max = 0;
+
+  for (i = 0; i < SAMPLE_COUNT; ++i) {
+    rtems_status_code sc;
+    rtems_counter_ticks a;
+    rtems_counter_ticks b;
+    rtems_counter_ticks d;
+    rtems_id id;
+    rtems_interrupt_level level;
+
+    rtems_interrupt_local_disable(level);
+    a = rtems_counter_read();
+    sc = rtems_timer_ident(n, &id);
+    b = rtems_counter_read();
+    rtems_interrupt_local_enable(level);
+
+    rtems_test_assert(sc == expected);
+
+    d = rtems_counter_difference(b, a);
+    if (d > max) {
+      max = d;
+    }
+  }
+
+  return max;
+}
+
+static void print_ident(
+  const char *element,
+  rtems_name n,
+  rtems_status_code expected
+)
+{
+  printf(
+    "<%s unit=\"ns\">%" PRIu64 "</%s>",
+    element,
+    rtems_counter_ticks_to_nanoseconds(measure_ident(n, expected)),
+    element
+  );
+}
+
+static void test_case(size_t count)
+{
+  Objects_Name_index *name_index;
+  rtems_name last;
+  rtems_name missing;
+
+  last = name_of_index(count);
+  missing = name_of_index(TIMER_COUNT + 1);
+
+  printf("  <Sample>\n    <Timers>%zu</Timers>", count);
+
+  print_ident("IndexLast", last, RTEMS_SUCCESSFUL);
+  print_ident("IndexMissing", missing, RTEMS_INVALID_NAME);
+
+  /*
+   * Disable the name index temporarily to compare with the linear search of
+   * the local table.
+   */
+  name_index = _Timer_Information.name_index;
+  _Timer_Information.name_index = NULL;
+
+  print_ident("LinearLast", last, RTEMS_SUCCESSFUL);
+  print_ident("LinearMissing", missing, RTEMS_INVALID_NAME);
+
+  _Timer_Information.name_index = name_index;
+
+  printf("\n  </Sample>\n");
+}
+
+static void test_duplicate_names(void)
+{
+  rtems_status_code sc;
+  rtems_name n;
+  rtems_id first;
+  rtems_id second;
+  rtems_id third;
+  rtems_id id;
+
+  n = rtems_build_name('D', 'U', 'P', ' ');
+
+  sc = rtems_timer_create(n, &first);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_create(n, &second);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(
+    rtems_object_id_get_index(first) < rtems_object_id_get_index(second)
+  );
+
+  /* The object with the lowest index is returned, like the linear search */
+  sc = rtems_timer_ident(n, &id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(id == first);
+
+  sc = rtems_timer_delete(first);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_ident(n, &id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(id == second);
+
+  sc = rtems_timer_create(n, &third);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_ident(n, &id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  if (rtems_object_id_get_index(third) < rtems_object_id_get_index(second)) {
+    rtems_test_assert(id == third);
+  } else {
+    rtems_test_assert(id == second);
+  }
+
+  sc = rtems_timer_delete(second);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_ident(n, &id);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(id == third);
+
+  sc = rtems_timer_delete(third);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_ident(n, &id);
+  rtems_test_assert(sc == RTEMS_INVALID_NAME);
+}
+
+static uint32_t bucket_of_index(Objects_Maximum index)
+{
+  const Objects_Name_index *name_index;
+  uint32_t bucket;
+
+  name_index = _Timer_Information.name_index;
+
+  for (bucket = 0; bucket <= name_index->bucket_mask; ++bucket) {
+    Objects_Maximum i;
+
+    i = name_index->entries[bucket];
+
+    while (i != 0) {
+      if (i == index) {
+        return bucket;
+      }
+
+      i = name_index->entries[name_index->bucket_mask + 1 + i];
+    }
+  }
+
+  rtems_test_assert(0);
+  return 0;
+}
+
+static void find_same_bucket_names(test_context *ctx, rtems_id stable)
+{
+  uint32_t bucket;
+  uint32_t candidate;
+  size_t found;
+
+  bucket = bucket_of_index(rtems_object_id_get_index(stable));
+  candidate = 0;
+  found = 0;
+
+  while (found < SAME_BUCKET_COUNT) {
+    rtems_status_code sc;
+    rtems_name n;
+    rtems_id id;
+
+    ++candidate;
+    n = rtems_build_name('C', 0, 0, 0) | candidate;
+
+    sc = rtems_timer_create(n, &id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+    if (bucket_of_index(rtems_object_id_get_index(id)) == bucket) {
+      ctx->same_bucket[found] = n;
+      ++found;
+    }
+
+    sc = rtems_timer_delete(id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+}
+
+static void churn_task(rtems_task_argument arg)
+{
+  test_context *ctx = (test_context *) arg;
+
+  while (!ctx->stop) {
+    size_t i;
+
+    for (i = 0; i < SAME_BUCKET_COUNT; ++i) {
+      rtems_status_code sc;
+      rtems_id id;
+
+      sc = rtems_timer_create(ctx->same_bucket[i], &id);
+      rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+      sc = rtems_timer_delete(id);
+      rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    }
+
+    ++ctx->churns;
+  }
+
+  rtems_task_suspend(RTEMS_SELF);
+}
+
+/*
+ * Identify a stable timer while another task creates and deletes timers with
+ * names of the same hash bucket.  The placeholders make indices below the one
+ * of the stable timer available, so that the churned timers precede it in
+ * the hash chain.
+ */
+static void test_ident_during_churn(test_context *ctx)
+{
+  rtems_status_code sc;
+  rtems_id placeholders[PLACEHOLDER_COUNT];
+  rtems_name n;
+  rtems_id stable;
+  rtems_id task;
+  rtems_id id;
+  rtems_mode mode;
+  rtems_interval start;
+  unsigned long idents;
+  size_t i;
+
+  for (i = 0; i < PLACEHOLDER_COUNT; ++i) {
+    sc = rtems_timer_create(
+      rtems_build_name('P', 'L', 'C', 'H'),
+      &placeholders[i]
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  n = rtems_build_name('S', 'T', 'B', 'L');
+  sc = rtems_timer_create(n, &stable);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  for (i = 0; i < PLACEHOLDER_COUNT; ++i) {
+    sc = rtems_timer_delete(placeholders[i]);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  find_same_bucket_names(ctx, stable);
+
+  sc = rtems_task_mode(
+    RTEMS_PREEMPT | RTEMS_TIMESLICE,
+    RTEMS_PREEMPT_MASK | RTEMS_TIMESLICE_MASK,
+    &mode
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_create(
+    rtems_build_name('C', 'H', 'R', 'N'),
+    CHURN_PRIORITY,
+    RTEMS_MINIMUM_STACK_SIZE,
+    RTEMS_TIMESLICE,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &task
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_start(task, churn_task, (rtems_task_argument) ctx);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  idents = 0;
+  start = rtems_clock_get_ticks_since_boot();
+
+  while (rtems_clock_get_ticks_since_boot() - start < CHURN_DURATION_IN_TICKS) {
+    sc = rtems_timer_ident(n, &id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    rtems_test_assert(id == stable);
+    ++idents;
+  }
+
+  ctx->stop = true;
+
+  while (rtems_task_is_suspended(task) == RTEMS_SUCCESSFUL) {
+    sc = rtems_task_wake_after(1);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  rtems_test_assert(idents > 0);
+  rtems_test_assert(ctx->churns > 0);
+
+  sc = rtems_task_delete(task);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_task_mode(
+    mode,
+    RTEMS_PREEMPT_MASK | RTEMS_TIMESLICE_MASK,
+    &mode
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_timer_delete(stable);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void test(void)
+{
+  size_t count;
+  size_t next;
+
+  rtems_test_assert(rtems_configuration_get_objects_name_index());
+
+  test_duplicate_names();
+  test_ident_during_churn(&test_instance);
+
+  printf("<TMIdent01>\n");
+
+  count = 0;
+  next = 1;
+
+  while (count < TIMER_COUNT) {
+    rtems_status_code sc;
+    rtems_id id;
+
+    ++count;
+    sc = rtems_timer_create(name_of_index(count), &id);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+    rtems_test_assert(_Objects_Has_name_index(&_Timer_Information));
+
+    if (count == next || count == TIMER_COUNT) {
+      test_case(count);
+      next *= 10;
+    }
+  }
+
+  printf("</TMIdent01>\n");
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_MAXIMUM_TASKS 2
+#define CONFIGURE_MAXIMUM_TIMERS rtems_resource_unlimited(1000)
+
+#define CONFIGURE_OBJECTS_NAME_INDEX
+
+#define CONFIGURE_INIT_TASK_PRIORITY CHURN_PRIORITY
+
+/*
+ * Switch between the identifying and the churning task often.
+ */
+#define CONFIGURE_TICKS_PER_TIMESLICE 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
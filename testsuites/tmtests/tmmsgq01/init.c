@@ -0,0 +1,167 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <rtems.h>
+#include <rtems/counter.h>
+
+const char rtems_test_name[] = "TMMSGQ 1";
+
+#define MESSAGE_COUNT 4
+
+#define MAXIMUM_MESSAGE_SIZE 8192
+
+#define SAMPLE_COUNT 100
+
+static char producer_buffer[MAXIMUM_MESSAGE_SIZE];
+
+static char consumer_buffer[MAXIMUM_MESSAGE_SIZE];
+
+static void copy_send_and_receive(rtems_id queue, size_t message_size)
+{
+  rtems_status_code sc;
+  size_t size;
+
+  memset(producer_buffer, 0x5a, message_size);
+
+  sc = rtems_message_queue_send(queue, producer_buffer, message_size);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive(
+    queue,
+    consumer_buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == message_size);
+}
+
+static void loan_submit_and_receive(rtems_id queue, size_t message_size)
+{
+  rtems_status_code sc;
+  void *buffer;
+  size_t size;
+
+  sc = rtems_message_queue_loan(queue, &buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  memset(buffer, 0x5a, message_size);
+
+  sc = rtems_message_queue_submit(queue, buffer, message_size);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  sc = rtems_message_queue_receive_loaned(
+    queue,
+    &buffer,
+    &size,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(size == message_size);
+
+  sc = rtems_message_queue_return(queue, buffer);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static uint64_t measure(
+  rtems_id queue,
+  size_t message_size,
+  void (*transfer)(rtems_id, size_t)
+)
+{
+  rtems_counter_ticks a;
+  rtems_counter_ticks b;
+  size_t i;
+
+  a = rtems_counter_read();
+
+  for (i = 0; i < SAMPLE_COUNT; ++i) {
+    (*transfer)(queue, message_size);
+  }
+
+  b = rtems_counter_read();
+
+  return rtems_counter_ticks_to_nanoseconds(rtems_counter_difference(b, a))
+    / SAMPLE_COUNT;
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  rtems_id queue;
+  size_t message_size;
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('M', 'S', 'G', 'Q'),
+    MESSAGE_COUNT,
+    MAXIMUM_MESSAGE_SIZE,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &queue
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  printf("<TMMsgq01>\n");
+
+  for (
+    message_size = 1024;
+    message_size <= MAXIMUM_MESSAGE_SIZE;
+    message_size *= 2
+  ) {
+    printf(
+      "  <Sample>\n"
+      "    <MessageSize unit=\"B\">%zu</MessageSize>"
+      "<Copy unit=\"ns\">%" PRIu64 "</Copy>"
+      "<Loan unit=\"ns\">%" PRIu64 "</Loan>\n"
+      "  </Sample>\n",
+      message_size,
+      measure(queue, message_size, copy_send_and_receive),
+      measure(queue, message_size, loan_submit_and_receive)
+    );
+  }
+
+  printf("</TMMsgq01>\n");
+
+  sc = rtems_message_queue_delete(queue);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MESSAGE_COUNT, MAXIMUM_MESSAGE_SIZE)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,169 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <rtems.h>
+#include <rtems/counter.h>
+
+const char rtems_test_name[] = "TMMSGQ 2";
+
+#define MAXIMUM_BURST 64
+
+#define MESSAGE_SIZE 16
+
+#define SAMPLE_COUNT 100
+
+static char producer_buffer[MAXIMUM_BURST][MESSAGE_SIZE];
+
+static char consumer_buffer[MAXIMUM_BURST][MESSAGE_SIZE];
+
+static size_t consumer_sizes[MAXIMUM_BURST];
+
+static void single_burst(rtems_id queue, uint32_t burst)
+{
+  uint32_t i;
+
+  for (i = 0; i < burst; ++i) {
+    rtems_status_code sc;
+
+    sc = rtems_message_queue_send(queue, producer_buffer[i], MESSAGE_SIZE);
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+
+  for (i = 0; i < burst; ++i) {
+    rtems_status_code sc;
+
+    sc = rtems_message_queue_receive(
+      queue,
+      consumer_buffer[i],
+      &consumer_sizes[i],
+      RTEMS_NO_WAIT,
+      0
+    );
+    rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  }
+}
+
+static void batched_burst(rtems_id queue, uint32_t burst)
+{
+  rtems_status_code sc;
+  uint32_t n;
+
+  sc = rtems_message_queue_send_many(
+    queue,
+    producer_buffer,
+    MESSAGE_SIZE,
+    burst,
+    &n
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(n == burst);
+
+  sc = rtems_message_queue_receive_many(
+    queue,
+    consumer_buffer,
+    MESSAGE_SIZE,
+    consumer_sizes,
+    burst,
+    &n,
+    RTEMS_NO_WAIT,
+    0
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+  rtems_test_assert(n == burst);
+}
+
+static uint64_t measure(
+  rtems_id queue,
+  uint32_t burst,
+  void (*transfer)(rtems_id, uint32_t)
+)
+{
+  rtems_counter_ticks a;
+  rtems_counter_ticks b;
+  size_t i;
+
+  a = rtems_counter_read();
+
+  for (i = 0; i < SAMPLE_COUNT; ++i) {
+    (*transfer)(queue, burst);
+  }
+
+  b = rtems_counter_read();
+
+  return rtems_counter_ticks_to_nanoseconds(rtems_counter_difference(b, a))
+    / (SAMPLE_COUNT * burst);
+}
+
+static void test(void)
+{
+  rtems_status_code sc;
+  rtems_id queue;
+  uint32_t burst;
+
+  sc = rtems_message_queue_create(
+    rtems_build_name('M', 'S', 'G', 'Q'),
+    MAXIMUM_BURST,
+    MESSAGE_SIZE,
+    RTEMS_DEFAULT_ATTRIBUTES,
+    &queue
+  );
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+
+  printf("<TMMsgq02>\n");
+
+  for (burst = 1; burst <= MAXIMUM_BURST; burst *= 4) {
+    printf(
+      "  <Sample>\n"
+      "    <Burst>%" PRIu32 "</Burst>"
+      "<Single unit=\"ns\">%" PRIu64 "</Single>"
+      "<Batched unit=\"ns\">%" PRIu64 "</Batched>\n"
+      "  </Sample>\n",
+      burst,
+      measure(queue, burst, single_burst),
+      measure(queue, burst, batched_burst)
+    );
+  }
+
+  printf("</TMMsgq02>\n");
+
+  sc = rtems_message_queue_delete(queue);
+  rtems_test_assert(sc == RTEMS_SUCCESSFUL);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 1
+#define CONFIGURE_MESSAGE_BUFFER_MEMORY \
+  CONFIGURE_MESSAGE_BUFFERS_FOR_QUEUE(MAXIMUM_BURST, MESSAGE_SIZE)
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,185 @@
+/*
+ * The license and distribution terms for this file may be
+ * found in the file LICENSE in this distribution or at
+ * http://www.rtems.org/license/LICENSE.
+ */
+
+#ifdef HAVE_CONFIG_H
+  #include "config.h"
+#endif
+
+#include "tmacros.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include <rtems.h>
+#include <rtems/counter.h>
+#include <rtems/score/watchdogimpl.h>
+
+const char rtems_test_name[] = "TMWATCHDOG 1";
+
+#define MAXIMUM_WATCHDOG_COUNT 100000
+
+typedef struct {
+  Watchdog_Control *watchdogs;
+  uint64_t *expire;
+  Watchdog_Header tree;
+  Watchdog_Header wheel_header;
+  Watchdog_Wheel wheel;
+} test_context;
+
+static test_context test_instance;
+
+static void never(Watchdog_Control *the_watchdog)
+{
+  rtems_test_assert(0);
+}
+
+static uint64_t measure_insert(
+  test_context *ctx,
+  Watchdog_Header *header,
+  size_t count
+)
+{
+  rtems_counter_ticks a;
+  rtems_counter_ticks b;
+  rtems_interrupt_level level;
+  size_t i;
+
+  rtems_interrupt_local_disable(level);
+  a = rtems_counter_read();
+
+  for (i = 0; i < count; ++i) {
+    _Watchdog_Insert(header, &ctx->watchdogs[i], ctx->expire[i]);
+  }
+
+  b = rtems_counter_read();
+  rtems_interrupt_local_enable(level);
+
+  return rtems_counter_ticks_to_nanoseconds(rtems_counter_difference(b, a))
+    / count;
+}
+
+static uint64_t measure_remove(
+  test_context *ctx,
+  Watchdog_Header *header,
+  size_t count
+)
+{
+  rtems_counter_ticks a;
+  rtems_counter_ticks b;
+  rtems_interrupt_level level;
+  size_t i;
+
+  rtems_interrupt_local_disable(level);
+  a = rtems_counter_read();
+
+  for (i = 0; i < count; ++i) {
+    _Watchdog_Remove(header, &ctx->watchdogs[i]);
+  }
+
+  b = rtems_counter_read();
+  rtems_interrupt_local_enable(level);
+
+  rtems_test_assert(_Watchdog_Header_first(header) == NULL);
+
+  return rtems_counter_ticks_to_nanoseconds(rtems_counter_difference(b, a))
+    / count;
+}
+
+static void test_case(test_context *ctx, size_t count)
+{
+  uint64_t tree_insert;
+  uint64_t tree_remove;
+  uint64_t wheel_insert;
+  uint64_t wheel_remove;
+
+  tree_insert = measure_insert(ctx, &ctx->tree, count);
+  tree_remove = measure_remove(ctx, &ctx->tree, count);
+  wheel_insert = measure_insert(ctx, &ctx->wheel_header, count);
+  wheel_remove = measure_remove(ctx, &ctx->wheel_header, count);
+
+  rtems_test_assert(ctx->wheel.count == 0);
+
+  printf(
+    "  <Sample>\n"
+    "    <Watchdogs>%zu</Watchdogs>\n"
+    "    <Tree><Insert unit=\"ns\">%" PRIu64 "</Insert>"
+    "<Remove unit=\"ns\">%" PRIu64 "</Remove></Tree>\n"
+    "    <Wheel><Insert unit=\"ns\">%" PRIu64 "</Insert>"
+    "<Remove unit=\"ns\">%" PRIu64 "</Remove></Wheel>\n"
+    "  </Sample>\n",
+    count,
+    tree_insert,
+    tree_remove,
+    wheel_insert,
+    wheel_remove
+  );
+}
+
+static void test(void)
+{
+  test_context *ctx = &test_instance;
+  Per_CPU_Control *cpu = _Per_CPU_Get_by_index(0);
+  uint32_t seed = 1;
+  size_t count;
+  size_t i;
+
+  ctx->watchdogs = calloc(MAXIMUM_WATCHDOG_COUNT, sizeof(*ctx->watchdogs));
+  ctx->expire = calloc(MAXIMUM_WATCHDOG_COUNT, sizeof(*ctx->expire));
+  rtems_test_assert(ctx->watchdogs != NULL);
+  rtems_test_assert(ctx->expire != NULL);
+
+  /*
+   * Timeouts of up to roughly one day at the default clock tick period of
+   * 10ms span all levels of the timing wheel.
+   */
+  for (i = 0; i < MAXIMUM_WATCHDOG_COUNT; ++i) {
+    seed = seed * 1103515245 + 12345;
+    ctx->expire[i] = 1 + (seed >> 8) % 8640000;
+    _Watchdog_Preinitialize(&ctx->watchdogs[i], cpu);
+    _Watchdog_Initialize(&ctx->watchdogs[i], never);
+  }
+
+  _Watchdog_Header_initialize(&ctx->tree);
+  _Watchdog_Header_initialize(&ctx->wheel_header);
+  _Watchdog_Header_initialize_wheel(&ctx->wheel_header, &ctx->wheel, 0);
+
+  printf("<TMWatchdog01>\n");
+
+  for (count = 1000; count <= MAXIMUM_WATCHDOG_COUNT; count *= 10) {
+    test_case(ctx, count);
+  }
+
+  printf("</TMWatchdog01>\n");
+
+  free(ctx->watchdogs);
+  free(ctx->expire);
+}
+
+static void Init(rtems_task_argument arg)
+{
+  TEST_BEGIN();
+
+  test();
+
+  TEST_END();
+  rtems_test_exit(0);
+}
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_SIMPLE_CONSOLE_DRIVER
+
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#define CONFIGURE_MAXIMUM_TASKS 1
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT
+
+#include <rtems/confdefs.h>